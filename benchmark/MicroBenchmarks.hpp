@@ -0,0 +1,258 @@
+/*
+    This source is a part of libosmscout-render
+
+    Copyright (C) 2012, Preet Desai
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef OSMSCOUTRENDER_BENCH_MICROBENCHMARKS_HPP
+#define OSMSCOUTRENDER_BENCH_MICROBENCHMARKS_HPP
+
+#include <chrono>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <unordered_map>
+
+#include <libosmscout-render/MapRenderer.h>
+#include <libosmscout-render/IdMap.hpp>
+#include <libosmscout-render/SharedNodeIndex.hpp>
+
+namespace osmsrender
+{
+    // micro benchmarks for the containers used while
+    // diffing and applying scene updates, each compared
+    // with the std container it replaced
+
+    inline double calcElapsedMs(std::chrono::steady_clock::time_point const &tStart)
+    {
+        return std::chrono::duration<double,std::milli>(
+                    std::chrono::steady_clock::now()-tStart).count();
+    }
+
+    // MapBenchResult
+    // * times in ms to insert numIds entries, find
+    //   each of them (and as many missing ids), iterate
+    //   over the map and erase every other entry
+    // * checksum should match between map types
+    struct MapBenchResult
+    {
+        MapBenchResult() :
+            insertMs(0),findMs(0),iterateMs(0),eraseMs(0),checksum(0)
+        {}
+
+        // KeepFastest
+        // * keeps the faster time for each operation
+        //   between this and another run
+        void KeepFastest(MapBenchResult const &other)
+        {
+            insertMs = std::min(insertMs,other.insertMs);
+            findMs = std::min(findMs,other.findMs);
+            iterateMs = std::min(iterateMs,other.iterateMs);
+            eraseMs = std::min(eraseMs,other.eraseMs);
+        }
+
+        double insertMs;
+        double findMs;
+        double iterateMs;
+        double eraseMs;
+        size_t checksum;
+    };
+
+    // BenchIdMap
+    // * ids are sparse and in no particular order
+    //   like the osm ids of objects in a view
+    template <typename MapType>
+    void BenchIdMap(std::vector<osmscout::Id> const &listIds,
+                    MapBenchResult &result)
+    {
+        result = MapBenchResult();
+        std::chrono::steady_clock::time_point tStart;
+
+        MapType mapIds;
+        tStart = std::chrono::steady_clock::now();
+        for(size_t i=0; i < listIds.size(); i++)
+        {   mapIds.insert(std::make_pair(listIds[i],i));   }
+        result.insertMs = calcElapsedMs(tStart);
+
+        tStart = std::chrono::steady_clock::now();
+        for(size_t i=0; i < listIds.size(); i++)   {
+            typename MapType::const_iterator it = mapIds.find(listIds[i]);
+            if(it != mapIds.end())
+            {   result.checksum += it->second;   }
+
+            // ids are even, so odd ids are misses
+            result.checksum += mapIds.count(listIds[i]+1);
+        }
+        result.findMs = calcElapsedMs(tStart);
+
+        tStart = std::chrono::steady_clock::now();
+        typename MapType::const_iterator it;
+        for(it = mapIds.begin(); it != mapIds.end(); ++it)
+        {   result.checksum += it->second;   }
+        result.iterateMs = calcElapsedMs(tStart);
+
+        tStart = std::chrono::steady_clock::now();
+        for(size_t i=0; i < listIds.size(); i+=2)
+        {   mapIds.erase(listIds[i]);   }
+        result.eraseMs = calcElapsedMs(tStart);
+
+        result.checksum += mapIds.size();
+    }
+
+    // GenBenchIds
+    // * numIds unique, even ids in random order
+    inline void GenBenchIds(size_t numIds, std::vector<osmscout::Id> &listIds)
+    {
+        std::mt19937_64 rng(12345);
+        listIds.resize(numIds);
+        for(size_t i=0; i < numIds; i++)
+        {   listIds[i] = (i*37 + (rng() % 37))*2 + 1000000000;   }
+
+        std::shuffle(listIds.begin(),listIds.end(),rng);
+    }
+
+    // SharedNodeBenchResult
+    // * times in ms to add every way of a dense street
+    //   grid, look up each way's intersections and
+    //   remove half of the ways
+    // * numXSecs should match between index types
+    struct SharedNodeBenchResult
+    {
+        SharedNodeBenchResult() :
+            addMs(0),lookupMs(0),removeMs(0),numXSecs(0)
+        {}
+
+        void KeepFastest(SharedNodeBenchResult const &other)
+        {
+            addMs = std::min(addMs,other.addMs);
+            lookupMs = std::min(lookupMs,other.lookupMs);
+            removeMs = std::min(removeMs,other.removeMs);
+        }
+
+        double addMs;
+        double lookupMs;
+        double removeMs;
+        size_t numXSecs;
+    };
+
+    typedef std::pair<osmscout::Id,std::vector<osmscout::Point> > BenchWay;
+
+    // GenBenchGrid
+    // * gridSize rows and columns of ways that
+    //   share a node wherever they cross
+    inline void GenBenchGrid(size_t gridSize, std::vector<BenchWay> &listWays)
+    {
+        listWays.clear();
+        for(size_t dir=0; dir < 2; dir++)   {
+            for(size_t line=0; line < gridSize; line++)
+            {
+                BenchWay way;
+                way.first = listWays.size()+1;
+                for(size_t k=0; k < gridSize; k++)   {
+                    size_t row = (dir == 0) ? line : k;
+                    size_t col = (dir == 0) ? k : line;
+                    way.second.push_back(osmscout::Point(row*gridSize+col+1,0,0));
+                }
+                listWays.push_back(way);
+            }
+        }
+    }
+
+    inline void BenchSharedNodeIndex(std::vector<BenchWay> const &listWays,
+                                     SharedNodeBenchResult &result)
+    {
+        result = SharedNodeBenchResult();
+        std::chrono::steady_clock::time_point tStart;
+
+        SharedNodeIndex index;
+        tStart = std::chrono::steady_clock::now();
+        for(size_t i=0; i < listWays.size(); i++)
+        {   index.AddWay(listWays[i].first,listWays[i].second);   }
+        index.Update();
+        result.addMs = calcElapsedMs(tStart);
+
+        tStart = std::chrono::steady_clock::now();
+        std::vector<WayXSec> listXSecs;
+        for(size_t i=0; i < listWays.size(); i++)   {
+            index.GetIntersections(listWays[i].first,listWays[i].second,listXSecs);
+            result.numXSecs += listXSecs.size();
+        }
+        result.lookupMs = calcElapsedMs(tStart);
+
+        tStart = std::chrono::steady_clock::now();
+        for(size_t i=0; i < listWays.size(); i+=2)
+        {   index.RemoveWay(listWays[i].first);   }
+        index.Update();
+        result.removeMs = calcElapsedMs(tStart);
+    }
+
+    // BenchSharedNodeMultimap
+    // * the node id -> way multimap the index replaced
+    inline void BenchSharedNodeMultimap(std::vector<BenchWay> const &listWays,
+                                        SharedNodeBenchResult &result)
+    {
+        typedef TYPE_UNORDERED_MULTIMAP<osmscout::Id,osmscout::Id> NodeWayMap;
+
+        result = SharedNodeBenchResult();
+        std::chrono::steady_clock::time_point tStart;
+
+        NodeWayMap mapNodeWays;
+        tStart = std::chrono::steady_clock::now();
+        for(size_t i=0; i < listWays.size(); i++)   {
+            std::vector<osmscout::Point> const &listNodes = listWays[i].second;
+            for(size_t j=0; j < listNodes.size(); j++)   {
+                mapNodeWays.insert(std::make_pair(listNodes[j].GetId(),
+                                                  listWays[i].first));
+            }
+        }
+        result.addMs = calcElapsedMs(tStart);
+
+        tStart = std::chrono::steady_clock::now();
+        for(size_t i=0; i < listWays.size(); i++)   {
+            std::vector<osmscout::Point> const &listNodes = listWays[i].second;
+            for(size_t j=0; j < listNodes.size(); j++)   {
+                std::pair<NodeWayMap::const_iterator,NodeWayMap::const_iterator> range =
+                        mapNodeWays.equal_range(listNodes[j].GetId());
+
+                NodeWayMap::const_iterator it;
+                for(it = range.first; it != range.second; ++it)   {
+                    if(it->second != listWays[i].first)
+                    {   result.numXSecs++;   }
+                }
+            }
+        }
+        result.lookupMs = calcElapsedMs(tStart);
+
+        tStart = std::chrono::steady_clock::now();
+        for(size_t i=0; i < listWays.size(); i+=2)   {
+            std::vector<osmscout::Point> const &listNodes = listWays[i].second;
+            for(size_t j=0; j < listNodes.size(); j++)   {
+                std::pair<NodeWayMap::iterator,NodeWayMap::iterator> range =
+                        mapNodeWays.equal_range(listNodes[j].GetId());
+
+                NodeWayMap::iterator it;
+                for(it = range.first; it != range.second; ++it)   {
+                    if(it->second == listWays[i].first)
+                    {   mapNodeWays.erase(it);   break;   }
+                }
+            }
+        }
+        result.removeMs = calcElapsedMs(tStart);
+    }
+}
+
+#endif
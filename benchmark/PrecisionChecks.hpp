@@ -0,0 +1,158 @@
+/*
+    This source is a part of libosmscout-render
+
+    Copyright (C) 2012, Preet Desai
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef OSMSCOUTRENDER_BENCH_PRECISIONCHECKS_HPP
+#define OSMSCOUTRENDER_BENCH_PRECISIONCHECKS_HPP
+
+#include <cmath>
+#include <cfloat>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#include <libosmscout-render/SimdMath.hpp>
+#include <libosmscout-render-null/MapRendererNull.h>
+
+namespace osmsrender
+{
+    // precision checks for the SSE2 paths, each compared
+    // with the scalar/libm code it stands in for; without
+    // SSE2 the batched conversions are the scalar ones
+
+    // PrecisionResult
+    // * maxError is the largest difference seen over
+    //   every sample and bound is the most it may be
+    struct PrecisionResult
+    {
+        PrecisionResult() :
+            maxError(0),bound(0)
+        {}
+
+        PrecisionResult(double myBound) :
+            maxError(0),bound(myBound)
+        {}
+
+        void Add(double error)
+        {   maxError = std::max(maxError,error);   }
+
+        bool Passed() const
+        {   return (maxError <= bound);   }
+
+        double maxError;
+        double bound;
+    };
+
+    // ConvRenderer
+    // * exposes the coordinate conversions, which
+    //   are only meant to be used by the renderer
+    class ConvRenderer : public MapRendererNull
+    {
+    public:
+        using MapRendererNull::convLLAToECEF;
+        using MapRendererNull::convECEFToLLA;
+    };
+
+    // GenPrecisionPoints
+    // * numPts random points anywhere on the globe
+    //   from the bottom of the sea to cruising altitude
+    // * an odd numPts also exercises the scalar tail
+    //   of the batched conversions
+    inline void GenPrecisionPoints(size_t numPts, std::vector<PointLLA> &listPointLLA)
+    {
+        std::mt19937_64 rng(12345);
+        std::uniform_real_distribution<double> distLat(-90.0,90.0);
+        std::uniform_real_distribution<double> distLon(-180.0,180.0);
+        std::uniform_real_distribution<double> distAlt(-11000.0,12000.0);
+
+        listPointLLA.resize(numPts);
+        for(size_t i=0; i < numPts; i++)   {
+            listPointLLA[i] = PointLLA(distLat(rng),distLon(rng),distAlt(rng));
+        }
+    }
+
+#if defined(__SSE2__)
+    // CheckSinCos2
+    // * max absolute difference between calcSinCos2
+    //   and libm sin/cos over [-2pi,2pi]
+    inline void CheckSinCos2(size_t numAngles, PrecisionResult &result)
+    {
+        std::mt19937_64 rng(12345);
+        std::uniform_real_distribution<double> distAngle(-2*K_PI,2*K_PI);
+
+        for(size_t i=0; i < numAngles; i+=2)
+        {
+            double x[2] = {distAngle(rng),distAngle(rng)};
+            double sinX[2],cosX[2];
+
+            __m128d vSinX,vCosX;
+            calcSinCos2(_mm_loadu_pd(x),vSinX,vCosX);
+            _mm_storeu_pd(sinX,vSinX);
+            _mm_storeu_pd(cosX,vCosX);
+
+            for(size_t k=0; k < 2; k++)   {
+                result.Add(fabs(sinX[k]-sin(x[k])));
+                result.Add(fabs(cosX[k]-cos(x[k])));
+            }
+        }
+    }
+#endif
+
+    // CheckLLAToECEF
+    // * max distance in meters between the batched
+    //   and the single point conversion
+    inline void CheckLLAToECEF(ConvRenderer &renderer,
+                               std::vector<PointLLA> const &listPointLLA,
+                               PrecisionResult &result)
+    {
+        GeomBuffer buffECEF;
+        renderer.convLLAToECEF(listPointLLA,buffECEF);
+
+        for(size_t i=0; i < listPointLLA.size(); i++)   {
+            Vec3 pointECEF = renderer.convLLAToECEF(listPointLLA[i]);
+            result.Add(pointECEF.DistanceTo(buffECEF.GetPoint(i)));
+        }
+    }
+
+    // CheckECEFToLLA
+    // * max difference in lat/lon (degrees) and alt
+    //   (meters) between the batched and the single
+    //   point conversion
+    inline void CheckECEFToLLA(ConvRenderer &renderer,
+                               std::vector<PointLLA> const &listPointLLA,
+                               PrecisionResult &resultLatLon,
+                               PrecisionResult &resultAlt)
+    {
+        std::vector<Vec3> listPointECEF(listPointLLA.size());
+        for(size_t i=0; i < listPointLLA.size(); i++)
+        {   renderer.convLLAToECEF(listPointLLA[i],listPointECEF[i]);   }
+
+        std::vector<PointLLA> listBatchLLA;
+        renderer.convECEFToLLA(listPointECEF,listBatchLLA);
+
+        for(size_t i=0; i < listPointECEF.size(); i++)   {
+            PointLLA pointLLA = renderer.convECEFToLLA(listPointECEF[i]);
+            resultLatLon.Add(fabs(pointLLA.lat-listBatchLLA[i].lat));
+            resultLatLon.Add(fabs(pointLLA.lon-listBatchLLA[i].lon));
+            resultAlt.Add(fabs(pointLLA.alt-listBatchLLA[i].alt));
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,255 @@
+/*
+    This source is a part of libosmscout-render
+
+    Copyright (C) 2012, Preet Desai
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef OSMSCOUTRENDER_BENCH_SYNTHETICCITY_HPP
+#define OSMSCOUTRENDER_BENCH_SYNTHETICCITY_HPP
+
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <osmscout/TypeConfig.h>
+
+#include <libosmscout-render/DataSet.hpp>
+
+namespace osmsrender
+{
+    // CityParams
+    // * a square grid of gridSize x gridSize blocks
+    //   centered on centerLat,centerLon, each
+    //   blockSize meters across
+    struct CityParams
+    {
+        CityParams() :
+            centerLat(51.5039),centerLon(-0.1214),
+            gridSize(64),blockSize(120.0),
+            waySpan(8),wayPtsPerBlock(3),
+            buildingsPerSide(2)
+        {}
+
+        double centerLat;
+        double centerLon;
+        size_t gridSize;
+        double blockSize;
+        size_t waySpan;             // blocks covered by each street way
+        size_t wayPtsPerBlock;      // way points along each block edge
+        size_t buildingsPerSide;    // buildings per block are this squared
+    };
+
+    struct CityStats
+    {
+        CityStats() :
+            numNodes(0),numWays(0),numAreas(0),
+            numWayPoints(0),numAreaPoints(0)
+        {}
+
+        size_t numNodes;
+        size_t numWays;
+        size_t numAreas;
+        size_t numWayPoints;
+        size_t numAreaPoints;
+    };
+
+    // BuildSyntheticCity
+    // * fills dataSet with a street grid, a pair of
+    //   diagonal motorways, buildings and parking lots
+    //   for each block and a point of interest per block
+    // * streets share nodes where they intersect and are
+    //   split into ways of params.waySpan blocks each, so
+    //   the scene has as many intersections and way ends
+    //   as a real city of the same size
+    // * street classes follow a fixed pattern (every 8th
+    //   street is primary, every 4th secondary and so on)
+    //   and the output only depends on params
+    inline void BuildSyntheticCity(DataSetTemp &dataSet,
+                                   osmscout::TypeConfig const &typeConfig,
+                                   CityParams const &params,
+                                   CityStats &stats)
+    {
+        stats = CityStats();
+
+        size_t const numLines = params.gridSize+1;
+        size_t const ptsPerBlock = std::max(params.wayPtsPerBlock,size_t(1));
+        double const degPerMeter = 1.0/111320.0;
+        double const dLat = params.blockSize*degPerMeter;
+        double const dLon = params.blockSize*degPerMeter/
+                cos(params.centerLat*3.141592653589/180.0);
+        double const minLat = params.centerLat - dLat*params.gridSize*0.5;
+        double const minLon = params.centerLon - dLon*params.gridSize*0.5;
+
+        osmscout::TypeId typeMotorway = typeConfig.GetWayTypeId("highway_motorway");
+        osmscout::TypeId typePrimary = typeConfig.GetWayTypeId("highway_primary");
+        osmscout::TypeId typeSecondary = typeConfig.GetWayTypeId("highway_secondary");
+        osmscout::TypeId typeTertiary = typeConfig.GetWayTypeId("highway_tertiary");
+        osmscout::TypeId typeResidential = typeConfig.GetWayTypeId("highway_residential");
+        osmscout::TypeId typeBuilding = typeConfig.GetAreaTypeId("building");
+        osmscout::TypeId typeParkingArea = typeConfig.GetAreaTypeId("amenity_parking");
+
+        std::vector<osmscout::TypeId> listPoiTypes;
+        listPoiTypes.push_back(typeConfig.GetNodeTypeId("amenity_parking"));
+        listPoiTypes.push_back(typeConfig.GetNodeTypeId("amenity_hospital"));
+        listPoiTypes.push_back(typeConfig.GetNodeTypeId("amenity"));
+        listPoiTypes.push_back(typeConfig.GetNodeTypeId("shop"));
+
+        // intersections are node ids [1,numLines^2], the
+        // points between them are numbered after that
+        osmscout::Id nextNodeId = numLines*numLines+1;
+
+        // [streets]
+        for(size_t dir=0; dir < 2; dir++)   {
+            for(size_t line=0; line < numLines; line++)
+            {
+                osmscout::TypeId wayType = typeResidential;
+                if(line % 8 == 0)        {   wayType = typePrimary;   }
+                else if(line % 4 == 0)   {   wayType = typeSecondary;   }
+                else if(line % 2 == 0)   {   wayType = typeTertiary;   }
+
+                std::stringstream ssName;
+                ssName << ((dir == 0) ? "Street " : "Avenue ") << line;
+
+                for(size_t b=0; b < params.gridSize; b+=params.waySpan)
+                {
+                    size_t bEnd = std::min(b+params.waySpan,params.gridSize);
+
+                    osmscout::Way way;
+                    way.SetType(wayType);
+                    for(size_t k=b; k <= bEnd; k++)
+                    {
+                        size_t row = (dir == 0) ? line : k;
+                        size_t col = (dir == 0) ? k : line;
+                        way.nodes.push_back(osmscout::Point(row*numLines+col+1,
+                                                            minLat+row*dLat,
+                                                            minLon+col*dLon));
+                        if(k == bEnd)
+                        {   break;   }
+
+                        for(size_t p=1; p < ptsPerBlock; p++)   {
+                            double t = double(p)/ptsPerBlock;
+                            way.nodes.push_back(osmscout::Point(nextNodeId++,
+                                minLat+(row+((dir == 0) ? 0 : t))*dLat,
+                                minLon+(col+((dir == 0) ? t : 0))*dLon));
+                        }
+                    }
+
+                    std::vector<osmscout::Tag> listTags;
+                    listTags.push_back(osmscout::Tag(typeConfig.tagName,ssName.str()));
+
+                    size_t wayId;
+                    if(dataSet.AddWay(way,listTags,wayId))   {
+                        stats.numWays++;
+                        stats.numWayPoints += way.nodes.size();
+                    }
+                }
+            }
+        }
+
+        // [motorways]
+        // * corner to corner, crossing the grid's
+        //   intersections without sharing their nodes
+        for(size_t m=0; m < 2; m++)
+        {
+            osmscout::Way way;
+            way.SetType(typeMotorway);
+            for(size_t k=0; k <= params.gridSize*ptsPerBlock; k++)   {
+                double t = double(k)/ptsPerBlock;
+                double col = (m == 0) ? t : params.gridSize-t;
+                way.nodes.push_back(osmscout::Point(nextNodeId++,
+                                                    minLat+t*dLat,
+                                                    minLon+col*dLon));
+            }
+
+            std::vector<osmscout::Tag> listTags;
+            listTags.push_back(osmscout::Tag(typeConfig.tagName,"Motorway"));
+
+            size_t wayId;
+            if(dataSet.AddWay(way,listTags,wayId))   {
+                stats.numWays++;
+                stats.numWayPoints += way.nodes.size();
+            }
+        }
+
+        // [blocks]
+        size_t const numSide = std::max(params.buildingsPerSide,size_t(1));
+        for(size_t row=0; row < params.gridSize; row++)   {
+            for(size_t col=0; col < params.gridSize; col++)
+            {
+                size_t blockIdx = row*params.gridSize+col;
+                double blockLat = minLat+row*dLat;
+                double blockLon = minLon+col*dLon;
+
+                // one in every seven blocks is a parking lot
+                bool isParking = (blockIdx % 7 == 3);
+                size_t numLots = isParking ? 1 : numSide;
+                double lotLat = dLat/numLots;
+                double lotLon = dLon/numLots;
+
+                for(size_t i=0; i < numLots; i++)   {
+                    for(size_t j=0; j < numLots; j++)
+                    {
+                        // inset each lot by 15% of its size
+                        double lat0 = blockLat+(i+0.15)*lotLat;
+                        double lat1 = blockLat+(i+0.85)*lotLat;
+                        double lon0 = blockLon+(j+0.15)*lotLon;
+                        double lon1 = blockLon+(j+0.85)*lotLon;
+
+                        osmscout::Way area;
+                        area.SetType(isParking ? typeParkingArea : typeBuilding);
+                        area.nodes.push_back(osmscout::Point(nextNodeId++,lat0,lon0));
+                        area.nodes.push_back(osmscout::Point(nextNodeId++,lat0,lon1));
+                        area.nodes.push_back(osmscout::Point(nextNodeId++,lat1,lon1));
+                        area.nodes.push_back(osmscout::Point(nextNodeId++,lat1,lon0));
+
+                        std::vector<osmscout::Tag> listTags;
+                        if(!isParking)   {
+                            std::stringstream ssHeight;
+                            ssHeight << 8+((blockIdx+i*3+j*5) % 10)*4;
+                            listTags.push_back(osmscout::Tag(dataSet.tagBuilding,"yes"));
+                            listTags.push_back(osmscout::Tag(dataSet.tagHeight,ssHeight.str()));
+                        }
+
+                        size_t areaId;
+                        if(dataSet.AddArea(area,listTags,areaId))   {
+                            stats.numAreas++;
+                            stats.numAreaPoints += area.nodes.size();
+                        }
+                    }
+                }
+
+                // a point of interest near the block's corner
+                osmscout::Node node;
+                node.SetType(listPoiTypes[blockIdx % listPoiTypes.size()]);
+                node.SetCoordinates(blockLon+dLon*0.1,blockLat+dLat*0.1);
+
+                std::stringstream ssName;
+                ssName << "Place " << blockIdx;
+
+                std::vector<osmscout::Tag> listTags;
+                listTags.push_back(osmscout::Tag(typeConfig.tagName,ssName.str()));
+
+                size_t nodeId;
+                if(dataSet.AddNode(node,listTags,nodeId))
+                {   stats.numNodes++;   }
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,29 @@
+TEMPLATE = app
+TARGET = osmscout-render-bench
+CONFIG += console release thread
+CONFIG -= qt
+QMAKE_CXXFLAGS += -std=c++11
+
+HEADERS += SyntheticCity.hpp \
+           MicroBenchmarks.hpp \
+           PrecisionChecks.hpp
+SOURCES += main.cpp
+
+#boost
+USE_BOOST   {
+   DEFINES += USE_BOOST
+   INCLUDEPATH += /home/preet/Dev/env/sys/boost-1.50
+}
+
+INCLUDEPATH += ..
+
+#libosmscout-render-null
+LIBS += -L../libosmscout-render-null -losmscoutrendernull
+
+#libosmscout-render
+INCLUDEPATH += ../libosmscout-render
+LIBS += -L../libosmscout-render -losmscoutrender
+
+#libosmscout
+INCLUDEPATH += /home/preet/Dev/env/sys/libosmscout/include
+LIBS += -L/home/preet/Dev/env/sys/libosmscout/lib -losmscout
@@ -0,0 +1,901 @@
+/*
+    This source is a part of libosmscout-render
+
+    Copyright (C) 2012, Preet Desai
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// benchmark
+// * runs MapRenderer with the null backend over a
+//   synthetic city, moving the camera along a set of
+//   scripted paths for every style in the style dir
+//   and with a couple of renderer configurations
+// * results are written as json so runs can be
+//   compared between builds (see writeUsage)
+
+// system
+#include <sys/resource.h>
+#include <dirent.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+// osmscout
+#include <osmscout/TypeConfig.h>
+#include <osmscout/TypeConfigLoader.h>
+
+// libosmscout-render
+#include <libosmscout-render/jansson/jansson.h>
+#include <libosmscout-render-null/MapRendererNull.h>
+
+#include "SyntheticCity.hpp"
+#include "MicroBenchmarks.hpp"
+#include "PrecisionChecks.hpp"
+
+using namespace osmsrender;
+
+// ========================================================================== //
+// ========================================================================== //
+
+enum CameraPath
+{
+    PATH_PAN,       // top down, around a square
+    PATH_ORBIT,     // tilted, circling a point
+    PATH_ZOOM,      // top down, in and back out
+    PATH_JUMP       // top down, to random places
+};
+
+struct PathInfo
+{
+    CameraPath path;
+    char const * name;
+};
+
+static PathInfo const g_listPaths[] = {
+    {PATH_PAN,"pan"},
+    {PATH_ORBIT,"orbit"},
+    {PATH_ZOOM,"zoom"},
+    {PATH_JUMP,"jump"}
+};
+
+// RunConfig
+// * "default" leaves every renderer option off, and
+//   "tuned" turns on the options the viewer uses
+struct RunConfig
+{
+    char const * name;
+    bool tuned;
+};
+
+static RunConfig const g_listConfigs[] = {
+    {"default",false},
+    {"tuned",true}
+};
+
+struct BenchParams
+{
+    BenchParams() :
+        typeConfigPath("../res/map_render.ost"),
+        styleDir("../res/styles/tests"),
+        numSteps(32),
+        camAlt(800.0),
+        runMicro(true),
+        runPrecision(false)
+    {}
+
+    std::string typeConfigPath;
+    std::string styleDir;
+    std::string outPath;
+    std::string tracePath;
+    size_t numSteps;
+    double camAlt;
+    bool runMicro;
+    bool runPrecision;
+    CityParams city;
+};
+
+// RunStats
+// * totals for the camera steps of a single run,
+//   counted from the backend's call log
+// * phase times are summed from the renderer's
+//   stats for each update (see SceneUpdateStats)
+struct RunStats
+{
+    RunStats() :
+        numUpdates(0),objectsAdded(0),objectsRemoved(0),
+        objectsRestyled(0),objectsShown(0),objectsHidden(0),
+        pointsAdded(0),lastUpdateIdx(0),
+        viewExtentsMs(0),queryMs(0),filterMs(0),diffMs(0),
+        genMs(0),commitMs(0),backendMs(0),doneMs(0)
+    {}
+
+    std::vector<double> listStepMs;
+    size_t numUpdates;
+    size_t objectsAdded;
+    size_t objectsRemoved;
+    size_t objectsRestyled;
+    size_t objectsShown;
+    size_t objectsHidden;
+    size_t pointsAdded;
+
+    size_t lastUpdateIdx;
+    double viewExtentsMs;
+    double queryMs;
+    double filterMs;
+    double diffMs;
+    double genMs;
+    double commitMs;
+    double backendMs;
+    double doneMs;
+};
+
+// ========================================================================== //
+// ========================================================================== //
+
+static void writeUsage()
+{
+    fprintf(stderr,
+        "usage: osmscout-render-bench [options]\n"
+        "  -t <file>   type config (default ../res/map_render.ost)\n"
+        "  -s <dir>    style dir, every .json file in it is run\n"
+        "              (default ../res/styles/tests)\n"
+        "  -o <file>   write results to file instead of stdout\n"
+        "  -r <file>   write a Chrome trace of the first run to file\n"
+        "  -g <n>      city size in blocks per side (default 64)\n"
+        "  -n <n>      camera steps per path (default 32)\n"
+        "  -a <m>      camera altitude in meters (default 800)\n"
+        "  -x          skip the container micro benchmarks\n"
+        "  -p          only run the SSE2 precision checks, exits\n"
+        "              with 1 if any of them are out of bounds\n"
+        "exits with 1 if a run with incremental updates doesn't\n"
+        "end with the same scene as a full rebuild\n");
+}
+
+static bool parseArgs(int argc, char *argv[], BenchParams &params)
+{
+    for(int i=1; i < argc; i++)
+    {
+        std::string arg(argv[i]);
+        if(arg == "-x")
+        {   params.runMicro = false;   continue;   }
+        if(arg == "-p")
+        {   params.runPrecision = true;   continue;   }
+
+        if(i+1 >= argc)
+        {   return false;   }
+
+        char const * value = argv[++i];
+        if(arg == "-t")        {   params.typeConfigPath = value;   }
+        else if(arg == "-s")   {   params.styleDir = value;   }
+        else if(arg == "-o")   {   params.outPath = value;   }
+        else if(arg == "-r")   {   params.tracePath = value;   }
+        else if(arg == "-g")   {   params.city.gridSize = strtoul(value,NULL,10);   }
+        else if(arg == "-n")   {   params.numSteps = strtoul(value,NULL,10);   }
+        else if(arg == "-a")   {   params.camAlt = strtod(value,NULL);   }
+        else                   {   return false;   }
+    }
+    return (params.city.gridSize > 0 && params.numSteps > 0);
+}
+
+static bool getStyleFiles(std::string const &styleDir,
+                          std::vector<std::string> &listStyleFiles)
+{
+    DIR * dir = opendir(styleDir.c_str());
+    if(dir == NULL)
+    {   return false;   }
+
+    struct dirent * entry;
+    while((entry = readdir(dir)) != NULL)   {
+        std::string name(entry->d_name);
+        if(name.size() > 5 && name.compare(name.size()-5,5,".json") == 0)
+        {   listStyleFiles.push_back(name);   }
+    }
+    closedir(dir);
+
+    // readdir order isn't defined
+    std::sort(listStyleFiles.begin(),listStyleFiles.end());
+    return true;
+}
+
+// getPeakMemoryKb
+// * the process' peak resident set size; it never
+//   goes down, so later runs report at least as
+//   much as earlier ones
+static long getPeakMemoryKb()
+{
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF,&usage) != 0)
+    {   return 0;   }
+
+    return usage.ru_maxrss;
+}
+
+static double calcPercentile(std::vector<double> listValues, double pct)
+{
+    if(listValues.empty())
+    {   return 0;   }
+
+    std::sort(listValues.begin(),listValues.end());
+    size_t idx = size_t(pct*(listValues.size()-1)+0.5);
+    return listValues[idx];
+}
+
+// ========================================================================== //
+// ========================================================================== //
+
+static void applyRunConfig(MapRendererNull &renderer, RunConfig const &config)
+{
+    if(!config.tuned)
+    {   return;   }
+
+    // scene updates stay synchronous so each camera step
+    // is timed from the camera update to the last commit
+    renderer.SetIncrementalSceneUpdates(true);
+    renderer.SetRenderDataCacheSize(64*1024*1024);
+    renderer.SetCompactRenderData(true);
+    renderer.SetLODHysteresis(0.1);
+}
+
+// moveCamera
+// * moves the camera to its position for step
+//   (1 to numSteps) along path
+static void moveCamera(MapRendererNull &renderer,
+                       BenchParams const &params,
+                       CameraPath path, size_t step,
+                       std::mt19937 &rng)
+{
+    Camera const * cam = renderer.GetCamera();
+    double const fovY = cam->fovY;
+    double const aspectRatio = cam->aspectRatio;
+
+    Vec3 viewDir = (cam->viewPt-cam->eye).Normalized();
+    Vec3 right = viewDir.Cross(cam->up).Normalized();
+
+    double const cityWidth = params.city.gridSize*params.city.blockSize;
+
+    if(path == PATH_PAN)
+    {
+        // a quarter of the steps along each side
+        // of a square half the city's width
+        double stepDist = 2.0*cityWidth/params.numSteps;
+        size_t side = ((step-1)*4)/params.numSteps;
+
+        Vec3 offset;
+        if(side == 0)        {   offset = right.ScaledBy(stepDist);   }
+        else if(side == 1)   {   offset = cam->up.ScaledBy(stepDist);   }
+        else if(side == 2)   {   offset = right.ScaledBy(-stepDist);   }
+        else                 {   offset = cam->up.ScaledBy(-stepDist);   }
+
+        renderer.UpdateCameraLookAt(cam->eye+offset,
+                                    cam->viewPt+offset,
+                                    cam->up);
+    }
+    else if(path == PATH_ORBIT)
+    {
+        Vec3 eyeVec = cam->eye-cam->viewPt;
+        Vec3 up = cam->up;
+
+        // tilt the camera 50 degrees off vertical
+        // on the first step, then circle
+        if(step == 1)   {
+            eyeVec = eyeVec.RotatedBy(right,-50.0);
+            up = up.RotatedBy(right,-50.0);
+        }
+        else   {
+            Vec3 axis = cam->viewPt.Normalized();
+            double angle = 360.0/params.numSteps;
+            eyeVec = eyeVec.RotatedBy(axis,angle);
+            up = up.RotatedBy(axis,angle);
+        }
+
+        renderer.UpdateCameraLookAt(cam->viewPt+eyeVec,cam->viewPt,up);
+    }
+    else if(path == PATH_ZOOM)
+    {
+        // down to a quarter of the altitude, out to eight
+        // times it and back, at a constant zoom rate
+        double t = double(step)/params.numSteps;
+        double zoom;
+        if(t < 0.25)        {   zoom = -2.0*(t/0.25);   }
+        else if(t < 0.75)   {   zoom = -2.0+5.0*((t-0.25)/0.5);   }
+        else                {   zoom = 3.0*(1.0-(t-0.75)/0.25);   }
+
+        double alt = params.camAlt*pow(2.0,zoom);
+        renderer.SetCamera(PointLLA(params.city.centerLat,
+                                    params.city.centerLon,alt),
+                           fovY,aspectRatio);
+    }
+    else if(path == PATH_JUMP)
+    {
+        double const degPerMeter = 1.0/111320.0;
+        double halfLat = 0.5*cityWidth*degPerMeter;
+        double halfLon = halfLat/cos(params.city.centerLat*3.141592653589/180.0);
+
+        std::uniform_real_distribution<double> dist(-1.0,1.0);
+        double lat = params.city.centerLat + dist(rng)*halfLat;
+        double lon = params.city.centerLon + dist(rng)*halfLon;
+
+        renderer.SetCamera(PointLLA(lat,lon,params.camAlt),
+                           fovY,aspectRatio);
+    }
+}
+
+// collectStepStats
+// * adds the calls in the backend's log to stats and
+//   clears the log; returns true if the scene changed
+static bool collectStepStats(MapRendererNull &renderer, RunStats &stats)
+{
+    std::vector<NullCallRecord> listRecords;
+    renderer.GetCallLog(listRecords);
+    renderer.ClearCallLog();
+
+    bool sceneChanged = false;
+    for(size_t i=0; i < listRecords.size(); i++)
+    {
+        NullCallRecord const &record = listRecords[i];
+        if(strncmp(record.call,"add",3) == 0)   {
+            stats.objectsAdded += record.numObjects;
+            stats.pointsAdded += record.numPoints;
+        }
+        else if(strncmp(record.call,"remove",6) == 0)   {
+            stats.objectsRemoved += record.numObjects;
+        }
+        else if(strncmp(record.call,"restyle",7) == 0)   {
+            stats.objectsRestyled += record.numObjects;
+        }
+        else if(strncmp(record.call,"show",4) == 0 &&
+                strcmp(record.call,"showCameraViewArea") != 0)   {
+            stats.objectsShown += record.numObjects;
+        }
+        else if(strncmp(record.call,"hide",4) == 0)   {
+            stats.objectsHidden += record.numObjects;
+        }
+        else   {
+            continue;
+        }
+        sceneChanged = true;
+    }
+    return sceneChanged;
+}
+
+// collectUpdateStats
+// * adds the phase times of the renderer's last
+//   update to stats if it hasn't been added yet
+static void collectUpdateStats(MapRendererNull &renderer, RunStats &stats)
+{
+    SceneUpdateStats updateStats;
+    renderer.GetSceneUpdateStats(updateStats);
+    if(updateStats.updateIdx == stats.lastUpdateIdx)
+    {   return;   }
+
+    stats.lastUpdateIdx = updateStats.updateIdx;
+    stats.viewExtentsMs += updateStats.viewExtentsMs;
+    stats.queryMs += updateStats.queryMs;
+    stats.filterMs += updateStats.filterMs;
+    stats.diffMs += updateStats.diffMs;
+    stats.genMs += updateStats.genMs;
+    stats.commitMs += updateStats.commitMs;
+
+    SceneTypeStats const * listTypeStats[] = {
+        &updateStats.nodeStats,&updateStats.wayStats,
+        &updateStats.areaStats,&updateStats.relAreaStats
+    };
+
+    for(size_t i=0; i < 4; i++)   {
+        SceneTypeStats const &typeStats = *(listTypeStats[i]);
+        stats.backendMs += typeStats.addMs + typeStats.showMs +
+                typeStats.restyleMs + typeStats.hideMs + typeStats.removeMs;
+        stats.doneMs += typeStats.doneMs;
+    }
+}
+
+static json_t * makeUsageJson(MemoryUsage const &usage)
+{
+    json_t * jUsage = json_object();
+    json_object_set_new(jUsage,"objects",json_integer(usage.numObjects));
+    json_object_set_new(jUsage,"bytes",json_integer(usage.numBytes));
+    return jUsage;
+}
+
+static json_t * makeObjectUsageJson(ObjectMemoryUsage const &objUsage)
+{
+    json_t * jObjUsage = json_object();
+    json_object_set_new(jObjUsage,"nodes",makeUsageJson(objUsage.nodes));
+    json_object_set_new(jObjUsage,"ways",makeUsageJson(objUsage.ways));
+    json_object_set_new(jObjUsage,"areas",makeUsageJson(objUsage.areas));
+    json_object_set_new(jObjUsage,"relAreas",makeUsageJson(objUsage.relAreas));
+    return jObjUsage;
+}
+
+// makeMemoryJson
+// * the renderer's memory use at the end of a run,
+//   split by object type, lod and osm type
+static json_t * makeMemoryJson(MapRendererNull &renderer)
+{
+    MemoryStats memStats;
+    renderer.GetMemoryStats(memStats);
+
+    json_t * jMemory = json_object();
+    json_object_set_new(jMemory,"totalBytes",json_integer(memStats.GetTotalBytes()));
+
+    json_t * jDataSets = json_array();
+    for(size_t i=0; i < memStats.listDataSetStats.size(); i++)   {
+        DataSetMemoryStats const &dsStats = memStats.listDataSetStats[i];
+        json_t * jDataSet = json_object();
+        json_object_set_new(jDataSet,"totalBytes",json_integer(dsStats.GetTotal().numBytes));
+
+        json_t * jLods = json_array();
+        for(size_t j=0; j < dsStats.listLODUsage.size(); j++)
+        {   json_array_append_new(jLods,makeObjectUsageJson(dsStats.listLODUsage[j]));   }
+        json_object_set_new(jDataSet,"lods",jLods);
+
+        json_t * jTypes = json_object();
+        std::map<osmscout::TypeId,MemoryUsage>::const_iterator it;
+        for(it = dsStats.mapTypeUsage.begin(); it != dsStats.mapTypeUsage.end(); ++it)   {
+            std::string const &typeName =
+                dsStats.dataSet->GetTypeConfig()->GetTypeInfo(it->first).GetName();
+            json_object_set_new(jTypes,typeName.c_str(),makeUsageJson(it->second));
+        }
+        json_object_set_new(jDataSet,"types",jTypes);
+
+        json_object_set_new(jDataSet,"sceneIds",makeObjectUsageJson(dsStats.sceneIds));
+        json_object_set_new(jDataSet,"sharedNodes",makeUsageJson(dsStats.sharedNodes));
+        json_object_set_new(jDataSet,"styleConfigs",makeUsageJson(dsStats.styleConfigs));
+        json_array_append_new(jDataSets,jDataSet);
+    }
+    json_object_set_new(jMemory,"dataSets",jDataSets);
+    json_object_set_new(jMemory,"cache",makeObjectUsageJson(memStats.cache));
+    json_object_set_new(jMemory,"backend",makeObjectUsageJson(memStats.backend));
+
+    json_t * jBackend = json_object();
+    for(size_t i=0; i < memStats.listBackendUsage.size(); i++)   {
+        BackendMemoryUsage const &backendUsage = memStats.listBackendUsage[i];
+        json_object_set_new(jBackend,backendUsage.name.c_str(),
+                            makeUsageJson(backendUsage.usage));
+    }
+    json_object_set_new(jMemory,"backendParts",jBackend);
+
+    return jMemory;
+}
+
+// calcNumIdDiffs
+// * the number of objects only in one of the lists
+//   or shown at a different lod in each
+static size_t calcNumIdDiffs(ListIdLods const &listOld,
+                             ListIdLods const &listNew)
+{
+    IdDiff diff;
+    CalcIdDiff(listOld,listNew,diff);
+    return diff.listAdds.size() + diff.listRemoves.size() +
+           diff.listLodChanges.size();
+}
+
+// checkFullRebuild
+// * queries the whole view again and returns the number
+//   of objects in the scene that changed; a camera path
+//   with incremental updates should end with the same
+//   objects at the same lods as a full rebuild
+static size_t checkFullRebuild(MapRendererNull &renderer, DataSetTemp &dataSet)
+{
+    ListIdLods listNodeIds = dataSet.listNodeIds;
+    ListIdLods listWayIds = dataSet.listWayIds;
+    ListIdLods listAreaIds = dataSet.listAreaIds;
+    ListIdLods listRelAreaIds = dataSet.listRelAreaIds;
+
+    renderer.UpdateSceneContents(&dataSet);
+
+    return calcNumIdDiffs(listNodeIds,dataSet.listNodeIds) +
+           calcNumIdDiffs(listWayIds,dataSet.listWayIds) +
+           calcNumIdDiffs(listAreaIds,dataSet.listAreaIds) +
+           calcNumIdDiffs(listRelAreaIds,dataSet.listRelAreaIds);
+}
+
+// runCameraPath
+// * if tracePath isn't empty, the run is traced
+//   and the trace is written to tracePath
+// * runs with incremental updates end with a full
+//   rebuild (see checkFullRebuild)
+static json_t * runCameraPath(DataSetTemp &dataSet,
+                              std::string const &stylePath,
+                              PathInfo const &pathInfo,
+                              RunConfig const &config,
+                              BenchParams const &params,
+                              std::string const &tracePath)
+{
+    json_t * jRun = json_object();
+
+    MapRendererNull renderer;
+    applyRunConfig(renderer,config);
+    renderer.SetRenderStyle(stylePath);
+    renderer.AddDataSet(&dataSet);
+
+    if(dataSet.listStyleConfigs.empty())   {
+        json_object_set_new(jRun,"error",json_string("could not load style"));
+        return jRun;
+    }
+
+    renderer.SetCallRecording(true);
+    if(!tracePath.empty())
+    {   renderer.SetTraceRecording(true);   }
+
+    std::chrono::steady_clock::time_point tStart;
+    RunStats stats;
+
+    // the initial scene is timed separately
+    // since it's built from scratch
+    tStart = std::chrono::steady_clock::now();
+    renderer.InitializeScene(PointLLA(params.city.centerLat,
+                                      params.city.centerLon,
+                                      params.camAlt),30.0,1.67);
+    double initMs = calcElapsedMs(tStart);
+
+    RunStats initStats;
+    collectStepStats(renderer,initStats);
+    collectUpdateStats(renderer,initStats);
+    stats.lastUpdateIdx = initStats.lastUpdateIdx;
+
+    // seeded per run so every style and config
+    // jumps to the same places
+    std::mt19937 rng(1234);
+    for(size_t step=1; step <= params.numSteps; step++)   {
+        tStart = std::chrono::steady_clock::now();
+        moveCamera(renderer,params,pathInfo.path,step,rng);
+        stats.listStepMs.push_back(calcElapsedMs(tStart));
+
+        if(collectStepStats(renderer,stats))
+        {   stats.numUpdates++;   }
+
+        collectUpdateStats(renderer,stats);
+    }
+
+    double totalMs=0;
+    for(size_t i=0; i < stats.listStepMs.size(); i++)
+    {   totalMs += stats.listStepMs[i];   }
+
+    double totalSecs = (initMs+totalMs)/1000.0;
+    size_t objectsAdded = initStats.objectsAdded+stats.objectsAdded;
+    size_t pointsAdded = initStats.pointsAdded+stats.pointsAdded;
+
+    if(!tracePath.empty() && !renderer.WriteTraceFile(tracePath))
+    {   fprintf(stderr,"WARN: could not write trace %s\n",tracePath.c_str());   }
+
+    NullSceneStats sceneStats;
+    renderer.GetSceneStats(sceneStats);
+    size_t sceneObjects = sceneStats.numNodes + sceneStats.numWays +
+                          sceneStats.numAreas + sceneStats.numRelAreas;
+
+    json_object_set_new(jRun,"initMs",json_real(initMs));
+    json_object_set_new(jRun,"initObjects",json_integer(initStats.objectsAdded));
+    json_object_set_new(jRun,"initPoints",json_integer(initStats.pointsAdded));
+    json_object_set_new(jRun,"steps",json_integer(params.numSteps));
+    json_object_set_new(jRun,"updates",json_integer(stats.numUpdates));
+    json_object_set_new(jRun,"stepsMs",json_real(totalMs));
+    json_object_set_new(jRun,"stepMeanMs",json_real(totalMs/params.numSteps));
+    json_object_set_new(jRun,"stepMedianMs",json_real(calcPercentile(stats.listStepMs,0.5)));
+    json_object_set_new(jRun,"stepP95Ms",json_real(calcPercentile(stats.listStepMs,0.95)));
+    json_object_set_new(jRun,"stepMaxMs",json_real(calcPercentile(stats.listStepMs,1.0)));
+    json_object_set_new(jRun,"objectsAdded",json_integer(stats.objectsAdded));
+    json_object_set_new(jRun,"objectsRemoved",json_integer(stats.objectsRemoved));
+    json_object_set_new(jRun,"objectsRestyled",json_integer(stats.objectsRestyled));
+    json_object_set_new(jRun,"objectsShown",json_integer(stats.objectsShown));
+    json_object_set_new(jRun,"objectsHidden",json_integer(stats.objectsHidden));
+    json_object_set_new(jRun,"pointsAdded",json_integer(stats.pointsAdded));
+    json_object_set_new(jRun,"objectsPerSec",json_real(objectsAdded/totalSecs));
+    json_object_set_new(jRun,"pointsPerSec",json_real(pointsAdded/totalSecs));
+    json_object_set_new(jRun,"sceneObjects",json_integer(sceneObjects));
+    json_object_set_new(jRun,"backendCalls",json_integer(sceneStats.numCalls));
+    json_object_set_new(jRun,"backendErrors",json_integer(sceneStats.numErrors));
+    json_object_set_new(jRun,"peakMemoryKb",json_integer(getPeakMemoryKb()));
+
+    // where the time in the steps went
+    json_t * jPhases = json_object();
+    json_object_set_new(jPhases,"viewExtentsMs",json_real(stats.viewExtentsMs));
+    json_object_set_new(jPhases,"queryMs",json_real(stats.queryMs));
+    json_object_set_new(jPhases,"filterMs",json_real(stats.filterMs));
+    json_object_set_new(jPhases,"diffMs",json_real(stats.diffMs));
+    json_object_set_new(jPhases,"genMs",json_real(stats.genMs));
+    json_object_set_new(jPhases,"commitMs",json_real(stats.commitMs));
+    json_object_set_new(jPhases,"backendMs",json_real(stats.backendMs));
+    json_object_set_new(jPhases,"doneUpdatingMs",json_real(stats.doneMs));
+    json_object_set_new(jRun,"phases",jPhases);
+    json_object_set_new(jRun,"memory",makeMemoryJson(renderer));
+
+    // after everything else so it isn't counted
+    if(renderer.GetIncrementalSceneUpdates())   {
+        size_t numDiffs = checkFullRebuild(renderer,dataSet);
+        json_object_set_new(jRun,"fullRebuildDiffs",json_integer(numDiffs));
+    }
+
+    return jRun;
+}
+
+// ========================================================================== //
+// ========================================================================== //
+
+// micro benchmarks are short enough that the first run
+// is skewed by page faults and caches warming up, so each
+// is run a few times and the fastest times are kept
+#define MICRO_BENCH_RUNS 3
+
+static json_t * runMicroBenchmarks()
+{
+    json_t * jMicro = json_object();
+
+    // [id maps]
+    std::vector<osmscout::Id> listIds;
+    GenBenchIds(200000,listIds);
+
+    // IdMap replaced TYPE_UNORDERED_MAP, which is either of
+    // the unordered maps depending on USE_BOOST, so it's
+    // compared with both when boost is available
+    std::vector<MapBenchResult> listMapResults;
+    std::vector<char const *> listMapNames;
+    listMapNames.push_back("IdMap");
+    listMapNames.push_back("unordered_map");
+#ifdef USE_BOOST
+    listMapNames.push_back("boost_unordered_map");
+#endif
+    listMapResults.resize(listMapNames.size());
+
+    for(size_t i=0; i < MICRO_BENCH_RUNS; i++)   {
+        std::vector<MapBenchResult> listRunResults(listMapNames.size());
+        size_t m=0;
+        BenchIdMap<IdMap<size_t> >(listIds,listRunResults[m++]);
+        BenchIdMap<std::unordered_map<osmscout::Id,size_t> >(listIds,listRunResults[m++]);
+#ifdef USE_BOOST
+        BenchIdMap<boost::unordered_map<osmscout::Id,size_t> >(listIds,listRunResults[m++]);
+#endif
+        for(m=0; m < listMapResults.size(); m++)   {
+            if(i == 0)   {   listMapResults[m] = listRunResults[m];   }
+            else         {   listMapResults[m].KeepFastest(listRunResults[m]);   }
+        }
+    }
+
+    json_t * jMaps = json_object();
+    json_object_set_new(jMaps,"numIds",json_integer(listIds.size()));
+    for(size_t i=0; i < listMapResults.size(); i++)   {
+        json_t * jMap = json_object();
+        json_object_set_new(jMap,"insertMs",json_real(listMapResults[i].insertMs));
+        json_object_set_new(jMap,"findMs",json_real(listMapResults[i].findMs));
+        json_object_set_new(jMap,"iterateMs",json_real(listMapResults[i].iterateMs));
+        json_object_set_new(jMap,"eraseMs",json_real(listMapResults[i].eraseMs));
+        json_object_set_new(jMap,"checksum",json_integer(listMapResults[i].checksum));
+        json_object_set_new(jMaps,listMapNames[i],jMap);
+    }
+    json_object_set_new(jMicro,"idMaps",jMaps);
+
+    // [shared nodes]
+    std::vector<BenchWay> listWays;
+    GenBenchGrid(400,listWays);
+
+    SharedNodeBenchResult indexResult,multimapResult;
+    for(size_t i=0; i < MICRO_BENCH_RUNS; i++)   {
+        SharedNodeBenchResult result;
+        BenchSharedNodeIndex(listWays,result);
+        if(i == 0)   {   indexResult = result;   }
+        else         {   indexResult.KeepFastest(result);   }
+
+        BenchSharedNodeMultimap(listWays,result);
+        if(i == 0)   {   multimapResult = result;   }
+        else         {   multimapResult.KeepFastest(result);   }
+    }
+
+    SharedNodeBenchResult const * listNodeResults[] = {&indexResult,&multimapResult};
+    char const * listNodeNames[] = {"SharedNodeIndex","unordered_multimap"};
+
+    json_t * jNodes = json_object();
+    json_object_set_new(jNodes,"numWays",json_integer(listWays.size()));
+    for(size_t i=0; i < 2; i++)   {
+        json_t * jIndex = json_object();
+        json_object_set_new(jIndex,"addMs",json_real(listNodeResults[i]->addMs));
+        json_object_set_new(jIndex,"lookupMs",json_real(listNodeResults[i]->lookupMs));
+        json_object_set_new(jIndex,"removeMs",json_real(listNodeResults[i]->removeMs));
+        json_object_set_new(jIndex,"numXSecs",json_integer(listNodeResults[i]->numXSecs));
+        json_object_set_new(jNodes,listNodeNames[i],jIndex);
+    }
+    json_object_set_new(jMicro,"sharedNodes",jNodes);
+
+    return jMicro;
+}
+
+// ========================================================================== //
+// ========================================================================== //
+
+// precision check bounds; the largest errors seen with
+// gcc and glibc were 1 ulp (sin/cos), 3E-9m (ecef),
+// 3E-14deg (lat/lon) and 6E-7m (alt, which goes through
+// p/cos(lat) and so is worst near the poles), the
+// bounds leave a margin for other compilers and libms
+#define PRECISION_SINCOS_BOUND      (4*DBL_EPSILON)
+#define PRECISION_ECEF_BOUND_M      1E-8
+#define PRECISION_LATLON_BOUND_DEG  1E-12
+#define PRECISION_ALT_BOUND_M       1E-5
+
+#define PRECISION_NUM_SAMPLES       1000001
+
+static json_t * makePrecisionJson(PrecisionResult const &result)
+{
+    json_t * jCheck = json_object();
+    json_object_set_new(jCheck,"maxError",json_real(result.maxError));
+    json_object_set_new(jCheck,"bound",json_real(result.bound));
+    json_object_set_new(jCheck,"pass",result.Passed() ? json_true() : json_false());
+    return jCheck;
+}
+
+static json_t * runPrecisionChecks(bool &passed)
+{
+    json_t * jPrecision = json_object();
+    json_object_set_new(jPrecision,"numSamples",json_integer(PRECISION_NUM_SAMPLES));
+    passed = true;
+
+#if defined(__SSE2__)
+    PrecisionResult sinCosResult(PRECISION_SINCOS_BOUND);
+    CheckSinCos2(PRECISION_NUM_SAMPLES,sinCosResult);
+    json_object_set_new(jPrecision,"sinCos2",makePrecisionJson(sinCosResult));
+    passed = passed && sinCosResult.Passed();
+#endif
+
+    std::vector<PointLLA> listPointLLA;
+    GenPrecisionPoints(PRECISION_NUM_SAMPLES,listPointLLA);
+    ConvRenderer renderer;
+
+    PrecisionResult ecefResult(PRECISION_ECEF_BOUND_M);
+    CheckLLAToECEF(renderer,listPointLLA,ecefResult);
+    json_object_set_new(jPrecision,"llaToEcefM",makePrecisionJson(ecefResult));
+    passed = passed && ecefResult.Passed();
+
+    PrecisionResult latLonResult(PRECISION_LATLON_BOUND_DEG);
+    PrecisionResult altResult(PRECISION_ALT_BOUND_M);
+    CheckECEFToLLA(renderer,listPointLLA,latLonResult,altResult);
+    json_object_set_new(jPrecision,"ecefToLatLonDeg",makePrecisionJson(latLonResult));
+    json_object_set_new(jPrecision,"ecefToAltM",makePrecisionJson(altResult));
+    passed = passed && latLonResult.Passed() && altResult.Passed();
+
+    return jPrecision;
+}
+
+// writeResults
+// * writes jRoot to outPath, or stdout if it's empty,
+//   and releases it
+static bool writeResults(json_t * jRoot, std::string const &outPath)
+{
+    size_t flags = JSON_INDENT(2) | JSON_PRESERVE_ORDER;
+    int result = 0;
+    if(outPath.empty())   {
+        result = json_dumpf(jRoot,stdout,flags);
+        fprintf(stdout,"\n");
+    }
+    else   {
+        result = json_dump_file(jRoot,outPath.c_str(),flags);
+    }
+    json_decref(jRoot);
+
+    if(result != 0)   {
+        fprintf(stderr,"ERROR: Could not write results\n");
+        return false;
+    }
+    return true;
+}
+
+// ========================================================================== //
+// ========================================================================== //
+
+int main(int argc, char *argv[])
+{
+    // the log is written to std::cout by default, which would
+    // end up in the results when they're written to stdout
+    osmsrender::Logger::Get().SetSink(&std::cerr);
+
+    BenchParams params;
+    if(!parseArgs(argc,argv,params))   {
+        writeUsage();
+        return 1;
+    }
+
+    // [precision]
+    if(params.runPrecision)   {
+        json_t * jRoot = json_object();
+        bool passed = false;
+        json_object_set_new(jRoot,"precision",runPrecisionChecks(passed));
+        if(!writeResults(jRoot,params.outPath) || !passed)
+        {   return 1;   }
+        return 0;
+    }
+
+    std::vector<std::string> listStyleFiles;
+    if(!getStyleFiles(params.styleDir,listStyleFiles) || listStyleFiles.empty())   {
+        fprintf(stderr,"ERROR: No styles found in %s\n",params.styleDir.c_str());
+        return 1;
+    }
+
+    osmscout::TypeConfig typeConfig;
+    if(!osmscout::LoadTypeConfig(params.typeConfigPath.c_str(),typeConfig))   {
+        fprintf(stderr,"ERROR: Could not load type config %s\n",
+                params.typeConfigPath.c_str());
+        return 1;
+    }
+
+    // [city]
+    DataSetTemp dataSet(&typeConfig);
+    CityStats cityStats;
+
+    std::chrono::steady_clock::time_point tStart =
+            std::chrono::steady_clock::now();
+    BuildSyntheticCity(dataSet,typeConfig,params.city,cityStats);
+    double cityMs = calcElapsedMs(tStart);
+
+    json_t * jRoot = json_object();
+    json_t * jCity = json_object();
+    json_object_set_new(jCity,"gridSize",json_integer(params.city.gridSize));
+    json_object_set_new(jCity,"blockSize",json_real(params.city.blockSize));
+    json_object_set_new(jCity,"nodes",json_integer(cityStats.numNodes));
+    json_object_set_new(jCity,"ways",json_integer(cityStats.numWays));
+    json_object_set_new(jCity,"areas",json_integer(cityStats.numAreas));
+    json_object_set_new(jCity,"wayPoints",json_integer(cityStats.numWayPoints));
+    json_object_set_new(jCity,"areaPoints",json_integer(cityStats.numAreaPoints));
+    json_object_set_new(jCity,"buildMs",json_real(cityMs));
+    json_object_set_new(jRoot,"city",jCity);
+    json_object_set_new(jRoot,"steps",json_integer(params.numSteps));
+    json_object_set_new(jRoot,"cameraAlt",json_real(params.camAlt));
+
+    // [runs]
+    json_t * jRuns = json_array();
+    bool rebuildsMatched = true;
+    for(size_t s=0; s < listStyleFiles.size(); s++)   {
+        std::string stylePath = params.styleDir + "/" + listStyleFiles[s];
+        for(size_t p=0; p < sizeof(g_listPaths)/sizeof(PathInfo); p++)   {
+            for(size_t c=0; c < sizeof(g_listConfigs)/sizeof(RunConfig); c++)
+            {
+                fprintf(stderr,"INFO: %s %s %s\n",listStyleFiles[s].c_str(),
+                        g_listPaths[p].name,g_listConfigs[c].name);
+
+                bool isFirstRun = (s == 0 && p == 0 && c == 0);
+                json_t * jRun = runCameraPath(dataSet,stylePath,g_listPaths[p],
+                                              g_listConfigs[c],params,
+                                              isFirstRun ? params.tracePath : "");
+
+                json_object_set_new(jRun,"style",json_string(listStyleFiles[s].c_str()));
+                json_object_set_new(jRun,"path",json_string(g_listPaths[p].name));
+                json_object_set_new(jRun,"config",json_string(g_listConfigs[c].name));
+
+                json_t * jDiffs = json_object_get(jRun,"fullRebuildDiffs");
+                if(jDiffs && json_integer_value(jDiffs) != 0)   {
+                    fprintf(stderr,"ERROR: %s %s %s scene differs from a full rebuild\n",
+                            listStyleFiles[s].c_str(),g_listPaths[p].name,
+                            g_listConfigs[c].name);
+                    rebuildsMatched = false;
+                }
+                json_array_append_new(jRuns,jRun);
+            }
+        }
+    }
+    json_object_set_new(jRoot,"runs",jRuns);
+
+    if(params.runMicro)
+    {   json_object_set_new(jRoot,"micro",runMicroBenchmarks());   }
+
+    json_object_set_new(jRoot,"peakMemoryKb",json_integer(getPeakMemoryKb()));
+
+    // [output]
+    if(!writeResults(jRoot,params.outPath) || !rebuildsMatched)
+    {   return 1;   }
+    return 0;
+}
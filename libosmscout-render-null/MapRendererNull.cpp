@@ -0,0 +1,632 @@
+/*
+    libosmscout-render
+
+    Copyright (C) 2012, Preet Desai
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "MapRendererNull.h"
+
+namespace osmsrender
+{
+
+MapRendererNull::MapRendererNull() :
+    m_nextGeomId(1),
+    m_retainGeometry(true),
+    m_recordCalls(false)
+{}
+
+MapRendererNull::~MapRendererNull()
+{}
+
+void MapRendererNull::ShowPlanetSurface()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    endCall("ShowPlanetSurface",tStart,0,0);
+}
+
+void MapRendererNull::HidePlanetSurface()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    endCall("HidePlanetSurface",tStart,0,0);
+}
+
+void MapRendererNull::ShowPlanetCoastlines()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    endCall("ShowPlanetCoastlines",tStart,0,0);
+}
+
+void MapRendererNull::HidePlanetCoastlines()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    endCall("HidePlanetCoastlines",tStart,0,0);
+}
+
+void MapRendererNull::ShowPlanetAdmin0()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    endCall("ShowPlanetAdmin0",tStart,0,0);
+}
+
+void MapRendererNull::HidePlanetAdmin0()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    endCall("HidePlanetAdmin0",tStart,0,0);
+}
+
+void MapRendererNull::SetRetainGeometry(bool enable)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_retainGeometry = enable;
+}
+
+bool MapRendererNull::GetRetainGeometry()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_retainGeometry;
+}
+
+void MapRendererNull::SetCallRecording(bool enable)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(enable && !m_recordCalls)   {
+        m_listCallRecords.clear();
+        m_recordStart = std::chrono::steady_clock::now();
+    }
+    m_recordCalls = enable;
+}
+
+bool MapRendererNull::GetCallRecording()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_recordCalls;
+}
+
+bool MapRendererNull::SetCallLogFile(std::string const &path)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(m_callLogFile.is_open())
+    {   m_callLogFile.close();   }
+
+    if(path.empty())
+    {   return true;   }
+
+    m_callLogFile.open(path.c_str(),std::ios::out | std::ios::trunc);
+    if(!m_callLogFile.is_open())   {
+        OSRWARN << "Could not open call log file " << path;
+        return false;
+    }
+    return true;
+}
+
+void MapRendererNull::GetCallLog(std::vector<NullCallRecord> &listRecords)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    listRecords = m_listCallRecords;
+}
+
+void MapRendererNull::ClearCallLog()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_listCallRecords.clear();
+}
+
+void MapRendererNull::GetSceneStats(NullSceneStats &stats)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    stats = m_sceneStats;
+    stats.numNodes = m_mapNodeGeom.size();
+    stats.numWays = m_mapWayGeom.size();
+    stats.numAreas = m_mapAreaGeom.size();
+    stats.numRelAreas = m_mapRelAreaGeom.size();
+}
+
+// ========================================================================== //
+// ========================================================================== //
+
+void MapRendererNull::rebuildStyleData(std::vector<DataSet const *> const &listDataSets)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    endCall("rebuildStyleData",tStart,listDataSets.size(),0);
+}
+
+void MapRendererNull::addNodeToScene(NodeRenderData &nodeData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    addGeom(m_mapNodeGeom,nodeData.geomPtr);
+    endCall("addNodeToScene",tStart,1,calcNumPoints(nodeData));
+}
+
+void MapRendererNull::addWayToScene(WayRenderData &wayData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    addGeom(m_mapWayGeom,wayData.geomPtr);
+    endCall("addWayToScene",tStart,1,calcNumPoints(wayData));
+}
+
+void MapRendererNull::addAreaToScene(AreaRenderData &areaData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    addGeom(m_mapAreaGeom,areaData.geomPtr);
+    endCall("addAreaToScene",tStart,1,calcNumPoints(areaData));
+}
+
+void MapRendererNull::addRelAreaToScene(RelAreaRenderData &relAreaData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    addGeom(m_mapRelAreaGeom,relAreaData.geomPtr);
+    endCall("addRelAreaToScene",tStart,1,calcNumPoints(relAreaData));
+}
+
+void MapRendererNull::doneUpdatingWays()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    endCall("doneUpdatingWays",tStart,0,0);
+}
+
+void MapRendererNull::doneUpdatingAreas()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    endCall("doneUpdatingAreas",tStart,0,0);
+}
+
+void MapRendererNull::doneUpdatingRelAreas()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    endCall("doneUpdatingRelAreas",tStart,0,0);
+}
+
+void MapRendererNull::removeNodeFromScene(NodeRenderData const &nodeData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    removeGeom(m_mapNodeGeom,nodeData.geomPtr);
+    endCall("removeNodeFromScene",tStart,1,0);
+}
+
+void MapRendererNull::removeWayFromScene(WayRenderData const &wayData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    removeGeom(m_mapWayGeom,wayData.geomPtr);
+    endCall("removeWayFromScene",tStart,1,0);
+}
+
+void MapRendererNull::removeAreaFromScene(AreaRenderData const &areaData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    removeGeom(m_mapAreaGeom,areaData.geomPtr);
+    endCall("removeAreaFromScene",tStart,1,0);
+}
+
+void MapRendererNull::removeRelAreaFromScene(RelAreaRenderData const &relAreaData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    removeGeom(m_mapRelAreaGeom,relAreaData.geomPtr);
+    endCall("removeRelAreaFromScene",tStart,1,0);
+}
+
+// ========================================================================== //
+// ========================================================================== //
+
+void MapRendererNull::addNodesToScene(std::vector<NodeRenderData> &listNodeData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+
+    size_t numPoints=0;
+    for(size_t i=0; i < listNodeData.size(); i++)   {
+        addGeom(m_mapNodeGeom,listNodeData[i].geomPtr);
+        numPoints += calcNumPoints(listNodeData[i]);
+    }
+    endCall("addNodesToScene",tStart,listNodeData.size(),numPoints);
+}
+
+void MapRendererNull::addWaysToScene(std::vector<WayRenderData> &listWayData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+
+    size_t numPoints=0;
+    for(size_t i=0; i < listWayData.size(); i++)   {
+        addGeom(m_mapWayGeom,listWayData[i].geomPtr);
+        numPoints += calcNumPoints(listWayData[i]);
+    }
+    endCall("addWaysToScene",tStart,listWayData.size(),numPoints);
+}
+
+void MapRendererNull::addAreasToScene(std::vector<AreaRenderData> &listAreaData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+
+    size_t numPoints=0;
+    for(size_t i=0; i < listAreaData.size(); i++)   {
+        addGeom(m_mapAreaGeom,listAreaData[i].geomPtr);
+        numPoints += calcNumPoints(listAreaData[i]);
+    }
+    endCall("addAreasToScene",tStart,listAreaData.size(),numPoints);
+}
+
+void MapRendererNull::addRelAreasToScene(std::vector<RelAreaRenderData> &listRelAreaData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+
+    size_t numPoints=0;
+    for(size_t i=0; i < listRelAreaData.size(); i++)   {
+        addGeom(m_mapRelAreaGeom,listRelAreaData[i].geomPtr);
+        numPoints += calcNumPoints(listRelAreaData[i]);
+    }
+    endCall("addRelAreasToScene",tStart,listRelAreaData.size(),numPoints);
+}
+
+void MapRendererNull::removeNodesFromScene(std::vector<NodeRenderData> const &listNodeData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+
+    for(size_t i=0; i < listNodeData.size(); i++)
+    {   removeGeom(m_mapNodeGeom,listNodeData[i].geomPtr);   }
+
+    endCall("removeNodesFromScene",tStart,listNodeData.size(),0);
+}
+
+void MapRendererNull::removeWaysFromScene(std::vector<WayRenderData> const &listWayData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+
+    for(size_t i=0; i < listWayData.size(); i++)
+    {   removeGeom(m_mapWayGeom,listWayData[i].geomPtr);   }
+
+    endCall("removeWaysFromScene",tStart,listWayData.size(),0);
+}
+
+void MapRendererNull::removeAreasFromScene(std::vector<AreaRenderData> const &listAreaData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+
+    for(size_t i=0; i < listAreaData.size(); i++)
+    {   removeGeom(m_mapAreaGeom,listAreaData[i].geomPtr);   }
+
+    endCall("removeAreasFromScene",tStart,listAreaData.size(),0);
+}
+
+void MapRendererNull::removeRelAreasFromScene(std::vector<RelAreaRenderData> const &listRelAreaData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+
+    for(size_t i=0; i < listRelAreaData.size(); i++)
+    {   removeGeom(m_mapRelAreaGeom,listRelAreaData[i].geomPtr);   }
+
+    endCall("removeRelAreasFromScene",tStart,listRelAreaData.size(),0);
+}
+
+// ========================================================================== //
+// ========================================================================== //
+
+bool MapRendererNull::hideNodeInScene(NodeRenderData &nodeData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    bool isHidden = m_retainGeometry && hideGeom(m_mapNodeGeom,nodeData.geomPtr);
+    endCall("hideNodeInScene",tStart,1,0);
+    return isHidden;
+}
+
+bool MapRendererNull::hideWayInScene(WayRenderData &wayData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    bool isHidden = m_retainGeometry && hideGeom(m_mapWayGeom,wayData.geomPtr);
+    endCall("hideWayInScene",tStart,1,0);
+    return isHidden;
+}
+
+bool MapRendererNull::hideAreaInScene(AreaRenderData &areaData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    bool isHidden = m_retainGeometry && hideGeom(m_mapAreaGeom,areaData.geomPtr);
+    endCall("hideAreaInScene",tStart,1,0);
+    return isHidden;
+}
+
+bool MapRendererNull::hideRelAreaInScene(RelAreaRenderData &relAreaData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    bool isHidden = m_retainGeometry && hideGeom(m_mapRelAreaGeom,relAreaData.geomPtr);
+    endCall("hideRelAreaInScene",tStart,1,0);
+    return isHidden;
+}
+
+void MapRendererNull::showNodeInScene(NodeRenderData &nodeData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    showGeom(m_mapNodeGeom,nodeData.geomPtr);
+    endCall("showNodeInScene",tStart,1,0);
+}
+
+void MapRendererNull::showWayInScene(WayRenderData &wayData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    showGeom(m_mapWayGeom,wayData.geomPtr);
+    endCall("showWayInScene",tStart,1,0);
+}
+
+void MapRendererNull::showAreaInScene(AreaRenderData &areaData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    showGeom(m_mapAreaGeom,areaData.geomPtr);
+    endCall("showAreaInScene",tStart,1,0);
+}
+
+void MapRendererNull::showRelAreaInScene(RelAreaRenderData &relAreaData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    showGeom(m_mapRelAreaGeom,relAreaData.geomPtr);
+    endCall("showRelAreaInScene",tStart,1,0);
+}
+
+// restyle[]InScene
+// * the restyled object keeps its old geomPtr; if the
+//   old one isn't in the scene, the object is added
+//   again instead
+
+bool MapRendererNull::restyleNodeInScene(NodeRenderData const &oldData,
+                                         NodeRenderData &newData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    bool restyled = m_retainGeometry && m_mapNodeGeom.count(oldData.geomPtr);
+    if(restyled)
+    {   newData.geomPtr = oldData.geomPtr;   }
+
+    endCall("restyleNodeInScene",tStart,1,calcNumPoints(newData));
+    return restyled;
+}
+
+bool MapRendererNull::restyleWayInScene(WayRenderData const &oldData,
+                                        WayRenderData &newData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    bool restyled = m_retainGeometry && m_mapWayGeom.count(oldData.geomPtr);
+    if(restyled)
+    {   newData.geomPtr = oldData.geomPtr;   }
+
+    endCall("restyleWayInScene",tStart,1,calcNumPoints(newData));
+    return restyled;
+}
+
+bool MapRendererNull::restyleAreaInScene(AreaRenderData const &oldData,
+                                         AreaRenderData &newData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    bool restyled = m_retainGeometry && m_mapAreaGeom.count(oldData.geomPtr);
+    if(restyled)
+    {   newData.geomPtr = oldData.geomPtr;   }
+
+    endCall("restyleAreaInScene",tStart,1,calcNumPoints(newData));
+    return restyled;
+}
+
+bool MapRendererNull::restyleRelAreaInScene(RelAreaRenderData const &oldData,
+                                            RelAreaRenderData &newData)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    bool restyled = m_retainGeometry && m_mapRelAreaGeom.count(oldData.geomPtr);
+    if(restyled)
+    {   newData.geomPtr = oldData.geomPtr;   }
+
+    endCall("restyleRelAreaInScene",tStart,1,calcNumPoints(newData));
+    return restyled;
+}
+
+void MapRendererNull::calcBackendMemoryUsage(ObjectMemoryUsage &objUsage,
+                                             std::vector<BackendMemoryUsage> &listUsage)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    objUsage.nodes.Add(m_mapNodeGeom.size(),calcGeomMapSize(m_mapNodeGeom));
+    objUsage.ways.Add(m_mapWayGeom.size(),calcGeomMapSize(m_mapWayGeom));
+    objUsage.areas.Add(m_mapAreaGeom.size(),calcGeomMapSize(m_mapAreaGeom));
+    objUsage.relAreas.Add(m_mapRelAreaGeom.size(),calcGeomMapSize(m_mapRelAreaGeom));
+
+    listUsage.push_back(BackendMemoryUsage("nodeGeom",objUsage.nodes));
+    listUsage.push_back(BackendMemoryUsage("wayGeom",objUsage.ways));
+    listUsage.push_back(BackendMemoryUsage("areaGeom",objUsage.areas));
+    listUsage.push_back(BackendMemoryUsage("relAreaGeom",objUsage.relAreas));
+
+    MemoryUsage callLog;
+    callLog.Add(m_listCallRecords.size(),
+                m_listCallRecords.capacity()*sizeof(NullCallRecord));
+
+    listUsage.push_back(BackendMemoryUsage("callLog",callLog));
+}
+
+// ========================================================================== //
+// ========================================================================== //
+
+void MapRendererNull::toggleSceneVisibility(bool)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    endCall("toggleSceneVisibility",tStart,0,0);
+}
+
+void MapRendererNull::removeAllFromScene()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+
+    size_t numObjects = m_mapNodeGeom.size() + m_mapWayGeom.size() +
+                        m_mapAreaGeom.size() + m_mapRelAreaGeom.size();
+
+    m_mapNodeGeom.clear();
+    m_mapWayGeom.clear();
+    m_mapAreaGeom.clear();
+    m_mapRelAreaGeom.clear();
+    m_sceneStats.numHidden = 0;
+
+    endCall("removeAllFromScene",tStart,numObjects,0);
+}
+
+void MapRendererNull::showCameraViewArea(Camera &)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::chrono::steady_clock::time_point tStart = beginCall();
+    endCall("showCameraViewArea",tStart,0,0);
+}
+
+// ========================================================================== //
+// ========================================================================== //
+
+void MapRendererNull::addGeom(NullGeomMap &mapGeom, void * &geomPtr)
+{
+    // geom ids are never reused, so a stale geomPtr
+    // can't be mistaken for a newer object's
+    geomPtr = reinterpret_cast<void*>(m_nextGeomId);
+    m_nextGeomId++;
+
+    mapGeom.insert(std::make_pair(geomPtr,false));
+}
+
+bool MapRendererNull::removeGeom(NullGeomMap &mapGeom, void const *geomPtr)
+{
+    NullGeomMap::iterator it = mapGeom.find(geomPtr);
+    if(it == mapGeom.end())   {
+        m_sceneStats.numErrors++;
+        return false;
+    }
+
+    if(it->second)
+    {   m_sceneStats.numHidden--;   }
+
+    mapGeom.erase(it);
+    return true;
+}
+
+bool MapRendererNull::hideGeom(NullGeomMap &mapGeom, void const *geomPtr)
+{
+    NullGeomMap::iterator it = mapGeom.find(geomPtr);
+    if(it == mapGeom.end() || it->second)   {
+        m_sceneStats.numErrors++;
+        return false;
+    }
+
+    it->second = true;
+    m_sceneStats.numHidden++;
+    return true;
+}
+
+bool MapRendererNull::showGeom(NullGeomMap &mapGeom, void const *geomPtr)
+{
+    NullGeomMap::iterator it = mapGeom.find(geomPtr);
+    if(it == mapGeom.end() || !it->second)   {
+        m_sceneStats.numErrors++;
+        return false;
+    }
+
+    it->second = false;
+    m_sceneStats.numHidden--;
+    return true;
+}
+
+std::chrono::steady_clock::time_point MapRendererNull::beginCall()
+{
+    m_sceneStats.numCalls++;
+    return std::chrono::steady_clock::now();
+}
+
+void MapRendererNull::endCall(char const *call,
+                              std::chrono::steady_clock::time_point const &tStart,
+                              size_t numObjects, size_t numPoints)
+{
+    if(!m_recordCalls)
+    {   return;   }
+
+    std::chrono::steady_clock::time_point tEnd =
+            std::chrono::steady_clock::now();
+
+    NullCallRecord record;
+    record.call = call;
+    record.numObjects = numObjects;
+    record.numPoints = numPoints;
+    record.startMs = std::chrono::duration<double,std::milli>(tStart-m_recordStart).count();
+    record.durationMs = std::chrono::duration<double,std::milli>(tEnd-tStart).count();
+    m_listCallRecords.push_back(record);
+
+    if(m_callLogFile.is_open())   {
+        m_callLogFile << record.call << "\t"
+                      << record.numObjects << "\t"
+                      << record.numPoints << "\t"
+                      << record.startMs << "\t"
+                      << record.durationMs << "\n";
+    }
+}
+
+size_t MapRendererNull::calcNumPoints(NodeRenderData const &)
+{   return 1;   }
+
+size_t MapRendererNull::calcNumPoints(WayRenderData const &wayData)
+{   return wayData.wayPoints.GetNumPoints();   }
+
+size_t MapRendererNull::calcNumPoints(AreaRenderData const &areaData)
+{   return areaData.areaPoints.GetNumPoints();   }
+
+size_t MapRendererNull::calcNumPoints(RelAreaRenderData const &relAreaData)
+{
+    size_t numPoints=0;
+    for(size_t i=0; i < relAreaData.listAreaData.size(); i++)
+    {   numPoints += calcNumPoints(relAreaData.listAreaData[i]);   }
+
+    return numPoints;
+}
+
+size_t MapRendererNull::calcGeomMapSize(NullGeomMap const &mapGeom)
+{
+    return mapGeom.bucket_count()*sizeof(void*) +
+           mapGeom.size()*(sizeof(NullGeomMap::value_type)+sizeof(void*));
+}
+
+}
@@ -0,0 +1,247 @@
+/*
+    This source is a part of libosmscout-render
+
+    Copyright (C) 2012, Preet Desai
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef OSMSCOUT_MAP_RENDERER_NULL_H
+#define OSMSCOUT_MAP_RENDERER_NULL_H
+
+// system
+#include <string>
+#include <vector>
+#include <fstream>
+#include <mutex>
+#include <chrono>
+
+// libosmscout-render
+#include <libosmscout-render/MapRenderer.h>
+
+namespace osmsrender
+{
+
+// NullCallRecord
+// * a single call MapRenderer made to the backend
+// * numObjects is the number of objects passed in the
+//   call and numPoints the number of points in them
+// * startMs is when the call was made (relative to when
+//   recording was enabled) and durationMs how long it took
+struct NullCallRecord
+{
+    NullCallRecord() :
+        call(NULL),numObjects(0),numPoints(0),
+        startMs(0),durationMs(0)
+    {}
+
+    char const *    call;
+    size_t          numObjects;
+    size_t          numPoints;
+    double          startMs;
+    double          durationMs;
+};
+
+// NullSceneStats
+// * objects of each type in the scene, including
+//   hidden objects (numHidden of all types)
+// * numCalls counts calls to the backend (whether
+//   or not they were recorded)
+// * numErrors counts calls that didn't make sense for
+//   the scene's contents, like removing an object that
+//   was never added or showing one that isn't hidden
+struct NullSceneStats
+{
+    NullSceneStats() :
+        numNodes(0),numWays(0),numAreas(0),numRelAreas(0),
+        numHidden(0),numCalls(0),numErrors(0)
+    {}
+
+    size_t numNodes;
+    size_t numWays;
+    size_t numAreas;
+    size_t numRelAreas;
+    size_t numHidden;
+    size_t numCalls;
+    size_t numErrors;
+};
+
+// geomPtr -> whether the object is hidden
+typedef TYPE_UNORDERED_MAP<void const *,bool> NullGeomMap;
+
+// ========================================================================== //
+// ========================================================================== //
+
+// MapRendererNull
+// * a backend that doesn't draw anything, so MapRenderer's
+//   queries, scene diffs and render data generation can be
+//   run (and benchmarked) without a graphics context
+// * every object added to the scene gets a unique geomPtr
+//   so removes, hides and shows can be checked against
+//   what's actually in the scene (see NullSceneStats)
+
+class MapRendererNull : public MapRenderer
+{
+public:
+    MapRendererNull();
+    ~MapRendererNull();
+
+    void ShowPlanetSurface();
+    void HidePlanetSurface();
+
+    void ShowPlanetCoastlines();
+    void HidePlanetCoastlines();
+
+    void ShowPlanetAdmin0();
+    void HidePlanetAdmin0();
+
+    // SetRetainGeometry
+    // * when enabled, objects are hidden instead of being
+    //   removed when their render data goes into the cache
+    //   and keep their geometry when they're restyled, as
+    //   with a backend that supports both; otherwise the
+    //   backend behaves like one that doesn't
+    // * enabled by default
+    void SetRetainGeometry(bool enable);
+    bool GetRetainGeometry();
+
+    // SetCallRecording
+    // * when enabled, each call MapRenderer makes to the
+    //   backend is added to the call log (see GetCallLog)
+    // * enabling recording clears the call log and
+    //   restarts its clock
+    // * disabled by default
+    void SetCallRecording(bool enable);
+    bool GetCallRecording();
+
+    // SetCallLogFile
+    // * also writes each recorded call to the file at
+    //   path as a line of tab separated values: call,
+    //   numObjects, numPoints, startMs, durationMs
+    // * an empty path closes the current file
+    // * returns false if the file couldn't be opened
+    bool SetCallLogFile(std::string const &path);
+
+    // GetCallLog
+    void GetCallLog(std::vector<NullCallRecord> &listRecords);
+    void ClearCallLog();
+
+    // GetSceneStats
+    void GetSceneStats(NullSceneStats &stats);
+
+private:
+    void rebuildStyleData(std::vector<DataSet const *> const &listDataSets);
+
+    void addNodeToScene(NodeRenderData &nodeData);
+    void addWayToScene(WayRenderData &wayData);
+    void addAreaToScene(AreaRenderData &areaData);
+    void addRelAreaToScene(RelAreaRenderData &relAreaData);
+
+    void doneUpdatingWays();
+    void doneUpdatingAreas();
+    void doneUpdatingRelAreas();
+
+    void removeNodeFromScene(NodeRenderData const &nodeData);
+    void removeWayFromScene(WayRenderData const &wayData);
+    void removeAreaFromScene(AreaRenderData const &areaData);
+    void removeRelAreaFromScene(RelAreaRenderData const &relAreaData);
+
+    void addNodesToScene(std::vector<NodeRenderData> &listNodeData);
+    void addWaysToScene(std::vector<WayRenderData> &listWayData);
+    void addAreasToScene(std::vector<AreaRenderData> &listAreaData);
+    void addRelAreasToScene(std::vector<RelAreaRenderData> &listRelAreaData);
+
+    void removeNodesFromScene(std::vector<NodeRenderData> const &listNodeData);
+    void removeWaysFromScene(std::vector<WayRenderData> const &listWayData);
+    void removeAreasFromScene(std::vector<AreaRenderData> const &listAreaData);
+    void removeRelAreasFromScene(std::vector<RelAreaRenderData> const &listRelAreaData);
+
+    bool hideNodeInScene(NodeRenderData &nodeData);
+    bool hideWayInScene(WayRenderData &wayData);
+    bool hideAreaInScene(AreaRenderData &areaData);
+    bool hideRelAreaInScene(RelAreaRenderData &relAreaData);
+
+    void showNodeInScene(NodeRenderData &nodeData);
+    void showWayInScene(WayRenderData &wayData);
+    void showAreaInScene(AreaRenderData &areaData);
+    void showRelAreaInScene(RelAreaRenderData &relAreaData);
+
+    bool restyleNodeInScene(NodeRenderData const &oldData,
+                            NodeRenderData &newData);
+    bool restyleWayInScene(WayRenderData const &oldData,
+                           WayRenderData &newData);
+    bool restyleAreaInScene(AreaRenderData const &oldData,
+                            AreaRenderData &newData);
+    bool restyleRelAreaInScene(RelAreaRenderData const &oldData,
+                               RelAreaRenderData &newData);
+
+    void calcBackendMemoryUsage(ObjectMemoryUsage &objUsage,
+                                std::vector<BackendMemoryUsage> &listUsage);
+
+    void toggleSceneVisibility(bool isVisible);
+    void removeAllFromScene();
+
+    void showCameraViewArea(Camera &sceneCam);
+
+    // addGeom,removeGeom,hideGeom,showGeom
+    // * track an object's geomPtr in mapGeom; addGeom
+    //   sets a new geomPtr, the others return false (and
+    //   count an error) if the object isn't in the
+    //   expected state
+    void addGeom(NullGeomMap &mapGeom, void * &geomPtr);
+    bool removeGeom(NullGeomMap &mapGeom, void const *geomPtr);
+    bool hideGeom(NullGeomMap &mapGeom, void const *geomPtr);
+    bool showGeom(NullGeomMap &mapGeom, void const *geomPtr);
+
+    // beginCall,endCall
+    // * time a call to the backend and record it
+    //   in the call log if recording is enabled
+    std::chrono::steady_clock::time_point beginCall();
+    void endCall(char const *call,
+                 std::chrono::steady_clock::time_point const &tStart,
+                 size_t numObjects, size_t numPoints);
+
+    static size_t calcNumPoints(NodeRenderData const &nodeData);
+    static size_t calcNumPoints(WayRenderData const &wayData);
+    static size_t calcNumPoints(AreaRenderData const &areaData);
+    static size_t calcNumPoints(RelAreaRenderData const &relAreaData);
+
+    // calcGeomMapSize
+    // * estimates the memory used by mapGeom's buckets
+    //   and entries (an entry is a node on the heap)
+    static size_t calcGeomMapSize(NullGeomMap const &mapGeom);
+
+    // guards everything below; the scene may be
+    // modified while another thread reads the log
+    std::mutex m_mutex;
+
+    NullGeomMap m_mapNodeGeom;
+    NullGeomMap m_mapWayGeom;
+    NullGeomMap m_mapAreaGeom;
+    NullGeomMap m_mapRelAreaGeom;
+    size_t      m_nextGeomId;
+    NullSceneStats m_sceneStats;
+
+    bool m_retainGeometry;
+
+    bool m_recordCalls;
+    std::chrono::steady_clock::time_point m_recordStart;
+    std::vector<NullCallRecord> m_listCallRecords;
+    std::ofstream m_callLogFile;
+};
+
+}
+
+#endif
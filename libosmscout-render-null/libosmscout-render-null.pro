@@ -0,0 +1,22 @@
+TEMPLATE = lib
+TARGET = osmscoutrendernull
+CONFIG += debug staticlib thread
+QMAKE_CXXFLAGS += -std=c++11
+
+HEADERS += MapRendererNull.h
+SOURCES += MapRendererNull.cpp
+
+#boost
+USE_BOOST   {
+   DEFINES += USE_BOOST
+   INCLUDEPATH += /home/preet/Dev/env/sys/boost-1.50
+}
+
+#libosmscout-render
+INCLUDEPATH += ..
+INCLUDEPATH += ../libosmscout-render
+LIBS += -L../libosmscout-render -losmscoutrender
+
+#libosmscout
+INCLUDEPATH += /home/preet/Dev/env/sys/libosmscout/include
+LIBS += -L/home/preet/Dev/env/sys/libosmscout/lib -losmscout
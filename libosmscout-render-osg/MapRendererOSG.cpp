@@ -25,6 +25,101 @@ namespace osmsrender
 
 std::vector<GLdouble*> MapRendererOSG::m_tListNewVx(0);     // for tessellator
 
+// calcMapSize
+// * estimates the memory used by an unordered map's
+//   buckets and entries (an entry is a node on the heap)
+template <typename MapType>
+static size_t calcMapSize(MapType const &map)
+{
+    return map.bucket_count()*sizeof(void*) +
+           map.size()*(sizeof(typename MapType::value_type)+sizeof(void*));
+}
+
+// calcGeoMapSize
+// * the map and each area's vertex attributes
+static size_t calcGeoMapSize(IdGeoMap const &mapGeo)
+{
+    size_t numBytes = calcMapSize(mapGeo);
+
+    IdGeoMap::const_iterator it;
+    for(it = mapGeo.begin(); it != mapGeo.end(); ++it)   {
+        VxAttributes const &vxAttr = it->second;
+        numBytes += vxAttr.listVx.valid() ? vxAttr.listVx->getTotalDataSize() : 0;
+        numBytes += vxAttr.listNx.valid() ? vxAttr.listNx->getTotalDataSize() : 0;
+        numBytes += vxAttr.listCx.valid() ? vxAttr.listCx->getTotalDataSize() : 0;
+    }
+    return numBytes;
+}
+
+// calcGeoMapNumVx
+static size_t calcGeoMapNumVx(IdGeoMap const &mapGeo)
+{
+    size_t numVx = 0;
+
+    IdGeoMap::const_iterator it;
+    for(it = mapGeo.begin(); it != mapGeo.end(); ++it)   {
+        if(it->second.listVx.valid())
+        {   numVx += it->second.listVx->size();   }
+    }
+    return numVx;
+}
+
+// calcLabelPosSize
+// * memory a label position points to
+static size_t calcLabelPosSize(LabelPos const &labelPos)
+{   return labelPos.name.capacity();   }
+
+static size_t calcLabelPosSize(WayLabelPos const &labelPos)
+{
+    return labelPos.name.capacity() +
+           labelPos.listCenters.capacity()*sizeof(Vec3);
+}
+
+static size_t calcLabelPosSize(ContourLabelPos const &labelPos)
+{
+    size_t numBytes = labelPos.listCenters.capacity()*sizeof(Vec3) +
+            labelPos.listSwitchNodes.capacity()*sizeof(osg::Switch*);
+
+    for(size_t i=0; i < labelPos.listPolylines.size(); i++)   {
+        numBytes += sizeof(std::vector<Vec3>) +
+                labelPos.listPolylines[i].capacity()*sizeof(Vec3);
+    }
+    return numBytes;
+}
+
+// calcLabelPosMapSize
+// * the map and the label positions in it
+template <typename MapType>
+static size_t calcLabelPosMapSize(MapType const &mapLabelPos)
+{
+    size_t numBytes = calcMapSize(mapLabelPos);
+
+    typename MapType::const_iterator it;
+    for(it = mapLabelPos.begin(); it != mapLabelPos.end(); ++it)
+    {   numBytes += calcLabelPosSize(it->second);   }
+
+    return numBytes;
+}
+
+// addMergedUsage
+// * splits a merged area geode between areas and
+//   relation areas by their share of its source
+//   vertices in mapAreaGeo and mapRelAreaGeo
+static void addMergedUsage(size_t numBytes,
+                           IdGeoMap const &mapAreaGeo,
+                           IdGeoMap const &mapRelAreaGeo,
+                           ObjectMemoryUsage &objUsage)
+{
+    size_t numAreaVx = calcGeoMapNumVx(mapAreaGeo);
+    size_t numRelAreaVx = calcGeoMapNumVx(mapRelAreaGeo);
+    if(numAreaVx+numRelAreaVx == 0)
+    {   return;   }
+
+    size_t numAreaBytes = double(numBytes)*numAreaVx/(numAreaVx+numRelAreaVx);
+    objUsage.areas.Add(0,numAreaBytes);
+    objUsage.relAreas.Add(0,numBytes-numAreaBytes);
+}
+
 MapRendererOSG::MapRendererOSG(osgViewer::Viewer *myViewer,
                                std::string const &pathShaders,
                                std::string const &pathFonts,
@@ -220,10 +315,10 @@ void MapRendererOSG::rebuildStyleData(std::vector<DataSet const *> const &listDa
     m_fontGeoMap.clear();
     m_fontGeoMap.reserve(listFonts.size());
 
-    OSRDEBUG << "INFO: Font Types Found: ";
+    OSRINFO << "Font Types Found: ";
     for(size_t i=0; i < listFonts.size(); i++)
     {
-        OSRDEBUG << "INFO:   " << listFonts[i];
+        OSRINFO << "  " << listFonts[i];
 
         CharGeoMap fontChars;
         fontChars.reserve(100);
@@ -442,6 +537,11 @@ void MapRendererOSG::removeNodeFromScene(const NodeRenderData &nodeData)
     m_nodeNodes->removeChild(nodeNode->get());
     delete nodeNode;
 
+    // a hidden node's label position data was
+    // moved out of the label position map
+    if(m_hiddenNodeLabelPosMap.erase(nodeData.geomPtr) > 0)
+    {   return;   }
+
     // remove node label position data
     LabelPosMap::iterator posIt =
         m_nodeLabelPosMap.find(nodeData.nodeRef->GetId());
@@ -450,6 +550,43 @@ void MapRendererOSG::removeNodeFromScene(const NodeRenderData &nodeData)
     {   m_nodeLabelPosMap.erase(posIt);   }
 }
 
+bool MapRendererOSG::hideNodeInScene(NodeRenderData &nodeData)
+{
+    osg::ref_ptr<osg::Node> * nodeNode =
+            reinterpret_cast<osg::ref_ptr<osg::Node>*>(nodeData.geomPtr);
+
+    // the ref_ptr in geomPtr keeps the node alive
+    m_nodeNodes->removeChild(nodeNode->get());
+
+    // stash label position data
+    LabelPosMap::iterator posIt =
+        m_nodeLabelPosMap.find(nodeData.nodeRef->GetId());
+
+    if(posIt != m_nodeLabelPosMap.end())   {
+        m_hiddenNodeLabelPosMap[nodeData.geomPtr] = posIt->second;
+        m_nodeLabelPosMap.erase(posIt);
+    }
+
+    return true;
+}
+
+void MapRendererOSG::showNodeInScene(NodeRenderData &nodeData)
+{
+    osg::ref_ptr<osg::Node> * nodeNode =
+            reinterpret_cast<osg::ref_ptr<osg::Node>*>(nodeData.geomPtr);
+
+    m_nodeNodes->addChild(nodeNode->get());
+
+    // restore label position data
+    TYPE_UNORDERED_MAP<void*,LabelPos>::iterator posIt =
+            m_hiddenNodeLabelPosMap.find(nodeData.geomPtr);
+
+    if(posIt != m_hiddenNodeLabelPosMap.end())   {
+        m_nodeLabelPosMap[nodeData.nodeRef->GetId()] = posIt->second;
+        m_hiddenNodeLabelPosMap.erase(posIt);
+    }
+}
+
 // ========================================================================== //
 // ========================================================================== //
 
@@ -458,9 +595,8 @@ void MapRendererOSG::addWayToScene(WayRenderData &wayData)
     // the geometry needs to be parented with a matrix
     // transform node to implement a floating origin offset;
     // we arbitrarily use the first way point for the offset
-    osg::Vec3d offsetVec(wayData.listWayPoints[0].x,
-                         wayData.listWayPoints[0].y,
-                         wayData.listWayPoints[0].z);
+    osg::Vec3d offsetVec =
+            convVec3ToOsgVec3d(wayData.wayPoints.GetPoint(0));
 
     osg::ref_ptr<osg::MatrixTransform> nodeTransform = new osg::MatrixTransform;
     nodeTransform->setMatrix(osg::Matrix::translate(offsetVec));
@@ -488,8 +624,8 @@ void MapRendererOSG::addWayToScene(WayRenderData &wayData)
     (*nodeRefPtr) = nodeTransform;
     wayData.geomPtr = nodeRefPtr;
 
-    //    OSRDEBUG << "INFO: Added Way "
-    //             << wayData.wayRef->GetId() << " to Scene Graph";
+    //    OSRINFO << "Added Way "
+    //           << wayData.wayRef->GetId() << " to Scene Graph";
 }
 
 void MapRendererOSG::removeWayFromScene(WayRenderData const &wayData)
@@ -501,6 +637,15 @@ void MapRendererOSG::removeWayFromScene(WayRenderData const &wayData)
     m_nodeWays->removeChild(wayNode->get());
     delete wayNode;
 
+    // a hidden way's label position info was
+    // moved out of the label position maps
+    size_t numHidden =
+            m_hiddenContourLabelPosMap.erase(wayData.geomPtr) +
+            m_hiddenWayLabelPosMap.erase(wayData.geomPtr);
+
+    if(numHidden > 0)
+    {   return;   }
+
     // remove contour label position info
     ContourLabelPosMap::iterator cIt =
         m_contourLabelPosMap.find(wayData.wayRef->GetId());
@@ -515,8 +660,61 @@ void MapRendererOSG::removeWayFromScene(WayRenderData const &wayData)
     if(wIt != m_wayLabelPosMap.end())
     {   m_wayLabelPosMap.erase(wIt);   }
 
-    //    OSRDEBUG << "INFO: Removed Way "
-    //             << wayData.wayRef->GetId() << " from Scene Graph";
+    //    OSRINFO << "Removed Way "
+    //           << wayData.wayRef->GetId() << " from Scene Graph";
+}
+
+bool MapRendererOSG::hideWayInScene(WayRenderData &wayData)
+{
+    osg::ref_ptr<osg::Node> * wayNode =
+            reinterpret_cast<osg::ref_ptr<osg::Node>*>(wayData.geomPtr);
+
+    // the ref_ptr in geomPtr keeps the node alive
+    m_nodeWays->removeChild(wayNode->get());
+
+    // stash label position info
+    ContourLabelPosMap::iterator cIt =
+        m_contourLabelPosMap.find(wayData.wayRef->GetId());
+
+    if(cIt != m_contourLabelPosMap.end())   {
+        m_hiddenContourLabelPosMap[wayData.geomPtr] = cIt->second;
+        m_contourLabelPosMap.erase(cIt);
+    }
+
+    WayLabelPosMap::iterator wIt =
+            m_wayLabelPosMap.find(wayData.wayRef->GetId());
+
+    if(wIt != m_wayLabelPosMap.end())   {
+        m_hiddenWayLabelPosMap[wayData.geomPtr] = wIt->second;
+        m_wayLabelPosMap.erase(wIt);
+    }
+
+    return true;
+}
+
+void MapRendererOSG::showWayInScene(WayRenderData &wayData)
+{
+    osg::ref_ptr<osg::Node> * wayNode =
+            reinterpret_cast<osg::ref_ptr<osg::Node>*>(wayData.geomPtr);
+
+    m_nodeWays->addChild(wayNode->get());
+
+    // restore label position info
+    TYPE_UNORDERED_MAP<void*,ContourLabelPos>::iterator cIt =
+            m_hiddenContourLabelPosMap.find(wayData.geomPtr);
+
+    if(cIt != m_hiddenContourLabelPosMap.end())   {
+        m_contourLabelPosMap[wayData.wayRef->GetId()] = cIt->second;
+        m_hiddenContourLabelPosMap.erase(cIt);
+    }
+
+    TYPE_UNORDERED_MAP<void*,WayLabelPos>::iterator wIt =
+            m_hiddenWayLabelPosMap.find(wayData.geomPtr);
+
+    if(wIt != m_hiddenWayLabelPosMap.end())   {
+        m_wayLabelPosMap[wayData.wayRef->GetId()] = wIt->second;
+        m_hiddenWayLabelPosMap.erase(wIt);
+    }
 }
 
 void MapRendererOSG::doneUpdatingWays()
@@ -889,6 +1087,151 @@ void MapRendererOSG::removeAllFromScene()
 //    m_nodeEarth->removeChildren(0,m_nodeEarth->getNumChildren());
     m_nodeWays->removeChildren(0,m_nodeWays->getNumChildren());
     m_nodeNodes->removeChildren(0,m_nodeNodes->getNumChildren());
+
+    m_hiddenContourLabelPosMap.clear();
+    m_hiddenWayLabelPosMap.clear();
+    m_hiddenNodeLabelPosMap.clear();
+}
+
+void MapRendererOSG::calcBackendMemoryUsage(ObjectMemoryUsage &objUsage,
+                                            std::vector<BackendMemoryUsage> &listUsage)
+{
+    // a single visitor is used for all of the scene's
+    // geometry so nothing shared is counted twice; font
+    // glyphs go first since contour labels share them
+    GeometrySizeVisitor sizeVisitor;
+    MemoryUsage usage;
+
+    FontGeoMap::const_iterator fIt;
+    for(fIt = m_fontGeoMap.begin(); fIt != m_fontGeoMap.end(); ++fIt)   {
+        usage.Add(0,calcMapSize(fIt->second));
+
+        CharGeoMap::const_iterator cIt;
+        for(cIt = fIt->second.begin(); cIt != fIt->second.end(); ++cIt)   {
+            usage.Add(1,cIt->first.capacity() +
+                      sizeVisitor.AddDrawable(cIt->second.get()));
+        }
+    }
+    usage.Add(0,calcMapSize(m_fontGeoMap));
+    listUsage.push_back(BackendMemoryUsage("fontGeoMap",usage));
+
+    // [planet]
+    usage = MemoryUsage();
+    m_nodeEarth->accept(sizeVisitor);
+    usage.Add(m_nodeEarth->getNumChildren(),sizeVisitor.GetNumBytes());
+    listUsage.push_back(BackendMemoryUsage("nodeEarth",usage));
+
+    // [nodes] (with their labels)
+    size_t numBytes = sizeVisitor.GetNumBytes();
+    m_nodeNodes->accept(sizeVisitor);
+
+    usage = MemoryUsage();
+    usage.Add(m_nodeNodes->getNumChildren(),sizeVisitor.GetNumBytes()-numBytes);
+    objUsage.nodes.Add(usage);
+    listUsage.push_back(BackendMemoryUsage("nodeNodes",usage));
+
+    // [ways] (with their labels)
+    numBytes = sizeVisitor.GetNumBytes();
+    m_nodeWays->accept(sizeVisitor);
+
+    usage = MemoryUsage();
+    usage.Add(m_nodeWays->getNumChildren(),sizeVisitor.GetNumBytes()-numBytes);
+    objUsage.ways.Add(usage);
+    listUsage.push_back(BackendMemoryUsage("nodeWays",usage));
+
+    // [areas]
+    usage = MemoryUsage();
+    usage.Add(m_mapDsAreaGeo.size(),calcGeoMapSize(m_mapDsAreaGeo));
+    objUsage.areas.Add(usage);
+    listUsage.push_back(BackendMemoryUsage("mapDsAreaGeo",usage));
+
+    usage = MemoryUsage();
+    usage.Add(m_mapLyAreaGeo.size(),calcGeoMapSize(m_mapLyAreaGeo));
+    objUsage.areas.Add(usage);
+    listUsage.push_back(BackendMemoryUsage("mapLyAreaGeo",usage));
+
+    usage = MemoryUsage();
+    usage.Add(m_mapDsRelAreaGeo.size(),calcGeoMapSize(m_mapDsRelAreaGeo));
+    objUsage.relAreas.Add(usage);
+    listUsage.push_back(BackendMemoryUsage("mapDsRelAreaGeo",usage));
+
+    usage = MemoryUsage();
+    usage.Add(m_mapLyRelAreaGeo.size(),calcGeoMapSize(m_mapLyRelAreaGeo));
+    objUsage.relAreas.Add(usage);
+    listUsage.push_back(BackendMemoryUsage("mapLyRelAreaGeo",usage));
+
+    // the merged vertex buffers hold a copy of
+    // each area's vertex attributes
+    numBytes = sizeVisitor.GetNumBytes();
+    m_geodeDsAreas->accept(sizeVisitor);
+
+    usage = MemoryUsage();
+    usage.Add(0,sizeVisitor.GetNumBytes()-numBytes);
+    addMergedUsage(usage.numBytes,m_mapDsAreaGeo,m_mapDsRelAreaGeo,objUsage);
+    listUsage.push_back(BackendMemoryUsage("geodeDsAreas",usage));
+
+    numBytes = sizeVisitor.GetNumBytes();
+    m_geodeLyAreas->accept(sizeVisitor);
+
+    usage = MemoryUsage();
+    usage.Add(0,sizeVisitor.GetNumBytes()-numBytes);
+    addMergedUsage(usage.numBytes,m_mapLyAreaGeo,m_mapLyRelAreaGeo,objUsage);
+    listUsage.push_back(BackendMemoryUsage("geodeLyAreas",usage));
+
+    // area labels are kept together for
+    // both areas and relation areas
+    numBytes = sizeVisitor.GetNumBytes();
+    m_nodeAreaLabels->accept(sizeVisitor);
+
+    usage = MemoryUsage();
+    usage.Add(m_listAreaLabels.size(),calcMapSize(m_listAreaLabels) +
+              sizeVisitor.GetNumBytes()-numBytes);
+    objUsage.areas.Add(0,usage.numBytes);
+    listUsage.push_back(BackendMemoryUsage("nodeAreaLabels",usage));
+
+    numBytes = sizeVisitor.GetNumBytes();
+    m_geodeAreaWireframes->accept(sizeVisitor);
+
+    usage = MemoryUsage();
+    usage.Add(m_mapAreaWireframes.size(),calcMapSize(m_mapAreaWireframes) +
+              sizeVisitor.GetNumBytes()-numBytes);
+
+    IdLineGeoMap::const_iterator wfIt;
+    for(wfIt = m_mapAreaWireframes.begin();
+        wfIt != m_mapAreaWireframes.end(); ++wfIt)   {
+        usage.Add(0,wfIt->second.listVx.capacity()*sizeof(Vec3) +
+                  wfIt->second.listIx.capacity()*sizeof(size_t));
+    }
+    objUsage.areas.Add(0,usage.numBytes);
+    listUsage.push_back(BackendMemoryUsage("mapAreaWireframes",usage));
+
+    // [label positions] (including those of
+    // objects hidden in the scene)
+    usage = MemoryUsage();
+    usage.Add(m_nodeLabelPosMap.size()+m_hiddenNodeLabelPosMap.size(),
+              calcLabelPosMapSize(m_nodeLabelPosMap) +
+              calcLabelPosMapSize(m_hiddenNodeLabelPosMap));
+    objUsage.nodes.Add(0,usage.numBytes);
+    listUsage.push_back(BackendMemoryUsage("nodeLabelPosMap",usage));
+
+    usage = MemoryUsage();
+    usage.Add(m_wayLabelPosMap.size()+m_hiddenWayLabelPosMap.size(),
+              calcLabelPosMapSize(m_wayLabelPosMap) +
+              calcLabelPosMapSize(m_hiddenWayLabelPosMap));
+    objUsage.ways.Add(0,usage.numBytes);
+    listUsage.push_back(BackendMemoryUsage("wayLabelPosMap",usage));
+
+    usage = MemoryUsage();
+    usage.Add(m_contourLabelPosMap.size()+m_hiddenContourLabelPosMap.size(),
+              calcLabelPosMapSize(m_contourLabelPosMap) +
+              calcLabelPosMapSize(m_hiddenContourLabelPosMap));
+    objUsage.ways.Add(0,usage.numBytes);
+    listUsage.push_back(BackendMemoryUsage("contourLabelPosMap",usage));
+
+    usage = MemoryUsage();
+    usage.Add(m_areaLabelPosMap.size(),calcLabelPosMapSize(m_areaLabelPosMap));
+    objUsage.areas.Add(0,usage.numBytes);
+    listUsage.push_back(BackendMemoryUsage("areaLabelPosMap",usage));
 }
 
 // ========================================================================== //
@@ -973,7 +1316,7 @@ void MapRendererOSG::addEarthAdmin0Geometry(const ColorRGBA &admin0Color)
     for(size_t i=0; i < admin0Ix.size(); i++)
     {   listIx->push_back(admin0Ix[i]);   }
 
-    OSRDEBUG << "INFO: Admin0 Vx Count: " << listVx->size();
+    OSRINFO << "Admin0 Vx Count: " << listVx->size();
 
     // admin0 geometry
     osg::ref_ptr<osg::Geometry> gmAdmin0 = new osg::Geometry;
@@ -1041,7 +1384,7 @@ void MapRendererOSG::addEarthCoastlineGeometry(const ColorRGBA &coastColor)
     geomCoast->setVertexArray(listVx);
     geomCoast->addPrimitiveSet(listIx);
 
-    OSRDEBUG << "INFO: Coastline Vx Count: " << listVx->size();
+    OSRINFO << "Coastline Vx Count: " << listVx->size();
 
     // color uniform
     osg::Vec4 geomColor = this->colorAsVec4(coastColor);
@@ -1192,21 +1535,22 @@ void MapRendererOSG::addCoastlineGeometry(const WayRenderData &wayData,
 
     // TODO: this method is wasteful it can be improved
     // copy vertex data
-    gmCoastVx->resize(wayData.listWayPoints.size());
-    for(size_t i=0; i < wayData.listWayPoints.size(); i++)   {
-        osg::Vec3 vx = convVec3ToOsgVec3(wayData.listWayPoints[i]);
+    size_t numPts = wayData.wayPoints.GetNumPoints();
+    gmCoastVx->resize(numPts);
+    for(size_t i=0; i < numPts; i++)   {
+        osg::Vec3 vx = convVec3ToOsgVec3(wayData.wayPoints.GetPoint(i));
         gmCoastVx->at(i) = (vx-offsetVec);
     }
 
-    printVector(wayData.listWayPoints[0]);
-    printVector(wayData.listWayPoints[wayData.listWayPoints.size()-1]);
+    printVector(wayData.wayPoints.GetPoint(0));
+    printVector(wayData.wayPoints.GetPoint(numPts-1));
 
     //build up an index suitable for GL_LINES; individual line
     //segments are separated by interspersed zero vertices (0,0,0)
     bool newSegment = false;
-    for(size_t i=0; i < wayData.listWayPoints.size(); i++)
+    for(size_t i=0; i < numPts; i++)
     {
-        Vec3 const &vx = wayData.listWayPoints[i];
+        Vec3 vx = wayData.wayPoints.GetPoint(i);
         if((vx.x == 0) && (vx.y == 0) && (vx.z == 0))
         {   newSegment = true;  continue;   }
 
@@ -1292,7 +1636,7 @@ void MapRendererOSG::addWayGeometry(const WayRenderData &wayData,
     bool cleanOverlaps = (dashSpacing > 0) ||
         (wayData.lineRenderStyle->GetLineColor().A < 1.0);
 
-    this->buildPolylineAsTriStrip(wayData.listWayPoints,wayWidth,
+    this->buildPolylineAsTriStrip(wayData.wayPoints,0,wayWidth,
                                   wayVx,wayTx,wayLength,cleanOverlaps);
 
     osg::ref_ptr<osg::Vec3Array> listVx = new osg::Vec3Array(wayVx.size());
@@ -1351,7 +1695,7 @@ void MapRendererOSG::addWayGeometry(const WayRenderData &wayData,
     if(outlineWidth > 0)
     {
         double extWidth = wayWidth+outlineWidth;
-        this->buildPolylineAsTriStrip(wayData.listWayPoints,
+        this->buildPolylineAsTriStrip(wayData.wayPoints,0,
                                       extWidth,wayVx,wayTx,wayLength);
 
         osg::ref_ptr<osg::Vec3Array> listOLVx = new osg::Vec3Array(wayVx.size());
@@ -1403,7 +1747,7 @@ void MapRendererOSG::addWayGeometry(const WayRenderData &wayData,
         // to have a number of points determined by 'symbolSpacing' param
         // and placing a symbol with the correct xform on each point
         double symbolSpacing = wayData.lineRenderStyle->GetSymbolSpacing();
-        calcPolylineResample(wayData.listWayPoints,symbolSpacing,wayVx);
+        calcPolylineResample(wayData.wayPoints,0,symbolSpacing,wayVx);
 
         osg::ref_ptr<osg::Vec3Array> listDashVx = new osg::Vec3Array(wayVx.size());   // pos
         osg::ref_ptr<osg::Vec3Array> listDashDx = new osg::Vec3Array(wayVx.size());   // dirn
@@ -1475,8 +1819,7 @@ void MapRendererOSG::createAreaGeometry(const AreaRenderData &areaData,
     std::vector<Vec3> listRoofTriVx;
     std::vector<Vec3> listRoofTriNx;
     Vec3 tessNormal = areaData.centerPoint.Normalized();
-    this->triangulateContours(areaData.listOuterPoints,
-                              areaData.listListInnerPoints,
+    this->triangulateContours(areaData.areaPoints,
                               tessNormal,listRoofTriVx);
 
     if(!areaData.isBuilding)
@@ -1512,12 +1855,9 @@ void MapRendererOSG::createAreaGeometry(const AreaRenderData &areaData,
         std::vector<Vec3> listSideTriVx;
         std::vector<Vec3> listSideTriNx;
 
-        // outer sidewall
-        this->buildContourSideWalls(areaData.listOuterPoints,offsetHeight,
-                                    listSideTriVx,listSideTriNx);
-        // inner sidewalls
-        for(size_t i=0; i < areaData.listListInnerPoints.size(); i++)   {
-            this->buildContourSideWalls(areaData.listListInnerPoints[i],offsetHeight,
+        // outer and inner sidewalls
+        for(size_t i=0; i < areaData.areaPoints.GetNumRings(); i++)   {
+            this->buildContourSideWalls(areaData.areaPoints,i,offsetHeight,
                                         listSideTriVx,listSideTriNx);
         }
 
@@ -1563,20 +1903,10 @@ void MapRendererOSG::createAreaWireframe(const AreaRenderData &areaData,
         Vec3 surfNormal = areaData.centerPoint.Normalized();
         Vec3 offsetHeight = surfNormal.ScaledBy(areaData.buildingHeight);
 
-        // outer contour
-        buildContourWireframe(areaData.listOuterPoints,
-                              offsetHeight,listVx,listIx);
-
-        wireframe.listVx.insert(wireframe.listVx.end(),
-                                listVx.begin(),listVx.end());
-
-        wireframe.listIx.insert(wireframe.listIx.end(),
-                                listIx.begin(),listIx.end());
-
-        // inner contours
-        for(size_t i=0; i < areaData.listListInnerPoints.size(); i++)
+        // outer and inner contours
+        for(size_t i=0; i < areaData.areaPoints.GetNumRings(); i++)
         {
-            buildContourWireframe(areaData.listListInnerPoints[i],
+            buildContourWireframe(areaData.areaPoints,i,
                                   offsetHeight,listVx,listIx);
             // adjust indices
             size_t nContourVx = wireframe.listVx.size();
@@ -1600,6 +1930,7 @@ void MapRendererOSG::addNodeLabel(const NodeRenderData &nodeData,
                                   const osg::Vec3d &offsetVec,
                                   osg::MatrixTransform *nodeParent)
 {
+    OSRTRACE("addNodeLabel","label");
     osg::StateSet * ss;
     std::string labelText = nodeData.nameLabel;
     LabelStyle const *labelStyle = nodeData.nameLabelRenderStyle;
@@ -1719,6 +2050,7 @@ void MapRendererOSG::addWayLabel(const WayRenderData &wayData,
                                  const osg::Vec3d &offsetVec,
                                  osg::MatrixTransform *nodeParent)
 {
+    OSRTRACE("addWayLabel","label");
     osg::StateSet * ss;
     std::string labelText = wayData.nameLabel;
     LabelStyle const *labelStyle = wayData.nameLabelRenderStyle;
@@ -1761,7 +2093,7 @@ void MapRendererOSG::addWayLabel(const WayRenderData &wayData,
     if(wayPointDist == 0)
     {   // arbitrarily set the wayPointDist to be
         // the length of the way divided by 5
-        double wayLength = calcPolylineLength(wayData.listWayPoints);
+        double wayLength = calcPolylineLength(wayData.wayPoints,0);
         wayPointDist = wayLength/5;
     }
 
@@ -1784,7 +2116,7 @@ void MapRendererOSG::addWayLabel(const WayRenderData &wayData,
     // calculate the position vectors of each label
     // taking offsetDist into account
     std::vector<Vec3> listLabelVx;
-    calcPolylineResample(wayData.listWayPoints,wayPointDist,listLabelVx);
+    calcPolylineResample(wayData.wayPoints,0,wayPointDist,listLabelVx);
     for(size_t i=0; i < listLabelVx.size(); i++)   {
         Vec3 surfOffset = listLabelVx[i].Normalized().ScaledBy(offsetDist);
         listLabelVx[i] = listLabelVx[i]+surfOffset;
@@ -1819,6 +2151,7 @@ void MapRendererOSG::addAreaLabel(const AreaRenderData &areaData,
                                   const osg::Vec3d &offsetVec,
                                   osg::MatrixTransform *nodeParent)
 {
+    OSRTRACE("addAreaLabel","label");
     osg::StateSet * ss;
     std::string labelText = areaData.nameLabel;
     LabelStyle const *labelStyle = areaData.nameLabelRenderStyle;
@@ -1857,11 +2190,12 @@ void MapRendererOSG::addAreaLabel(const AreaRenderData &areaData,
     {
         // use the base bounding box dist along x,y or z
         // as a rough metric for setting max label width
-        double xMin = areaData.listOuterPoints[0].x; double xMax = xMin;
-        double yMin = areaData.listOuterPoints[0].y; double yMax = yMin;
-        double zMin = areaData.listOuterPoints[0].z; double zMax = zMin;
-        for(size_t i=1; i < areaData.listOuterPoints.size(); i++)   {
-            Vec3 const &areaPoint = areaData.listOuterPoints[i];
+        GeomBuffer const &areaPoints = areaData.areaPoints;
+        double xMin = areaPoints.listX[0]; double xMax = xMin;
+        double yMin = areaPoints.listY[0]; double yMax = yMin;
+        double zMin = areaPoints.listZ[0]; double zMax = zMin;
+        for(size_t i=1; i < areaPoints.GetRingSize(0); i++)   {
+            Vec3 areaPoint = areaPoints.GetPoint(i);
             xMin = std::min(xMin,areaPoint.x);
             xMax = std::max(xMax,areaPoint.x);
             yMin = std::min(yMin,areaPoint.y);
@@ -1929,6 +2263,7 @@ void MapRendererOSG::addContourLabel(const WayRenderData &wayData,
                                      const osg::Vec3d &offsetVec,
                                      osg::MatrixTransform *nodeParent)
 {
+    OSRTRACE("addContourLabel","label");
     std::string labelText = wayData.nameLabel;
     LabelStyle const * labelStyle = wayData.nameLabelRenderStyle;
     double fontSize = labelStyle->GetFontSize();
@@ -1970,7 +2305,7 @@ void MapRendererOSG::addContourLabel(const WayRenderData &wayData,
 
             fCharIt = fontCharsMap.insert(addChar).first;
 
-            OSRDEBUG << "INFO: Added char " << charStr
+            OSRDEBUG << "Added char " << charStr
                      << " for font " << labelStyle->GetFontFamily();
         }
 
@@ -2006,15 +2341,15 @@ void MapRendererOSG::addContourLabel(const WayRenderData &wayData,
 
     // [calc label params]
     std::vector<double> listSegLengths;
-    calcPolylineSegmentDist(wayData.listWayPoints,listSegLengths);
+    calcPolylineSegmentDist(wayData.wayPoints,0,listSegLengths);
     double baselineOffset = (maxCHeight-minCHeight)/2.0 - minCHeight;
     double labelLength = (nameLength + 2.0*labelPadding*nameLength);
     size_t numLabelsFit = listSegLengths.back()/labelLength;
 
     if(listSegLengths.back()/labelLength < 1.0)
     {   // check at least one label can fit within the way
-        // OSRDEBUG << "WARN: Label " << wayData.nameLabel
-        //          << " length exceeds wayLength";
+        // OSRWARN << "Label " << wayData.nameLabel
+        //        << " length exceeds wayLength";
         return;
     }
 
@@ -2030,9 +2365,9 @@ void MapRendererOSG::addContourLabel(const WayRenderData &wayData,
 
     // get way centerline as osg vecs
     osg::ref_ptr<osg::Vec3dArray> listWayPoints = new osg::Vec3dArray;
-    listWayPoints->resize(wayData.listWayPoints.size());
+    listWayPoints->resize(wayData.wayPoints.GetNumPoints());
     for(size_t i=0; i < listWayPoints->size(); i++)
-    {   listWayPoints->at(i) = convVec3ToOsgVec3d(wayData.listWayPoints[i]);   }
+    {   listWayPoints->at(i) = convVec3ToOsgVec3d(wayData.wayPoints.GetPoint(i));   }
 
     double labelSpace = listSegLengths.back();
     double labelOffset = labelPadding*nameLength;
@@ -2060,7 +2395,7 @@ void MapRendererOSG::addContourLabel(const WayRenderData &wayData,
 
         // [check for label intersections]
         std::vector<Vec3> listVxLabel; Vec3 midPoint;
-        calcPolylineTrimmed(wayData.listWayPoints,startLength,endLength,listVxLabel);
+        calcPolylineTrimmed(wayData.wayPoints,0,startLength,endLength,listVxLabel);
         calcPolylineVxAtDist(listVxLabel,(nameLength/2.0),midPoint);
 
         if(calcContourLabelOverlap(wayData.wayRef->GetId(),fontSize,
@@ -2220,6 +2555,8 @@ void MapRendererOSG::addDsAreaGeometries()
     if((!m_modDsAreas) && (!m_modDsRelAreas))
     {   return;   }
 
+    OSRTRACE("addDsAreaGeometries","backend");
+
     Camera const * myCamera = this->GetCamera();
     osg::Vec3d offsetVec(myCamera->eye.x,
                          myCamera->eye.y,
@@ -2394,6 +2731,8 @@ void MapRendererOSG::addLyAreaGeometries()
     if((!m_modLyAreas) && (!m_modLyRelAreas))
     {   return;   }
 
+    OSRTRACE("addLyAreaGeometries","backend");
+
     // remove all geometry from merged geode
     m_geodeLyAreas->removeDrawables(0,
         m_geodeLyAreas->getNumDrawables());
@@ -2869,11 +3208,12 @@ void MapRendererOSG::tessErrorCallback(GLenum errorCode)
 // ========================================================================== //
 // ========================================================================== //
 
-void MapRendererOSG::triangulateContours(const std::vector<Vec3> &outerContour,
-                                         const std::vector<std::vector<Vec3> > &innerContours,
+void MapRendererOSG::triangulateContours(GeomBuffer const &buff,
                                          Vec3 const &vecNormal,
                                          std::vector<Vec3> &listTriVx)
 {
+    OSRTRACE("triangulateContours","backend");
+
     // begin polygon and pass listTriVx as user data
     osg::gluTessBeginPolygon(m_tobj,&listTriVx);
     osg::gluTessNormal(m_tobj,vecNormal.x,vecNormal.y,vecNormal.z);
@@ -2881,44 +3221,20 @@ void MapRendererOSG::triangulateContours(const std::vector<Vec3> &outerContour,
     // note: need to keep the GLdouble arrays alive
     // for as long as we have gluTessEndPolygon
 
-    // total number of inner contour vertices
-    size_t innerVxCount = 0;
-    for(size_t i=0; i < innerContours.size(); i++)   {
-        innerVxCount += innerContours[i].size();
-    }
-
     // apparently arrays of size 0 are valid in C?
-    GLdouble outerVx[outerContour.size()][3];
-    GLdouble innerVx[innerVxCount][3];
-    size_t kIdx = 0;
-
-    // outer contour
-    osg::gluTessBeginContour(m_tobj);
-    for(size_t i=0; i < outerContour.size(); i++)
-    {
-        Vec3 const &myVx = outerContour[i];
-        outerVx[i][0] = myVx.x;
-        outerVx[i][1] = myVx.y;
-        outerVx[i][2] = myVx.z;
-        osg::gluTessVertex(m_tobj,outerVx[i],outerVx[i]);
-    }
-    osg::gluTessEndContour(m_tobj);
+    GLdouble listVx[buff.GetNumPoints()][3];
 
-    // inner contours
-    for(size_t i=0; i < innerContours.size(); i++)
+    // outer contour, then inner contours
+    for(size_t i=0; i < buff.GetNumRings(); i++)
     {
-        std::vector<Vec3> const &innerContour = innerContours[i];
-
         osg::gluTessBeginContour(m_tobj);
-        for(size_t j=0; j < innerContour.size(); j++)
+        size_t ringEnd = buff.GetRingBegin(i)+buff.GetRingSize(i);
+        for(size_t k=buff.GetRingBegin(i); k < ringEnd; k++)
         {
-            Vec3 const &myVx = innerContour[j];
-            innerVx[kIdx][0] = myVx.x;
-            innerVx[kIdx][1] = myVx.y;
-            innerVx[kIdx][2] = myVx.z;
-            osg::gluTessVertex(m_tobj,innerVx[kIdx],innerVx[kIdx]);
-
-            kIdx++;
+            listVx[k][0] = buff.listX[k];
+            listVx[k][1] = buff.listY[k];
+            listVx[k][2] = buff.listZ[k];
+            osg::gluTessVertex(m_tobj,listVx[k],listVx[k]);
         }
         osg::gluTessEndContour(m_tobj);
     }
@@ -3329,8 +3645,8 @@ void MapRendererOSG::endTiming()
     double timeTaken = 0;
     timeTaken += (m_t2.tv_sec - m_t1.tv_sec) * 1000.0 * 1000.0;
     timeTaken += (m_t2.tv_usec - m_t1.tv_usec);
-    OSRDEBUG << "INFO: " << m_timingDesc << ": \t\t"
-              << timeTaken << " microseconds";
+    OSRINFO << m_timingDesc << ": \t\t"
+            << timeTaken << " microseconds";
 }
 
 }
@@ -25,6 +25,7 @@
 #include <sys/time.h>
 #include <string>
 #include <sstream>
+#include <set>
 
 // osg
 #include <osg/ref_ptr>
@@ -142,6 +143,89 @@ private:
     osg::Camera const * m_cam;
 };
 
+// GeometrySizeVisitor
+// * adds up the memory used by the vertex attributes and
+//   index lists of the geometry under the nodes it visits;
+//   drawables and arrays are only counted the first time
+//   they're seen, so geometry shared between nodes (like
+//   node symbols) isn't counted again
+// * text is estimated from its characters since its
+//   glyph quads aren't accessible
+class GeometrySizeVisitor : public osg::NodeVisitor
+{
+public:
+    GeometrySizeVisitor() :
+        osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN),
+        m_numBytes(0)
+    {}
+
+    virtual void apply(osg::Geode &geode)
+    {
+        for(unsigned int i=0; i < geode.getNumDrawables(); i++)
+        {   AddDrawable(geode.getDrawable(i));   }
+
+        traverse(geode);
+    }
+
+    // AddDrawable
+    // * counts a drawable that isn't under a visited
+    //   node; returns the bytes added (if any)
+    size_t AddDrawable(osg::Drawable const *drawable)
+    {
+        if(drawable == NULL || !m_setSeen.insert(drawable).second)
+        {   return 0;   }
+
+        size_t numBytes = 0;
+        osg::Geometry const * geom = drawable->asGeometry();
+        osgText::Text const * text = dynamic_cast<osgText::Text const *>(drawable);
+
+        if(geom)   {
+            numBytes += sizeof(osg::Geometry);
+            numBytes += addArray(geom->getVertexArray());
+            numBytes += addArray(geom->getNormalArray());
+            numBytes += addArray(geom->getColorArray());
+            numBytes += addArray(geom->getSecondaryColorArray());
+            numBytes += addArray(geom->getFogCoordArray());
+
+            for(unsigned int i=0; i < geom->getNumTexCoordArrays(); i++)
+            {   numBytes += addArray(geom->getTexCoordArray(i));   }
+
+            for(unsigned int i=0; i < geom->getNumVertexAttribArrays(); i++)
+            {   numBytes += addArray(geom->getVertexAttribArray(i));   }
+
+            for(unsigned int i=0; i < geom->getNumPrimitiveSets(); i++)   {
+                osg::DrawElements const * drawElements =
+                        geom->getPrimitiveSet(i)->getDrawElements();
+
+                if(drawElements && m_setSeen.insert(drawElements).second)
+                {   numBytes += drawElements->getTotalDataSize();   }
+            }
+        }
+        else if(text)   {
+            numBytes += sizeof(osgText::Text) +
+                    text->getText().size()*sizeof(unsigned int);
+        }
+
+        m_numBytes += numBytes;
+        return numBytes;
+    }
+
+    size_t GetNumBytes() const
+    {   return m_numBytes;   }
+
+private:
+    size_t addArray(osg::Array const *array)
+    {
+        if(array == NULL || !m_setSeen.insert(array).second)
+        {   return 0;   }
+
+        return array->getTotalDataSize();
+    }
+
+    std::set<void const *> m_setSeen;
+    size_t m_numBytes;
+};
+
 class MapRendererOSG : public MapRenderer
 {
 public:
@@ -176,9 +260,13 @@ private:
 
     void addNodeToScene(NodeRenderData &nodeData);
     void removeNodeFromScene(const NodeRenderData &nodeData);
+    bool hideNodeInScene(NodeRenderData &nodeData);
+    void showNodeInScene(NodeRenderData &nodeData);
 
     void addWayToScene(WayRenderData &wayData);
     void removeAreaFromScene(AreaRenderData const &areaData);
+    bool hideWayInScene(WayRenderData &wayData);
+    void showWayInScene(WayRenderData &wayData);
     void doneUpdatingWays();
 
     void addAreaToScene(AreaRenderData &areaData);
@@ -194,6 +282,9 @@ private:
 
     void showCameraViewArea(Camera &sceneCam);
 
+    void calcBackendMemoryUsage(ObjectMemoryUsage &objUsage,
+                                std::vector<BackendMemoryUsage> &listUsage);
+
     void addEarthSurfaceGeometry(ColorRGBA const &surfColor);
     void addEarthCoastlineGeometry(ColorRGBA const &coastColor);
     void addEarthAdmin0Geometry(ColorRGBA const &admin0Color);
@@ -269,8 +360,7 @@ private:
     static void tessEndCallback();
     static void tessErrorCallback(GLenum errorCode);
 
-    void triangulateContours(std::vector<Vec3> const &outerContour,                 // const
-                             std::vector<std::vector<Vec3> > const &innerContours,
+    void triangulateContours(GeomBuffer const &buff,                // const
                              Vec3 const &vecNormal,
                              std::vector<Vec3> &listTriVx);
 
@@ -398,6 +488,13 @@ private:
     LabelPosMap         m_nodeLabelPosMap;
     LabelPosMap         m_areaLabelPosMap;
 
+    // label position data for hidden nodes and
+    // ways, keyed by their geomPtr; hidden objects
+    // shouldn't affect label placement
+    TYPE_UNORDERED_MAP<void*,ContourLabelPos>   m_hiddenContourLabelPosMap;
+    TYPE_UNORDERED_MAP<void*,WayLabelPos>       m_hiddenWayLabelPosMap;
+    TYPE_UNORDERED_MAP<void*,LabelPos>          m_hiddenNodeLabelPosMap;
+
     // layer defs <-> render bins
     unsigned int m_minLayer;
     unsigned int m_layerPlanetSurface;
@@ -1,6 +1,7 @@
 TEMPLATE = lib
 TARGET = osmscoutrenderosg
-CONFIG += debug staticlib
+CONFIG += debug staticlib thread
+QMAKE_CXXFLAGS += -std=c++11
 
 HEADERS += MapRendererOSG.h
 SOURCES += MapRendererOSG.cpp
@@ -2,6 +2,8 @@ TEMPLATE =  subdirs
 
 #SUBDIRS +=  libosmscout-render \
 #            libosmscout-render-osg \
+#            libosmscout-render-null \
+#            benchmark \
 #            mapviewer
 
 SUBDIRS += mapviewer
@@ -0,0 +1,81 @@
+/*
+    libosmscout-render
+
+    Copyright (C) 2012, Preet Desai
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef OSMSCOUTRENDER_COMPACTGEOMETRY_HPP
+#define OSMSCOUTRENDER_COMPACTGEOMETRY_HPP
+
+#include <vector>
+
+#include "Vec3.hpp"
+#include "GeomBuffer.hpp"
+
+namespace osmsrender
+{
+    // compact geometry stores an object's points as
+    // float offsets from a double precision origin
+    // close to the object (half the size of a GeomBuffer)
+
+    // absolute ECEF coordinates are ~6.4e6m so floats
+    // can't hold them to better than about half a meter,
+    // but offsets within an object are small enough that
+    // the error is on the order of millimeters, and the
+    // offsets are the same local coordinates a backend
+    // uses for vertex data anyway
+
+    // PackPoints
+    // * sets offsets to the points of buff relative
+    //   to origin, with the same rings and parts
+    inline void PackPoints(GeomBuffer const &buff,
+                           Vec3 const &origin,
+                           GeomBufferf &offsets)
+    {
+        size_t numPts = buff.GetNumPoints();
+        offsets.Clear();
+        offsets.Resize(numPts);
+        for(size_t i=0; i < numPts; i++)   {
+            offsets.listX[i] = float(buff.listX[i] - origin.x);
+            offsets.listY[i] = float(buff.listY[i] - origin.y);
+            offsets.listZ[i] = float(buff.listZ[i] - origin.z);
+        }
+        offsets.listRingEnds = buff.listRingEnds;
+        offsets.listPartEnds = buff.listPartEnds;
+    }
+
+    // UnpackPoints
+    // * sets buff to the absolute
+    //   position of each offset
+    inline void UnpackPoints(GeomBufferf const &offsets,
+                             Vec3 const &origin,
+                             GeomBuffer &buff)
+    {
+        size_t numPts = offsets.GetNumPoints();
+        buff.Clear();
+        buff.Resize(numPts);
+        for(size_t i=0; i < numPts; i++)   {
+            buff.listX[i] = origin.x + double(offsets.listX[i]);
+            buff.listY[i] = origin.y + double(offsets.listY[i]);
+            buff.listZ[i] = origin.z + double(offsets.listZ[i]);
+        }
+        buff.listRingEnds = offsets.listRingEnds;
+        buff.listPartEnds = offsets.listPartEnds;
+    }
+}
+
+#endif
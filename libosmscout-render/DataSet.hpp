@@ -9,7 +9,12 @@
 // osmscout-render includes
 #include "Vec2.hpp"
 #include "Vec3.hpp"
+#include "GeomBuffer.hpp"
+#include "CompactGeometry.hpp"
 #include "RenderStyleConfig.hpp"
+#include "IdMap.hpp"
+#include "IdDiff.hpp"
+#include "SharedNodeIndex.hpp"
 
 #ifdef USE_BOOST
     #include <boost/unordered_map.hpp>
@@ -81,12 +86,6 @@ struct Camera
     Vec3 exBL;
 };
 
-struct WayXSec
-{
-    osmscout::Id wayId;
-    bool isUsed;
-};
-
 //double nmod(double a,double b)
 //{   // modulo with proper negative
 //    // number support
@@ -128,9 +127,16 @@ struct WayRenderData
     // geometry data
     osmscout::WayRef        wayRef;
     size_t                  wayLayer;
-    std::vector<Vec3>       listWayPoints;
+    GeomBuffer              wayPoints;      // a single ring
 //    std::vector<bool>       listSharedNodes;
     LineStyle const*        lineRenderStyle;
+
+    // compact geometry (see SetCompactRenderData)
+    // * once the way is in the scene, wayPoints may
+    //   be moved into float offsets from wayOrigin (the
+    //   first point) and cleared
+    Vec3                    wayOrigin;
+    GeomBufferf             wayOffsets;
     bool                    isCoast;
 
     // label data
@@ -138,8 +144,9 @@ struct WayRenderData
     std::string                 nameLabel;
     LabelStyle const *          nameLabelRenderStyle;
 
-    //
-    std::vector<std::vector<WayXSec*> > listIntersections;
+    // other ways that share a node with this one,
+    // sorted by node (see OPT_TRACK_SHARED_NODES)
+    std::vector<WayXSec>    listIntersections;
 
     void *geomPtr;
 };
@@ -154,10 +161,16 @@ struct AreaRenderData
     Vec3                                centerPoint;
     bool                                pathIsCCW;
     size_t                              lod;
-    std::vector<Vec3>                   listOuterPoints;
-    std::vector<std::vector<Vec3> >     listListInnerPoints;
+    GeomBuffer                          areaPoints;     // outer ring, then
+                                                        // any inner rings
     FillStyle const*              fillRenderStyle;
 
+    // compact geometry (see SetCompactRenderData)
+    // * once the area is in the scene, its points may
+    //   be moved into float offsets from centerPoint
+    //   and cleared
+    GeomBufferf                         areaOffsets;
+
     bool                        isBuilding;
     double                      buildingHeight;
 
@@ -212,22 +225,22 @@ typedef std::vector<osmscout::GroundTile*>
 typedef std::pair<osmscout::NodeRef,size_t>                                     NodeRefAndLod;
 typedef std::pair<osmscout::WayRef,size_t>                                      WayRefAndLod;
 typedef std::pair<osmscout::RelationRef,size_t>                                 RelRefAndLod;
-typedef std::vector<TYPE_UNORDERED_MAP<osmscout::Id,NodeRenderData> >           ListNodeDataByLod;
-typedef std::vector<TYPE_UNORDERED_MAP<osmscout::Id,WayRenderData> >            ListWayDataByLod;
-typedef std::vector<TYPE_UNORDERED_MAP<osmscout::Id,AreaRenderData> >           ListAreaDataByLod;
-typedef std::vector<TYPE_UNORDERED_MAP<osmscout::Id,RelWayRenderData> >         ListRelWayDataByLod;
-typedef std::vector<TYPE_UNORDERED_MAP<osmscout::Id,RelAreaRenderData> >        ListRelAreaDataByLod;
-typedef std::vector<TYPE_UNORDERED_MAP<osmscout::Id,osmscout::NodeRef> >        ListNodeRefsByLod;
-typedef std::vector<TYPE_UNORDERED_MAP<osmscout::Id,osmscout::WayRef> >         ListWayRefsByLod;
-typedef std::vector<TYPE_UNORDERED_MAP<osmscout::Id,osmscout::WayRef> >         ListAreaRefsByLod;
-typedef std::vector<TYPE_UNORDERED_MAP<osmscout::Id,osmscout::RelationRef> >    ListRelWayRefsByLod;
-typedef std::vector<TYPE_UNORDERED_MAP<osmscout::Id,osmscout::RelationRef> >    ListRelAreaRefsByLod;
-typedef TYPE_UNORDERED_MULTIMAP<osmscout::Id,WayXSec>                           ListSharedNodes;
-typedef std::vector<ListSharedNodes>                                            ListSharedNodesByLod;
+typedef std::vector<IdMap<NodeRenderData> >                                     ListNodeDataByLod;
+typedef std::vector<IdMap<WayRenderData> >                                      ListWayDataByLod;
+typedef std::vector<IdMap<AreaRenderData> >                                     ListAreaDataByLod;
+typedef std::vector<IdMap<RelWayRenderData> >                                   ListRelWayDataByLod;
+typedef std::vector<IdMap<RelAreaRenderData> >                                  ListRelAreaDataByLod;
+typedef std::vector<IdMap<osmscout::NodeRef> >                                  ListNodeRefsByLod;
+typedef std::vector<IdMap<osmscout::WayRef> >                                   ListWayRefsByLod;
+typedef std::vector<IdMap<osmscout::WayRef> >                                   ListAreaRefsByLod;
+typedef std::vector<IdMap<osmscout::RelationRef> >                              ListRelWayRefsByLod;
+typedef std::vector<IdMap<osmscout::RelationRef> >                              ListRelAreaRefsByLod;
+typedef std::vector<SharedNodeIndex>                                            ListSharedNodesByLod;
 typedef TYPE_UNORDERED_MULTIMAP<osmscout::TypeId,osmscout::NodeRef>             ListNodesByType;
 typedef TYPE_UNORDERED_MULTIMAP<osmscout::TypeId,osmscout::WayRef>              ListWaysByType;
 typedef TYPE_UNORDERED_MULTIMAP<osmscout::TypeId,osmscout::WayRef>              ListAreasByType;
 typedef TYPE_UNORDERED_MULTIMAP<osmscout::Id,osmscout::Id>                      ListIdsById;
+typedef std::vector<std::vector<GeoBounds> >                                    ListGeoBoundsByLod;
 
 // ========================================================================== //
 // ========================================================================== //
@@ -240,6 +253,25 @@ public:
     virtual bool GetBoundingBox(double &minLat,double &minLon,
                                 double &maxLat,double &maxLon) const = 0;
 
+    // GetObjectsIsReentrant
+    // * true if GetObjects can be called from multiple
+    //   threads at once
+    virtual bool GetObjectsIsReentrant() const
+    {   return false;   }
+
+    // GetQuerySource
+    // * non-reentrant DataSets that return the same source
+    //   (ie. a shared osmscout::Database) are never queried
+    //   concurrently with each other
+    virtual void const * GetQuerySource() const
+    {   return this;   }
+
+    // GetObjects
+    // * has to return at least every node within and
+    //   every way, area and relation whose bounding box
+    //   overlaps one of listBounds; MapRenderer drops
+    //   any others with the same bounding box test it
+    //   uses for objects kept between updates
     bool GetObjects(std::vector<GeoBounds> const &listBounds,
                     osmscout::TypeSet const &typeSet,
                     std::vector<osmscout::NodeRef> &listNodeRefs,
@@ -310,12 +342,23 @@ public:
     ListRelAreaDataByLod listRelAreaData;
     ListRelWayDataByLod  listRelWayData;
 
-    //
+    // ids of the objects in the scene and
+    // their lods, sorted by id; used to diff
+    // the scene against a new view
+    ListIdLods           listNodeIds;
+    ListIdLods           listWayIds;
+    ListIdLods           listAreaIds;
+    ListIdLods           listRelAreaIds;
+
+    // bounds the current render data was queried
+    // with, by lod (empty if it wasn't all queried
+    // for the same camera)
+    ListGeoBoundsByLod   listQueryBounds;
+
+    // the nodes used by the ways in the scene, by
+    // lod (see OPT_TRACK_SHARED_NODES)
     ListSharedNodesByLod listSharedNodes;
 
-    // check for intersections <NodeId,WayXSec>
-//    ListWayXsecByNode    listSharedNodes;
-
     // RenderStyleConfig
     std::vector<RenderStyleConfig*> listStyleConfigs;
 };
@@ -346,6 +389,9 @@ public:
         return m_database->GetBoundingBox(minLat,minLon,maxLat,maxLon);
     }
 
+    void const * GetQuerySource() const
+    {   return m_database;   }
+
 private:
     bool getObjects(double minLon, double minLat,
                     double maxLon, double maxLat,
@@ -401,6 +447,9 @@ public:
         return m_database->GetBoundingBox(minLat,minLon,maxLat,maxLon);
     }
 
+    void const * GetQuerySource() const
+    {   return m_database;   }
+
 private:
 
     size_t intlog2(size_t val)
@@ -575,7 +624,7 @@ public:
         {   tagHeight = typeConfig->RegisterTagForExternalUse("height");   }
     }
 
-    ~DataSetTemp();
+    ~DataSetTemp() {}
 
     bool AddNode(osmscout::Node const &addNode,
                  std::vector<osmscout::Tag> listTags,
@@ -799,10 +848,8 @@ private:
 
             for(wIt = wayRange.first; wIt != wayRange.second; ++wIt)
             {
-                double centerLat,centerLon;
-                wIt->second->GetCenter(centerLat,centerLon);
-                if(isWithinBounds(minLat,minLon,maxLat,maxLon,
-                                  centerLat,centerLon))
+                if(overlapsBounds(minLat,minLon,maxLat,maxLon,
+                                  wIt->second->nodes))
                 {   listWayRefs.push_back(wIt->second);   }
             }
 
@@ -814,10 +861,8 @@ private:
 
             for(aIt = areaRange.first; aIt != areaRange.second; ++aIt)
             {
-                double centerLat,centerLon;
-                aIt->second->GetCenter(centerLat,centerLon);
-                if(isWithinBounds(minLat,minLon,maxLat,maxLon,
-                                  centerLat,centerLon))
+                if(overlapsBounds(minLat,minLon,maxLat,maxLon,
+                                  aIt->second->nodes))
                 {   listAreaRefs.push_back(aIt->second);    }
             }
 
@@ -829,13 +874,10 @@ private:
 
     size_t genObjectId()
     {
-        if(m_id_counter > 32767)   {    // randomly using 16-bit as upper limit;
-            m_id_counter = 0;           // we should never have this many objects
-        }
-        else   {
-            m_id_counter++;
-        }
-
+        // ids are never reused; the render data for each
+        // lod is keyed by id, so two objects with the same
+        // id would replace each other in the scene
+        m_id_counter++;
         return m_id_counter;
     }
 
@@ -859,6 +901,29 @@ private:
         return false;
     }
 
+    // overlapsBounds
+    // * true if the bounding box of listPoints
+    //   overlaps the given bounds
+    bool overlapsBounds(double minLat,double minLon,
+                        double maxLat,double maxLon,
+                        std::vector<osmscout::Point> const &listPoints) const
+    {
+        if(listPoints.empty())
+        {   return false;   }
+
+        double objMinLat = listPoints[0].GetLat(); double objMaxLat = objMinLat;
+        double objMinLon = listPoints[0].GetLon(); double objMaxLon = objMinLon;
+        for(size_t i=1; i < listPoints.size(); i++)   {
+            objMinLat = std::min(objMinLat,listPoints[i].GetLat());
+            objMaxLat = std::max(objMaxLat,listPoints[i].GetLat());
+            objMinLon = std::min(objMinLon,listPoints[i].GetLon());
+            objMaxLon = std::max(objMaxLon,listPoints[i].GetLon());
+        }
+
+        return (objMaxLat >= minLat) && (objMinLat <= maxLat) &&
+               (objMaxLon >= minLon) && (objMinLon <= maxLon);
+    }
+
     size_t m_id_counter;
     double m_minLat;
     double m_minLon;
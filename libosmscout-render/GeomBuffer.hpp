@@ -0,0 +1,178 @@
+/*
+    libosmscout-render
+
+    Copyright (C) 2012, Preet Desai
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef OSMSCOUTRENDER_GEOMBUFFER_HPP
+#define OSMSCOUTRENDER_GEOMBUFFER_HPP
+
+#include <vector>
+#include <cstddef>
+
+#include "Vec3.hpp"
+
+namespace osmsrender
+{
+    // GeomBufferT
+    // * the points of one or more polylines or contours,
+    //   with each coordinate in its own array (structure
+    //   of arrays) so kernels can load consecutive points
+    //   without shuffling x,y,z apart
+    // * points are grouped into rings (a polyline, or one
+    //   outer or inner contour of an area) and rings into
+    //   parts (an area with its holes)
+    // * GeomBuffer holds absolute (ECEF) points, and
+    //   GeomBufferf the float offsets used for compact
+    //   render data (see CompactGeometry.hpp)
+
+    // listRingEnds[r] is one past the last point in ring r
+    // and listPartEnds[p] one past the last ring in part p,
+    // so an empty buffer doesn't allocate anything
+
+    // points added after the last EndRing (or rings added
+    // after the last EndPart) aren't in a ring (or part)
+    // yet, so EndRing and EndPart should always be called
+
+    template <typename T>
+    class GeomBufferT
+    {
+    public:
+        void Clear()
+        {
+            listX.clear();
+            listY.clear();
+            listZ.clear();
+            listRingEnds.clear();
+            listPartEnds.clear();
+        }
+
+        // Swap
+        // * swapping with an empty buffer is the
+        //   only way to release the memory
+        void Swap(GeomBufferT &other)
+        {
+            listX.swap(other.listX);
+            listY.swap(other.listY);
+            listZ.swap(other.listZ);
+            listRingEnds.swap(other.listRingEnds);
+            listPartEnds.swap(other.listPartEnds);
+        }
+
+        void Reserve(size_t numPts)
+        {
+            listX.reserve(numPts);
+            listY.reserve(numPts);
+            listZ.reserve(numPts);
+        }
+
+        // Resize
+        // * adds (or removes) points at the end of the
+        //   buffer to leave numPts; new points are (0,0,0)
+        void Resize(size_t numPts)
+        {
+            listX.resize(numPts,0);
+            listY.resize(numPts,0);
+            listZ.resize(numPts,0);
+        }
+
+        void AddPoint(T x, T y, T z)
+        {
+            listX.push_back(x);
+            listY.push_back(y);
+            listZ.push_back(z);
+        }
+
+        void AddPoint(Vec3 const &point)
+        {   AddPoint(T(point.x),T(point.y),T(point.z));   }
+
+        void SetPoint(size_t idx, Vec3 const &point)
+        {
+            listX[idx] = T(point.x);
+            listY[idx] = T(point.y);
+            listZ[idx] = T(point.z);
+        }
+
+        // EndRing
+        // * ends the ring made up of the points
+        //   added since the last call
+        void EndRing()
+        {   listRingEnds.push_back(listX.size());   }
+
+        // EndPart
+        // * ends the part made up of the rings
+        //   added since the last call
+        void EndPart()
+        {   listPartEnds.push_back(listRingEnds.size());   }
+
+        bool IsEmpty() const
+        {   return listX.empty();   }
+
+        size_t GetNumPoints() const
+        {   return listX.size();   }
+
+        size_t GetNumRings() const
+        {   return listRingEnds.size();   }
+
+        size_t GetNumParts() const
+        {   return listPartEnds.size();   }
+
+        size_t GetRingBegin(size_t ring) const
+        {   return (ring == 0) ? 0 : listRingEnds[ring-1];   }
+
+        size_t GetRingSize(size_t ring) const
+        {   return listRingEnds[ring]-GetRingBegin(ring);   }
+
+        size_t GetPartRingBegin(size_t part) const
+        {   return (part == 0) ? 0 : listPartEnds[part-1];   }
+
+        size_t GetPartNumRings(size_t part) const
+        {   return listPartEnds[part]-GetPartRingBegin(part);   }
+
+        Vec3 GetPoint(size_t idx) const
+        {   return Vec3(listX[idx],listY[idx],listZ[idx]);   }
+
+        // GetRing
+        // * copies a ring's points into listVx
+        void GetRing(size_t ring, std::vector<Vec3> &listVx) const
+        {
+            size_t begin = GetRingBegin(ring);
+            listVx.resize(GetRingSize(ring));
+            for(size_t i=0; i < listVx.size(); i++)
+            {   listVx[i] = GetPoint(begin+i);   }
+        }
+
+        // GetNumBytes
+        // * the memory held by the buffer's lists
+        size_t GetNumBytes() const
+        {
+            return (listX.capacity()+listY.capacity()+listZ.capacity())*sizeof(T) +
+                   (listRingEnds.capacity()+listPartEnds.capacity())*sizeof(size_t);
+        }
+
+        std::vector<T>          listX;
+        std::vector<T>          listY;
+        std::vector<T>          listZ;
+        std::vector<size_t>     listRingEnds;
+        std::vector<size_t>     listPartEnds;
+    };
+
+    typedef GeomBufferT<double> GeomBuffer;
+    typedef GeomBufferT<float>  GeomBufferf;
+}
+
+#endif
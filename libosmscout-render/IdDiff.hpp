@@ -0,0 +1,191 @@
+/*
+    libosmscout-render
+
+    Copyright (C) 2012, Preet Desai
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef OSMSCOUTRENDER_IDDIFF_HPP
+#define OSMSCOUTRENDER_IDDIFF_HPP
+
+#include <vector>
+#include <algorithm>
+
+#include "IdMap.hpp"
+
+namespace osmsrender
+{
+    // IdLod
+    // * an object id and the lod it's shown at
+    struct IdLod
+    {
+        IdLod() :
+            id(0),lod(0)
+        {}
+
+        IdLod(osmscout::Id myId, size_t myLod) :
+            id(myId),lod(myLod)
+        {}
+
+        bool operator < (IdLod const &other) const
+        {   return (id < other.id);   }
+
+        osmscout::Id id;
+        size_t lod;
+    };
+
+    // ListIdLods
+    // * a list of IdLods sorted by id; since an object
+    //   is only shown at a single lod, an id appears
+    //   at most once
+    typedef std::vector<IdLod> ListIdLods;
+
+    struct IdLodChange
+    {
+        IdLodChange() :
+            id(0),oldLod(0),newLod(0)
+        {}
+
+        IdLodChange(osmscout::Id myId, size_t myOldLod, size_t myNewLod) :
+            id(myId),oldLod(myOldLod),newLod(myNewLod)
+        {}
+
+        osmscout::Id id;
+        size_t oldLod;
+        size_t newLod;
+    };
+
+    // IdDiff
+    // * the difference between two ListIdLods
+    // * listAdds: objects only in the new list
+    // * listRemoves: objects only in the old list
+    // * listLodChanges: objects in both lists
+    //   but at different lods
+    // * numKept: objects in both lists at the same lod
+    struct IdDiff
+    {
+        IdDiff() :
+            numKept(0)
+        {}
+
+        void clear()
+        {
+            listAdds.clear();
+            listRemoves.clear();
+            listLodChanges.clear();
+            numKept = 0;
+        }
+
+        ListIdLods                  listAdds;
+        ListIdLods                  listRemoves;
+        std::vector<IdLodChange>    listLodChanges;
+        size_t                      numKept;
+    };
+
+    // BuildSortedIds
+    // * fills listIds with the ids from a list
+    //   of per-lod IdMaps, sorted by id
+    template <typename T>
+    void BuildSortedIds(std::vector<IdMap<T> > const &listByLod,
+                        ListIdLods &listIds)
+    {
+        size_t numIds=0;
+        for(size_t i=0; i < listByLod.size(); i++)
+        {   numIds += listByLod[i].size();   }
+
+        listIds.clear();
+        listIds.reserve(numIds);
+
+        for(size_t i=0; i < listByLod.size(); i++)
+        {
+            typename IdMap<T>::const_iterator it;
+            for(it = listByLod[i].begin();
+                it != listByLod[i].end(); ++it)
+            {   listIds.push_back(IdLod(it->first,i));   }
+        }
+
+        std::sort(listIds.begin(),listIds.end());
+    }
+
+    // CalcIdDiff
+    // * diffs two sorted ListIdLods with a single
+    //   linear merge
+    inline void CalcIdDiff(ListIdLods const &listOld,
+                           ListIdLods const &listNew,
+                           IdDiff &diff)
+    {
+        diff.clear();
+
+        size_t o=0;
+        size_t n=0;
+        while(o < listOld.size() && n < listNew.size())
+        {
+            if(listOld[o].id < listNew[n].id)   {
+                diff.listRemoves.push_back(listOld[o]);
+                o++;
+            }
+            else if(listNew[n].id < listOld[o].id)   {
+                diff.listAdds.push_back(listNew[n]);
+                n++;
+            }
+            else   {
+                if(listOld[o].lod == listNew[n].lod)
+                {   diff.numKept++;   }
+                else   {
+                    diff.listLodChanges.push_back(IdLodChange(
+                        listNew[n].id,listOld[o].lod,listNew[n].lod));
+                }
+                o++;
+                n++;
+            }
+        }
+
+        for(; o < listOld.size(); o++)
+        {   diff.listRemoves.push_back(listOld[o]);   }
+
+        for(; n < listNew.size(); n++)
+        {   diff.listAdds.push_back(listNew[n]);   }
+    }
+
+    // RemoveSortedIds
+    // * removes the ids in listRemIds from listIds;
+    //   listRemIds is sorted in place
+    inline void RemoveSortedIds(ListIdLods &listIds,
+                                std::vector<osmscout::Id> &listRemIds)
+    {
+        if(listRemIds.empty())
+        {   return;   }
+
+        std::sort(listRemIds.begin(),listRemIds.end());
+
+        size_t numKept=0;
+        size_t r=0;
+        for(size_t j=0; j < listIds.size(); j++)
+        {
+            while(r < listRemIds.size() && listRemIds[r] < listIds[j].id)
+            {   r++;   }
+
+            if(r < listRemIds.size() && listRemIds[r] == listIds[j].id)
+            {   continue;   }
+
+            listIds[numKept] = listIds[j];
+            numKept++;
+        }
+        listIds.resize(numKept);
+    }
+}
+
+#endif
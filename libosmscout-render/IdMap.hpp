@@ -0,0 +1,390 @@
+/*
+    libosmscout-render
+
+    Copyright (C) 2012, Preet Desai
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef OSMSCOUTRENDER_IDMAP_HPP
+#define OSMSCOUTRENDER_IDMAP_HPP
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+#include <osmscout/Types.h>
+
+namespace osmsrender
+{
+    // IdMap
+    // * a hash map keyed by osmscout::Id that stores its
+    //   entries in a single contiguous array (open addressing
+    //   with linear probing) so lookups and iteration don't
+    //   chase a pointer for every entry
+    // * the interface is the subset of std::unordered_map
+    //   used with the per-lod render data and ref maps
+
+    // notes:
+    // * erased entries are marked as deleted instead of
+    //   being moved, so erasing an entry never invalidates
+    //   iterators to other entries -- the scene diff loops
+    //   erase entries while iterating
+    // * unlike std::unordered_map, an insert that grows
+    //   the table invalidates references to entries as
+    //   well as iterators
+    // * the key in value_type isn't const, but it must
+    //   not be modified
+
+    template <typename T>
+    class IdMap
+    {
+    public:
+        typedef osmscout::Id key_type;
+        typedef T mapped_type;
+        typedef std::pair<osmscout::Id,T> value_type;
+
+        template <typename MapType, typename ValueType>
+        class IteratorBase
+        {
+        public:
+            IteratorBase() :
+                m_map(NULL),m_idx(0)
+            {}
+
+            IteratorBase(MapType *map, size_t idx) :
+                m_map(map),m_idx(idx)
+            {}
+
+            // allow iterator -> const_iterator
+            template <typename OtherMapType, typename OtherValueType>
+            IteratorBase(IteratorBase<OtherMapType,OtherValueType> const &other) :
+                m_map(other.m_map),m_idx(other.m_idx)
+            {}
+
+            ValueType & operator * () const
+            {   return m_map->m_listSlots[m_idx];   }
+
+            ValueType * operator -> () const
+            {   return &(m_map->m_listSlots[m_idx]);   }
+
+            IteratorBase & operator ++ ()
+            {
+                m_idx = m_map->nextFullSlot(m_idx+1);
+                return *this;
+            }
+
+            IteratorBase operator ++ (int)
+            {
+                IteratorBase it(*this);
+                ++(*this);
+                return it;
+            }
+
+            bool operator == (IteratorBase const &other) const
+            {   return (m_idx == other.m_idx);   }
+
+            bool operator != (IteratorBase const &other) const
+            {   return (m_idx != other.m_idx);   }
+
+        private:
+            friend class IdMap;
+            template <typename M, typename V> friend class IteratorBase;
+
+            MapType * m_map;
+            size_t m_idx;
+        };
+
+        typedef IteratorBase<IdMap,value_type> iterator;
+        typedef IteratorBase<IdMap const,value_type const> const_iterator;
+
+        IdMap(size_t numEntries=0) :
+            m_numEntries(0),
+            m_numDeleted(0)
+        {   reserve(numEntries);   }
+
+        size_t size() const
+        {   return m_numEntries;   }
+
+        bool empty() const
+        {   return (m_numEntries == 0);   }
+
+        iterator begin()
+        {   return iterator(this,nextFullSlot(0));   }
+
+        iterator end()
+        {   return iterator(this,m_listSlots.size());   }
+
+        const_iterator begin() const
+        {   return const_iterator(this,nextFullSlot(0));   }
+
+        const_iterator end() const
+        {   return const_iterator(this,m_listSlots.size());   }
+
+        iterator find(osmscout::Id key)
+        {   return iterator(this,findSlot(key));   }
+
+        const_iterator find(osmscout::Id key) const
+        {   return const_iterator(this,findSlot(key));   }
+
+        size_t count(osmscout::Id key) const
+        {   return (findSlot(key) == m_listSlots.size()) ? 0 : 1;   }
+
+        // GetNumBytes
+        // * memory used by the table's slots (including
+        //   empty ones), not counting anything the
+        //   entries point to
+        size_t GetNumBytes() const
+        {
+            return m_listSlots.capacity()*sizeof(value_type) +
+                   m_listStates.capacity();
+        }
+
+        std::pair<iterator,bool> insert(value_type const &value)
+        {
+            size_t idx = findSlot(value.first);
+            if(idx != m_listSlots.size())
+            {   return std::make_pair(iterator(this,idx),false);   }
+
+            idx = insertSlot(value.first);
+            m_listSlots[idx].second = value.second;
+            return std::make_pair(iterator(this,idx),true);
+        }
+
+        T & operator [] (osmscout::Id key)
+        {
+            size_t idx = findSlot(key);
+            if(idx == m_listSlots.size())
+            {   idx = insertSlot(key);   }
+
+            return m_listSlots[idx].second;
+        }
+
+        iterator erase(iterator it)
+        {
+            eraseSlot(it.m_idx);
+            return iterator(this,nextFullSlot(it.m_idx+1));
+        }
+
+        size_t erase(osmscout::Id key)
+        {
+            size_t idx = findSlot(key);
+            if(idx == m_listSlots.size())
+            {   return 0;   }
+
+            eraseSlot(idx);
+            return 1;
+        }
+
+        void clear()
+        {
+            m_listSlots.clear();
+            m_listStates.clear();
+            m_numEntries = 0;
+            m_numDeleted = 0;
+        }
+
+        // reserve
+        // * sizes the table so numEntries can be
+        //   inserted without growing it
+        void reserve(size_t numEntries)
+        {
+            size_t numSlots = calcNumSlots(numEntries);
+            if(numSlots > m_listSlots.size())
+            {   rehash(numSlots);   }
+        }
+
+        void swap(IdMap &other)
+        {
+            m_listSlots.swap(other.m_listSlots);
+            m_listStates.swap(other.m_listStates);
+            std::swap(m_numEntries,other.m_numEntries);
+            std::swap(m_numDeleted,other.m_numDeleted);
+        }
+
+    private:
+        enum SlotState
+        {
+            SLOT_EMPTY,
+            SLOT_FULL,
+            SLOT_DELETED
+        };
+
+        static size_t calcHash(osmscout::Id key)
+        {
+            // ids are mostly sequential so mix the
+            // bits before masking (fibonacci hashing)
+            uint64_t hash = uint64_t(key) * 0x9E3779B97F4A7C15ULL;
+            return size_t(hash ^ (hash >> 32));
+        }
+
+        static size_t calcNumSlots(size_t numEntries)
+        {
+            if(numEntries == 0)
+            {   return 0;   }
+
+            // keep the load factor at or below 0.75
+            size_t numSlots = 8;
+            while(numSlots*3 < numEntries*4)
+            {   numSlots *= 2;   }
+
+            return numSlots;
+        }
+
+        size_t nextFullSlot(size_t idx) const
+        {
+            while(idx < m_listStates.size() &&
+                  m_listStates[idx] != SLOT_FULL)
+            {   idx++;   }
+
+            return idx;
+        }
+
+        // findSlot
+        // * returns the slot holding key or
+        //   m_listSlots.size() if it isn't found
+        size_t findSlot(osmscout::Id key) const
+        {
+            size_t numSlots = m_listSlots.size();
+            if(m_numEntries == 0)
+            {   return numSlots;   }
+
+            size_t mask = numSlots-1;
+            size_t idx = calcHash(key) & mask;
+
+            while(m_listStates[idx] != SLOT_EMPTY)   {
+                if(m_listStates[idx] == SLOT_FULL &&
+                   m_listSlots[idx].first == key)
+                {   return idx;   }
+
+                idx = (idx+1) & mask;
+            }
+
+            return numSlots;
+        }
+
+        // insertSlot
+        // * claims a slot for key, which must not
+        //   already be in the map
+        size_t insertSlot(osmscout::Id key)
+        {
+            // deleted slots still lengthen probes so count
+            // them towards the load factor; like the std
+            // containers, the table never shrinks
+            if((m_numEntries+m_numDeleted+1)*4 > m_listSlots.size()*3)   {
+                rehash(std::max(m_listSlots.size(),
+                                calcNumSlots(m_numEntries+1)));
+            }
+
+            size_t mask = m_listSlots.size()-1;
+            size_t idx = calcHash(key) & mask;
+
+            while(m_listStates[idx] == SLOT_FULL)
+            {   idx = (idx+1) & mask;   }
+
+            if(m_listStates[idx] == SLOT_DELETED)
+            {   m_numDeleted--;   }
+
+            m_listStates[idx] = SLOT_FULL;
+            m_listSlots[idx].first = key;
+            m_numEntries++;
+            return idx;
+        }
+
+        void eraseSlot(size_t idx)
+        {
+            // reset the value so it doesn't hold
+            // on to any memory or refs
+            m_listSlots[idx].second = T();
+            m_listStates[idx] = SLOT_DELETED;
+            m_numEntries--;
+            m_numDeleted++;
+        }
+
+        void rehash(size_t numSlots)
+        {
+            std::vector<value_type> listSlots(numSlots);
+            std::vector<unsigned char> listStates(numSlots,SLOT_EMPTY);
+            listSlots.swap(m_listSlots);
+            listStates.swap(m_listStates);
+            m_numDeleted = 0;
+
+            size_t mask = numSlots-1;
+            for(size_t i=0; i < listSlots.size(); i++)
+            {
+                if(listStates[i] != SLOT_FULL)
+                {   continue;   }
+
+                size_t idx = calcHash(listSlots[i].first) & mask;
+                while(m_listStates[idx] == SLOT_FULL)
+                {   idx = (idx+1) & mask;   }
+
+                m_listStates[idx] = SLOT_FULL;
+                m_listSlots[idx].first = listSlots[i].first;
+                std::swap(m_listSlots[idx].second,listSlots[i].second);
+            }
+        }
+
+        std::vector<value_type>     m_listSlots;
+        std::vector<unsigned char>  m_listStates;
+        size_t                      m_numEntries;
+        size_t                      m_numDeleted;
+    };
+
+    // IdSet
+    // * an osmscout::Id set with the same layout as IdMap
+
+    class IdSet
+    {
+    public:
+        IdSet(size_t numEntries=0) :
+            m_map(numEntries)
+        {}
+
+        size_t size() const
+        {   return m_map.size();   }
+
+        bool empty() const
+        {   return m_map.empty();   }
+
+        size_t count(osmscout::Id key) const
+        {   return m_map.count(key);   }
+
+        // insert
+        // * the second member of the returned pair is
+        //   true if key wasn't already in the set
+        std::pair<osmscout::Id,bool> insert(osmscout::Id key)
+        {
+            return std::make_pair(key,m_map.insert(
+                std::make_pair(key,char(0))).second);
+        }
+
+        size_t erase(osmscout::Id key)
+        {   return m_map.erase(key);   }
+
+        void clear()
+        {   m_map.clear();   }
+
+        void reserve(size_t numEntries)
+        {   m_map.reserve(numEntries);   }
+
+    private:
+        IdMap<char> m_map;
+    };
+}
+
+#endif
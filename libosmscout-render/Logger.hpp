@@ -0,0 +1,342 @@
+/*
+    libosmscout-render
+
+    Copyright (C) 2012, Preet Desai
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef OSMSCOUTRENDER_LOGGER_HPP
+#define OSMSCOUTRENDER_LOGGER_HPP
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+// option: the least severe log level that's compiled
+// in; messages below it are removed by the compiler
+// (0 debug, 1 info, 2 warn, 3 error)
+#ifndef OPT_LOG_MIN_LEVEL
+#define OPT_LOG_MIN_LEVEL 0
+#endif
+
+// option: number of messages kept in the log and the
+// max length of each message (longer ones are cut off)
+#define OPT_LOG_RING_SIZE 1024
+#define OPT_LOG_MSG_SIZE 256
+
+namespace osmsrender
+{
+    enum LogLevel
+    {
+        LOG_DEBUG = 0,
+        LOG_INFO  = 1,
+        LOG_WARN  = 2,
+        LOG_ERROR = 3
+    };
+
+    // LogSlot
+    // * a message in the log's ring; msgIdx is the index
+    //   of the message (counting from 1) or 0 if empty
+    // * busy is only held while the slot is written or
+    //   copied, which is never contended unless the log
+    //   wraps around while a slot is being read
+    struct LogSlot
+    {
+        LogSlot() :
+            msgIdx(0),source(NULL)
+        {
+            busy.clear();
+            text[0] = '\0';
+        }
+
+        std::atomic_flag    busy;
+        size_t              msgIdx;
+        void const *        source;
+        char                text[OPT_LOG_MSG_SIZE];
+    };
+
+    // a process wide log of recent messages
+
+    // messages are written to a fixed size ring; logging
+    // threads don't share a lock (each message gets its own
+    // slot from an atomic counter) and nothing is allocated
+    // once a message has been formatted
+
+    // a background thread periodically copies new messages
+    // from the ring to the sink (std::cout by default), so
+    // a logging thread never waits on output
+
+    // levels below the runtime level (LOG_INFO by default)
+    // or below OPT_LOG_MIN_LEVEL aren't formatted at all
+
+    class Logger
+    {
+    public:
+        // Get
+        // * the logger is never destroyed, so messages can
+        //   be logged at any point (even during exit); the
+        //   sink is flushed and the sink thread is stopped
+        //   when the program exits
+        static Logger & Get()
+        {
+            static Logger * logger = createLogger();
+            return *logger;
+        }
+
+        static bool IsEnabled(LogLevel level)
+        {   return (level >= Get().m_level.load(std::memory_order_relaxed));   }
+
+        // SetLevel
+        // * messages below level are skipped
+        void SetLevel(LogLevel level)
+        {   m_level.store(level,std::memory_order_relaxed);   }
+
+        LogLevel GetLevel()
+        {   return LogLevel(m_level.load(std::memory_order_relaxed));   }
+
+        // SetSink
+        // * new messages are written to sink, a line each;
+        //   NULL stops messages from being written (they're
+        //   still kept in the log)
+        void SetSink(std::ostream *sink)
+        {
+            std::lock_guard<std::mutex> lock(m_sinkMutex);
+            flushSink();
+            m_sink = sink;
+        }
+
+        // Flush
+        // * writes any messages that haven't been written
+        //   to the sink yet without waiting for the thread
+        void Flush()
+        {
+            std::lock_guard<std::mutex> lock(m_sinkMutex);
+            flushSink();
+        }
+
+        // Add
+        // * adds a message from source to the log
+        void Add(void const *source, std::string const &text)
+        {
+            size_t msgIdx = m_numMessages.fetch_add(1,std::memory_order_relaxed)+1;
+            LogSlot &slot = m_listSlots[msgIdx % OPT_LOG_RING_SIZE];
+
+            while(slot.busy.test_and_set(std::memory_order_acquire))
+            {   std::this_thread::yield();   }
+
+            // a newer message got here first if
+            // the log wrapped around mid-write
+            if(slot.msgIdx < msgIdx)   {
+                slot.msgIdx = msgIdx;
+                slot.source = source;
+
+                size_t len = std::min(text.size(),size_t(OPT_LOG_MSG_SIZE-1));
+                memcpy(slot.text,text.data(),len);
+                slot.text[len] = '\0';
+            }
+            slot.busy.clear(std::memory_order_release);
+
+            startSinkThread();
+        }
+
+        // GetMessages
+        // * copies the messages in the log that were added
+        //   by source (or all messages if source is NULL)
+        //   to listMessages, oldest first
+        void GetMessages(void const *source,
+                         std::vector<std::string> &listMessages)
+        {
+            std::vector<std::pair<size_t,std::string> > listFound;
+            for(size_t i=0; i < OPT_LOG_RING_SIZE; i++)
+            {
+                LogSlot &slot = m_listSlots[i];
+                while(slot.busy.test_and_set(std::memory_order_acquire))
+                {   std::this_thread::yield();   }
+
+                if(slot.msgIdx > 0 && (source == NULL || slot.source == source))
+                {   listFound.push_back(std::make_pair(slot.msgIdx,std::string(slot.text)));   }
+
+                slot.busy.clear(std::memory_order_release);
+            }
+
+            std::sort(listFound.begin(),listFound.end());
+            for(size_t i=0; i < listFound.size(); i++)
+            {   listMessages.push_back(listFound[i].second);   }
+        }
+
+    private:
+        Logger() :
+            m_level(LOG_INFO),
+            m_numMessages(0),
+            m_listSlots(OPT_LOG_RING_SIZE),
+            m_sink(&std::cout),
+            m_numWritten(0),
+            m_sinkStarted(false),
+            m_sinkExit(false)
+        {}
+
+        static Logger * createLogger()
+        {
+            Logger * logger = new Logger;
+            std::atexit(&Logger::stopSinkThread);
+            return logger;
+        }
+
+        void startSinkThread()
+        {
+            if(m_sinkStarted.load(std::memory_order_acquire))
+            {   return;   }
+
+            std::lock_guard<std::mutex> lock(m_sinkMutex);
+            if(m_sinkStarted.load(std::memory_order_relaxed) || m_sinkExit)
+            {   return;   }
+
+            m_sinkThread = std::thread(&Logger::runSinkThread,this);
+            m_sinkStarted.store(true,std::memory_order_release);
+        }
+
+        void runSinkThread()
+        {
+            std::unique_lock<std::mutex> lock(m_sinkMutex);
+            while(!m_sinkExit)   {
+                m_sinkCondVar.wait_for(lock,std::chrono::milliseconds(50));
+                flushSink();
+            }
+        }
+
+        static void stopSinkThread()
+        {
+            Logger &logger = Get();
+            {
+                std::lock_guard<std::mutex> lock(logger.m_sinkMutex);
+                logger.m_sinkExit = true;
+                logger.flushSink();
+            }
+            logger.m_sinkCondVar.notify_all();
+
+            if(logger.m_sinkThread.joinable())
+            {   logger.m_sinkThread.join();   }
+        }
+
+        // flushSink
+        // * writes messages added since the last flush;
+        //   m_sinkMutex must be held
+        // * stops at the first message that's still being
+        //   written, and skips messages that were overwritten
+        //   before they could be written (if messages are
+        //   logged faster than the sink can keep up with)
+        void flushSink()
+        {
+            size_t numMessages = m_numMessages.load(std::memory_order_acquire);
+            if(numMessages - m_numWritten > OPT_LOG_RING_SIZE)   {
+                size_t numSkipped = numMessages - OPT_LOG_RING_SIZE - m_numWritten;
+                if(m_sink)
+                {   (*m_sink) << "WARN: " << numSkipped << " log messages were dropped\n";   }
+
+                m_numWritten += numSkipped;
+            }
+
+            std::string text;
+            for(; m_numWritten < numMessages; m_numWritten++)
+            {
+                size_t msgIdx = m_numWritten+1;
+                LogSlot &slot = m_listSlots[msgIdx % OPT_LOG_RING_SIZE];
+                while(slot.busy.test_and_set(std::memory_order_acquire))
+                {   std::this_thread::yield();   }
+
+                size_t slotIdx = slot.msgIdx;
+                if(slotIdx == msgIdx)
+                {   text = slot.text;   }
+
+                slot.busy.clear(std::memory_order_release);
+
+                if(slotIdx < msgIdx)
+                {   break;   }
+
+                if(slotIdx == msgIdx && m_sink)
+                {   (*m_sink) << text << "\n";   }
+            }
+
+            if(m_sink)
+            {   m_sink->flush();   }
+        }
+
+        std::atomic<int>            m_level;
+        std::atomic<size_t>         m_numMessages;
+        std::vector<LogSlot>        m_listSlots;
+
+        // sink vars
+        // * guarded by m_sinkMutex, except for
+        //   m_sinkStarted which is checked first
+        std::mutex                  m_sinkMutex;
+        std::condition_variable     m_sinkCondVar;
+        std::thread                 m_sinkThread;
+        std::ostream *              m_sink;
+        size_t                      m_numWritten;
+        std::atomic<bool>           m_sinkStarted;
+        bool                        m_sinkExit;
+    };
+
+    // LogMessage
+    // * formats a single message and adds it
+    //   to the log once it's been streamed
+    class LogMessage
+    {
+    public:
+        LogMessage(LogLevel level, void const *source) :
+            m_source(source)
+        {
+            m_stringstream.precision(8);
+            if(level == LOG_INFO)         {   m_stringstream << "INFO: ";   }
+            else if(level == LOG_WARN)    {   m_stringstream << "WARN: ";   }
+            else if(level == LOG_ERROR)   {   m_stringstream << "ERROR: ";   }
+        }
+
+        ~LogMessage()
+        {   Logger::Get().Add(m_source,m_stringstream.str());   }
+
+        std::ostream & GetStream()
+        {   return m_stringstream;   }
+
+    private:
+        void const * m_source;
+        std::ostringstream m_stringstream;
+    };
+}
+
+// OSRLOG
+// * logs a message from the current object (see
+//   GetDebugLog) if level is enabled; the message
+//   isn't formatted otherwise
+#define OSRLOG(level) \
+    if((level) < OPT_LOG_MIN_LEVEL || !osmsrender::Logger::IsEnabled(level)) {} \
+    else osmsrender::LogMessage(level,this).GetStream()
+
+#define OSRDEBUG OSRLOG(osmsrender::LOG_DEBUG)
+#define OSRINFO  OSRLOG(osmsrender::LOG_INFO)
+#define OSRWARN  OSRLOG(osmsrender::LOG_WARN)
+#define OSRERROR OSRLOG(osmsrender::LOG_ERROR)
+
+#endif
@@ -19,17 +19,395 @@
  */
 
 #include "MapRenderer.h"
+#include "SimdMath.hpp"
 
 
 namespace osmsrender
 {
 
-MapRenderer::MapRenderer()
+// removeFailedAdds
+// * removes render data of objType from listAddsByLod that
+//   couldn't be generated (listOk is false for its entry in
+//   listAddOrder), saves their ids to listFailedIds and
+//   updates the indices in listAddOrder to match
+template <typename T>
+static void removeFailedAdds(ObjectType objType,
+                             std::vector<QueuedAdd> &listAddOrder,
+                             std::vector<bool> const &listOk,
+                             std::vector<std::vector<T> > &listAddsByLod,
+                             std::vector<osmscout::Id> &listFailedIds)
+{
+    std::vector<std::vector<bool> > listFailed(listAddsByLod.size());
+    for(size_t i=0; i < listAddsByLod.size(); i++)
+    {   listFailed[i].resize(listAddsByLod[i].size(),false);   }
+
+    for(size_t k=0; k < listAddOrder.size(); k++)   {
+        QueuedAdd const &add = listAddOrder[k];
+        if(add.objType == objType && !listOk[k])
+        {   listFailed[add.lod][add.idx] = true;   }
+    }
+
+    // listNewIdxs maps each entry's old index to its new one
+    std::vector<std::vector<size_t> > listNewIdxs(listAddsByLod.size());
+    for(size_t i=0; i < listAddsByLod.size(); i++)
+    {
+        std::vector<T> &listAdds = listAddsByLod[i];
+        listNewIdxs[i].resize(listAdds.size(),0);
+
+        size_t numKept=0;
+        for(size_t j=0; j < listAdds.size(); j++)   {
+            if(listFailed[i][j])   {
+                listFailedIds.push_back(getRenderDataId(listAdds[j]));
+                continue;
+            }
+            if(numKept != j)
+            {   listAdds[numKept] = listAdds[j];   }
+
+            listNewIdxs[i][j] = numKept;
+            numKept++;
+        }
+        listAdds.resize(numKept);
+    }
+
+    for(size_t k=0; k < listAddOrder.size(); k++)   {
+        QueuedAdd &add = listAddOrder[k];
+        if(add.objType == objType && listOk[k])
+        {   add.idx = listNewIdxs[add.lod][add.idx];   }
+    }
+}
+
+// expandGeoBounds
+// * grows the lat/lon bounds minPt,maxPt so
+//   that they contain every point in listPoints
+static void expandGeoBounds(std::vector<osmscout::Point> const &listPoints,
+                            PointLLA &minPt, PointLLA &maxPt)
+{
+    for(size_t i=0; i < listPoints.size(); i++)   {
+        minPt.lat = std::min(minPt.lat,listPoints[i].GetLat());
+        minPt.lon = std::min(minPt.lon,listPoints[i].GetLon());
+        maxPt.lat = std::max(maxPt.lat,listPoints[i].GetLat());
+        maxPt.lon = std::max(maxPt.lon,listPoints[i].GetLon());
+    }
+}
+
+// calcGeoCenter
+// * returns the center of the lat/lon bounds
+//   of a way or of all of a relation's roles
+static PointLLA calcGeoCenter(PointLLA const &minPt, PointLLA const &maxPt)
+{
+    if(minPt.lat > maxPt.lat)
+    {   return PointLLA(0,0);   }
+
+    return PointLLA((minPt.lat+maxPt.lat)*0.5,
+                    (minPt.lon+maxPt.lon)*0.5);
+}
+
+static PointLLA calcGeoCenter(std::vector<osmscout::Point> const &listPoints)
+{
+    PointLLA minPt(90,180),maxPt(-90,-180);
+    expandGeoBounds(listPoints,minPt,maxPt);
+    return calcGeoCenter(minPt,maxPt);
+}
+
+static PointLLA calcGeoCenter(osmscout::RelationRef const &relRef)
+{
+    PointLLA minPt(90,180),maxPt(-90,-180);
+    for(size_t r=0; r < relRef->roles.size(); r++)
+    {   expandGeoBounds(relRef->roles[r].nodes,minPt,maxPt);   }
+
+    return calcGeoCenter(minPt,maxPt);
+}
+
+// calcCameraViewChanged
+// * true if the cameras would query different
+//   objects (their eyes or view extents differ)
+static bool calcCameraViewChanged(Camera const &oldCam, Camera const &newCam)
+{
+    double const maxDist2 = 1E-6;
+    return (oldCam.eye.Distance2To(newCam.eye) > maxDist2 ||
+            oldCam.exTL.Distance2To(newCam.exTL) > maxDist2 ||
+            oldCam.exTR.Distance2To(newCam.exTR) > maxDist2 ||
+            oldCam.exBR.Distance2To(newCam.exBR) > maxDist2 ||
+            oldCam.exBL.Distance2To(newCam.exBL) > maxDist2);
+}
+
+// getQueuedIds
+// * gets the objects a diff adds and the objects
+//   it moves to another lod (with their new lod)
+static void getQueuedIds(IdDiff const &diff, ListIdLods &listQueued)
+{
+    listQueued.reserve(diff.listAdds.size()+diff.listLodChanges.size());
+    listQueued.insert(listQueued.end(),diff.listAdds.begin(),diff.listAdds.end());
+    for(size_t c=0; c < diff.listLodChanges.size(); c++)   {
+        IdLodChange const &lodChange = diff.listLodChanges[c];
+        listQueued.push_back(IdLod(lodChange.id,lodChange.newLod));
+    }
+}
+
+// getRenderDataId
+// * gets the id of the object render data is for
+static osmscout::Id getRenderDataId(NodeRenderData const &nodeRenderData)
+{   return nodeRenderData.nodeRef->GetId();   }
+
+static osmscout::Id getRenderDataId(WayRenderData const &wayRenderData)
+{   return wayRenderData.wayRef->GetId();   }
+
+static osmscout::Id getRenderDataId(AreaRenderData const &areaRenderData)
+{   return areaRenderData.areaRef->GetId();   }
+
+static osmscout::Id getRenderDataId(RelAreaRenderData const &relRenderData)
+{   return relRenderData.relRef->GetId();   }
+
+// getRenderDataType
+// * gets the osmscout type of the object render data is for
+static osmscout::TypeId getRenderDataType(NodeRenderData const &nodeRenderData)
+{   return nodeRenderData.nodeRef->GetType();   }
+
+static osmscout::TypeId getRenderDataType(WayRenderData const &wayRenderData)
+{   return wayRenderData.wayRef->GetType();   }
+
+static osmscout::TypeId getRenderDataType(AreaRenderData const &areaRenderData)
+{   return areaRenderData.areaRef->GetType();   }
+
+static osmscout::TypeId getRenderDataType(RelAreaRenderData const &relRenderData)
+{   return relRenderData.relRef->GetType();   }
+
+// compactRenderData
+// * moves the points kept in render data into their
+//   compact form (see SetCompactRenderData)
+static void compactRenderData(NodeRenderData &)
 {}
 
-MapRenderer::~MapRenderer()
+static void compactRenderData(WayRenderData &wayRenderData)
+{
+    // coastlines mark breaks with (0,0,0) points, which
+    // are too far from any origin to keep as floats
+    if(wayRenderData.isCoast || wayRenderData.wayPoints.IsEmpty())
+    {   return;   }
+
+    wayRenderData.wayOrigin = wayRenderData.wayPoints.GetPoint(0);
+    PackPoints(wayRenderData.wayPoints,wayRenderData.wayOrigin,
+               wayRenderData.wayOffsets);
+    GeomBuffer().Swap(wayRenderData.wayPoints);
+}
+
+static void compactRenderData(AreaRenderData &areaRenderData)
+{
+    if(areaRenderData.areaPoints.IsEmpty())
+    {   return;   }
+
+    PackPoints(areaRenderData.areaPoints,areaRenderData.centerPoint,
+               areaRenderData.areaOffsets);
+    GeomBuffer().Swap(areaRenderData.areaPoints);
+}
+
+static void compactRenderData(RelAreaRenderData &relRenderData)
+{
+    for(size_t i=0; i < relRenderData.listAreaData.size(); i++)
+    {   compactRenderData(relRenderData.listAreaData[i]);   }
+}
+
+// expandRenderData
+// * restores compacted points so render
+//   data can be added to the scene
+static void expandRenderData(NodeRenderData &)
 {}
 
+static void expandRenderData(WayRenderData &wayRenderData)
+{
+    if(wayRenderData.wayOffsets.IsEmpty())
+    {   return;   }
+
+    UnpackPoints(wayRenderData.wayOffsets,wayRenderData.wayOrigin,
+                 wayRenderData.wayPoints);
+    GeomBufferf().Swap(wayRenderData.wayOffsets);
+}
+
+static void expandRenderData(AreaRenderData &areaRenderData)
+{
+    if(areaRenderData.areaOffsets.IsEmpty())
+    {   return;   }
+
+    UnpackPoints(areaRenderData.areaOffsets,areaRenderData.centerPoint,
+                 areaRenderData.areaPoints);
+    GeomBufferf().Swap(areaRenderData.areaOffsets);
+}
+
+static void expandRenderData(RelAreaRenderData &relRenderData)
+{
+    for(size_t i=0; i < relRenderData.listAreaData.size(); i++)
+    {   expandRenderData(relRenderData.listAreaData[i]);   }
+}
+
+// findPrefetched
+// * copies the prefetched render data for
+//   objId into renderData if there is any
+template <typename T>
+static bool findPrefetched(IdMap<T> const &listData,
+                           osmscout::Id objId,
+                           T &renderData)
+{
+    typename IdMap<T>::const_iterator it =
+            listData.find(objId);
+
+    if(it == listData.end())
+    {   return false;   }
+
+    renderData = it->second;
+    expandRenderData(renderData);
+    return true;
+}
+
+// calcRenderDataSize
+// * estimates the memory used by render data
+static size_t calcRenderDataSize(NodeRenderData const &nodeData)
+{
+    return sizeof(NodeRenderData) + nodeData.nameLabel.capacity();
+}
+
+static size_t calcRenderDataSize(WayRenderData const &wayData)
+{
+    size_t numBytes = sizeof(WayRenderData) +
+            wayData.wayPoints.GetNumBytes() +
+            wayData.wayOffsets.GetNumBytes() +
+            wayData.nameLabel.capacity();
+
+    numBytes += wayData.listIntersections.capacity()*sizeof(WayXSec);
+    return numBytes;
+}
+
+static size_t calcRenderDataSize(AreaRenderData const &areaData)
+{
+    return sizeof(AreaRenderData) +
+            areaData.areaPoints.GetNumBytes() +
+            areaData.areaOffsets.GetNumBytes() +
+            areaData.nameLabel.capacity();
+}
+
+static size_t calcRenderDataSize(RelAreaRenderData const &relAreaData)
+{
+    size_t numBytes = sizeof(RelAreaRenderData);
+    for(size_t i=0; i < relAreaData.listAreaData.size(); i++)   {
+        numBytes += calcRenderDataSize(relAreaData.listAreaData[i]);
+    }
+    return numBytes;
+}
+
+// calcRenderDataNumPts
+// * counts the points in render data passed to the
+//   backend (render data that isn't compacted)
+static size_t calcRenderDataNumPts(NodeRenderData const &)
+{   return 1;   }
+
+static size_t calcRenderDataNumPts(WayRenderData const &wayData)
+{   return wayData.wayPoints.GetNumPoints();   }
+
+static size_t calcRenderDataNumPts(AreaRenderData const &areaData)
+{   return areaData.areaPoints.GetNumPoints();   }
+
+static size_t calcRenderDataNumPts(RelAreaRenderData const &relAreaData)
+{
+    size_t numPts=0;
+    for(size_t i=0; i < relAreaData.listAreaData.size(); i++)
+    {   numPts += calcRenderDataNumPts(relAreaData.listAreaData[i]);   }
+
+    return numPts;
+}
+
+// calcMemoryUsage
+// * adds the memory used by a lod's render data to
+//   lodUsage, and each object's render data to the
+//   usage for its osmscout type
+template <typename T>
+static void calcMemoryUsage(IdMap<T> const &listData,
+                            MemoryUsage &lodUsage,
+                            std::map<osmscout::TypeId,MemoryUsage> &mapTypeUsage)
+{
+    size_t numBytes = listData.GetNumBytes();
+
+    typename IdMap<T>::const_iterator it;
+    for(it = listData.begin(); it != listData.end(); ++it)   {
+        // the render data itself is in the
+        // map's slots, which are counted above
+        size_t dataBytes = calcRenderDataSize(it->second);
+        numBytes += dataBytes-sizeof(T);
+
+        mapTypeUsage[getRenderDataType(it->second)].Add(1,dataBytes);
+    }
+
+    lodUsage.Add(listData.size(),numBytes);
+}
+
+// calcMemoryUsage
+// * adds the memory used by a list of
+//   scene ids to usage
+static void calcMemoryUsage(ListIdLods const &listIdLods,
+                            MemoryUsage &usage)
+{   usage.Add(listIdLods.size(),listIdLods.capacity()*sizeof(IdLod));   }
+
+// getTypeStats
+// * gets the stats for the object type of render data
+static SceneTypeStats & getTypeStats(SceneUpdateStats &stats,
+                                     NodeRenderData const &)
+{   return stats.nodeStats;   }
+
+static SceneTypeStats & getTypeStats(SceneUpdateStats &stats,
+                                     WayRenderData const &)
+{   return stats.wayStats;   }
+
+static SceneTypeStats & getTypeStats(SceneUpdateStats &stats,
+                                     AreaRenderData const &)
+{   return stats.areaStats;   }
+
+static SceneTypeStats & getTypeStats(SceneUpdateStats &stats,
+                                     RelAreaRenderData const &)
+{   return stats.relAreaStats;   }
+
+// calcElapsedMs
+// * milliseconds since tStart
+static double calcElapsedMs(std::chrono::steady_clock::time_point const &tStart)
+{
+    return std::chrono::duration<double,std::milli>(
+                std::chrono::steady_clock::now()-tStart).count();
+}
+
+MapRenderer::MapRenderer() :
+    m_asyncUpdates(false),
+    m_workerExit(false),
+    m_workerBusy(false),
+    m_workerHasJob(false),
+    m_pendingUpdate(NULL),
+    m_sceneGeneration(0),
+    m_commitMaxMillis(0),
+    m_commitMaxObjects(0),
+    m_incrementalUpdates(false),
+    m_lodHysteresis(0),
+    m_prefetchTime(0),
+    m_camHasLastEye(false),
+    m_camHasVelocity(false),
+    m_workerHasPrefetchJob(false),
+    m_cacheMaxBytes(0),
+    m_cacheTick(0),
+    m_cacheHits(0),
+    m_cacheMisses(0),
+    m_cacheEvictions(0),
+    m_compactRenderData(false)
+{
+    for(size_t i=0; i < m_taskPool.GetNumThreads(); i++)
+    {   m_listScratchArenas.push_back(new ScratchArena);   }
+}
+
+MapRenderer::~MapRenderer()
+{
+    // the renderer implementation is already gone
+    // so any uncommitted update is just dropped
+    stopSceneUpdateWorker();
+    delete m_pendingUpdate;
+
+    for(size_t i=0; i < m_listScratchArenas.size(); i++)
+    {   delete m_listScratchArenas[i];   }
+}
+
 // ========================================================================== //
 // ========================================================================== //
 
@@ -41,15 +419,7 @@ void MapRenderer::AddDataSet(DataSetOSM * dataSet)
 
 void MapRenderer::RemoveDataSet(DataSetOSM * dataSet)
 {
-    std::vector<DataSet*>::iterator dsIt;
-    for(dsIt = m_listDataSets.begin();
-        dsIt != m_listDataSets.end(); ++dsIt)
-    {
-        if(static_cast<DataSet*>(dataSet) == (*dsIt))  // TODO: check
-        {   break;   }
-    }
-    m_listDataSets.erase(dsIt);
-    rebuildAllData();
+    removeDataSet(dataSet);
 }
 
 void MapRenderer::AddDataSet(DataSetOSMCoast * dataSet)
@@ -60,15 +430,7 @@ void MapRenderer::AddDataSet(DataSetOSMCoast * dataSet)
 
 void MapRenderer::RemoveDataSet(DataSetOSMCoast * dataSet)
 {
-    std::vector<DataSet*>::iterator dsIt;
-    for(dsIt = m_listDataSets.begin();
-        dsIt != m_listDataSets.end(); ++dsIt)
-    {
-        if(static_cast<DataSet*>(dataSet) == (*dsIt))  // TODO: check
-        {   break;   }
-    }
-    m_listDataSets.erase(dsIt);
-    rebuildAllData();
+    removeDataSet(dataSet);
 }
 
 void MapRenderer::AddDataSet(DataSetTemp *dataSet)
@@ -79,15 +441,7 @@ void MapRenderer::AddDataSet(DataSetTemp *dataSet)
 
 void MapRenderer::RemoveDataSet(DataSetTemp *dataSet)
 {
-    std::vector<DataSet*>::iterator dsIt;
-    for(dsIt = m_listDataSets.begin();
-        dsIt != m_listDataSets.end(); ++dsIt)
-    {
-        if(static_cast<DataSet*>(dataSet) == (*dsIt))  // TODO: check
-        {   break;   }
-    }
-    m_listDataSets.erase(dsIt);
-    rebuildAllData();
+    removeDataSet(dataSet);
 }
 
 // ========================================================================== //
@@ -98,14 +452,11 @@ void MapRenderer::SetRenderStyle(const std::string &stylePath)
     m_stylePath = stylePath;
 
     rebuildAllData();
-    OSRDEBUG << "INFO: Set New Style: " << m_stylePath;
+    OSRINFO << "Set New Style: " << m_stylePath;
 }
 
 void MapRenderer::GetDebugLog(std::vector<std::string> &listDebugMessages)
-{
-    for(size_t i=0; i < m_listMessages.size(); i++)
-    {   listDebugMessages.push_back(m_listMessages.at(i));   }
-}
+{   Logger::Get().GetMessages(this,listDebugMessages);   }
 
 // ========================================================================== //
 // ========================================================================== //
@@ -113,7 +464,7 @@ void MapRenderer::GetDebugLog(std::vector<std::string> &listDebugMessages)
 void MapRenderer::InitializeScene()
 {
     if(m_listDataSets.size() < 1)
-    {   OSRDEBUG << "ERROR: No available data sets!";   return;   }
+    {   OSRERROR << "No available data sets!";   return;   }
 
     // set camera / update scene
     double minLat,minLon,maxLat,maxLon;
@@ -127,7 +478,7 @@ void MapRenderer::InitializeScene(const PointLLA &camLLA,
                                   double fovy, double aspectRatio)
 {
     if(m_listDataSets.size() < 1)
-    {   OSRDEBUG << "ERROR: No available data sets!";   return;   }
+    {   OSRERROR << "No available data sets!";   return;   }
 
     // set camera
     SetCamera(camLLA,fovy,aspectRatio);
@@ -146,8 +497,12 @@ void MapRenderer::SetCamera(const PointLLA &camLLA,
     m_camera.fovY = fovy;
     m_camera.aspectRatio = aspectRatio;
 
+    // the camera jumped so its velocity is unknown
+    m_camHasLastEye = false;
+    m_camHasVelocity = false;
+
     if(!calcCamViewExtents(m_camera))
-    {   OSRDEBUG << "WARN: Could not calculate view extents";   }
+    {   OSRWARN << "Could not calculate view extents";   }
     else
     {   updateSceneBasedOnCamera();   }
 }
@@ -161,9 +516,12 @@ void MapRenderer::UpdateCameraLookAt(const Vec3 &eye,
     m_camera.up = up;
     m_camera.LLA = convECEFToLLA(m_camera.eye);
 
+    if(m_prefetchTime > 0)
+    {   updateCameraVelocity();   }
+
     // update scene if required
     if(!calcCamViewExtents(m_camera))
-    {   OSRDEBUG << "WARN: Could not calculate view extents";   }
+    {   OSRWARN << "Could not calculate view extents";   }
     else
     {   updateSceneBasedOnCamera();   }
 }
@@ -177,260 +535,740 @@ void MapRenderer::UpdateSceneContents(const DataSet *dataSet)
             listDataSets.push_back(m_listDataSets[i]);
         }
     }
+
+    std::unique_lock<std::mutex> lock(m_workerMutex);
+    bool droppedUpdate = waitForWorkerIdle(lock);
+
+    // the DataSet's contents may have changed anywhere
+    // so the whole view needs to be queried again
+    for(size_t i=0; i < listDataSets.size(); i++)
+    {   listDataSets[i]->listQueryBounds.clear();   }
+
+    std::vector<PrefetchData>::iterator pfIt;
+    for(pfIt = m_listPrefetchData.begin();
+        pfIt != m_listPrefetchData.end();)
+    {
+        if(pfIt->dataSet == dataSet)
+        {   pfIt = m_listPrefetchData.erase(pfIt);   }
+        else
+        {   ++pfIt;   }
+    }
+
+    if(!listDataSets.empty())
+    {   removeCachedRenderData(dataSet);   }
+
     updateSceneContents(listDataSets);
+
+    // a dropped update may have included other DataSets
+    if(droppedUpdate)
+    {   queueSceneUpdate();   }
 }
 
 void MapRenderer::UpdateSceneContentsAll()
 {
+    std::unique_lock<std::mutex> lock(m_workerMutex);
+    waitForWorkerIdle(lock);
+
+    for(size_t i=0; i < m_listDataSets.size(); i++)
+    {   m_listDataSets[i]->listQueryBounds.clear();   }
+
+    m_listPrefetchData.clear();
+    removeCachedRenderData(NULL);
     updateSceneContents(m_listDataSets);
 }
 
 Camera const * MapRenderer::GetCamera()
 {   return &m_camera;   }
 
-// ========================================================================== //
-// ========================================================================== //
-
-void MapRenderer::rebuildAllData()
+void MapRenderer::SetAsyncSceneUpdates(bool enable)
 {
-    if((m_listDataSets.size() < 1) || (m_stylePath.empty()))
+    if(enable == m_asyncUpdates)
     {   return;   }
 
-    // clear implemented scene
-    removeAllFromScene();
-
-    OSRDEBUG << "===================================";
-    std::vector<DataSet*>::iterator dsIt;
-    std::vector<DataSet const *> listKDataSetPtrs;
-    for(dsIt = m_listDataSets.begin();
-        dsIt != m_listDataSets.end(); ++dsIt)
-    {
-        DataSet * dataSet = (*dsIt);
-
-        // clear existing render data
-        dataSet->listNodeData.clear();
-        dataSet->listWayData.clear();
-        dataSet->listAreaData.clear();
-        dataSet->listRelWayData.clear();
-        dataSet->listRelAreaData.clear();
-        dataSet->listSharedNodes.clear();
-
-        // remove old style data
-        for(size_t i=0; i < dataSet->listStyleConfigs.size(); i++)
-        {   delete dataSet->listStyleConfigs[i];   }
-        dataSet->listStyleConfigs.clear();
-
-        // add new style data
-        bool opOk = false;
-        RenderStyleReader styleReader(m_stylePath,
-            dataSet->GetTypeConfig(),
-            dataSet->listStyleConfigs,opOk);
+    if(enable)   {
+        m_workerExit = false;
+        m_workerThread = std::thread(&MapRenderer::runSceneUpdateWorker,this);
+        m_asyncUpdates = true;
+        return;
+    }
 
-        if(!opOk)   {
-            OSRDEBUG << "ERROR: Could not set style info";
-            return;
-        }
+    stopSceneUpdateWorker();
 
-        size_t numLods = dataSet->listStyleConfigs.size();
-        dataSet->listNodeData.resize(numLods);
-        dataSet->listWayData.resize(numLods);
-        dataSet->listAreaData.resize(numLods);
-        dataSet->listRelWayData.resize(numLods);
-        dataSet->listRelAreaData.resize(numLods);
-        dataSet->listSharedNodes.resize(numLods);
+    // apply the last finished update so the scene
+    // isn't left behind the most recent camera
+    std::unique_lock<std::mutex> lock(m_workerMutex);
+    CommitBudget budget;
+    commitPendingUpdate(budget);
+}
 
-        for(size_t i=0; i < numLods; i++)   {
-            // TODO: empirically determine reserve count
-            //       (or if we even need them at all)
-            dataSet->listNodeData[i].reserve(50);
-            dataSet->listWayData[i].reserve(150);
-            dataSet->listAreaData[i].reserve(100);
-            dataSet->listRelWayData[i].reserve(5);
-            dataSet->listRelAreaData[i].reserve(25);
+bool MapRenderer::GetAsyncSceneUpdates()
+{   return m_asyncUpdates;   }
 
-            if(OPT_TRACK_SHARED_NODES)
-            {   dataSet->listSharedNodes[i].reserve(2000);   }
-        }
+bool MapRenderer::CommitSceneUpdate()
+{
+    std::unique_lock<std::mutex> lock(m_workerMutex);
+    if(m_pendingUpdate == NULL)
+    {   return false;   }
 
-        // save list for virtual implementation
-        listKDataSetPtrs.push_back(dataSet);
+    CommitBudget budget;
+    if(m_commitMaxMillis > 0)   {
+        budget.hasDeadline = true;
+        budget.deadline = std::chrono::steady_clock::now() +
+            std::chrono::microseconds(int64_t(m_commitMaxMillis*1000.0));
     }
+    budget.maxObjects = m_commitMaxObjects;
 
-    rebuildStyleData(listKDataSetPtrs);
-    updateSceneContents(m_listDataSets);
+    commitPendingUpdate(budget);
+    return true;
+}
 
-    OSRDEBUG << "===================================";
+bool MapRenderer::IsSceneUpdatePending()
+{
+    std::unique_lock<std::mutex> lock(m_workerMutex);
+    return (m_pendingUpdate != NULL);
 }
 
-void MapRenderer::updateSceneContents(std::vector<DataSet*> &listDataSets)
+void MapRenderer::SetSceneCommitBudget(double maxMillis, size_t maxObjects)
 {
-    if(listDataSets.size() < 1)
-    {   return;   }
+    m_commitMaxMillis = std::max(maxMillis,0.0);
+    m_commitMaxObjects = maxObjects;
+}
 
-    // calculate the minimum and maximum distance to
-    // m_camera.eye within the available lat/lon bounds
-    double minViewDist,maxViewDist;
-    this->calcCamViewDistances(minViewDist,maxViewDist);
+void MapRenderer::GetSceneCommitBudget(double &maxMillis, size_t &maxObjects)
+{
+    maxMillis = m_commitMaxMillis;
+    maxObjects = m_commitMaxObjects;
+}
 
-    OSRDEBUG << "### Camera Min View Dist: " << minViewDist;
-    OSRDEBUG << "### Camera Max View Dist: " << maxViewDist;
+void MapRenderer::SetIncrementalSceneUpdates(bool enable)
+{
+    // the worker reads the flag while building an update
+    std::unique_lock<std::mutex> lock(m_workerMutex);
+    bool droppedUpdate = waitForWorkerIdle(lock);
+    m_incrementalUpdates = enable;
 
-    // use the min and max distance between m_camera.eye
-    // and the view bounds to set active LOD ranges
+    if(droppedUpdate)
+    {   queueSceneUpdate();   }
+}
 
-    // (range data is common amongst DataSet style configs)
-    size_t numLodRanges = listDataSets[0]->listStyleConfigs.size();
-    std::vector<bool> listLODRangesActive(numLodRanges);
-    std::vector<std::pair<double,double> > listLODRanges(numLodRanges);
+bool MapRenderer::GetIncrementalSceneUpdates()
+{   return m_incrementalUpdates;   }
 
-    for(size_t i=0; i < numLodRanges; i++)
+void MapRenderer::SetScenePrefetch(double lookAheadSecs)
+{
+    m_prefetchTime = std::max(lookAheadSecs,0.0);
+    m_camHasLastEye = false;
+    m_camHasVelocity = false;
+
+    if(m_prefetchTime == 0)
     {
-        std::pair<double,double> lodRange;
-        lodRange.first = listDataSets[0]->listStyleConfigs[i]->GetMinDistance();
-        lodRange.second = listDataSets[0]->listStyleConfigs[i]->GetMaxDistance();
-        listLODRanges[i] = lodRange;
+        std::unique_lock<std::mutex> lock(m_workerMutex);
+        bool droppedUpdate = waitForWorkerIdle(lock);
+        m_listPrefetchData.clear();
 
-        // if the min-max distance range overlaps with
-        // lodRange, set the range as active
-        if(lodRange.second < minViewDist || lodRange.first > maxViewDist)
-        {   listLODRangesActive[i] = false;   }
-        else
-        {   listLODRangesActive[i] = true;   }
+        if(droppedUpdate)
+        {   queueSceneUpdate();   }
     }
+}
 
-    // check if at least one valid style
-    bool hasValidStyle = false;
-    for(size_t i=0; i < listLODRangesActive.size(); i++)
-    {
-        if(listLODRangesActive[i])
-        {   hasValidStyle = true;   break;   }
-    }
+double MapRenderer::GetScenePrefetch()
+{   return m_prefetchTime;   }
+
+void MapRenderer::SetRenderDataCacheSize(size_t maxBytes)
+{
+    bool toggled = ((maxBytes > 0) != (m_cacheMaxBytes > 0));
 
-    if(!hasValidStyle)
     {
-        OSRDEBUG << "WARN: No valid style data found";
-
-        // hide all data
-//        this->toggleSceneVisibility(false);
-
-        // (experimental) -- prefer to HIDE instead of delete
-        // remove all scene data if no style data is available
-//        std::vector<DataSet*>::iterator dsIt;
-//        for(dsIt = m_listDataSets.begin();
-//            dsIt != m_listDataSets.end(); ++dsIt)
-//        {
-//            DataSet * dataSet = (*dsIt);
-
-//            // clear existing render data
-//            dataSet->listNodeData.clear();
-//            dataSet->listWayData.clear();
-//            dataSet->listAreaData.clear();
-//            dataSet->listRelWayData.clear();
-//            dataSet->listRelAreaData.clear();
-//            dataSet->listSharedNodes.clear();
-
-//            size_t numLods = dataSet->listStyleConfigs.size();
-//            dataSet->listNodeData.resize(numLods);
-//            dataSet->listWayData.resize(numLods);
-//            dataSet->listAreaData.resize(numLods);
-//            dataSet->listRelWayData.resize(numLods);
-//            dataSet->listRelAreaData.resize(numLods);
-//        }
-//        this->removeAllFromScene();
-//        this->doneUpdatingAreas();
-//        this->doneUpdatingRelAreas();
-
-//        // update current data extents
-//        m_data_exTL = m_camera.exTL;
-//        m_data_exTR = m_camera.exTR;
-//        m_data_exBL = m_camera.exBL;
-//        m_data_exBR = m_camera.exBR;
+        std::unique_lock<std::mutex> lock(m_workerMutex);
+        bool droppedUpdate = waitForWorkerIdle(lock);
+        m_cacheMaxBytes = maxBytes;
+        trimRenderDataCache();
 
-        return;
+        if(droppedUpdate && !toggled)
+        {   queueSceneUpdate();   }
     }
-    else
-    {   toggleSceneVisibility(true);   }
 
-    PointLLA camLLA = convECEFToLLA(m_camera.eye);
-    size_t num_lod_ranges = listLODRanges.size();
+    // render data in the scene needs to be kept
+    // (or cleared) for the cache to work
+    if(toggled)
+    {   rebuildAllData();   }
+}
 
-    // for specified DataSets
+size_t MapRenderer::GetRenderDataCacheSize()
+{   return m_cacheMaxBytes;   }
+
+void MapRenderer::GetRenderDataCacheStats(RenderDataCacheStats &stats)
+{
+    stats.numHits = m_cacheHits;
+    stats.numMisses = m_cacheMisses;
+    stats.numEvictions = m_cacheEvictions;
+    stats.maxBytes = m_cacheMaxBytes;
+
+    stats.numEntries =
+            m_nodeCache.GetNumEntries() +
+            m_wayCache.GetNumEntries() +
+            m_areaCache.GetNumEntries() +
+            m_relAreaCache.GetNumEntries();
+
+    stats.numBytes =
+            m_nodeCache.GetNumBytes() +
+            m_wayCache.GetNumBytes() +
+            m_areaCache.GetNumBytes() +
+            m_relAreaCache.GetNumBytes();
+}
+
+void MapRenderer::SetCompactRenderData(bool enable)
+{
+    // the worker compacts prefetched render data; kept
+    // render data is restored whether or not it was
+    // compacted, so nothing needs to be rebuilt
+    std::unique_lock<std::mutex> lock(m_workerMutex);
+    bool droppedUpdate = waitForWorkerIdle(lock);
+    m_compactRenderData = enable;
+
+    if(droppedUpdate)
+    {   queueSceneUpdate();   }
+}
+
+bool MapRenderer::GetCompactRenderData()
+{   return m_compactRenderData;   }
+
+void MapRenderer::SetLODHysteresis(double bandFraction)
+{
+    // the worker reads the band while building an update
+    std::unique_lock<std::mutex> lock(m_workerMutex);
+    bool droppedUpdate = waitForWorkerIdle(lock);
+    m_lodHysteresis = std::max(bandFraction,0.0);
+
+    if(droppedUpdate)
+    {   queueSceneUpdate();   }
+}
+
+double MapRenderer::GetLODHysteresis()
+{   return m_lodHysteresis;   }
+
+void MapRenderer::GetLODHysteresisStats(LODHysteresisStats &stats)
+{
+    std::unique_lock<std::mutex> lock(m_workerMutex);
+    stats = m_lodStats;
+}
+
+void MapRenderer::GetScratchArenaStats(ScratchArenaStats &stats)
+{
+    std::unique_lock<std::mutex> lock(m_workerMutex);
+    stats = m_scratchStats;
+}
+
+void MapRenderer::GetSceneUpdateStats(SceneUpdateStats &stats)
+{
+    std::unique_lock<std::mutex> lock(m_workerMutex);
+    stats = m_updateStats;
+}
+
+void MapRenderer::GetMemoryStats(MemoryStats &stats)
+{
+    // the worker only reads scene render data, so
+    // nothing here changes unless it's changed by
+    // the calling thread
+    stats = MemoryStats();
+    stats.listDataSetStats.resize(m_listDataSets.size());
+
+    for(size_t i=0; i < m_listDataSets.size(); i++)
+    {
+        DataSet const * dataSet = m_listDataSets[i];
+        DataSetMemoryStats &dsStats = stats.listDataSetStats[i];
+        dsStats.dataSet = dataSet;
+
+        size_t numLods = dataSet->listNodeData.size();
+        dsStats.listLODUsage.resize(numLods);
+        for(size_t k=0; k < numLods; k++)   {
+            ObjectMemoryUsage &lodUsage = dsStats.listLODUsage[k];
+            calcMemoryUsage(dataSet->listNodeData[k],
+                            lodUsage.nodes,dsStats.mapTypeUsage);
+
+            calcMemoryUsage(dataSet->listWayData[k],
+                            lodUsage.ways,dsStats.mapTypeUsage);
+
+            calcMemoryUsage(dataSet->listAreaData[k],
+                            lodUsage.areas,dsStats.mapTypeUsage);
+
+            calcMemoryUsage(dataSet->listRelAreaData[k],
+                            lodUsage.relAreas,dsStats.mapTypeUsage);
+        }
+
+        calcMemoryUsage(dataSet->listNodeIds,dsStats.sceneIds.nodes);
+        calcMemoryUsage(dataSet->listWayIds,dsStats.sceneIds.ways);
+        calcMemoryUsage(dataSet->listAreaIds,dsStats.sceneIds.areas);
+        calcMemoryUsage(dataSet->listRelAreaIds,dsStats.sceneIds.relAreas);
+
+        for(size_t k=0; k < dataSet->listSharedNodes.size(); k++)   {
+            SharedNodeIndex const &sharedNodes = dataSet->listSharedNodes[k];
+            dsStats.sharedNodes.Add(sharedNodes.GetNumNodes(),
+                                    sharedNodes.GetNumBytes());
+        }
+
+        for(size_t k=0; k < dataSet->listStyleConfigs.size(); k++)
+        {   dsStats.styleConfigs.Add(1,dataSet->listStyleConfigs[k]->GetNumBytes());   }
+    }
+
+    stats.cache.nodes.Add(m_nodeCache.GetNumEntries(),m_nodeCache.GetNumBytes());
+    stats.cache.ways.Add(m_wayCache.GetNumEntries(),m_wayCache.GetNumBytes());
+    stats.cache.areas.Add(m_areaCache.GetNumEntries(),m_areaCache.GetNumBytes());
+    stats.cache.relAreas.Add(m_relAreaCache.GetNumEntries(),m_relAreaCache.GetNumBytes());
+
+    calcBackendMemoryUsage(stats.backend,stats.listBackendUsage);
+}
+
+void MapRenderer::SetTraceRecording(bool enable, size_t maxEventsPerThread)
+{
+    // recording is restarted while no other
+    // thread can be adding events
+    std::unique_lock<std::mutex> lock(m_workerMutex);
+    bool droppedUpdate = waitForWorkerIdle(lock);
+
+    if(enable)
+    {   m_trace.Start(maxEventsPerThread);   }
+    else
+    {   m_trace.Stop();   }
+
+    if(droppedUpdate)
+    {   queueSceneUpdate();   }
+}
+
+bool MapRenderer::GetTraceRecording()
+{   return m_trace.IsRecording();   }
+
+bool MapRenderer::WriteTraceFile(std::string const &path)
+{
+    std::vector<std::vector<TraceEvent> > listEventsByThread;
+    size_t numDropped = m_trace.GetEvents(listEventsByThread);
+
+    // events are written as 'complete' events with
+    // a start time and duration, and each thread is
+    // named with a metadata event
+    json_t * jEvents = json_array();
+    for(size_t t=0; t < listEventsByThread.size(); t++)
+    {
+        std::string threadName = "thread " + convIntToStr(t);
+        json_t * jArgs = json_object();
+        json_object_set_new(jArgs,"name",json_string(threadName.c_str()));
+
+        json_t * jThread = json_object();
+        json_object_set_new(jThread,"name",json_string("thread_name"));
+        json_object_set_new(jThread,"ph",json_string("M"));
+        json_object_set_new(jThread,"pid",json_integer(1));
+        json_object_set_new(jThread,"tid",json_integer(t));
+        json_object_set_new(jThread,"args",jArgs);
+        json_array_append_new(jEvents,jThread);
+
+        std::vector<TraceEvent> const &listEvents = listEventsByThread[t];
+        for(size_t i=0; i < listEvents.size(); i++)
+        {
+            json_t * jEvent = json_object();
+            json_object_set_new(jEvent,"name",json_string(listEvents[i].name));
+            json_object_set_new(jEvent,"cat",json_string(listEvents[i].category));
+            json_object_set_new(jEvent,"ph",json_string("X"));
+            json_object_set_new(jEvent,"ts",json_real(listEvents[i].startUs));
+            json_object_set_new(jEvent,"dur",json_real(listEvents[i].durationUs));
+            json_object_set_new(jEvent,"pid",json_integer(1));
+            json_object_set_new(jEvent,"tid",json_integer(t));
+            json_array_append_new(jEvents,jEvent);
+        }
+    }
+
+    json_t * jOther = json_object();
+    json_object_set_new(jOther,"droppedEvents",json_integer(numDropped));
+
+    json_t * jRoot = json_object();
+    json_object_set_new(jRoot,"traceEvents",jEvents);
+    json_object_set_new(jRoot,"displayTimeUnit",json_string("ms"));
+    json_object_set_new(jRoot,"otherData",jOther);
+
+    bool opOk = (json_dump_file(jRoot,path.c_str(),JSON_COMPACT) == 0);
+    json_decref(jRoot);
+
+    if(!opOk)   {
+        OSRWARN << "Could not write trace file " << path;
+        return false;
+    }
+
+    if(numDropped > 0)   {
+        OSRWARN << "Trace dropped " << numDropped
+               << " events (thread buffers were full)";
+    }
+    return true;
+}
+
+// ========================================================================== //
+// ========================================================================== //
+
+void MapRenderer::removeDataSet(DataSet *dataSet)
+{
+    std::vector<DataSet*>::iterator dsIt =
+            std::find(m_listDataSets.begin(),m_listDataSets.end(),dataSet);
+
+    if(dsIt == m_listDataSets.end())   {
+        OSRWARN << "RemoveDataSet: DataSet was never added";
+        return;
+    }
+
+    {
+        // the worker, the pending update and prefetch data
+        // all keep raw DataSet pointers, so they must let
+        // go of this one before the caller deletes it
+        std::unique_lock<std::mutex> lock(m_workerMutex);
+        waitForWorkerIdle(lock);
+
+        std::vector<PrefetchData>::iterator pfIt;
+        for(pfIt = m_listPrefetchData.begin();
+            pfIt != m_listPrefetchData.end();)
+        {
+            if(pfIt->dataSet == dataSet)
+            {   pfIt = m_listPrefetchData.erase(pfIt);   }
+            else
+            {   ++pfIt;   }
+        }
+
+        m_workerDataSets.erase(std::remove(m_workerDataSets.begin(),
+                                           m_workerDataSets.end(),dataSet),
+                               m_workerDataSets.end());
+
+        removeCachedRenderData(dataSet);
+        m_listDataSets.erase(dsIt);
+
+        // the scene is cleared before the DataSet's render
+        // data; rebuildAllData adds the remaining DataSets
+        // back (and does nothing if there are none left)
+        removeAllFromScene();
+        m_listLODRangesActive.clear();
+
+        // the render data points to the DataSet's style
+        // data, which was created by (and belongs to) us
+        dataSet->listNodeData.clear();
+        dataSet->listWayData.clear();
+        dataSet->listAreaData.clear();
+        dataSet->listRelWayData.clear();
+        dataSet->listRelAreaData.clear();
+        dataSet->listNodeIds.clear();
+        dataSet->listWayIds.clear();
+        dataSet->listAreaIds.clear();
+        dataSet->listRelAreaIds.clear();
+        dataSet->listSharedNodes.clear();
+        dataSet->listQueryBounds.clear();
+
+        for(size_t i=0; i < dataSet->listStyleConfigs.size(); i++)
+        {   delete dataSet->listStyleConfigs[i];   }
+        dataSet->listStyleConfigs.clear();
+    }
+
+    rebuildAllData();
+}
+
+void MapRenderer::rebuildAllData()
+{
+    if((m_listDataSets.size() < 1) || (m_stylePath.empty()))
+    {   return;   }
+
+    // the worker can't be building an update while
+    // DataSet render and style data is replaced
+    std::unique_lock<std::mutex> lock(m_workerMutex);
+    waitForWorkerIdle(lock);
+
+    // clear implemented scene
+    removeCachedRenderData(NULL);
+    removeAllFromScene();
+    m_listLODRangesActive.clear();
+    m_listPrefetchData.clear();
+
+    OSRDEBUG << "===================================";
     std::vector<DataSet*>::iterator dsIt;
-    for(dsIt = listDataSets.begin();
-        dsIt != listDataSets.end(); ++dsIt)
+    std::vector<DataSet const *> listKDataSetPtrs;
+    for(dsIt = m_listDataSets.begin();
+        dsIt != m_listDataSets.end(); ++dsIt)
     {
-        // get style configs belonging to this DataSet
         DataSet * dataSet = (*dsIt);
+
+        // clear existing render data
+        dataSet->listNodeData.clear();
+        dataSet->listWayData.clear();
+        dataSet->listAreaData.clear();
+        dataSet->listRelWayData.clear();
+        dataSet->listRelAreaData.clear();
+        dataSet->listNodeIds.clear();
+        dataSet->listWayIds.clear();
+        dataSet->listAreaIds.clear();
+        dataSet->listRelAreaIds.clear();
+        dataSet->listSharedNodes.clear();
+        dataSet->listQueryBounds.clear();
+
+        // remove old style data
+        for(size_t i=0; i < dataSet->listStyleConfigs.size(); i++)
+        {   delete dataSet->listStyleConfigs[i];   }
+        dataSet->listStyleConfigs.clear();
+
+        // add new style data
+        bool opOk = false;
+        RenderStyleReader styleReader(m_stylePath,
+            dataSet->GetTypeConfig(),
+            dataSet->listStyleConfigs,opOk);
+
+        if(!opOk)   {
+            OSRERROR << "Could not set style info";
+            return;
+        }
+
+        size_t numLods = dataSet->listStyleConfigs.size();
+        dataSet->listNodeData.resize(numLods);
+        dataSet->listWayData.resize(numLods);
+        dataSet->listAreaData.resize(numLods);
+        dataSet->listRelWayData.resize(numLods);
+        dataSet->listRelAreaData.resize(numLods);
+        dataSet->listSharedNodes.resize(numLods);
+
+        for(size_t i=0; i < numLods; i++)   {
+            // TODO: empirically determine reserve count
+            //       (or if we even need them at all)
+            dataSet->listNodeData[i].reserve(50);
+            dataSet->listWayData[i].reserve(150);
+            dataSet->listAreaData[i].reserve(100);
+            dataSet->listRelWayData[i].reserve(5);
+            dataSet->listRelAreaData[i].reserve(25);
+        }
+
+        // save list for virtual implementation
+        listKDataSetPtrs.push_back(dataSet);
+    }
+
+    rebuildStyleData(listKDataSetPtrs);
+    updateSceneContents(m_listDataSets);
+
+    OSRDEBUG << "===================================";
+}
+
+void MapRenderer::updateSceneContents(std::vector<DataSet*> &listDataSets)
+{
+    OSRTRACE("updateSceneContents","scene");
+    SceneUpdate sceneUpdate;
+    sceneUpdate.generation = m_sceneGeneration;
+
+    CommitBudget budget;
+    if(buildSceneUpdate(m_camera,listDataSets,m_listLODRangesActive,sceneUpdate))
+    {   applySceneUpdate(sceneUpdate,budget);   }
+}
+
+bool MapRenderer::buildSceneUpdate(Camera const &cam,
+                                   std::vector<DataSet*> const &listDataSets,
+                                   std::vector<bool> const &listLODRangesWereActive,
+                                   SceneUpdate &sceneUpdate)
+{
+    OSRTRACE("buildSceneUpdate","scene");
+    if(listDataSets.size() < 1)
+    {   return false;   }
+
+    SceneUpdateStats &stats = sceneUpdate.stats;
+    stats.generation = sceneUpdate.generation;
+    std::chrono::steady_clock::time_point tBuild =
+            std::chrono::steady_clock::now();
+
+    for(size_t i=0; i < m_listScratchArenas.size(); i++)
+    {   m_listScratchArenas[i]->Reset();   }
+
+    ScratchArena &scratch = *(m_listScratchArenas[0]);
+
+    // get query bounds for each active LOD range; these
+    // only depend on the camera so all DataSets share them
+    // (range data is common amongst DataSet style configs)
+    std::vector<bool> listLODRangesActive;
+    ListGeoBoundsByLod listBoundsByLod;
+    if(!calcQueryBounds(cam,listDataSets[0]->listStyleConfigs,
+                        listLODRangesWereActive,listLODRangesActive,
+                        listBoundsByLod,sceneUpdate.lodStats,scratch))
+    {   return false;   }
+
+    stats.viewExtentsMs = calcElapsedMs(tBuild);
+
+    sceneUpdate.camera = cam;
+    sceneUpdate.listLODRangesActive = listLODRangesActive;
+    sceneUpdate.listDataSetUpdates.resize(listDataSets.size());
+
+    size_t num_lod_ranges = listBoundsByLod.size();
+    stats.listLODStats.resize(num_lod_ranges);
+    for(size_t i=0; i < num_lod_ranges; i++)
+    {   stats.listLODStats[i].isActive = listLODRangesActive[i];   }
+
+    // queue a query for each DataSet, active LOD range and GeoBounds
+    std::vector<ObjectQuery> listObjQueries;
+    std::vector<std::vector<bool> > listLodIsDelta(listDataSets.size());
+    std::vector<std::vector<bool> > listLodUsesPrefetch(listDataSets.size());
+    std::vector<PrefetchData const *> listPrefetch(listDataSets.size());
+
+    for(size_t d=0; d < listDataSets.size(); d++)
+    {
+        DataSet * dataSet = listDataSets[d];
+
+        // regions that were prefetched don't need to be queried
+        PrefetchData const * prefetch = findPrefetchData(dataSet);
+        if(prefetch && prefetch->listBounds.size() != num_lod_ranges)
+        {   prefetch = NULL;   }
+
+        listPrefetch[d] = prefetch;
+        listLodUsesPrefetch[d].resize(num_lod_ranges,false);
+
+        // if the DataSet's scene data was queried for a
+        // previous camera, only query the regions that
+        // weren't part of that query
+        bool canQueryDelta = m_incrementalUpdates &&
+            (dataSet->listQueryBounds.size() == num_lod_ranges);
+
+        listLodIsDelta[d].resize(num_lod_ranges,false);
+
+        for(size_t i=0; i < num_lod_ranges; i++)
+        {
+            if(!listLODRangesActive[i])
+            {   continue;   }
+
+            std::vector<GeoBounds> listQueryBounds = listBoundsByLod[i];
+            if(canQueryDelta)
+            {
+                std::vector<GeoBounds> listDeltaBounds;
+                calcGeoBoundsDifference(listBoundsByLod[i],
+                                        dataSet->listQueryBounds[i],
+                                        listDeltaBounds);
+
+                // checking every object already in the scene
+                // isn't worth it if most of the view is new
+                if(calcGeoBoundsArea(listDeltaBounds) <
+                   calcGeoBoundsArea(listBoundsByLod[i])*0.5)
+                {
+                    listQueryBounds = listDeltaBounds;
+                    listLodIsDelta[d][i] = true;
+                }
+            }
+
+            if(prefetch && !prefetch->listBounds[i].empty())
+            {
+                std::vector<GeoBounds> listRemBounds;
+                calcGeoBoundsDifference(listQueryBounds,
+                                        prefetch->listBounds[i],
+                                        listRemBounds);
+
+                if(calcGeoBoundsArea(listRemBounds) <
+                   calcGeoBoundsArea(listQueryBounds))
+                {
+                    listQueryBounds = listRemBounds;
+                    listLodUsesPrefetch[d][i] = true;
+                }
+            }
+
+            osmscout::TypeSet const &typeSet =
+                    dataSet->listStyleConfigs[i]->GetActiveTypeSet();
+
+            for(size_t b=0; b < listQueryBounds.size(); b++)
+            {
+                ObjectQuery objQuery;
+                objQuery.dataSet = dataSet;
+                objQuery.dsIdx = d;
+                objQuery.lod = i;
+                objQuery.listBounds.push_back(listQueryBounds[b]);
+                objQuery.typeSet = typeSet;
+                objQuery.opOk = false;
+                objQuery.queryMs = 0;
+                listObjQueries.push_back(objQuery);
+            }
+            stats.listLODStats[i].numQueries += listQueryBounds.size();
+        }
+    }
+
+    std::chrono::steady_clock::time_point tPhase =
+            std::chrono::steady_clock::now();
+
+    runObjectQueries(listObjQueries,sceneUpdate.generation);
+    stats.queryMs = calcElapsedMs(tPhase);
+
+    if(isSceneUpdateCancelled(sceneUpdate.generation))
+    {   return false;   }
+
+    // for specified DataSets
+    size_t q=0;
+    for(size_t d=0; d < listDataSets.size(); d++)
+    {
+        // get style configs belonging to this DataSet
+        DataSet * dataSet = listDataSets[d];
         std::vector<RenderStyleConfig*> &listStyleConfigs =
                 dataSet->listStyleConfigs;
 
         // create lists to hold database results by lod
-        ListNodeRefsByLod    listNodeRefsByLod(num_lod_ranges);
-        ListWayRefsByLod     listWayRefsByLod(num_lod_ranges);
-        ListAreaRefsByLod    listAreaRefsByLod(num_lod_ranges);
-        ListRelWayRefsByLod  listRelWayRefsByLod(num_lod_ranges);
-        ListRelAreaRefsByLod listRelAreaRefsByLod(num_lod_ranges);
+        DataSetUpdate &dsUpdate = sceneUpdate.listDataSetUpdates[d];
+        dsUpdate.dataSet = dataSet;
+        bool allQueriesOk = true;
+
+        ListNodeRefsByLod    &listNodeRefsByLod = dsUpdate.listNodeRefs;
+        ListWayRefsByLod     &listWayRefsByLod = dsUpdate.listWayRefs;
+        ListAreaRefsByLod    &listAreaRefsByLod = dsUpdate.listAreaRefs;
+        ListRelAreaRefsByLod &listRelAreaRefsByLod = dsUpdate.listRelAreaRefs;
+
+        listNodeRefsByLod.resize(num_lod_ranges);
+        listWayRefsByLod.resize(num_lod_ranges);
+        listAreaRefsByLod.resize(num_lod_ranges);
+        listRelAreaRefsByLod.resize(num_lod_ranges);
 
         // create sets to hold database results for all lods
-        TYPE_UNORDERED_SET<osmscout::Id> setNodesAllLods(300);
-        TYPE_UNORDERED_SET<osmscout::Id> setWaysAllLods(600);
-        TYPE_UNORDERED_SET<osmscout::Id> setAreasAllLods(300);
-        TYPE_UNORDERED_SET<osmscout::Id> setRelWaysAllLods(50);
-        TYPE_UNORDERED_SET<osmscout::Id> setRelAreasAllLods(100);
+        IdSet setNodesAllLods(300);
+        IdSet setWaysAllLods(600);
+        IdSet setAreasAllLods(300);
+        IdSet setRelWaysAllLods(50);
+        IdSet setRelAreasAllLods(100);
 
         for(size_t i=0; i < num_lod_ranges; i++)
         {
             if(listLODRangesActive[i])
             {
-                // create bounds for active LOD range
-                Vec3 rangeTL,rangeTR,rangeBR,rangeBL;
-                calcDistBoundingBox(camLLA,listLODRanges[i].second,
-                                    rangeTL,rangeTR,rangeBR,rangeBL);
-
-                std::vector<Vec3> listVxB1(4);
-                listVxB1[0] = m_camera.exTL;
-                listVxB1[1] = m_camera.exTR;
-                listVxB1[2] = m_camera.exBR;
-                listVxB1[3] = m_camera.exBL;
-
-                std::vector<Vec3> listVxB2(4);
-                listVxB2[0] = rangeTL;
-                listVxB2[1] = rangeTR;
-                listVxB2[2] = rangeBR;
-                listVxB2[3] = rangeBL;
-
-                // find overlap between camera extents and LOD range
-                std::vector<Vec3> listVxROI; Vec3 vxROICentroid;
-                if(!calcBoundsIntersection(listVxB1,listVxB2,listVxROI,vxROICentroid))
-                {   OSRDEBUG << "WARN: Could not find LOD Overlap";  return;   }
-
-                if(listVxROI.size() < 3)
-                {   OSRDEBUG << "WARN: Invalid LOD Overlap";  return;   }
-
-                // get minimum enclosing bounds in lon/lat
-                // note: for the point within the bounds, we use
-                // the centroid of a triangle from its poly
-
-                std::vector<GeoBounds> listQueries;
-                calcEnclosingGeoBounds(listVxROI,listQueries);
-
-                // get objects from database
-                osmscout::TypeSet typeSet;
-                listStyleConfigs[i]->GetActiveTypes(typeSet);
-
-                std::vector<osmscout::NodeRef>        listNodeRefs;
-                std::vector<osmscout::WayRef>         listWayRefs;
-                std::vector<osmscout::WayRef>         listAreaRefs;
-                std::vector<osmscout::RelationRef>    listRelWayRefs;
-                std::vector<osmscout::RelationRef>    listRelAreaRefs;
-
-                if(dataSet->GetObjects(listQueries,
-                                       typeSet,
-                                       listNodeRefs,
-                                       listWayRefs,
-                                       listAreaRefs,
-                                       listRelWayRefs,
-                                       listRelAreaRefs))
+                SceneLODStats &lodStats = stats.listLODStats[i];
+                tPhase = std::chrono::steady_clock::now();
+
+                // merge query results for this LOD in the order
+                // they were queued so the merge is deterministic
+                std::vector<GeoBounds> const &listQueries = listBoundsByLod[i];
+
+                ScratchScope scope(scratch);
+                std::vector<osmscout::NodeRef> &listNodeRefs =
+                        scratch.Take<osmscout::NodeRef>();
+                std::vector<osmscout::WayRef> &listWayRefs =
+                        scratch.Take<osmscout::WayRef>();
+                std::vector<osmscout::WayRef> &listAreaRefs =
+                        scratch.Take<osmscout::WayRef>();
+                std::vector<osmscout::RelationRef> &listRelWayRefs =
+                        scratch.Take<osmscout::RelationRef>();
+                std::vector<osmscout::RelationRef> &listRelAreaRefs =
+                        scratch.Take<osmscout::RelationRef>();
+
+                bool opOk = true;
+                for(; q < listObjQueries.size() &&
+                      listObjQueries[q].dsIdx == d &&
+                      listObjQueries[q].lod == i; q++)
+                {
+                    ObjectQuery &objQuery = listObjQueries[q];
+                    opOk = opOk && objQuery.opOk;
+                    allQueriesOk = allQueriesOk && objQuery.opOk;
+                    lodStats.queryMs += objQuery.queryMs;
+
+                    listNodeRefs.insert(listNodeRefs.end(),
+                        objQuery.listNodeRefs.begin(),objQuery.listNodeRefs.end());
+
+                    listWayRefs.insert(listWayRefs.end(),
+                        objQuery.listWayRefs.begin(),objQuery.listWayRefs.end());
+
+                    listAreaRefs.insert(listAreaRefs.end(),
+                        objQuery.listAreaRefs.begin(),objQuery.listAreaRefs.end());
+
+                    listRelWayRefs.insert(listRelWayRefs.end(),
+                        objQuery.listRelWayRefs.begin(),objQuery.listRelWayRefs.end());
+
+                    listRelAreaRefs.insert(listRelAreaRefs.end(),
+                        objQuery.listRelAreaRefs.begin(),objQuery.listRelAreaRefs.end());
+                }
+
+                if(opOk)
                 {
                     // we retrieve objects from a high LOD (close up)
                     // to a lower LOD (further away)
@@ -445,30 +1283,22 @@ void MapRenderer::updateSceneContents(std::vector<DataSet*> &listDataSets)
                     // areas should be kept -- so even if the db query returns certain
                     // primitives, we only use them if they are explicitly specified
 
+                    // note: libosmscout returns a lot of objects well beyond the
+                    // specified bounds (it works with index cells), so we check
+                    // if objects are in our ROI with the same tests keepObjects
+                    // uses; otherwise an incremental update would drop objects
+                    // that a full query of the same view keeps
+
                     // [nodes]
                     std::vector<osmscout::NodeRef>::iterator nodeIt;
                     for(nodeIt = listNodeRefs.begin();
                         nodeIt != listNodeRefs.end(); ++nodeIt)
                     {
-                        if(listStyleConfigs[i]->GetNodeTypeIsValid((*nodeIt)->GetType()))
+                        if(listStyleConfigs[i]->GetNodeTypeIsValid((*nodeIt)->GetType()) &&
+                           calcPointInGeoBounds((*nodeIt)->GetLat(),(*nodeIt)->GetLon(),listQueries))
                         {
-                            // note: libosmscout returns a lot of nodes well beyond the
-                            // specified bounds, so we check if nodes are in our ROI
-
-                            double myLat = (*nodeIt)->GetLat();                   // TODO FIXME
-                            double myLon = (*nodeIt)->GetLon();                   // TODO FIXME
-
-                            for(size_t b=0; b < listQueries.size(); b++)
-                            {
-                                if(myLat > listQueries[b].minLat &&
-                                   myLat < listQueries[b].maxLat &&
-                                   myLon > listQueries[b].minLon &&
-                                   myLon < listQueries[b].maxLon)
-                                {
-                                    if(setNodesAllLods.insert((*nodeIt)->GetId()).second)   {
-                                        listNodeRefsByLod[i].insert(std::make_pair((*nodeIt)->GetId(),*nodeIt));
-                                    }
-                                }
+                            if(setNodesAllLods.insert((*nodeIt)->GetId()).second)   {
+                                listNodeRefsByLod[i].insert(std::make_pair((*nodeIt)->GetId(),*nodeIt));
                             }
                         }
                     }
@@ -478,7 +1308,8 @@ void MapRenderer::updateSceneContents(std::vector<DataSet*> &listDataSets)
                     for(wayIt = listWayRefs.begin();
                         wayIt != listWayRefs.end(); ++wayIt)
                     {
-                        if(listStyleConfigs[i]->GetWayTypeIsValid((*wayIt)->GetType()))
+                        if(listStyleConfigs[i]->GetWayTypeIsValid((*wayIt)->GetType()) &&
+                           calcPointsInGeoBounds((*wayIt)->nodes,listQueries))
                         {
                             if(setWaysAllLods.insert((*wayIt)->GetId()).second)   {
                                 listWayRefsByLod[i].insert(std::make_pair((*wayIt)->GetId(),*wayIt));
@@ -491,7 +1322,8 @@ void MapRenderer::updateSceneContents(std::vector<DataSet*> &listDataSets)
                     for(areaIt = listAreaRefs.begin();
                         areaIt != listAreaRefs.end(); ++areaIt)
                     {
-                        if(listStyleConfigs[i]->GetAreaTypeIsValid((*areaIt)->GetType()))
+                        if(listStyleConfigs[i]->GetAreaTypeIsValid((*areaIt)->GetType()) &&
+                           calcPointsInGeoBounds((*areaIt)->nodes,listQueries))
                         {
                             if(setAreasAllLods.insert((*areaIt)->GetId()).second)   {
                                 listAreaRefsByLod[i].insert(std::make_pair((*areaIt)->GetId(),*areaIt));
@@ -507,54 +1339,494 @@ void MapRenderer::updateSceneContents(std::vector<DataSet*> &listDataSets)
                     for(relAreaIt = listRelAreaRefs.begin();
                         relAreaIt != listRelAreaRefs.end(); ++relAreaIt)
                     {
-                        if(listStyleConfigs[i]->GetAreaTypeIsValid((*relAreaIt)->GetType()))
+                        osmscout::RelationRef const &relRef = *relAreaIt;
+                        if(!listStyleConfigs[i]->GetAreaTypeIsValid(relRef->GetType()))
+                        {   continue;   }
+
+                        for(size_t r=0; r < relRef->roles.size(); r++)
                         {
-                            if(setRelAreasAllLods.insert((*relAreaIt)->GetId()).second)   {
-                                listRelAreaRefsByLod[i].insert(std::make_pair((*relAreaIt)->GetId(),*relAreaIt));
+                            if(calcPointsInGeoBounds(relRef->roles[r].nodes,listQueries))   {
+                                if(setRelAreasAllLods.insert(relRef->GetId()).second)   {
+                                    listRelAreaRefsByLod[i].insert(std::make_pair(relRef->GetId(),relRef));
+                                }
+                                break;
                             }
                         }
                     }
+
+                    // only the newly exposed regions were queried,
+                    // so keep objects from the rest of the view
+                    if(listLodIsDelta[d][i])   {
+                        keepObjects(*dataSet,dataSet,i,listQueries,dsUpdate,
+                                    setNodesAllLods,setWaysAllLods,
+                                    setAreasAllLods,setRelAreasAllLods);
+                    }
+
+                    // add objects from prefetched regions
+                    if(listLodUsesPrefetch[d][i])   {
+                        keepObjects(*listPrefetch[d],dataSet,i,listQueries,dsUpdate,
+                                    setNodesAllLods,setWaysAllLods,
+                                    setAreasAllLods,setRelAreasAllLods);
+                    }
                 }
+
+                lodStats.numNodes += listNodeRefsByLod[i].size();
+                lodStats.numWays += listWayRefsByLod[i].size();
+                lodStats.numAreas += listAreaRefsByLod[i].size();
+                lodStats.numRelAreas += listRelAreaRefsByLod[i].size();
+
+                double filterMs = calcElapsedMs(tPhase);
+                lodStats.filterMs += filterMs;
+                stats.filterMs += filterMs;
             }
         }   // for each LOD
 
-        // update render data
-        updateNodeRenderData(dataSet,listNodeRefsByLod);
-        updateWayRenderData(dataSet,listWayRefsByLod);
-        updateAreaRenderData(dataSet,listAreaRefsByLod);
-        updateRelAreaRenderData(dataSet,listRelAreaRefsByLod);
+        // the next update can only query the difference
+        // if everything in view was queried successfully
+        if(allQueriesOk)
+        {   dsUpdate.listQueryBounds = listBoundsByLod;   }
+
+        // diff the objects in the new view against
+        // the objects in the scene with a sorted merge
+        tPhase = std::chrono::steady_clock::now();
+        BuildSortedIds(listNodeRefsByLod,dsUpdate.listNodeIds);
+        BuildSortedIds(listWayRefsByLod,dsUpdate.listWayIds);
+        BuildSortedIds(listAreaRefsByLod,dsUpdate.listAreaIds);
+        BuildSortedIds(listRelAreaRefsByLod,dsUpdate.listRelAreaIds);
+
+        CalcIdDiff(dataSet->listNodeIds,dsUpdate.listNodeIds,dsUpdate.nodeDiff);
+        CalcIdDiff(dataSet->listWayIds,dsUpdate.listWayIds,dsUpdate.wayDiff);
+        CalcIdDiff(dataSet->listAreaIds,dsUpdate.listAreaIds,dsUpdate.areaDiff);
+        CalcIdDiff(dataSet->listRelAreaIds,dsUpdate.listRelAreaIds,dsUpdate.relAreaDiff);
+
+        // queue up objects that aren't in the scene
+        // yet or that are shown at a different lod
+        queueNodeAdds(listNodeRefsByLod,dsUpdate.nodeDiff,dsUpdate.listNodeAdds);
+        queueWayAdds(listWayRefsByLod,dsUpdate.wayDiff,dsUpdate.listWayAdds);
+        queueAreaAdds(listAreaRefsByLod,dsUpdate.areaDiff,dsUpdate.listAreaAdds);
+        queueRelAreaAdds(listRelAreaRefsByLod,dsUpdate.relAreaDiff,dsUpdate.listRelAreaAdds);
+        orderQueuedAdds(cam,dsUpdate);
+        stats.diffMs += calcElapsedMs(tPhase);
 
     }   // for each DataSet
 
-    this->doneUpdatingWays();
-    this->doneUpdatingAreas();
-    this->doneUpdatingRelAreas();
+    if(isSceneUpdateCancelled(sceneUpdate.generation))
+    {   return false;   }
 
-    // update current data extents
-    m_data_exTL = m_camera.exTL;
-    m_data_exTR = m_camera.exTR;
-    m_data_exBL = m_camera.exBL;
-    m_data_exBR = m_camera.exBR;
+    // generate their render data
+    tPhase = std::chrono::steady_clock::now();
+    bool opOk = genSceneUpdateRenderData(sceneUpdate,listPrefetch,true);
+    stats.genMs = calcElapsedMs(tPhase);
+
+    for(size_t i=0; i < m_listScratchArenas.size(); i++)
+    {   sceneUpdate.scratchStats.Add(m_listScratchArenas[i]->GetStats());   }
+
+    stats.buildMs = calcElapsedMs(tBuild);
+    return opOk;
 }
 
-void MapRenderer::updateSceneBasedOnCamera()
+bool MapRenderer::calcQueryBounds(Camera const &cam,
+                                  std::vector<RenderStyleConfig*> const &listStyleConfigs,
+                                  std::vector<bool> const &listLODRangesWereActive,
+                                  std::vector<bool> &listLODRangesActive,
+                                  ListGeoBoundsByLod &listBoundsByLod,
+                                  LODHysteresisStats &lodStats,
+                                  ScratchArena &scratch)
 {
-    OSRDEBUG << "INFO: [Updating Scene Contents...]";
-    updateSceneContents(m_listDataSets);
+    // calculate the minimum and maximum distance to
+    // cam.eye within the available lat/lon bounds
+    double minViewDist,maxViewDist;
+    this->calcCamViewDistances(cam,minViewDist,maxViewDist);
 
-    /*
-    double oldArea =
-            calcTriangleArea(m_data_exTL,m_data_exTR,m_data_exBR) +
-            calcTriangleArea(m_data_exTL,m_data_exBL,m_data_exBR);
+    OSRDEBUG << "### Camera Min View Dist: " << minViewDist;
+    OSRDEBUG << "### Camera Max View Dist: " << maxViewDist;
 
-    double newArea =
-            calcTriangleArea(m_camera.exTL,m_camera.exTR,m_camera.exBR) +
-            calcTriangleArea(m_camera.exTL,m_camera.exBL,m_camera.exBR);
+    // use the min and max distance between cam.eye
+    // and the view bounds to set active LOD ranges
 
-    // calc overlap
-    std::vector<Vec3> listVxPoly1(4);
-    listVxPoly1[0] = m_data_exTL;
-    listVxPoly1[1] = m_data_exTR;
+    size_t numLodRanges = listStyleConfigs.size();
+    listLODRangesActive.resize(numLodRanges);
+    std::vector<std::pair<double,double> > listLODRanges(numLodRanges);
+
+    // changes (and hysteresis) only apply if we
+    // know which ranges are active in the scene
+    bool hasWereActive = (listLODRangesWereActive.size() == numLodRanges);
+
+    // ranges that are only active because of hysteresis
+    std::vector<bool> listLODRangesHeld(numLodRanges,false);
+
+    for(size_t i=0; i < numLodRanges; i++)
+    {
+        std::pair<double,double> lodRange;
+        lodRange.first = listStyleConfigs[i]->GetMinDistance();
+        lodRange.second = listStyleConfigs[i]->GetMaxDistance();
+        listLODRanges[i] = lodRange;
+
+        // if the min-max distance range overlaps with
+        // lodRange, set the range as active
+        if(lodRange.second < minViewDist || lodRange.first > maxViewDist)
+        {   listLODRangesActive[i] = false;   }
+        else
+        {   listLODRangesActive[i] = true;   }
+
+        if(!hasWereActive ||
+           listLODRangesActive[i] == listLODRangesWereActive[i])
+        {   continue;   }
+
+        // a range has to be band further outside (or inside)
+        // the view distances before it changes state
+        double band = (lodRange.second-lodRange.first)*m_lodHysteresis;
+        if(listLODRangesWereActive[i])
+        {
+            if(lodRange.second+band < minViewDist ||
+               lodRange.first-band > maxViewDist)
+            {   lodStats.numDeactivations++;   }
+            else   {
+                listLODRangesActive[i] = true;
+                listLODRangesHeld[i] = true;
+                listLODRanges[i].second += band;
+                lodStats.numDeactivationsHeld++;
+            }
+        }
+        else
+        {
+            if(lodRange.second-band < minViewDist ||
+               lodRange.first+band > maxViewDist)   {
+                listLODRangesActive[i] = false;
+                lodStats.numActivationsHeld++;
+            }
+            else
+            {   lodStats.numActivations++;   }
+        }
+    }
+
+    // check if at least one valid style
+    bool hasValidStyle = false;
+    for(size_t i=0; i < listLODRangesActive.size(); i++)
+    {
+        if(listLODRangesActive[i])
+        {   hasValidStyle = true;   break;   }
+    }
+
+    if(!hasValidStyle)
+    {
+        OSRWARN << "No valid style data found";
+        return false;
+    }
+
+    PointLLA camLLA = convECEFToLLA(cam.eye);
+    size_t num_lod_ranges = listLODRanges.size();
+
+    listBoundsByLod.clear();
+    listBoundsByLod.resize(num_lod_ranges);
+    for(size_t i=0; i < num_lod_ranges; i++)
+    {
+        if(listLODRangesActive[i])
+        {
+            // create bounds for active LOD range
+            Vec3 rangeTL,rangeTR,rangeBR,rangeBL;
+            calcDistBoundingBox(camLLA,listLODRanges[i].second,
+                                rangeTL,rangeTR,rangeBR,rangeBL);
+
+            ScratchScope scope(scratch);
+            std::vector<Vec3> &listVxB1 = scratch.Take<Vec3>();
+            listVxB1.resize(4);
+            listVxB1[0] = cam.exTL;
+            listVxB1[1] = cam.exTR;
+            listVxB1[2] = cam.exBR;
+            listVxB1[3] = cam.exBL;
+
+            std::vector<Vec3> &listVxB2 = scratch.Take<Vec3>();
+            listVxB2.resize(4);
+            listVxB2[0] = rangeTL;
+            listVxB2[1] = rangeTR;
+            listVxB2[2] = rangeBR;
+            listVxB2[3] = rangeBL;
+
+            // find overlap between camera extents and LOD range
+            std::vector<Vec3> &listVxROI = scratch.Take<Vec3>();
+            Vec3 vxROICentroid;
+            bool foundOverlap =
+                calcBoundsIntersection(cam.eye,listVxB1,listVxB2,
+                                       listVxROI,vxROICentroid,scratch) &&
+                (listVxROI.size() >= 3);
+
+            // a range held by hysteresis may be just
+            // outside of the view, so it's dropped
+            if(!foundOverlap && listLODRangesHeld[i])   {
+                listLODRangesActive[i] = false;
+                lodStats.numDeactivationsHeld--;
+                lodStats.numDeactivations++;
+                continue;
+            }
+
+            if(!foundOverlap)
+            {   OSRWARN << "Could not find LOD Overlap";  return false;   }
+
+            // get minimum enclosing bounds in lon/lat
+            // note: for the point within the bounds, we use
+            // the centroid of a triangle from its poly
+            calcEnclosingGeoBounds(cam.eye,listVxROI,listBoundsByLod[i],scratch);
+        }
+    }
+
+
+    return true;
+}
+
+void MapRenderer::runObjectQueries(std::vector<ObjectQuery> &listObjQueries,
+                                   size_t generation)
+{
+    // each query is a separate task if its DataSet can be
+    // queried concurrently, otherwise all queries with the
+    // same source are run one after another in one task
+    std::vector<std::vector<size_t> > listQueryTasks;
+    std::map<void const *,size_t> listTasksBySource;
+
+    for(size_t k=0; k < listObjQueries.size(); k++)
+    {
+        DataSet * dataSet = listObjQueries[k].dataSet;
+
+        size_t taskIdx = listQueryTasks.size();
+        if(!dataSet->GetObjectsIsReentrant())
+        {
+            std::pair<std::map<void const *,size_t>::iterator,bool> insResult =
+                listTasksBySource.insert(std::make_pair(dataSet->GetQuerySource(),taskIdx));
+
+            if(!insResult.second)
+            {   taskIdx = insResult.first->second;   }
+        }
+
+        if(taskIdx == listQueryTasks.size())
+        {   listQueryTasks.push_back(std::vector<size_t>());   }
+
+        listQueryTasks[taskIdx].push_back(k);
+    }
+
+    // get objects from database
+    m_taskPool.RunTasks(listQueryTasks.size(),[&](size_t t)
+    {
+        std::vector<size_t> const &listTaskQueries = listQueryTasks[t];
+        for(size_t k=0; k < listTaskQueries.size(); k++)
+        {
+            if(isSceneUpdateCancelled(generation))
+            {   return;   }
+
+            OSRTRACE("DataSet::GetObjects","query");
+            std::chrono::steady_clock::time_point tStart =
+                    std::chrono::steady_clock::now();
+
+            ObjectQuery &objQuery = listObjQueries[listTaskQueries[k]];
+            objQuery.opOk = objQuery.dataSet->GetObjects(objQuery.listBounds,
+                                                         objQuery.typeSet,
+                                                         objQuery.listNodeRefs,
+                                                         objQuery.listWayRefs,
+                                                         objQuery.listAreaRefs,
+                                                         objQuery.listRelWayRefs,
+                                                         objQuery.listRelAreaRefs);
+            objQuery.queryMs = calcElapsedMs(tStart);
+        }
+    });
+}
+
+template <typename ObjectSource>
+void MapRenderer::keepObjects(ObjectSource const &objSource,
+                              DataSet *dataSet,size_t lod,
+                              std::vector<GeoBounds> const &listBounds,
+                              DataSetUpdate &dsUpdate,
+                              IdSet &setNodesAllLods,
+                              IdSet &setWaysAllLods,
+                              IdSet &setAreasAllLods,
+                              IdSet &setRelAreasAllLods)
+{
+    RenderStyleConfig const * renderStyle = dataSet->listStyleConfigs[lod];
+
+    // objects are checked at every lod so that objects
+    // leaving a closer lod's bounds can move to this one
+    for(size_t k=0; k < objSource.listNodeData.size(); k++)
+    {
+        // [nodes]
+        IdMap<NodeRenderData>::const_iterator nodeIt;
+        for(nodeIt = objSource.listNodeData[k].begin();
+            nodeIt != objSource.listNodeData[k].end(); ++nodeIt)
+        {
+            osmscout::NodeRef const &nodeRef = nodeIt->second.nodeRef;
+            if(setNodesAllLods.count(nodeIt->first) != 0 ||
+               !renderStyle->GetNodeTypeIsValid(nodeRef->GetType()))
+            {   continue;   }
+
+            if(calcPointInGeoBounds(nodeRef->GetLat(),nodeRef->GetLon(),listBounds))   {
+                setNodesAllLods.insert(nodeIt->first);
+                dsUpdate.listNodeRefs[lod].insert(std::make_pair(nodeIt->first,nodeRef));
+            }
+        }
+
+        // [ways]
+        IdMap<WayRenderData>::const_iterator wayIt;
+        for(wayIt = objSource.listWayData[k].begin();
+            wayIt != objSource.listWayData[k].end(); ++wayIt)
+        {
+            osmscout::WayRef const &wayRef = wayIt->second.wayRef;
+            if(setWaysAllLods.count(wayIt->first) != 0 ||
+               !renderStyle->GetWayTypeIsValid(wayRef->GetType()))
+            {   continue;   }
+
+            if(calcPointsInGeoBounds(wayRef->nodes,listBounds))   {
+                setWaysAllLods.insert(wayIt->first);
+                dsUpdate.listWayRefs[lod].insert(std::make_pair(wayIt->first,wayRef));
+            }
+        }
+
+        // [areas]
+        IdMap<AreaRenderData>::const_iterator areaIt;
+        for(areaIt = objSource.listAreaData[k].begin();
+            areaIt != objSource.listAreaData[k].end(); ++areaIt)
+        {
+            osmscout::WayRef const &areaRef = areaIt->second.areaRef;
+            if(setAreasAllLods.count(areaIt->first) != 0 ||
+               !renderStyle->GetAreaTypeIsValid(areaRef->GetType()))
+            {   continue;   }
+
+            if(calcPointsInGeoBounds(areaRef->nodes,listBounds))   {
+                setAreasAllLods.insert(areaIt->first);
+                dsUpdate.listAreaRefs[lod].insert(std::make_pair(areaIt->first,areaRef));
+            }
+        }
+
+        // [relation areas]
+        IdMap<RelAreaRenderData>::const_iterator relAreaIt;
+        for(relAreaIt = objSource.listRelAreaData[k].begin();
+            relAreaIt != objSource.listRelAreaData[k].end(); ++relAreaIt)
+        {
+            osmscout::RelationRef const &relRef = relAreaIt->second.relRef;
+            if(setRelAreasAllLods.count(relAreaIt->first) != 0 ||
+               !renderStyle->GetAreaTypeIsValid(relRef->GetType()))
+            {   continue;   }
+
+            for(size_t r=0; r < relRef->roles.size(); r++)
+            {
+                if(calcPointsInGeoBounds(relRef->roles[r].nodes,listBounds))   {
+                    setRelAreasAllLods.insert(relAreaIt->first);
+                    dsUpdate.listRelAreaRefs[lod].insert(std::make_pair(relAreaIt->first,relRef));
+                    break;
+                }
+            }
+        }
+    }
+}
+
+bool MapRenderer::applySceneUpdate(SceneUpdate &sceneUpdate,
+                                   CommitBudget &budget)
+{
+    OSRTRACE("applySceneUpdate","scene");
+    std::chrono::steady_clock::time_point tCommit =
+            std::chrono::steady_clock::now();
+
+    if(!sceneUpdate.commitStarted)   {
+        toggleSceneVisibility(true);
+        m_commitScratch.Reset();
+        m_commitStats = sceneUpdate.stats;
+        sceneUpdate.commitStarted = true;
+    }
+
+    bool applied = true;
+    for(; sceneUpdate.commitDsIdx < sceneUpdate.listDataSetUpdates.size();
+        sceneUpdate.commitDsIdx++)
+    {
+        DataSetUpdate &dsUpdate =
+                sceneUpdate.listDataSetUpdates[sceneUpdate.commitDsIdx];
+
+        if(!applyDataSetUpdate(dsUpdate,budget))
+        {
+            applied = false;
+            break;
+        }
+
+        // the DataSet matches the update once
+        // all of its objects have been applied
+        dsUpdate.dataSet->listQueryBounds = dsUpdate.listQueryBounds;
+        dsUpdate.dataSet->listNodeIds.swap(dsUpdate.listNodeIds);
+        dsUpdate.dataSet->listWayIds.swap(dsUpdate.listWayIds);
+        dsUpdate.dataSet->listAreaIds.swap(dsUpdate.listAreaIds);
+        dsUpdate.dataSet->listRelAreaIds.swap(dsUpdate.listRelAreaIds);
+    }
+
+    trimRenderDataCache();
+
+    // the backend batches its changes until doneUpdating[]
+    // is called, so it's called at the end of every slice
+    std::chrono::steady_clock::time_point tStart;
+    if(budget.modifiedWays)   {
+        tStart = std::chrono::steady_clock::now();
+        this->doneUpdatingWays();
+        m_commitStats.wayStats.doneMs += calcElapsedMs(tStart);
+    }
+
+    if(budget.modifiedAreas)   {
+        tStart = std::chrono::steady_clock::now();
+        this->doneUpdatingAreas();
+        m_commitStats.areaStats.doneMs += calcElapsedMs(tStart);
+    }
+
+    if(budget.modifiedRelAreas)   {
+        tStart = std::chrono::steady_clock::now();
+        this->doneUpdatingRelAreas();
+        m_commitStats.relAreaStats.doneMs += calcElapsedMs(tStart);
+    }
+
+    m_commitStats.numCommits++;
+    m_commitStats.commitMs += calcElapsedMs(tCommit);
+
+    if(!applied)
+    {   return false;   }
+
+    // lod hysteresis is relative to the scene
+    m_listLODRangesActive = sceneUpdate.listLODRangesActive;
+    m_lodStats.numActivationsHeld += sceneUpdate.lodStats.numActivationsHeld;
+    m_lodStats.numDeactivationsHeld += sceneUpdate.lodStats.numDeactivationsHeld;
+    m_lodStats.numActivations += sceneUpdate.lodStats.numActivations;
+    m_lodStats.numDeactivations += sceneUpdate.lodStats.numDeactivations;
+
+    m_scratchStats = sceneUpdate.scratchStats;
+    m_scratchStats.Add(m_commitScratch.GetStats());
+
+    size_t updateIdx = m_updateStats.updateIdx+1;
+    m_updateStats = m_commitStats;
+    m_updateStats.updateIdx = updateIdx;
+
+    // update current data extents
+    m_data_exTL = sceneUpdate.camera.exTL;
+    m_data_exTR = sceneUpdate.camera.exTR;
+    m_data_exBL = sceneUpdate.camera.exBL;
+    m_data_exBR = sceneUpdate.camera.exBR;
+    return true;
+}
+
+void MapRenderer::updateSceneBasedOnCamera()
+{
+    if(m_asyncUpdates)
+    {   // let the worker build the update
+        std::unique_lock<std::mutex> lock(m_workerMutex);
+        queueSceneUpdate();
+        return;
+    }
+
+    OSRINFO << "[Updating Scene Contents...]";
+    updateSceneContents(m_listDataSets);
+
+    /*
+    double oldArea =
+            calcTriangleArea(m_data_exTL,m_data_exTR,m_data_exBR) +
+            calcTriangleArea(m_data_exTL,m_data_exBL,m_data_exBR);
+
+    double newArea =
+            calcTriangleArea(m_camera.exTL,m_camera.exTR,m_camera.exBR) +
+            calcTriangleArea(m_camera.exTL,m_camera.exBL,m_camera.exBR);
+
+    // calc overlap
+    std::vector<Vec3> listVxPoly1(4);
+    listVxPoly1[0] = m_data_exTL;
+    listVxPoly1[1] = m_data_exTR;
     listVxPoly1[2] = m_data_exBR;
     listVxPoly1[3] = m_data_exBL;
 
@@ -577,281 +1849,1709 @@ void MapRenderer::updateSceneBasedOnCamera()
                                      listVxOverlap[2]);
     }
 
-    if(oldArea < 1E-7)
-    {   updateSceneContents(m_listDataSets);   return;   }
+    if(oldArea < 1E-7)
+    {   updateSceneContents(m_listDataSets);   return;   }
+
+    double oldOverlap = overlapArea/oldArea;
+    double newOverlap = overlapArea/newArea;
+
+    if(oldOverlap < 0.75 || newOverlap < 0.75)
+    {
+        // just for debugging TODO
+        showCameraViewArea(m_camera);
+
+        // update scene contents
+        OSRINFO << "[Updating Scene Contents...]";
+        updateSceneContents(m_listDataSets);
+    }
+    */
+}
+
+// ========================================================================== //
+// ========================================================================== //
+
+void MapRenderer::queueNodeAdds(ListNodeRefsByLod const &listNodeRefs,
+                                IdDiff const &nodeDiff,
+                                ListNodeAddsByLod &listNodeAdds)
+{
+    ListIdLods listQueued;
+    getQueuedIds(nodeDiff,listQueued);
+
+    // queue objects from the new view extents not present
+    // in the old view extents (or present at another lod)
+    listNodeAdds.resize(listNodeRefs.size());
+    for(size_t j=0; j < listQueued.size(); j++)
+    {
+        IdLod const &idLod = listQueued[j];
+        NodeRenderData nodeRenderData;
+        nodeRenderData.nodeRef = listNodeRefs[idLod.lod].find(idLod.id)->second;
+        listNodeAdds[idLod.lod].push_back(nodeRenderData);
+    }
+}
+
+void MapRenderer::queueWayAdds(ListWayRefsByLod const &listWayRefs,
+                               IdDiff const &wayDiff,
+                               ListWayAddsByLod &listWayAdds)
+{
+    ListIdLods listQueued;
+    getQueuedIds(wayDiff,listQueued);
+
+    // queue objects from the new view extents not present
+    // in the old view extents (or present at another lod)
+    listWayAdds.resize(listWayRefs.size());
+    for(size_t j=0; j < listQueued.size(); j++)
+    {
+        IdLod const &idLod = listQueued[j];
+        WayRenderData wayRenderData;
+        wayRenderData.wayRef = listWayRefs[idLod.lod].find(idLod.id)->second;
+        listWayAdds[idLod.lod].push_back(wayRenderData);
+    }
+}
+
+void MapRenderer::queueAreaAdds(ListAreaRefsByLod const &listAreaRefs,
+                                IdDiff const &areaDiff,
+                                ListAreaAddsByLod &listAreaAdds)
+{
+    ListIdLods listQueued;
+    getQueuedIds(areaDiff,listQueued);
+
+    // queue objects from the new view extents not present
+    // in the old view extents (or present at another lod)
+    listAreaAdds.resize(listAreaRefs.size());
+    for(size_t j=0; j < listQueued.size(); j++)
+    {
+        IdLod const &idLod = listQueued[j];
+        AreaRenderData areaRenderData;
+        areaRenderData.lod = idLod.lod;
+        areaRenderData.areaRef = listAreaRefs[idLod.lod].find(idLod.id)->second;
+        listAreaAdds[idLod.lod].push_back(areaRenderData);
+    }
+}
+
+void MapRenderer::queueRelAreaAdds(ListRelAreaRefsByLod const &listRelAreaRefs,
+                                   IdDiff const &relAreaDiff,
+                                   ListRelAreaAddsByLod &listRelAreaAdds)
+{
+    ListIdLods listQueued;
+    getQueuedIds(relAreaDiff,listQueued);
+
+    // queue objects from the new view extents not present
+    // in the old view extents (or present at another lod)
+    listRelAreaAdds.resize(listRelAreaRefs.size());
+    for(size_t j=0; j < listQueued.size(); j++)
+    {
+        IdLod const &idLod = listQueued[j];
+        RelAreaRenderData relRenderData;
+        relRenderData.relRef = listRelAreaRefs[idLod.lod].find(idLod.id)->second;
+        listRelAreaAdds[idLod.lod].push_back(relRenderData);
+    }
+}
+
+void MapRenderer::orderQueuedAdds(Camera const &cam,DataSetUpdate &dsUpdate)
+{
+    std::vector<QueuedAdd> &listAddOrder = dsUpdate.listAddOrder;
+    listAddOrder.clear();
+
+    for(size_t i=0; i < dsUpdate.listNodeAdds.size(); i++)
+    {
+        for(size_t j=0; j < dsUpdate.listNodeAdds[i].size(); j++)   {
+            osmscout::NodeRef const &nodeRef = dsUpdate.listNodeAdds[i][j].nodeRef;
+            QueuedAdd add(OBJ_NODE,i,j);
+            add.distSq = cam.eye.Distance2To(convLLAToECEF(
+                PointLLA(nodeRef->GetLat(),nodeRef->GetLon())));
+            listAddOrder.push_back(add);
+        }
+
+        for(size_t j=0; j < dsUpdate.listWayAdds[i].size(); j++)   {
+            osmscout::WayRef const &wayRef = dsUpdate.listWayAdds[i][j].wayRef;
+            QueuedAdd add(OBJ_WAY,i,j);
+            add.distSq = cam.eye.Distance2To(convLLAToECEF(
+                calcGeoCenter(wayRef->nodes)));
+            listAddOrder.push_back(add);
+        }
+
+        for(size_t j=0; j < dsUpdate.listAreaAdds[i].size(); j++)   {
+            osmscout::WayRef const &areaRef = dsUpdate.listAreaAdds[i][j].areaRef;
+            QueuedAdd add(OBJ_AREA,i,j);
+            add.distSq = cam.eye.Distance2To(convLLAToECEF(
+                calcGeoCenter(areaRef->nodes)));
+            listAddOrder.push_back(add);
+        }
+
+        for(size_t j=0; j < dsUpdate.listRelAreaAdds[i].size(); j++)   {
+            osmscout::RelationRef const &relRef = dsUpdate.listRelAreaAdds[i][j].relRef;
+            QueuedAdd add(OBJ_RELAREA,i,j);
+            add.distSq = cam.eye.Distance2To(convLLAToECEF(
+                calcGeoCenter(relRef)));
+            listAddOrder.push_back(add);
+        }
+    }
+
+    // lods with a smaller min distance are
+    // shown closer up so they're more detailed
+    std::vector<RenderStyleConfig*> const &listStyleConfigs =
+            dsUpdate.dataSet->listStyleConfigs;
+
+    std::vector<size_t> listLodsByDetail(listStyleConfigs.size());
+    for(size_t i=0; i < listLodsByDetail.size(); i++)
+    {   listLodsByDetail[i] = i;   }
+
+    std::stable_sort(listLodsByDetail.begin(),listLodsByDetail.end(),
+                     [&](size_t a, size_t b)
+    {
+        return (listStyleConfigs[a]->GetMinDistance() <
+                listStyleConfigs[b]->GetMinDistance());
+    });
+
+    std::vector<size_t> listLodRanks(listLodsByDetail.size());
+    for(size_t r=0; r < listLodsByDetail.size(); r++)
+    {   listLodRanks[listLodsByDetail[r]] = r;   }
+
+    std::sort(listAddOrder.begin(),listAddOrder.end(),
+              [&](QueuedAdd const &a, QueuedAdd const &b)
+    {
+        if(a.lod != b.lod)
+        {   return (listLodRanks[a.lod] < listLodRanks[b.lod]);   }
+
+        return (a.distSq < b.distSq);
+    });
+}
+
+// ========================================================================== //
+// ========================================================================== //
+
+bool MapRenderer::genSceneUpdateRenderData(SceneUpdate &sceneUpdate,
+                                           std::vector<PrefetchData const *> const &listPrefetch,
+                                           bool useCache)
+{
+    useCache = useCache && (m_cacheMaxBytes > 0);
+
+    // every queued object gets its own task; tasks write
+    // directly into their render data entry so no two
+    // threads ever touch the same data
+    std::vector<GenTask> listTasks;
+    for(size_t d=0; d < sceneUpdate.listDataSetUpdates.size(); d++)
+    {
+        DataSetUpdate &dsUpdate = sceneUpdate.listDataSetUpdates[d];
+        for(size_t k=0; k < dsUpdate.listAddOrder.size(); k++)   {
+            QueuedAdd const &add = dsUpdate.listAddOrder[k];
+            listTasks.push_back(GenTask(add.objType,d,add.lod,add.idx));
+        }
+    }
+
+    // nearest objects are generated first
+    m_taskPool.RunTasksByPriority(listTasks.size(),[&](size_t t)
+    {
+        if(isSceneUpdateCancelled(sceneUpdate.generation))
+        {   return;   }
+
+        std::chrono::steady_clock::time_point tStart =
+                std::chrono::steady_clock::now();
+
+        genTaskRenderData(sceneUpdate,listPrefetch[listTasks[t].dsIdx],
+                          useCache,listTasks[t]);
+
+        listTasks[t].genMs = calcElapsedMs(tStart);
+    });
+
+    // skipped objects would look like they failed
+    if(isSceneUpdateCancelled(sceneUpdate.generation))
+    {   return false;   }
+
+    for(size_t t=0; t < listTasks.size(); t++)
+    {
+        GenTask const &genTask = listTasks[t];
+        SceneTypeStats &typeStats =
+                sceneUpdate.stats.GetTypeStats(genTask.objType);
+
+        typeStats.numQueued++;
+        typeStats.genMs += genTask.genMs;
+
+        if(!genTask.opOk)                {   typeStats.numFailed++;   }
+        else if(genTask.isPrefetched)    {   typeStats.numPrefetched++;   }
+        else if(genTask.isCached)        {   typeStats.numCached++;   }
+        else                             {   typeStats.numGenerated++;   }
+    }
+
+    // remove objects that couldn't be generated, going
+    // through the lists in the same order as above; they
+    // won't be in the scene so they're removed from the
+    // update's ids as well
+    size_t t=0;
+    for(size_t d=0; d < sceneUpdate.listDataSetUpdates.size(); d++)
+    {
+        DataSetUpdate &dsUpdate = sceneUpdate.listDataSetUpdates[d];
+        std::vector<QueuedAdd> &listAddOrder = dsUpdate.listAddOrder;
+
+        std::vector<bool> listOk(listAddOrder.size());
+        for(size_t k=0; k < listAddOrder.size(); k++,t++)
+        {   listOk[k] = listTasks[t].opOk;   }
+
+        std::vector<osmscout::Id> listFailedNodes,listFailedWays;
+        std::vector<osmscout::Id> listFailedAreas,listFailedRelAreas;
+
+        removeFailedAdds(OBJ_NODE,listAddOrder,listOk,
+                         dsUpdate.listNodeAdds,listFailedNodes);
+        removeFailedAdds(OBJ_WAY,listAddOrder,listOk,
+                         dsUpdate.listWayAdds,listFailedWays);
+        removeFailedAdds(OBJ_AREA,listAddOrder,listOk,
+                         dsUpdate.listAreaAdds,listFailedAreas);
+        removeFailedAdds(OBJ_RELAREA,listAddOrder,listOk,
+                         dsUpdate.listRelAreaAdds,listFailedRelAreas);
+
+        size_t numKept=0;
+        for(size_t k=0; k < listAddOrder.size(); k++)   {
+            if(listOk[k])   {
+                listAddOrder[numKept] = listAddOrder[k];
+                numKept++;
+            }
+        }
+        listAddOrder.erase(listAddOrder.begin()+numKept,listAddOrder.end());
+
+        RemoveSortedIds(dsUpdate.listNodeIds,listFailedNodes);
+        RemoveSortedIds(dsUpdate.listWayIds,listFailedWays);
+        RemoveSortedIds(dsUpdate.listAreaIds,listFailedAreas);
+        RemoveSortedIds(dsUpdate.listRelAreaIds,listFailedRelAreas);
+    }
+
+    return true;
+}
+
+void MapRenderer::genTaskRenderData(SceneUpdate &sceneUpdate,
+                                    PrefetchData const *prefetch,
+                                    bool useCache,
+                                    GenTask &genTask)
+{
+    DataSetUpdate &dsUpdate = sceneUpdate.listDataSetUpdates[genTask.dsIdx];
+    DataSet * dataSet = dsUpdate.dataSet;
+    RenderStyleConfig const * renderStyle =
+            dataSet->listStyleConfigs[genTask.lod];
+
+    // each task pool thread has its own arena
+    ScratchArena &scratch =
+            *(m_listScratchArenas[TaskPool::GetThreadIdx()]);
+
+    // refs are copied since gen[]RenderData
+    // overwrites the render data they're in
+    if(genTask.objType == OBJ_NODE)   {
+        NodeRenderData &nodeRenderData =
+                dsUpdate.listNodeAdds[genTask.lod][genTask.idx];
+
+        osmscout::NodeRef nodeRef = nodeRenderData.nodeRef;
+        if(prefetch && findPrefetched(prefetch->listNodeData[genTask.lod],
+                                      nodeRef->GetId(),nodeRenderData))
+        {   genTask.opOk = true;   genTask.isPrefetched = true;   return;   }
+
+        if(useCache)   {
+            NodeRenderData const * cached =
+                    m_nodeCache.Find(dataSet,genTask.lod,nodeRef->GetId());
+
+            if(cached)   {
+                nodeRenderData = *cached;
+                genTask.opOk = true;
+                genTask.isCached = true;
+                m_cacheHits++;
+                return;
+            }
+
+            m_cacheMisses++;
+        }
+
+        genTask.opOk = genNodeRenderData(dataSet,nodeRef,renderStyle,
+                                         nodeRenderData);
+    }
+    else if(genTask.objType == OBJ_WAY)   {
+        WayRenderData &wayRenderData =
+                dsUpdate.listWayAdds[genTask.lod][genTask.idx];
+
+        osmscout::WayRef wayRef = wayRenderData.wayRef;
+        if(prefetch && findPrefetched(prefetch->listWayData[genTask.lod],
+                                      wayRef->GetId(),wayRenderData))
+        {   genTask.opOk = true;   genTask.isPrefetched = true;   return;   }
+
+        if(useCache)   {
+            WayRenderData const * cached =
+                    m_wayCache.Find(dataSet,genTask.lod,wayRef->GetId());
+
+            if(cached)   {
+                wayRenderData = *cached;
+                expandRenderData(wayRenderData);
+                genTask.opOk = true;
+                genTask.isCached = true;
+                m_cacheHits++;
+                return;
+            }
+
+            m_cacheMisses++;
+        }
+
+        genTask.opOk = genWayRenderData(dataSet,wayRef,renderStyle,
+                                        wayRenderData,scratch);
+    }
+    else if(genTask.objType == OBJ_AREA)   {
+        AreaRenderData &areaRenderData =
+                dsUpdate.listAreaAdds[genTask.lod][genTask.idx];
+
+        osmscout::WayRef areaRef = areaRenderData.areaRef;
+        if(prefetch && findPrefetched(prefetch->listAreaData[genTask.lod],
+                                      areaRef->GetId(),areaRenderData))
+        {   genTask.opOk = true;   genTask.isPrefetched = true;   return;   }
+
+        if(useCache)   {
+            AreaRenderData const * cached =
+                    m_areaCache.Find(dataSet,genTask.lod,areaRef->GetId());
+
+            if(cached)   {
+                areaRenderData = *cached;
+                expandRenderData(areaRenderData);
+                genTask.opOk = true;
+                genTask.isCached = true;
+                m_cacheHits++;
+                return;
+            }
+
+            m_cacheMisses++;
+        }
+
+        genTask.opOk = genAreaRenderData(dataSet,areaRef,renderStyle,
+                                         areaRenderData,scratch);
+    }
+    else if(genTask.objType == OBJ_RELAREA)   {
+        RelAreaRenderData &relRenderData =
+                dsUpdate.listRelAreaAdds[genTask.lod][genTask.idx];
+
+        osmscout::RelationRef relRef = relRenderData.relRef;
+        if(prefetch && findPrefetched(prefetch->listRelAreaData[genTask.lod],
+                                      relRef->GetId(),relRenderData))
+        {   genTask.opOk = true;   genTask.isPrefetched = true;   return;   }
+
+        if(useCache)   {
+            RelAreaRenderData const * cached =
+                    m_relAreaCache.Find(dataSet,genTask.lod,relRef->GetId());
+
+            if(cached)   {
+                relRenderData = *cached;
+                expandRenderData(relRenderData);
+                genTask.opOk = true;
+                genTask.isCached = true;
+                m_cacheHits++;
+                return;
+            }
+
+            m_cacheMisses++;
+        }
+
+        genTask.opOk = genRelAreaRenderData(dataSet,relRef,renderStyle,
+                                            relRenderData,scratch);
+    }
+}
+
+// ========================================================================== //
+// ========================================================================== //
+
+bool MapRenderer::applyDataSetUpdate(DataSetUpdate &dsUpdate, CommitBudget &budget)
+{
+    // note:
+    // we first remove all objects that need to be removed
+    // before adding new objects
+    if(!applyNodeRemoves(dsUpdate,budget) ||
+       !applyWayRemoves(dsUpdate,budget) ||
+       !applyAreaRemoves(dsUpdate,budget) ||
+       !applyRelAreaRemoves(dsUpdate,budget))
+    {   return false;   }
+
+    // add objects from the new view extents not present
+    // in the old view extents, nearest objects first
+    // new geometry is passed to the backend in batches of
+    // one object type, so the batch is flushed whenever
+    // the type changes (the budget's time limit is only
+    // checked between objects, so batches are kept short)
+    ObjectType batchType = OBJ_NODE;
+    for(; dsUpdate.addIdx < dsUpdate.listAddOrder.size(); dsUpdate.addIdx++)
+    {
+        if(budget.IsSpent())   {
+            flushAddBatches(dsUpdate.dataSet);
+            return false;
+        }
+
+        QueuedAdd const &add = dsUpdate.listAddOrder[dsUpdate.addIdx];
+        if(add.objType != batchType ||
+           calcNumBatched() >= OPT_SCENE_BATCH_SIZE)   {
+            flushAddBatches(dsUpdate.dataSet);
+            batchType = add.objType;
+        }
+
+        if(add.objType == OBJ_NODE)   {
+            applyNodeAdd(dsUpdate,add);
+        }
+        else if(add.objType == OBJ_WAY)   {
+            applyWayAdd(dsUpdate,add);
+            budget.modifiedWays = true;
+        }
+        else if(add.objType == OBJ_AREA)   {
+            applyAreaAdd(dsUpdate,add);
+            budget.modifiedAreas = true;
+        }
+        else if(add.objType == OBJ_RELAREA)   {
+            applyRelAreaAdd(dsUpdate,add);
+            budget.modifiedRelAreas = true;
+        }
+        budget.numObjects++;
+    }
+    flushAddBatches(dsUpdate.dataSet);
+
+    // objects that changed lod but couldn't be
+    // generated at their new lod are removed
+    DataSet * dataSet = dsUpdate.dataSet;
+    removeOldLods(m_nodeCache,dataSet,dataSet->listNodeData,
+                  dsUpdate.nodeCursor);
+
+    if(removeOldLods(m_wayCache,dataSet,dataSet->listWayData,
+                     dsUpdate.wayCursor))
+    {   budget.modifiedWays = true;   }
+
+    if(removeOldLods(m_areaCache,dataSet,dataSet->listAreaData,
+                     dsUpdate.areaCursor))
+    {   budget.modifiedAreas = true;   }
+
+    if(removeOldLods(m_relAreaCache,dataSet,dataSet->listRelAreaData,
+                     dsUpdate.relAreaCursor))
+    {   budget.modifiedRelAreas = true;   }
+
+    return true;
+}
+
+bool MapRenderer::applyNodeRemoves(DataSetUpdate &dsUpdate, CommitBudget &budget)
+{
+    DataSet * dataSet = dsUpdate.dataSet;
+    ListNodeDataByLod &listNodeData = dataSet->listNodeData;
+    IdDiff const &diff = dsUpdate.nodeDiff;
+    ApplyCursor &cursor = dsUpdate.nodeCursor;
+
+    if(cursor.stage != APPLY_REMOVES)
+    {   return true;   }
+
+    // remove objects from the old view extents
+    // not present in the new view extents
+    for(; cursor.idx < diff.listRemoves.size(); cursor.idx++)   {
+        if(budget.IsSpent())   {
+            flushRemoveBatch(m_nodeBatch);
+            return false;
+        }
+
+        if(m_nodeBatch.listData.size() >= OPT_SCENE_BATCH_SIZE)
+        {   flushRemoveBatch(m_nodeBatch);   }
+
+        IdLod const &idLod = diff.listRemoves[cursor.idx];
+        removeSceneObject(m_nodeCache,dataSet,idLod.lod,
+                          listNodeData[idLod.lod],idLod.id,&m_nodeBatch);
+        budget.numObjects++;
+    }
+    flushRemoveBatch(m_nodeBatch);
+
+    // objects that only changed lod are queued
+    // as adds for their new lod
+    cursor.listOldLods.reserve(diff.listLodChanges.size());
+    for(size_t c=0; c < diff.listLodChanges.size(); c++)   {
+        IdLodChange const &lodChange = diff.listLodChanges[c];
+        cursor.listOldLods[lodChange.id] = lodChange.oldLod;
+    }
+
+    cursor.stage = APPLY_ADDS;
+    return true;
+}
+
+bool MapRenderer::applyWayRemoves(DataSetUpdate &dsUpdate, CommitBudget &budget)
+{
+    DataSet * dataSet = dsUpdate.dataSet;
+    ListWayDataByLod &listWayData = dataSet->listWayData;
+    IdDiff const &diff = dsUpdate.wayDiff;
+    ApplyCursor &cursor = dsUpdate.wayCursor;
+
+    if(cursor.stage != APPLY_REMOVES)
+    {   return true;   }
+
+    // remove objects from the old view extents
+    // not present in the new view extents
+    for(; cursor.idx < diff.listRemoves.size(); cursor.idx++)   {
+        if(budget.IsSpent())   {
+            flushRemoveBatch(m_wayBatch);
+            return false;
+        }
+
+        if(m_wayBatch.listData.size() >= OPT_SCENE_BATCH_SIZE)
+        {   flushRemoveBatch(m_wayBatch);   }
+
+        IdLod const &idLod = diff.listRemoves[cursor.idx];
+        if(OPT_TRACK_SHARED_NODES)
+        {   dataSet->listSharedNodes[idLod.lod].RemoveWay(idLod.id);   }
+
+        removeSceneObject(m_wayCache,dataSet,idLod.lod,
+                          listWayData[idLod.lod],idLod.id,&m_wayBatch);
+        budget.numObjects++;
+        budget.modifiedWays = true;
+    }
+    flushRemoveBatch(m_wayBatch);
+
+    // objects that only changed lod are queued
+    // as adds for their new lod
+    cursor.listOldLods.reserve(diff.listLodChanges.size());
+    for(size_t c=0; c < diff.listLodChanges.size(); c++)   {
+        IdLodChange const &lodChange = diff.listLodChanges[c];
+        cursor.listOldLods[lodChange.id] = lodChange.oldLod;
+
+        if(OPT_TRACK_SHARED_NODES)
+        {   dataSet->listSharedNodes[lodChange.oldLod].RemoveWay(lodChange.id);   }
+    }
+
+    if(OPT_TRACK_SHARED_NODES)
+    {   addWaysToSharedNodes(dsUpdate);   }
+
+    cursor.stage = APPLY_ADDS;
+    return true;
+}
+
+bool MapRenderer::applyAreaRemoves(DataSetUpdate &dsUpdate, CommitBudget &budget)
+{
+    DataSet * dataSet = dsUpdate.dataSet;
+    ListAreaDataByLod &listAreaData = dataSet->listAreaData;
+    IdDiff const &diff = dsUpdate.areaDiff;
+    ApplyCursor &cursor = dsUpdate.areaCursor;
+
+    if(cursor.stage != APPLY_REMOVES)
+    {   return true;   }
+
+    // remove objects from the old view extents
+    // not present in the new view extents
+    for(; cursor.idx < diff.listRemoves.size(); cursor.idx++)   {
+        if(budget.IsSpent())   {
+            flushRemoveBatch(m_areaBatch);
+            return false;
+        }
+
+        if(m_areaBatch.listData.size() >= OPT_SCENE_BATCH_SIZE)
+        {   flushRemoveBatch(m_areaBatch);   }
+
+        IdLod const &idLod = diff.listRemoves[cursor.idx];
+        removeSceneObject(m_areaCache,dataSet,idLod.lod,
+                          listAreaData[idLod.lod],idLod.id,&m_areaBatch);
+        budget.numObjects++;
+        budget.modifiedAreas = true;
+    }
+    flushRemoveBatch(m_areaBatch);
+
+    // objects that only changed lod are queued
+    // as adds for their new lod
+    cursor.listOldLods.reserve(diff.listLodChanges.size());
+    for(size_t c=0; c < diff.listLodChanges.size(); c++)   {
+        IdLodChange const &lodChange = diff.listLodChanges[c];
+        cursor.listOldLods[lodChange.id] = lodChange.oldLod;
+    }
+
+    cursor.stage = APPLY_ADDS;
+    return true;
+}
+
+bool MapRenderer::applyRelAreaRemoves(DataSetUpdate &dsUpdate, CommitBudget &budget)
+{
+    DataSet * dataSet = dsUpdate.dataSet;
+    ListRelAreaDataByLod &listRelAreaData = dataSet->listRelAreaData;
+    IdDiff const &diff = dsUpdate.relAreaDiff;
+    ApplyCursor &cursor = dsUpdate.relAreaCursor;
+
+    if(cursor.stage != APPLY_REMOVES)
+    {   return true;   }
+
+    // remove objects from the old view extents
+    // not present in the new view extents
+    for(; cursor.idx < diff.listRemoves.size(); cursor.idx++)   {
+        if(budget.IsSpent())   {
+            flushRemoveBatch(m_relAreaBatch);
+            return false;
+        }
+
+        if(m_relAreaBatch.listData.size() >= OPT_SCENE_BATCH_SIZE)
+        {   flushRemoveBatch(m_relAreaBatch);   }
+
+        IdLod const &idLod = diff.listRemoves[cursor.idx];
+        removeSceneObject(m_relAreaCache,dataSet,idLod.lod,
+                          listRelAreaData[idLod.lod],idLod.id,&m_relAreaBatch);
+        budget.numObjects++;
+        budget.modifiedRelAreas = true;
+    }
+    flushRemoveBatch(m_relAreaBatch);
+
+    // objects that only changed lod are queued
+    // as adds for their new lod
+    cursor.listOldLods.reserve(diff.listLodChanges.size());
+    for(size_t c=0; c < diff.listLodChanges.size(); c++)   {
+        IdLodChange const &lodChange = diff.listLodChanges[c];
+        cursor.listOldLods[lodChange.id] = lodChange.oldLod;
+    }
+
+    cursor.stage = APPLY_ADDS;
+    return true;
+}
+
+void MapRenderer::applyNodeAdd(DataSetUpdate &dsUpdate, QueuedAdd const &add)
+{
+    DataSet * dataSet = dsUpdate.dataSet;
+    ListNodeDataByLod &listNodeData = dataSet->listNodeData;
+    ApplyCursor &cursor = dsUpdate.nodeCursor;
+
+    size_t i = add.lod;
+    NodeRenderData &nodeRenderData = dsUpdate.listNodeAdds[i][add.idx];
+    osmscout::Id nodeId = nodeRenderData.nodeRef->GetId();
+
+    // skip anything added since the update was built
+    if(listNodeData[i].count(nodeId) != 0)
+    {   return;   }
+
+    bool restyled = false;
+    IdMap<size_t>::iterator lodIt = cursor.listOldLods.find(nodeId);
+    if(lodIt != cursor.listOldLods.end())   {
+        size_t oldLod = lodIt->second;
+        cursor.listOldLods.erase(lodIt);
+        restyled = changeObjectLod(m_nodeCache,dataSet,oldLod,
+                                   listNodeData[oldLod],nodeId,
+                                   nodeRenderData);
+    }
+
+    // objects that left the scene recently
+    // may still have their geometry
+    if(restyled ||
+       takeCachedGeometry(m_nodeCache,dataSet,i,nodeId,nodeRenderData))   {
+        retainRenderData(nodeRenderData);
+
+        std::pair<osmscout::Id,NodeRenderData> insPair(nodeId,nodeRenderData);
+        listNodeData[i].insert(insPair);
+        return;
+    }
+
+    // new geometry is added with the rest of its batch
+    m_nodeBatch.listData.push_back(nodeRenderData);
+    m_nodeBatch.listLods.push_back(i);
+}
+
+void MapRenderer::applyWayAdd(DataSetUpdate &dsUpdate, QueuedAdd const &add)
+{
+    DataSet * dataSet = dsUpdate.dataSet;
+    ListWayDataByLod &listWayData = dataSet->listWayData;
+    ApplyCursor &cursor = dsUpdate.wayCursor;
+
+    size_t i = add.lod;
+    WayRenderData &wayRenderData = dsUpdate.listWayAdds[i][add.idx];
+    osmscout::Id wayId = wayRenderData.wayRef->GetId();
+
+    // skip anything added since the update was built
+    if(listWayData[i].count(wayId) != 0)
+    {   return;   }
+
+    if(OPT_TRACK_SHARED_NODES && !wayRenderData.isCoast)   {
+        dataSet->listSharedNodes[i].GetIntersections(
+            wayId,wayRenderData.wayRef->nodes,
+            wayRenderData.listIntersections);
+    }
+
+    bool restyled = false;
+    IdMap<size_t>::iterator lodIt = cursor.listOldLods.find(wayId);
+    if(lodIt != cursor.listOldLods.end())   {
+        size_t oldLod = lodIt->second;
+        cursor.listOldLods.erase(lodIt);
+        restyled = changeObjectLod(m_wayCache,dataSet,oldLod,
+                                   listWayData[oldLod],wayId,
+                                   wayRenderData);
+    }
+
+    // objects that left the scene recently
+    // may still have their geometry
+    if(restyled ||
+       takeCachedGeometry(m_wayCache,dataSet,i,wayId,wayRenderData))   {
+        retainRenderData(wayRenderData);
+
+        std::pair<osmscout::Id,WayRenderData> insPair(wayId,wayRenderData);
+        listWayData[i].insert(insPair);
+        return;
+    }
+
+    // new geometry is added with the rest of its batch
+    m_wayBatch.listData.push_back(wayRenderData);
+    m_wayBatch.listLods.push_back(i);
+}
+
+void MapRenderer::applyAreaAdd(DataSetUpdate &dsUpdate, QueuedAdd const &add)
+{
+    DataSet * dataSet = dsUpdate.dataSet;
+    ListAreaDataByLod &listAreaData = dataSet->listAreaData;
+    ApplyCursor &cursor = dsUpdate.areaCursor;
+
+    size_t i = add.lod;
+    AreaRenderData &areaRenderData = dsUpdate.listAreaAdds[i][add.idx];
+    osmscout::Id areaId = areaRenderData.areaRef->GetId();
+
+    // skip anything added since the update was built
+    if(listAreaData[i].count(areaId) != 0)
+    {   return;   }
+
+    bool restyled = false;
+    IdMap<size_t>::iterator lodIt = cursor.listOldLods.find(areaId);
+    if(lodIt != cursor.listOldLods.end())   {
+        size_t oldLod = lodIt->second;
+        cursor.listOldLods.erase(lodIt);
+        restyled = changeObjectLod(m_areaCache,dataSet,oldLod,
+                                   listAreaData[oldLod],areaId,
+                                   areaRenderData);
+    }
+
+    // objects that left the scene recently
+    // may still have their geometry
+    if(restyled ||
+       takeCachedGeometry(m_areaCache,dataSet,i,areaId,areaRenderData))   {
+        retainRenderData(areaRenderData);
+
+        std::pair<osmscout::Id,AreaRenderData> insPair(areaId,areaRenderData);
+        listAreaData[i].insert(insPair);
+        return;
+    }
+
+    // new geometry is added with the rest of its batch
+    m_areaBatch.listData.push_back(areaRenderData);
+    m_areaBatch.listLods.push_back(i);
+}
+
+void MapRenderer::applyRelAreaAdd(DataSetUpdate &dsUpdate, QueuedAdd const &add)
+{
+    DataSet * dataSet = dsUpdate.dataSet;
+    ListRelAreaDataByLod &listRelAreaData = dataSet->listRelAreaData;
+    ApplyCursor &cursor = dsUpdate.relAreaCursor;
+
+    size_t i = add.lod;
+    RelAreaRenderData &relRenderData = dsUpdate.listRelAreaAdds[i][add.idx];
+    osmscout::Id relId = relRenderData.relRef->GetId();
+
+    // skip anything added since the update was built
+    if(listRelAreaData[i].count(relId) != 0)
+    {   return;   }
+
+    bool restyled = false;
+    IdMap<size_t>::iterator lodIt = cursor.listOldLods.find(relId);
+    if(lodIt != cursor.listOldLods.end())   {
+        size_t oldLod = lodIt->second;
+        cursor.listOldLods.erase(lodIt);
+        restyled = changeObjectLod(m_relAreaCache,dataSet,oldLod,
+                                   listRelAreaData[oldLod],relId,
+                                   relRenderData);
+    }
+
+    // objects that left the scene recently
+    // may still have their geometry
+    if(restyled ||
+       takeCachedGeometry(m_relAreaCache,dataSet,i,relId,relRenderData))   {
+        retainRenderData(relRenderData);
+
+        std::pair<osmscout::Id,RelAreaRenderData> insPair(relId,relRenderData);
+        listRelAreaData[i].insert(insPair);
+        return;
+    }
+
+    // new geometry is added with the rest of its batch
+    m_relAreaBatch.listData.push_back(relRenderData);
+    m_relAreaBatch.listLods.push_back(i);
+}
+
+template <typename T>
+bool MapRenderer::removeOldLods(RenderDataCache<T> &cache,
+                                DataSet *dataSet,
+                                std::vector<IdMap<T> > &listData,
+                                ApplyCursor &cursor)
+{
+    if(cursor.stage != APPLY_ADDS)
+    {   return false;   }
+
+    bool removed = !cursor.listOldLods.empty();
+
+    IdMap<size_t>::iterator lodIt;
+    for(lodIt = cursor.listOldLods.begin();
+        lodIt != cursor.listOldLods.end(); ++lodIt)   {
+        removeSceneObject(cache,dataSet,lodIt->second,
+                          listData[lodIt->second],lodIt->first);
+    }
+    cursor.listOldLods.clear();
+    cursor.stage = APPLY_DONE;
+    return removed;
+}
+
+template <typename T>
+void MapRenderer::removeSceneObject(RenderDataCache<T> &cache,
+                                    DataSet *dataSet,size_t lod,
+                                    IdMap<T> &listData,
+                                    osmscout::Id objId,
+                                    SceneBatch<T> *batch)
+{
+    typename IdMap<T>::iterator it = listData.find(objId);
+    if(it == listData.end())
+    {   return;   }
+
+    if(m_cacheMaxBytes > 0)   {
+        cacheRenderData(cache,dataSet,lod,objId,it->second);
+    }
+    else if(batch != NULL)   {
+        batch->listData.push_back(T());
+        std::swap(batch->listData.back(),it->second);
+    }
+    else   {
+        SceneTypeStats &typeStats = getTypeStats(m_commitStats,it->second);
+        std::chrono::steady_clock::time_point tStart =
+                std::chrono::steady_clock::now();
+
+        removeFromScene(it->second);
+        typeStats.removeMs += calcElapsedMs(tStart);
+        typeStats.numRemoved++;
+    }
+
+    listData.erase(it);
+}
+
+template <typename T>
+void MapRenderer::flushAddBatch(std::vector<IdMap<T> > &listData,
+                                SceneBatch<T> &batch)
+{
+    if(batch.listData.empty())
+    {   return;   }
+
+    SceneTypeStats &typeStats = getTypeStats(m_commitStats,batch.listData[0]);
+    for(size_t k=0; k < batch.listData.size(); k++)
+    {   typeStats.numVertices += calcRenderDataNumPts(batch.listData[k]);   }
+
+    std::chrono::steady_clock::time_point tStart =
+            std::chrono::steady_clock::now();
+
+    addToScene(batch.listData);
+    typeStats.addMs += calcElapsedMs(tStart);
+    typeStats.numAdded += batch.listData.size();
+
+    for(size_t k=0; k < batch.listData.size(); k++)   {
+        T &renderData = batch.listData[k];
+        osmscout::Id objId = getRenderDataId(renderData);
+        retainRenderData(renderData);
+
+        std::swap(listData[batch.listLods[k]][objId],renderData);
+    }
+
+    batch.listData.clear();
+    batch.listLods.clear();
+}
+
+void MapRenderer::flushAddBatches(DataSet *dataSet)
+{
+    flushAddBatch(dataSet->listNodeData,m_nodeBatch);
+    flushAddBatch(dataSet->listWayData,m_wayBatch);
+    flushAddBatch(dataSet->listAreaData,m_areaBatch);
+    flushAddBatch(dataSet->listRelAreaData,m_relAreaBatch);
+}
+
+template <typename T>
+void MapRenderer::flushRemoveBatch(SceneBatch<T> &batch)
+{
+    if(batch.listData.empty())
+    {   return;   }
+
+    SceneTypeStats &typeStats = getTypeStats(m_commitStats,batch.listData[0]);
+    std::chrono::steady_clock::time_point tStart =
+            std::chrono::steady_clock::now();
+
+    removeFromScene(batch.listData);
+    typeStats.removeMs += calcElapsedMs(tStart);
+    typeStats.numRemoved += batch.listData.size();
+    batch.listData.clear();
+}
+
+size_t MapRenderer::calcNumBatched() const
+{
+    return (m_nodeBatch.listData.size() +
+            m_wayBatch.listData.size() +
+            m_areaBatch.listData.size() +
+            m_relAreaBatch.listData.size());
+}
+
+template <typename T>
+bool MapRenderer::changeObjectLod(RenderDataCache<T> &cache,
+                                  DataSet *dataSet,size_t oldLod,
+                                  IdMap<T> &listOldData,
+                                  osmscout::Id objId,T &renderData)
+{
+    typename IdMap<T>::iterator it = listOldData.find(objId);
+    if(it == listOldData.end())
+    {   return false;   }
+
+    SceneTypeStats &typeStats = getTypeStats(m_commitStats,renderData);
+    std::chrono::steady_clock::time_point tStart =
+            std::chrono::steady_clock::now();
+
+    bool restyled = restyleInScene(it->second,renderData);
+    typeStats.restyleMs += calcElapsedMs(tStart);
+
+    if(restyled)   {
+        typeStats.numRestyled++;
+        listOldData.erase(it);
+        return true;
+    }
+
+    removeSceneObject(cache,dataSet,oldLod,listOldData,objId);
+    return false;
+}
+
+// ========================================================================== //
+// ========================================================================== //
+
+void MapRenderer::addNodesToScene(std::vector<NodeRenderData> &listNodeData)
+{
+    for(size_t i=0; i < listNodeData.size(); i++)
+    {   addNodeToScene(listNodeData[i]);   }
+}
+
+void MapRenderer::addWaysToScene(std::vector<WayRenderData> &listWayData)
+{
+    for(size_t i=0; i < listWayData.size(); i++)
+    {   addWayToScene(listWayData[i]);   }
+}
+
+void MapRenderer::addAreasToScene(std::vector<AreaRenderData> &listAreaData)
+{
+    for(size_t i=0; i < listAreaData.size(); i++)
+    {   addAreaToScene(listAreaData[i]);   }
+}
+
+void MapRenderer::addRelAreasToScene(std::vector<RelAreaRenderData> &listRelAreaData)
+{
+    for(size_t i=0; i < listRelAreaData.size(); i++)
+    {   addRelAreaToScene(listRelAreaData[i]);   }
+}
+
+void MapRenderer::removeNodesFromScene(std::vector<NodeRenderData> const &listNodeData)
+{
+    for(size_t i=0; i < listNodeData.size(); i++)
+    {   removeNodeFromScene(listNodeData[i]);   }
+}
+
+void MapRenderer::removeWaysFromScene(std::vector<WayRenderData> const &listWayData)
+{
+    for(size_t i=0; i < listWayData.size(); i++)
+    {   removeWayFromScene(listWayData[i]);   }
+}
+
+void MapRenderer::removeAreasFromScene(std::vector<AreaRenderData> const &listAreaData)
+{
+    for(size_t i=0; i < listAreaData.size(); i++)
+    {   removeAreaFromScene(listAreaData[i]);   }
+}
+
+void MapRenderer::removeRelAreasFromScene(std::vector<RelAreaRenderData> const &listRelAreaData)
+{
+    for(size_t i=0; i < listRelAreaData.size(); i++)
+    {   removeRelAreaFromScene(listRelAreaData[i]);   }
+}
+
+bool MapRenderer::hideNodeInScene(NodeRenderData &)
+{   return false;   }
+
+bool MapRenderer::hideWayInScene(WayRenderData &)
+{   return false;   }
+
+bool MapRenderer::hideAreaInScene(AreaRenderData &)
+{   return false;   }
+
+bool MapRenderer::hideRelAreaInScene(RelAreaRenderData &)
+{   return false;   }
+
+void MapRenderer::showNodeInScene(NodeRenderData &)
+{}
+
+void MapRenderer::showWayInScene(WayRenderData &)
+{}
+
+void MapRenderer::showAreaInScene(AreaRenderData &)
+{}
+
+void MapRenderer::showRelAreaInScene(RelAreaRenderData &)
+{}
+
+bool MapRenderer::restyleNodeInScene(NodeRenderData const &,
+                                     NodeRenderData &)
+{   return false;   }
+
+bool MapRenderer::restyleWayInScene(WayRenderData const &,
+                                    WayRenderData &)
+{   return false;   }
+
+bool MapRenderer::restyleAreaInScene(AreaRenderData const &,
+                                     AreaRenderData &)
+{   return false;   }
+
+bool MapRenderer::restyleRelAreaInScene(RelAreaRenderData const &,
+                                        RelAreaRenderData &)
+{   return false;   }
+
+void MapRenderer::calcBackendMemoryUsage(ObjectMemoryUsage &,
+                                         std::vector<BackendMemoryUsage> &)
+{}
+
+template <typename T>
+void MapRenderer::cacheRenderData(RenderDataCache<T> &cache,
+                                  DataSet const *dataSet,size_t lod,
+                                  osmscout::Id objId,T &renderData)
+{
+    typename RenderDataCache<T>::Entry entry;
+    entry.dataSet = dataSet;
+    entry.lod = lod;
+    entry.objId = objId;
+    entry.numBytes = calcRenderDataSize(renderData);
+    entry.insertTick = m_cacheTick++;
+
+    SceneTypeStats &typeStats = getTypeStats(m_commitStats,renderData);
+    std::chrono::steady_clock::time_point tStart =
+            std::chrono::steady_clock::now();
+
+    entry.hasGeometry = hideInScene(renderData);
+    typeStats.hideMs += calcElapsedMs(tStart);
+
+    if(entry.hasGeometry)   {
+        typeStats.numHidden++;
+    }
+    else   {
+        tStart = std::chrono::steady_clock::now();
+        removeFromScene(renderData);
+        typeStats.removeMs += calcElapsedMs(tStart);
+        typeStats.numRemoved++;
+    }
+
+    entry.renderData = renderData;
+
+    std::vector<typename RenderDataCache<T>::Entry> listReplaced;
+    cache.Insert(entry,listReplaced);
+    releaseCacheEntries<T>(listReplaced);
+}
+
+template <typename T>
+bool MapRenderer::takeCachedGeometry(RenderDataCache<T> &cache,
+                                     DataSet const *dataSet,size_t lod,
+                                     osmscout::Id objId,T &renderData)
+{
+    if(m_cacheMaxBytes == 0)
+    {   return false;   }
+
+    typename RenderDataCache<T>::Entry entry;
+    if(!cache.Take(dataSet,lod,objId,entry) || !entry.hasGeometry)
+    {   return false;   }
+
+    SceneTypeStats &typeStats = getTypeStats(m_commitStats,renderData);
+    std::chrono::steady_clock::time_point tStart =
+            std::chrono::steady_clock::now();
+
+    renderData = entry.renderData;
+    showInScene(renderData);
+    typeStats.showMs += calcElapsedMs(tStart);
+    typeStats.numShown++;
+    return true;
+}
+
+template <typename T>
+void MapRenderer::retainRenderData(T &renderData)
+{
+    if(m_cacheMaxBytes == 0)
+    {   clearRenderData(renderData);   }
+    else if(m_compactRenderData)
+    {   compactRenderData(renderData);   }
+}
+
+template <typename T>
+void MapRenderer::releaseCacheEntries(std::vector<typename RenderDataCache<T>::Entry> &listEntries)
+{
+    for(size_t i=0; i < listEntries.size(); i++)   {
+        if(!listEntries[i].hasGeometry)
+        {   continue;   }
+
+        SceneTypeStats &typeStats =
+                getTypeStats(m_commitStats,listEntries[i].renderData);
+        std::chrono::steady_clock::time_point tStart =
+                std::chrono::steady_clock::now();
+
+        removeFromScene(listEntries[i].renderData);
+        typeStats.removeMs += calcElapsedMs(tStart);
+        typeStats.numRemoved++;
+    }
+}
+
+void MapRenderer::removeCachedRenderData(DataSet const *dataSet)
+{
+    std::vector<RenderDataCache<NodeRenderData>::Entry> listNodeEntries;
+    m_nodeCache.Remove(dataSet,listNodeEntries);
+    releaseCacheEntries<NodeRenderData>(listNodeEntries);
+
+    std::vector<RenderDataCache<WayRenderData>::Entry> listWayEntries;
+    m_wayCache.Remove(dataSet,listWayEntries);
+    releaseCacheEntries<WayRenderData>(listWayEntries);
+
+    std::vector<RenderDataCache<AreaRenderData>::Entry> listAreaEntries;
+    m_areaCache.Remove(dataSet,listAreaEntries);
+    releaseCacheEntries<AreaRenderData>(listAreaEntries);
+
+    std::vector<RenderDataCache<RelAreaRenderData>::Entry> listRelAreaEntries;
+    m_relAreaCache.Remove(dataSet,listRelAreaEntries);
+    releaseCacheEntries<RelAreaRenderData>(listRelAreaEntries);
+}
+
+void MapRenderer::trimRenderDataCache()
+{
+    while(m_nodeCache.GetNumBytes() + m_wayCache.GetNumBytes() +
+          m_areaCache.GetNumBytes() + m_relAreaCache.GetNumBytes() > m_cacheMaxBytes)
+    {
+        // find the oldest entry amongst all object types
+        ObjectType oldestType = OBJ_NODE;
+        size_t oldestTick = 0;
+        size_t insertTick;
+        bool foundEntry = false;
+
+        if(m_nodeCache.PeekOldest(insertTick) &&
+           (!foundEntry || insertTick < oldestTick))
+        {   oldestType = OBJ_NODE;   oldestTick = insertTick;   foundEntry = true;   }
+
+        if(m_wayCache.PeekOldest(insertTick) &&
+           (!foundEntry || insertTick < oldestTick))
+        {   oldestType = OBJ_WAY;   oldestTick = insertTick;   foundEntry = true;   }
+
+        if(m_areaCache.PeekOldest(insertTick) &&
+           (!foundEntry || insertTick < oldestTick))
+        {   oldestType = OBJ_AREA;   oldestTick = insertTick;   foundEntry = true;   }
+
+        if(m_relAreaCache.PeekOldest(insertTick) &&
+           (!foundEntry || insertTick < oldestTick))
+        {   oldestType = OBJ_RELAREA;   oldestTick = insertTick;   foundEntry = true;   }
+
+        if(!foundEntry)
+        {   break;   }
+
+        if(oldestType == OBJ_NODE)   {
+            std::vector<RenderDataCache<NodeRenderData>::Entry> listEntries(1);
+            m_nodeCache.PopOldest(listEntries[0]);
+            releaseCacheEntries<NodeRenderData>(listEntries);
+        }
+        else if(oldestType == OBJ_WAY)   {
+            std::vector<RenderDataCache<WayRenderData>::Entry> listEntries(1);
+            m_wayCache.PopOldest(listEntries[0]);
+            releaseCacheEntries<WayRenderData>(listEntries);
+        }
+        else if(oldestType == OBJ_AREA)   {
+            std::vector<RenderDataCache<AreaRenderData>::Entry> listEntries(1);
+            m_areaCache.PopOldest(listEntries[0]);
+            releaseCacheEntries<AreaRenderData>(listEntries);
+        }
+        else   {
+            std::vector<RenderDataCache<RelAreaRenderData>::Entry> listEntries(1);
+            m_relAreaCache.PopOldest(listEntries[0]);
+            releaseCacheEntries<RelAreaRenderData>(listEntries);
+        }
+        m_cacheEvictions++;
+    }
+}
+
+// ========================================================================== //
+// ========================================================================== //
+
+void MapRenderer::runSceneUpdateWorker()
+{
+    std::unique_lock<std::mutex> lock(m_workerMutex);
+
+    while(true)
+    {
+        // wait for a new camera; the previous update must be
+        // committed first since the render thread modifies
+        // DataSet render data when the update is applied
+        while(!m_workerExit && !(m_workerHasJob && m_pendingUpdate == NULL) &&
+              !m_workerHasPrefetchJob)
+        {   m_workerCondVar.wait(lock);   }
+
+        if(m_workerExit)
+        {   break;   }
+
+        if(!(m_workerHasJob && m_pendingUpdate == NULL))
+        {
+            // prefetching doesn't read DataSet render data
+            // so it can run while an update is uncommitted
+            Camera cam = m_workerCamera;
+            Camera predCam = m_workerPrefetchCamera;
+            std::vector<DataSet*> listDataSets = m_workerDataSets;
+            std::vector<bool> listLODRangesActive = m_listLODRangesActive;
+            size_t generation = m_sceneGeneration;
+            m_workerHasPrefetchJob = false;
+            m_workerBusy = true;
+            lock.unlock();
+
+            std::vector<PrefetchData> listPrefetchData;
+            bool opOk = buildPrefetch(cam,predCam,generation,listDataSets,
+                                      listLODRangesActive,listPrefetchData);
+
+            lock.lock();
+            m_workerBusy = false;
+
+            if(opOk)
+            {   m_listPrefetchData.swap(listPrefetchData);   }
+            else if(m_workerHasJob && m_pendingUpdate == NULL)
+            {   // cancelled; try again after the update
+                m_workerHasPrefetchJob = true;
+            }
+
+            m_workerCondVar.notify_all();
+            continue;
+        }
+
+        // only the most recent camera is used
+        Camera cam = m_workerCamera;
+        std::vector<DataSet*> listDataSets = m_workerDataSets;
+        std::vector<bool> listLODRangesActive = m_listLODRangesActive;
+        m_workerHasJob = false;
+        m_workerBusy = true;
+
+        SceneUpdate * sceneUpdate = new SceneUpdate;
+        sceneUpdate->generation = m_sceneGeneration;
+        lock.unlock();
+
+        bool opOk = buildSceneUpdate(cam,listDataSets,
+                                     listLODRangesActive,*sceneUpdate);
+
+        lock.lock();
+        m_workerBusy = false;
+
+        if(isSceneUpdateCancelled(sceneUpdate->generation))
+        {
+            // a stale update is never committed; the camera
+            // it was superseded by still needs an update (if
+            // the update was dropped instead, the job is
+            // cleared again by waitForWorkerIdle)
+            OSRINFO << "Scene update superseded";
+            m_workerHasJob = true;
+            delete sceneUpdate;
+        }
+        else if(opOk)
+        {   m_pendingUpdate = sceneUpdate;   }
+        else
+        {   delete sceneUpdate;   }
+
+        m_workerCondVar.notify_all();
+    }
+}
+
+void MapRenderer::stopSceneUpdateWorker()
+{
+    if(!m_asyncUpdates)
+    {   return;   }
+
+    {
+        std::unique_lock<std::mutex> lock(m_workerMutex);
+        m_workerExit = true;
+        m_sceneGeneration++;
+        m_workerHasJob = false;
+        m_workerHasPrefetchJob = false;
+        m_workerCondVar.notify_all();
+    }
+    m_workerThread.join();
+    m_asyncUpdates = false;
+}
+
+void MapRenderer::queueSceneUpdate()
+{
+    // a new view supersedes any update that's being built
+    // or that's waiting to be committed for the old one --
+    // an update that's partly committed is finished though
+    // so the scene stays consistent with its DataSets
+    if(calcCameraViewChanged(m_workerCamera,m_camera))
+    {
+        m_sceneGeneration++;
+        if(m_pendingUpdate && !m_pendingUpdate->commitStarted)   {
+            delete m_pendingUpdate;
+            m_pendingUpdate = NULL;
+        }
+    }
 
-    double oldOverlap = overlapArea/oldArea;
-    double newOverlap = overlapArea/newArea;
+    // DataSets are copied since the list may be
+    // changed by the render thread mid-update
+    m_workerCamera = m_camera;
+    m_workerDataSets = m_listDataSets;
+    m_workerHasJob = true;
 
-    if(oldOverlap < 0.75 || newOverlap < 0.75)
-    {
-        // just for debugging TODO
-        showCameraViewArea(m_camera);
+    // prefetch for where the camera is headed
+    // once the update has been built
+    if(m_prefetchTime > 0 && m_camHasVelocity &&
+       calcPredictedCamera(m_prefetchTime,m_workerPrefetchCamera))
+    {   m_workerHasPrefetchJob = true;   }
 
-        // update scene contents
-        OSRDEBUG << "INFO: [Updating Scene Contents...]";
-        updateSceneContents(m_listDataSets);
+    m_workerCondVar.notify_all();
+}
+
+bool MapRenderer::waitForWorkerIdle(std::unique_lock<std::mutex> &lock)
+{
+    // anything the worker is building will be dropped
+    // so let it give up at its next checkpoint
+    m_sceneGeneration++;
+
+    while(m_workerBusy)
+    {   m_workerCondVar.wait(lock);   }
+
+    // the scene and DataSets are only consistent
+    // again once a started update is fully applied
+    if(m_pendingUpdate && m_pendingUpdate->commitStarted)   {
+        CommitBudget budget;
+        commitPendingUpdate(budget);
     }
-    */
+
+    bool droppedUpdate = (m_workerHasJob || m_pendingUpdate);
+    m_workerHasJob = false;
+    m_workerHasPrefetchJob = false;
+    delete m_pendingUpdate;
+    m_pendingUpdate = NULL;
+
+    return droppedUpdate;
 }
 
-// ========================================================================== //
-// ========================================================================== //
+void MapRenderer::commitPendingUpdate(CommitBudget &budget)
+{
+    if(m_pendingUpdate == NULL)
+    {   return;   }
+
+    // the update is applied while holding the lock so the
+    // worker can't read DataSet render data as it changes
+    if(!applySceneUpdate(*m_pendingUpdate,budget))
+    {   return;   }
 
-void MapRenderer::updateNodeRenderData(DataSet *dataSet,
-                                       ListNodeRefsByLod &listNodeRefs)
+    delete m_pendingUpdate;
+    m_pendingUpdate = NULL;
+
+    // let the worker start on the next queued camera
+    m_workerCondVar.notify_all();
+}
+
+bool MapRenderer::buildPrefetch(Camera const &cam,Camera const &predCam,
+                                size_t generation,
+                                std::vector<DataSet*> const &listDataSets,
+                                std::vector<bool> const &listLODRangesWereActive,
+                                std::vector<PrefetchData> &listPrefetchData)
 {
-    size_t thingsAdded = 0; size_t thingsRemoved = 0;
-    ListNodeDataByLod &listNodeData = dataSet->listNodeData;
-    TYPE_UNORDERED_MAP<osmscout::Id,osmscout::NodeRef>::iterator itNew;
-    TYPE_UNORDERED_MAP<osmscout::Id,NodeRenderData>::iterator itOld;
+    OSRTRACE("buildPrefetch","scene");
+    if(listDataSets.size() < 1)
+    {   return false;   }
 
-    for(size_t i=0; i < listNodeRefs.size(); i++)
-    {
-        // remove objects from the old view extents
-        // not present in the new view extents
-        for(itOld = listNodeData[i].begin();
-            itOld != listNodeData[i].end();)
-        {
-            itNew = listNodeRefs[i].find((*itOld).first);
-
-            if(itNew == listNodeRefs[i].end())
-            {   // node dne in new view -- remove it
-                TYPE_UNORDERED_MAP<osmscout::Id,NodeRenderData>::iterator itDelete = itOld;
-                removeNodeFromScene((*itDelete).second); ++itOld;
-                listNodeData[i].erase(itDelete);
-                thingsRemoved++;
-            }
-            else
-            {   ++itOld;   }
-        }
+    std::vector<bool> listCamLODRangesActive,listPredLODRangesActive;
+    ListGeoBoundsByLod listCamBounds,listPredBounds;
+    // the predicted view is treated as the next update
+    // after the current view, for lod hysteresis
+    LODHysteresisStats lodStats;
+    ScratchArena &scratch = *(m_listScratchArenas[0]);
+    if(!calcQueryBounds(cam,listDataSets[0]->listStyleConfigs,
+                        listLODRangesWereActive,listCamLODRangesActive,
+                        listCamBounds,lodStats,scratch) ||
+       !calcQueryBounds(predCam,listDataSets[0]->listStyleConfigs,
+                        listCamLODRangesActive,listPredLODRangesActive,
+                        listPredBounds,lodStats,scratch))
+    {   return false;   }
+
+    size_t num_lod_ranges = listPredBounds.size();
+
+    // only the region the predicted view adds
+    // to the current view is prefetched
+    ListGeoBoundsByLod listPrefetchBounds(num_lod_ranges);
+    for(size_t i=0; i < num_lod_ranges; i++)   {
+        calcGeoBoundsDifference(listPredBounds[i],listCamBounds[i],
+                                listPrefetchBounds[i]);
     }
 
-    for(size_t i=0; i < listNodeRefs.size(); i++)
+    std::vector<ObjectQuery> listObjQueries;
+    for(size_t d=0; d < listDataSets.size(); d++)
     {
-        // add objects from the new view extents
-        // not present in the old view extents
-        NodeRenderData nodeRenderData;
-        for(itNew = listNodeRefs[i].begin();
-            itNew != listNodeRefs[i].end(); ++itNew)
+        for(size_t i=0; i < num_lod_ranges; i++)
         {
-            itOld = listNodeData[i].find((*itNew).first);
+            osmscout::TypeSet const &typeSet =
+                    listDataSets[d]->listStyleConfigs[i]->GetActiveTypeSet();
 
-            if(itOld == listNodeData[i].end())
-            {   // node dne in old view -- add it
-                if(genNodeRenderData(dataSet,(*itNew).second,
-                                     dataSet->listStyleConfigs[i],
-                                     nodeRenderData))
-                {
-                    addNodeToScene(nodeRenderData);
-                    clearNodeRenderData(nodeRenderData);
-                    std::pair<osmscout::Id,NodeRenderData> insPair((*itNew).first,nodeRenderData);
-                    listNodeData[i].insert(insPair);
-                    thingsAdded++;
-                }
+            for(size_t b=0; b < listPrefetchBounds[i].size(); b++)
+            {
+                ObjectQuery objQuery;
+                objQuery.dataSet = listDataSets[d];
+                objQuery.dsIdx = d;
+                objQuery.lod = i;
+                objQuery.listBounds.push_back(listPrefetchBounds[i][b]);
+                objQuery.typeSet = typeSet;
+                objQuery.opOk = false;
+                objQuery.queryMs = 0;
+                listObjQueries.push_back(objQuery);
             }
         }
     }
-}
 
-void MapRenderer::updateWayRenderData(DataSet *dataSet,
-                                      ListWayRefsByLod &listWayRefs)
-{
-    size_t thingsAdded = 0; size_t thingsRemoved = 0;
-    ListWayDataByLod &listWayData = dataSet->listWayData;
-    TYPE_UNORDERED_MAP<osmscout::Id,osmscout::WayRef>::iterator itNew;
-    TYPE_UNORDERED_MAP<osmscout::Id,WayRenderData>::iterator itOld;
+    runObjectQueries(listObjQueries,generation);
 
-    // note:
-    // we first remove all objects that need to be removed
-    // before adding new objects; to do this we go through
-    // each LOD to remove objects before adding new ones
+    if(isPrefetchCancelled() || isSceneUpdateCancelled(generation))
+    {   return false;   }
+
+    // sort everything found into a SceneUpdate so render
+    // data is generated the same way as for the scene
+    SceneUpdate prefetchUpdate;
+    prefetchUpdate.camera = predCam;
+    prefetchUpdate.generation = generation;
+    prefetchUpdate.listDataSetUpdates.resize(listDataSets.size());
+    listPrefetchData.resize(listDataSets.size());
 
-    for(size_t i=0; i < listWayRefs.size(); i++)
+    // render data from the last prefetch is reused
+    std::vector<PrefetchData const *> listLastPrefetch(listDataSets.size());
+
+    size_t q=0;
+    for(size_t d=0; d < listDataSets.size(); d++)
     {
-        // remove objects from the old view extents
-        // not present in the new view extents
-        for(itOld = listWayData[i].begin();
-            itOld != listWayData[i].end();)
+        DataSet * dataSet = listDataSets[d];
+        DataSetUpdate &dsUpdate = prefetchUpdate.listDataSetUpdates[d];
+        dsUpdate.dataSet = dataSet;
+        dsUpdate.listNodeAdds.resize(num_lod_ranges);
+        dsUpdate.listWayAdds.resize(num_lod_ranges);
+        dsUpdate.listAreaAdds.resize(num_lod_ranges);
+        dsUpdate.listRelAreaAdds.resize(num_lod_ranges);
+
+        PrefetchData &prefetch = listPrefetchData[d];
+        prefetch.dataSet = dataSet;
+        prefetch.listBounds.resize(num_lod_ranges);
+        prefetch.listNodeData.resize(num_lod_ranges);
+        prefetch.listWayData.resize(num_lod_ranges);
+        prefetch.listAreaData.resize(num_lod_ranges);
+        prefetch.listRelAreaData.resize(num_lod_ranges);
+
+        listLastPrefetch[d] = findPrefetchData(dataSet);
+        if(listLastPrefetch[d] &&
+           listLastPrefetch[d]->listBounds.size() != num_lod_ranges)
+        {   listLastPrefetch[d] = NULL;   }
+
+        // closer lods take precedence as usual
+        IdSet setNodesAllLods;
+        IdSet setWaysAllLods;
+        IdSet setAreasAllLods;
+        IdSet setRelAreasAllLods;
+
+        for(size_t i=0; i < num_lod_ranges; i++)
         {
-            itNew = listWayRefs[i].find((*itOld).first);
+            std::vector<GeoBounds> const &listBounds = listPrefetchBounds[i];
+            RenderStyleConfig const * renderStyle = dataSet->listStyleConfigs[i];
 
-            if(itNew == listWayRefs[i].end())
-            {   // way dne in new view -- remove it
-                TYPE_UNORDERED_MAP<osmscout::Id,WayRenderData>::iterator itDelete = itOld;
+            size_t qBegin = q;
+            bool opOk = true;
+            for(; q < listObjQueries.size() &&
+                  listObjQueries[q].dsIdx == d &&
+                  listObjQueries[q].lod == i; q++)
+            {   opOk = opOk && listObjQueries[q].opOk;   }
 
-                if(OPT_TRACK_SHARED_NODES)   {
-                    removeWayFromSharedNodes(dataSet->listSharedNodes[i],
-                                             itDelete->second.wayRef);
-                }
+            // a region that couldn't be queried isn't covered
+            if(!opOk)
+            {   continue;   }
 
-                removeWayFromScene((*itDelete).second); ++itOld;
-                listWayData[i].erase(itDelete);
-                thingsRemoved++;
-            }
-            else
-            {   ++itOld;   }
-        }
-    }
+            prefetch.listBounds[i] = listBounds;
 
-    for(size_t i=0; i < listWayRefs.size(); i++)
-    {
-        // we pass ways to the render implementation
-        // in order of descending layer
-        std::multimap<size_t,osmscout::WayRef> listOrderedWayRefs;
-        std::multimap<size_t,osmscout::WayRef>::iterator itOrdered;
+            for(size_t k=qBegin; k < q; k++)
+            {
+                ObjectQuery const &objQuery = listObjQueries[k];
 
-        for(itNew = listWayRefs[i].begin();
-            itNew != listWayRefs[i].end(); ++itNew)
-        {
-            osmscout::TypeId wayType = itNew->second->GetType();
-            std::pair<size_t,osmscout::WayRef> insData;
-            insData.first = 1000 - dataSet->listStyleConfigs[i]->GetWayLayer(wayType);
-            insData.second = itNew->second;
-            listOrderedWayRefs.insert(insData);
-        }
+                // [nodes]
+                std::vector<osmscout::NodeRef>::const_iterator nodeIt;
+                for(nodeIt = objQuery.listNodeRefs.begin();
+                    nodeIt != objQuery.listNodeRefs.end(); ++nodeIt)
+                {
+                    if(renderStyle->GetNodeTypeIsValid((*nodeIt)->GetType()) &&
+                       calcPointInGeoBounds((*nodeIt)->GetLat(),(*nodeIt)->GetLon(),listBounds) &&
+                       setNodesAllLods.insert((*nodeIt)->GetId()).second)
+                    {
+                        NodeRenderData nodeRenderData;
+                        nodeRenderData.nodeRef = *nodeIt;
+                        dsUpdate.listNodeAdds[i].push_back(nodeRenderData);
+                    }
+                }
 
-        // add objects from the new view extents
-        // not present in the old view extents
-        WayRenderData wayRenderData;
-        for(itOrdered = listOrderedWayRefs.begin();
-            itOrdered != listOrderedWayRefs.end(); ++itOrdered)
-        {
-            itOld = listWayData[i].find(itOrdered->second->GetId());
-
-            if(itOld == listWayData[i].end())
-            {   // way dne in old iew -- add it
-                if(genWayRenderData(dataSet,itOrdered->second,
-                                    dataSet->listStyleConfigs[i],
-                                    dataSet->listSharedNodes[i],
-                                    wayRenderData))
+                // [ways]
+                std::vector<osmscout::WayRef>::const_iterator wayIt;
+                for(wayIt = objQuery.listWayRefs.begin();
+                    wayIt != objQuery.listWayRefs.end(); ++wayIt)
+                {
+                    if(renderStyle->GetWayTypeIsValid((*wayIt)->GetType()) &&
+                       calcPointsInGeoBounds((*wayIt)->nodes,listBounds) &&
+                       setWaysAllLods.insert((*wayIt)->GetId()).second)
+                    {
+                        WayRenderData wayRenderData;
+                        wayRenderData.wayRef = *wayIt;
+                        dsUpdate.listWayAdds[i].push_back(wayRenderData);
+                    }
+                }
+
+                // [areas]
+                std::vector<osmscout::WayRef>::const_iterator areaIt;
+                for(areaIt = objQuery.listAreaRefs.begin();
+                    areaIt != objQuery.listAreaRefs.end(); ++areaIt)
+                {
+                    if(renderStyle->GetAreaTypeIsValid((*areaIt)->GetType()) &&
+                       calcPointsInGeoBounds((*areaIt)->nodes,listBounds) &&
+                       setAreasAllLods.insert((*areaIt)->GetId()).second)
+                    {
+                        AreaRenderData areaRenderData;
+                        areaRenderData.lod = i;
+                        areaRenderData.areaRef = *areaIt;
+                        dsUpdate.listAreaAdds[i].push_back(areaRenderData);
+                    }
+                }
+
+                // [relation areas]
+                std::vector<osmscout::RelationRef>::const_iterator relAreaIt;
+                for(relAreaIt = objQuery.listRelAreaRefs.begin();
+                    relAreaIt != objQuery.listRelAreaRefs.end(); ++relAreaIt)
                 {
-                    addWayToScene(wayRenderData);
-                    clearWayRenderData(wayRenderData);
-                    std::pair<osmscout::Id,WayRenderData> insPair;
-                    insPair.first = itOrdered->second->GetId();
-                    insPair.second = wayRenderData;
-                    listWayData[i].insert(insPair);
-                    thingsAdded++;
+                    osmscout::RelationRef const &relRef = *relAreaIt;
+                    if(!renderStyle->GetAreaTypeIsValid(relRef->GetType()))
+                    {   continue;   }
+
+                    for(size_t r=0; r < relRef->roles.size(); r++)
+                    {
+                        if(calcPointsInGeoBounds(relRef->roles[r].nodes,listBounds))   {
+                            if(setRelAreasAllLods.insert(relRef->GetId()).second)   {
+                                RelAreaRenderData relRenderData;
+                                relRenderData.relRef = relRef;
+                                dsUpdate.listRelAreaAdds[i].push_back(relRenderData);
+                            }
+                            break;
+                        }
+                    }
                 }
             }
         }
     }
-}
 
-void MapRenderer::updateAreaRenderData(DataSet *dataSet,
-                                       ListAreaRefsByLod &listAreaRefs)
-{
-    ListAreaDataByLod &listAreaData = dataSet->listAreaData;
-    TYPE_UNORDERED_MAP<osmscout::Id,osmscout::WayRef>::iterator itNew;
-    TYPE_UNORDERED_MAP<osmscout::Id,AreaRenderData>::iterator itOld;
+    if(isPrefetchCancelled())
+    {   return false;   }
+
+    for(size_t d=0; d < listDataSets.size(); d++)
+    {   orderQueuedAdds(predCam,prefetchUpdate.listDataSetUpdates[d]);   }
 
-    for(size_t i=0; i < listAreaRefs.size(); i++)
+    if(!genSceneUpdateRenderData(prefetchUpdate,listLastPrefetch,false))
+    {   return false;   }
+
+    // index render data by id for scene updates
+    for(size_t d=0; d < listDataSets.size(); d++)
     {
-        // remove objects from the old view extents
-        // not present in the new view extents
-        for(itOld = listAreaData[i].begin();
-            itOld != listAreaData[i].end();)
+        DataSetUpdate &dsUpdate = prefetchUpdate.listDataSetUpdates[d];
+        PrefetchData &prefetch = listPrefetchData[d];
+
+        for(size_t i=0; i < num_lod_ranges; i++)
         {
-            itNew = listAreaRefs[i].find((*itOld).first);
+            for(size_t j=0; j < dsUpdate.listNodeAdds[i].size(); j++)   {
+                NodeRenderData const &nodeRenderData = dsUpdate.listNodeAdds[i][j];
+                prefetch.listNodeData[i].insert(std::make_pair(
+                    nodeRenderData.nodeRef->GetId(),nodeRenderData));
+            }
+
+            for(size_t j=0; j < dsUpdate.listWayAdds[i].size(); j++)   {
+                WayRenderData &wayRenderData = dsUpdate.listWayAdds[i][j];
+                if(m_compactRenderData)
+                {   compactRenderData(wayRenderData);   }
 
-            if(itNew == listAreaRefs[i].end())
-            {   // dne in new view -- remove it
-                TYPE_UNORDERED_MAP<osmscout::Id,AreaRenderData>::iterator itDelete = itOld;
-                removeAreaFromScene((*itDelete).second); ++itOld;
-                listAreaData[i].erase(itDelete);
+                prefetch.listWayData[i].insert(std::make_pair(
+                    wayRenderData.wayRef->GetId(),wayRenderData));
             }
-            else
-            {   ++itOld;   }
-        }
-    }
 
-    for(size_t i=0; i < listAreaRefs.size(); i++)
-    {
-        // add objects from the new view extents
-        // not present in the old view extents
-        for(itNew = listAreaRefs[i].begin();
-            itNew != listAreaRefs[i].end(); ++itNew)
-        {
-            itOld = listAreaData[i].find((*itNew).first);
+            for(size_t j=0; j < dsUpdate.listAreaAdds[i].size(); j++)   {
+                AreaRenderData &areaRenderData = dsUpdate.listAreaAdds[i][j];
+                if(m_compactRenderData)
+                {   compactRenderData(areaRenderData);   }
+
+                prefetch.listAreaData[i].insert(std::make_pair(
+                    areaRenderData.areaRef->GetId(),areaRenderData));
+            }
 
-            if(itOld == listAreaData[i].end())
-            {   // dne in old view -- add it
-                AreaRenderData areaRenderData;
-                areaRenderData.lod = i;
+            for(size_t j=0; j < dsUpdate.listRelAreaAdds[i].size(); j++)   {
+                RelAreaRenderData &relRenderData = dsUpdate.listRelAreaAdds[i][j];
+                if(m_compactRenderData)
+                {   compactRenderData(relRenderData);   }
 
-                if(genAreaRenderData(dataSet,(*itNew).second,
-                                     dataSet->listStyleConfigs[i],
-                                     areaRenderData))
-                {
-                    addAreaToScene(areaRenderData);
-                    clearAreaRenderData(areaRenderData);
-                    std::pair<osmscout::Id,AreaRenderData> insPair((*itNew).first,areaRenderData);
-                    listAreaData[i].insert(insPair);
-                }
+                prefetch.listRelAreaData[i].insert(std::make_pair(
+                    relRenderData.relRef->GetId(),relRenderData));
             }
         }
     }
+
+    return true;
 }
 
-void MapRenderer::updateRelWayRenderData(DataSet *dataSet,
-                                         ListRelWayRefsByLod &listRelWayRefs)
+bool MapRenderer::isSceneUpdateCancelled(size_t generation)
+{   return (generation != m_sceneGeneration);   }
+
+bool MapRenderer::isPrefetchCancelled()
 {
-    // todo
+    std::unique_lock<std::mutex> lock(m_workerMutex);
+    return (m_workerExit || (m_workerHasJob && m_pendingUpdate == NULL));
 }
 
-void MapRenderer::updateRelAreaRenderData(DataSet *dataSet,
-                                          ListRelAreaRefsByLod &listRelAreaRefs)
+PrefetchData const * MapRenderer::findPrefetchData(DataSet const *dataSet)
 {
-    ListRelAreaDataByLod &listRelAreaData = dataSet->listRelAreaData;
-    TYPE_UNORDERED_MAP<osmscout::Id,osmscout::RelationRef>::iterator itNew;
-    TYPE_UNORDERED_MAP<osmscout::Id,RelAreaRenderData>::iterator itOld;
+    for(size_t i=0; i < m_listPrefetchData.size(); i++)   {
+        if(m_listPrefetchData[i].dataSet == dataSet)   {
+            return &(m_listPrefetchData[i]);
+        }
+    }
+    return NULL;
+}
+
+void MapRenderer::updateCameraVelocity()
+{
+    std::chrono::steady_clock::time_point timeNow =
+            std::chrono::steady_clock::now();
 
-    for(size_t i=0; i < listRelAreaRefs.size(); i++)
+    double dt = std::chrono::duration<double>(timeNow-m_camLastTime).count();
+
+    if(m_camHasLastEye && dt < 1E-3)
+    {   return;   }
+
+    // the camera isn't following a path if it
+    // hasn't been updated for a while
+    if(m_camHasLastEye && dt < 5.0)
     {
-        // remove objects from the old view extents
-        // not present in the new view extents
-        for(itOld = listRelAreaData[i].begin();
-            itOld != listRelAreaData[i].end();)
-        {
-            itNew = listRelAreaRefs[i].find((*itOld).first);
+        Vec3 velocity = (m_camera.eye-m_camLastEye).ScaledBy(1.0/dt);
 
-            if(itNew == listRelAreaRefs[i].end())
-            {   // dne in new view -- remove it
-                TYPE_UNORDERED_MAP<osmscout::Id,RelAreaRenderData>::iterator itDelete = itOld;
-                removeRelAreaFromScene((*itDelete).second); ++itOld;
-                listRelAreaData[i].erase(itDelete);
-            }
-            else
-            {   ++itOld;   }
+        if(m_camHasVelocity)   {
+            m_camVelocity = m_camVelocity.ScaledBy(0.5) +
+                            velocity.ScaledBy(0.5);
+        }
+        else   {
+            m_camVelocity = velocity;
         }
+        m_camHasVelocity = true;
     }
+    else
+    {   m_camHasVelocity = false;   }
 
-    for(size_t i=0; i < listRelAreaRefs.size(); i++)
-    {
-        // add objects from the new view extents
-        // not present in the old view extents
-        for(itNew = listRelAreaRefs[i].begin();
-            itNew != listRelAreaRefs[i].end(); ++itNew)
-        {
-            itOld = listRelAreaData[i].find((*itNew).first);
+    m_camLastEye = m_camera.eye;
+    m_camLastTime = timeNow;
+    m_camHasLastEye = true;
+}
 
-            if(itOld == listRelAreaData[i].end())
-            {   // dne in old view -- add it
-                RelAreaRenderData relRenderData;
+bool MapRenderer::calcPredictedCamera(double lookAheadSecs,Camera &predCam)
+{
+    Vec3 offset = m_camVelocity.ScaledBy(lookAheadSecs);
 
-                if(genRelAreaRenderData(dataSet,(*itNew).second,
-                                        dataSet->listStyleConfigs[i],
-                                        relRenderData))
-                {
-                    addRelAreaToScene(relRenderData);
-                    clearRelAreaRenderData(relRenderData);
-                    std::pair<osmscout::Id,RelAreaRenderData> insPair((*itNew).first,relRenderData);
-                    listRelAreaData[i].insert(insPair);
-                }
-            }
-        }
-    }
+    // ignore movement that's small relative to
+    // how much of the ground the camera can see
+    if(offset.Magnitude() < m_camera.LLA.alt*0.05)
+    {   return false;   }
+
+    // the prediction follows the Earth's surface
+    PointLLA predLLA = convECEFToLLA(m_camera.eye+offset);
+    predLLA.alt = m_camera.LLA.alt;
+
+    predCam = m_camera;
+    predCam.LLA = predLLA;
+    predCam.eye = convLLAToECEF(predLLA);
+    predCam.viewPt = m_camera.viewPt + (predCam.eye-m_camera.eye);
+
+    return calcCamViewExtents(predCam);
 }
 
 // ========================================================================== //
@@ -862,13 +3562,14 @@ bool MapRenderer::genNodeRenderData(DataSet *dataSet,
                                     const RenderStyleConfig *renderStyle,
                                     NodeRenderData &nodeRenderData)
 {
-    osmscout::TypeId nodeType = nodeRef->GetType();
+    OSRTRACE("genNodeRenderData","gen");
+    TypeStyle const &typeStyle = renderStyle->GetTypeStyle(nodeRef->GetType());
 
     nodeRenderData.nodeRef = nodeRef;
     nodeRenderData.fillRenderStyle =
-            renderStyle->GetNodeFillStyle(nodeType);
+            renderStyle->GetFillStyle(typeStyle.nodeFill);
     nodeRenderData.symbolRenderStyle =
-            renderStyle->GetNodeSymbolStyle(nodeType);
+            renderStyle->GetSymbolStyle(typeStyle.nodeSymbol);
 
     // get node geometry
     nodeRenderData.nodePosn =
@@ -883,7 +3584,7 @@ bool MapRenderer::genNodeRenderData(DataSet *dataSet,
         {   sRef = nodeRef->GetTagValue(i);   }
     }
 
-    LabelStyle const * labelStyle = renderStyle->GetNodeNameLabelStyle(nodeType);
+    LabelStyle const * labelStyle = renderStyle->GetLabelStyle(typeStyle.nodeLabel);
     if(labelStyle == NULL)
     {   nodeRenderData.hasLabel = false;   }
     else   {
@@ -898,18 +3599,29 @@ bool MapRenderer::genNodeRenderData(DataSet *dataSet,
 bool MapRenderer::genWayRenderData(DataSet *dataSet,
                                    osmscout::WayRef const &wayRef,
                                    RenderStyleConfig const *renderStyle,
-                                   ListSharedNodes &listSharedNodes,
-                                   WayRenderData &wayRenderData)
+                                   WayRenderData &wayRenderData,
+                                   ScratchArena &scratch)
 {
+    OSRTRACE("genWayRenderData","gen");
     osmscout::TypeId wayType = wayRef->GetType();
+    TypeStyle const &typeStyle = renderStyle->GetTypeStyle(wayType);
 
     // set general way properties
     wayRenderData.wayRef = wayRef;
-    wayRenderData.wayLayer = renderStyle->GetWayLayer(wayType);
-    wayRenderData.lineRenderStyle = renderStyle->GetWayLineStyle(wayType);
+    wayRenderData.wayLayer = typeStyle.wayLayer;
+    wayRenderData.lineRenderStyle = renderStyle->GetLineStyle(typeStyle.wayLine);
 
     // build way geometry
-    wayRenderData.listWayPoints.resize(wayRef->nodes.size());
+    ScratchScope scope(scratch);
+    std::vector<PointLLA> &listPointLLA = scratch.Take<PointLLA>();
+    listPointLLA.resize(wayRef->nodes.size());
+    for(size_t i=0; i < wayRef->nodes.size(); i++)   {
+        listPointLLA[i] = PointLLA(wayRef->nodes[i].GetLat(),
+                                   wayRef->nodes[i].GetLon(),0.0);
+    }
+    wayRenderData.wayPoints.Clear();
+    convLLAToECEF(listPointLLA,wayRenderData.wayPoints);
+    wayRenderData.wayPoints.EndPart();
 
     if(wayType == dataSet->GetTypeConfig()->GetTypeId("_tile_coastline"))
     {   // if the way is coastline data, we encode breaks
@@ -920,42 +3632,19 @@ bool MapRenderer::genWayRenderData(DataSet *dataSet,
             double lat = wayRef->nodes[i].GetLat();
             double lon = wayRef->nodes[i].GetLon();
             if((lat == 0) && (lon == 0))   {
-                wayRenderData.listWayPoints[i] = Vec3(0,0,0);
-            }
-            else   {
-                wayRenderData.listWayPoints[i] =
-                        convLLAToECEF(PointLLA(lat,lon,0.0));
+                wayRenderData.wayPoints.SetPoint(i,Vec3(0,0,0));
             }
         }
         wayRenderData.isCoast = true;
     }
     else
-    {   // if the way can be a street type, we need to save
-        // shared nodes to get intersection data
-        for(size_t i=0; i < wayRef->nodes.size(); i++)   {
-            wayRenderData.listWayPoints[i] =
-                    convLLAToECEF(PointLLA(wayRef->nodes[i].GetLat(),
-                                           wayRef->nodes[i].GetLon(),0.0));
-
-            if(OPT_TRACK_SHARED_NODES)   {
-                WayXSec wayxs;
-                wayxs.wayId     = wayRef->GetId();
-                wayxs.isUsed    = false;
-
-                std::pair<osmscout::Id,WayXSec> nodeInWay(wayRef->nodes[i].GetId(),wayxs);
-                listSharedNodes.insert(nodeInWay);
-            }
-        }
+    {   // intersections are found once the way is
+        // added to the scene (see applyWayAdd)
         wayRenderData.isCoast = false;
     }
 
-    if(OPT_TRACK_SHARED_NODES)   {
-        this->getListSharedWayNodes(listSharedNodes,wayRef,
-            wayRenderData.listIntersections);
-    }
-
     // way label data
-    LabelStyle const * labelStyle = renderStyle->GetWayNameLabelStyle(wayType);
+    LabelStyle const * labelStyle = renderStyle->GetLabelStyle(typeStyle.wayLabel);
     if(labelStyle == NULL)
     {   wayRenderData.hasLabel = false;   }
     else   {
@@ -980,15 +3669,20 @@ bool MapRenderer::genRelWayRenderData(DataSet *dataSet,
 bool MapRenderer::genAreaRenderData(DataSet *dataSet,
                                     const osmscout::WayRef &areaRef,
                                     const RenderStyleConfig *renderStyle,
-                                    AreaRenderData &areaRenderData)
+                                    AreaRenderData &areaRenderData,
+                                    ScratchArena &scratch)
 {
+    OSRTRACE("genAreaRenderData","gen");
+
     // ensure that the area is valid before building
     // the area geometry in ecef coordinates
     double minLat = 200;
     double minLon = 200;
     double maxLat = -200;
     double maxLon = -200;
-    std::vector<Vec2> listOuterPoints(areaRef->nodes.size());
+    ScratchScope scope(scratch);
+    std::vector<Vec2> &listOuterPoints = scratch.Take<Vec2>();
+    listOuterPoints.resize(areaRef->nodes.size());
     for(int i=0; i < listOuterPoints.size(); i++)
     {
         double myLat = areaRef->nodes[i].GetLat();
@@ -1004,12 +3698,12 @@ bool MapRenderer::genAreaRenderData(DataSet *dataSet,
     }
 
     if(!this->calcAreaIsValid(listOuterPoints))   {
-        OSRDEBUG << "WARN: AreaRef " << areaRef->GetId()
-                 << " is invalid";
+        OSRWARN << "AreaRef " << areaRef->GetId()
+               << " is invalid";
         return false;
     }
 
-    osmscout::TypeId areaType = areaRef->GetType();
+    TypeStyle const &typeStyle = renderStyle->GetTypeStyle(areaRef->GetType());
 
     // check if area is a building
     double areaHeight = 0;
@@ -1032,10 +3726,9 @@ bool MapRenderer::genAreaRenderData(DataSet *dataSet,
 
     // set area data
     areaRenderData.areaRef = areaRef;
-    areaRenderData.areaLayer =
-            renderStyle->GetAreaLayer(areaType);
+    areaRenderData.areaLayer = typeStyle.areaLayer;
     areaRenderData.fillRenderStyle =
-            renderStyle->GetAreaFillStyle(areaType);
+            renderStyle->GetFillStyle(typeStyle.areaFill);
 
     if(areaRenderData.isBuilding)   {
         if(areaHeight > 0)   {
@@ -1055,13 +3748,16 @@ bool MapRenderer::genAreaRenderData(DataSet *dataSet,
     }
 
     // convert area geometry to ecef
-    areaRenderData.listOuterPoints.resize(listOuterPoints.size());
-    for(int i=0; i < listOuterPoints.size(); i++)
+    std::vector<PointLLA> &listPointLLA = scratch.Take<PointLLA>();
+    listPointLLA.resize(listOuterPoints.size());
+    for(size_t i=0; i < listOuterPoints.size(); i++)
     {
-        areaRenderData.listOuterPoints[i] =
-                convLLAToECEF(PointLLA(listOuterPoints[i].y,
-                                       listOuterPoints[i].x,0.0));
+        listPointLLA[i] = PointLLA(listOuterPoints[i].y,
+                                   listOuterPoints[i].x,0.0);
     }
+    areaRenderData.areaPoints.Clear();
+    convLLAToECEF(listPointLLA,areaRenderData.areaPoints);
+    areaRenderData.areaPoints.EndPart();
 
     // save center point
     double centerLat,centerLon;
@@ -1072,7 +3768,7 @@ bool MapRenderer::genAreaRenderData(DataSet *dataSet,
     // set area label
     areaRenderData.nameLabel = areaRef->GetName();
     areaRenderData.nameLabelRenderStyle =
-            renderStyle->GetAreaNameLabelStyle(areaType);
+            renderStyle->GetLabelStyle(typeStyle.areaLabel);
     areaRenderData.hasName = (areaRenderData.nameLabel.size() > 0) &&
             !(areaRenderData.nameLabelRenderStyle == NULL);
 
@@ -1082,8 +3778,11 @@ bool MapRenderer::genAreaRenderData(DataSet *dataSet,
 bool MapRenderer::genRelAreaRenderData(DataSet *dataSet,
                                        const osmscout::RelationRef &relRef,
                                        const RenderStyleConfig *renderStyle,
-                                       RelAreaRenderData &relRenderData)
+                                       RelAreaRenderData &relRenderData,
+                                       ScratchArena &scratch)
 {
+    OSRTRACE("genRelAreaRenderData","gen");
+
     // create a separate area for each ring by
     // clipping its immediate children (ie 1's are
     // children of 0, 2's are children of 1)
@@ -1138,9 +3837,10 @@ bool MapRenderer::genRelAreaRenderData(DataSet *dataSet,
         // type -- roles/relations that have way (or other)
         // are not currently supported
         if(!renderStyle->GetAreaTypeIsValid(areaType))   {
-            OSRDEBUG << "WARN: Relation " << relRef->GetId() << " has a non-area type";
+            OSRWARN << "Relation " << relRef->GetId() << " has a non-area type";
             continue;
         }
+        TypeStyle const &typeStyle = renderStyle->GetTypeStyle(areaType);
 
         std::vector<Vec2>                 listOuterPts;
         std::vector<std::vector<Vec2> >   listListInnerPts;
@@ -1184,8 +3884,8 @@ bool MapRenderer::genRelAreaRenderData(DataSet *dataSet,
 
         if(!this->calcAreaIsValid(listOuterPts,listListInnerPts))
         {
-            OSRDEBUG << "WARN: AreaRef " << relRef->GetId()
-                     << " is invalid";
+            OSRWARN << "AreaRef " << relRef->GetId()
+                   << " is invalid";
             return false;
 
             // todo: there are different ways we can handle a complex
@@ -1262,8 +3962,8 @@ bool MapRenderer::genRelAreaRenderData(DataSet *dataSet,
         }
 
         // set area properties/materials
-        areaData.areaLayer = renderStyle->GetAreaLayer(areaType);
-        areaData.fillRenderStyle = renderStyle->GetAreaFillStyle(areaType);
+        areaData.areaLayer = typeStyle.areaLayer;
+        areaData.fillRenderStyle = renderStyle->GetFillStyle(typeStyle.areaFill);
 
         if(areaData.isBuilding)   {
             if(areaHeight > 0)  {
@@ -1273,26 +3973,29 @@ bool MapRenderer::genRelAreaRenderData(DataSet *dataSet,
         }
 
         // convert outer relation area geometry to ecef
-        areaData.listOuterPoints.resize(listOuterPts.size());
-        for(int j=0; j < listOuterPts.size(); j++)
+        ScratchScope scope(scratch);
+        std::vector<PointLLA> &listPointLLA = scratch.Take<PointLLA>();
+        listPointLLA.resize(listOuterPts.size());
+        for(size_t j=0; j < listOuterPts.size(); j++)
         {
-            areaData.listOuterPoints[j] =
-                    convLLAToECEF(PointLLA(listOuterPts[j].y,
-                                           listOuterPts[j].x,0.0));
+            listPointLLA[j] = PointLLA(listOuterPts[j].y,
+                                       listOuterPts[j].x,0.0);
         }
+        convLLAToECEF(listPointLLA,areaData.areaPoints);
 
-        // convert inner relation area geometry to ecef
-        areaData.listListInnerPoints.resize(listListInnerPts.size());
-        for(int j=0; j < listListInnerPts.size(); j++)
+        // convert inner relation area geometry to ecef,
+        // each inner ring follows the outer one
+        for(size_t j=0; j < listListInnerPts.size(); j++)
         {
-            areaData.listListInnerPoints[j].resize(listListInnerPts[j].size());
-            for(int k=0; k < listListInnerPts[j].size(); k++)
+            listPointLLA.resize(listListInnerPts[j].size());
+            for(size_t k=0; k < listListInnerPts[j].size(); k++)
             {
-                areaData.listListInnerPoints[j][k] =
-                        convLLAToECEF(PointLLA(listListInnerPts[j][k].y,
-                                               listListInnerPts[j][k].x,0.0));
+                listPointLLA[k] = PointLLA(listListInnerPts[j][k].y,
+                                           listListInnerPts[j][k].x,0.0);
             }
+            convLLAToECEF(listPointLLA,areaData.areaPoints);
         }
+        areaData.areaPoints.EndPart();
 
         // center point
         double cLat,cLon;
@@ -1301,7 +4004,7 @@ bool MapRenderer::genRelAreaRenderData(DataSet *dataSet,
 
         // set area label
         areaData.nameLabelRenderStyle =
-                renderStyle->GetAreaNameLabelStyle(areaType);
+                renderStyle->GetLabelStyle(typeStyle.areaLabel);
         areaData.hasName = (areaData.nameLabel.size() > 0) &&
                 !(areaData.nameLabelRenderStyle == NULL);
 
@@ -1338,15 +4041,16 @@ void MapRenderer::clearNodeRenderData(NodeRenderData &nodeRenderData)
 
 void MapRenderer::clearWayRenderData(WayRenderData &wayRenderData)
 {
-    wayRenderData.listWayPoints.clear();
+    wayRenderData.wayPoints.Clear();
+    wayRenderData.wayOffsets.Clear();
     wayRenderData.listIntersections.clear();
     wayRenderData.nameLabel.clear();
 }
 
 void MapRenderer::clearAreaRenderData(AreaRenderData &areaRenderData)
 {
-    areaRenderData.listOuterPoints.clear();
-    areaRenderData.listListInnerPoints.clear();
+    areaRenderData.areaPoints.Clear();
+    areaRenderData.areaOffsets.Clear();
     areaRenderData.nameLabel.clear();
 }
 
@@ -1363,47 +4067,22 @@ void MapRenderer::clearRelAreaRenderData(RelAreaRenderData &relRenderData)
 // ========================================================================== //
 // ========================================================================== //
 
-void MapRenderer::getListSharedWayNodes(ListSharedNodes &listSharedNodes,
-                                        osmscout::WayRef const &wayRef,
-                                        std::vector<std::vector<WayXSec *> > &listWayXsec)
-{
-    TYPE_UNORDERED_MULTIMAP<osmscout::Id,WayXSec>::iterator itShNode;
-    std::pair<TYPE_UNORDERED_MULTIMAP<osmscout::Id,WayXSec>::iterator,
-              TYPE_UNORDERED_MULTIMAP<osmscout::Id,WayXSec>::iterator> itRange;
-
-    listWayXsec.resize(wayRef->nodes.size());
-    for(size_t i=0; i < wayRef->nodes.size(); i++)
-    {
-        std::vector<WayXSec*> listNodeXsec;
-
-        itRange = listSharedNodes.equal_range(wayRef->nodes[i].GetId());
-        for(itShNode = itRange.first; itShNode != itRange.second;)   {
-            listNodeXsec.push_back(&(itShNode->second));
-            ++itShNode;
-        }
-        listWayXsec[i] = listNodeXsec;
-    }
-}
-
-void MapRenderer::removeWayFromSharedNodes(ListSharedNodes &listSharedNodes,
-                                           osmscout::WayRef const &wayRef)
+void MapRenderer::addWaysToSharedNodes(DataSetUpdate &dsUpdate)
 {
-    TYPE_UNORDERED_MULTIMAP<osmscout::Id,WayXSec>::iterator itShNode,itDelete;
-    std::pair<TYPE_UNORDERED_MULTIMAP<osmscout::Id,WayXSec>::iterator,
-              TYPE_UNORDERED_MULTIMAP<osmscout::Id,WayXSec>::iterator> itRange;
-
-    for(size_t i=0; i < wayRef->nodes.size(); i++)
+    DataSet * dataSet = dsUpdate.dataSet;
+    for(size_t i=0; i < dsUpdate.listWayAdds.size(); i++)
     {
-        itRange = listSharedNodes.equal_range(wayRef->nodes[i].GetId());
-
-        for(itShNode = itRange.first; itShNode != itRange.second;)   {
-            if(itShNode->second.wayId == wayRef->GetId())   {
-                itDelete = itShNode; ++itShNode;
-                listSharedNodes.erase(itDelete);
+        SharedNodeIndex &sharedNodes = dataSet->listSharedNodes[i];
+
+        std::vector<WayRenderData> const &listWayAdds = dsUpdate.listWayAdds[i];
+        for(size_t k=0; k < listWayAdds.size(); k++)   {
+            WayRenderData const &wayRenderData = listWayAdds[k];
+            if(!wayRenderData.isCoast)   {
+                sharedNodes.AddWay(wayRenderData.wayRef->GetId(),
+                                   wayRenderData.wayRef->nodes);
             }
-            else
-            {   ++itShNode;   }
         }
+        sharedNodes.Update();
     }
 }
 
@@ -1506,6 +4185,130 @@ PointLLA MapRenderer::convECEFToLLA(const Vec3 &pointECEF)
     return pointLLA;
 }
 
+void MapRenderer::convLLAToECEF(std::vector<PointLLA> const &listPointLLA,
+                                GeomBuffer &buffECEF)
+{
+    size_t numPts = listPointLLA.size();
+    size_t first = buffECEF.GetNumPoints();
+    buffECEF.Resize(first+numPts);
+
+    double * listX = buffECEF.listX.data()+first;
+    double * listY = buffECEF.listY.data()+first;
+    double * listZ = buffECEF.listZ.data()+first;
+
+    size_t i=0;
+#if defined(__SSE2__)
+    __m128d const kPi = _mm_set1_pd(K_PI);
+    __m128d const semiMajor = _mm_set1_pd(ELL_SEMI_MAJOR);
+    __m128d const eccExp2 = _mm_set1_pd(ELL_ECC_EXP2);
+    __m128d const one = _mm_set1_pd(1.0);
+
+    for(; i+1 < numPts; i+=2)
+    {
+        PointLLA const &pA = listPointLLA[i];
+        PointLLA const &pB = listPointLLA[i+1];
+
+        // same deg->rad order of operations as the scalar
+        // version; calcSinCos2 is within an ulp of libm, so
+        // the points differ from the scalar ones by up to
+        // ~3E-9m (see the benchmark's precision checks)
+        __m128d lat = _mm_div_pd(_mm_mul_pd(_mm_set_pd(pB.lat,pA.lat),kPi),
+                                 _mm_set1_pd(180.0));
+        __m128d lon = _mm_div_pd(_mm_mul_pd(_mm_set_pd(pB.lon,pA.lon),kPi),
+                                 _mm_set1_pd(180.0));
+        __m128d alt = _mm_set_pd(pB.alt,pA.alt);
+
+        __m128d sinLat,cosLat,sinLon,cosLon;
+        calcSinCos2(lat,sinLat,cosLat);
+        calcSinCos2(lon,sinLon,cosLon);
+
+        // v = radius of curvature (meters)
+        __m128d v = _mm_div_pd(semiMajor,_mm_sqrt_pd(
+            _mm_sub_pd(one,_mm_mul_pd(eccExp2,_mm_mul_pd(sinLat,sinLat)))));
+
+        __m128d vAlt = _mm_add_pd(v,alt);
+        __m128d x = _mm_mul_pd(_mm_mul_pd(vAlt,cosLat),cosLon);
+        __m128d y = _mm_mul_pd(_mm_mul_pd(vAlt,cosLat),sinLon);
+        __m128d z = _mm_mul_pd(_mm_add_pd(_mm_mul_pd(_mm_sub_pd(one,eccExp2),v),alt),
+                               sinLat);
+
+        // both points are adjacent in each array
+        _mm_storeu_pd(listX+i,x);
+        _mm_storeu_pd(listY+i,y);
+        _mm_storeu_pd(listZ+i,z);
+    }
+#endif
+
+    for(; i < numPts; i++)   {
+        Vec3 pointECEF;
+        convLLAToECEF(listPointLLA[i],pointECEF);
+        listX[i] = pointECEF.x;
+        listY[i] = pointECEF.y;
+        listZ[i] = pointECEF.z;
+    }
+    buffECEF.EndRing();
+}
+
+void MapRenderer::convECEFToLLA(std::vector<Vec3> const &listPointECEF,
+                                std::vector<PointLLA> &listPointLLA)
+{
+    size_t numPts = listPointECEF.size();
+    listPointLLA.resize(numPts);
+
+    size_t i=0;
+#if defined(__SSE2__)
+    // there's no vector atan2, so only the
+    // sin/cos and sqrt terms are batched
+    for(; i+1 < numPts; i+=2)
+    {
+        Vec3 const &pA = listPointECEF[i];
+        Vec3 const &pB = listPointECEF[i+1];
+
+        double pAB[2];
+        __m128d x = _mm_set_pd(pB.x,pA.x);
+        __m128d y = _mm_set_pd(pB.y,pA.y);
+        __m128d p = _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(x,x),_mm_mul_pd(y,y)));
+        _mm_storeu_pd(pAB,p);
+
+        __m128d th = _mm_set_pd(atan2(pB.z*ELL_SEMI_MAJOR,pAB[1]*ELL_SEMI_MINOR),
+                                atan2(pA.z*ELL_SEMI_MAJOR,pAB[0]*ELL_SEMI_MINOR));
+        __m128d sinTh,cosTh;
+        calcSinCos2(th,sinTh,cosTh);
+
+        double sinTh3[2],cosTh3[2];
+        _mm_storeu_pd(sinTh3,_mm_mul_pd(_mm_mul_pd(sinTh,sinTh),sinTh));
+        _mm_storeu_pd(cosTh3,_mm_mul_pd(_mm_mul_pd(cosTh,cosTh),cosTh));
+
+        double latAB[2];
+        latAB[0] = atan2(pA.z + ELL_ECC2_EXP2*ELL_SEMI_MINOR*sinTh3[0],
+                         pAB[0] - ELL_ECC_EXP2*ELL_SEMI_MAJOR*cosTh3[0]);
+        latAB[1] = atan2(pB.z + ELL_ECC2_EXP2*ELL_SEMI_MINOR*sinTh3[1],
+                         pAB[1] - ELL_ECC_EXP2*ELL_SEMI_MAJOR*cosTh3[1]);
+
+        // calc altitude
+        __m128d sinLat,cosLat;
+        calcSinCos2(_mm_loadu_pd(latAB),sinLat,cosLat);
+        __m128d N = _mm_div_pd(_mm_set1_pd(ELL_SEMI_MAJOR),_mm_sqrt_pd(
+            _mm_sub_pd(_mm_set1_pd(1.0),_mm_mul_pd(_mm_set1_pd(ELL_ECC_EXP2),
+                                                   _mm_mul_pd(sinLat,sinLat)))));
+        double altAB[2];
+        _mm_storeu_pd(altAB,_mm_sub_pd(_mm_div_pd(p,cosLat),N));
+
+        // convert from rad to deg
+        listPointLLA[i].lon = atan2(pA.y,pA.x) * 180.0/K_PI;
+        listPointLLA[i].lat = latAB[0] * 180.0/K_PI;
+        listPointLLA[i].alt = altAB[0];
+
+        listPointLLA[i+1].lon = atan2(pB.y,pB.x) * 180.0/K_PI;
+        listPointLLA[i+1].lat = latAB[1] * 180.0/K_PI;
+        listPointLLA[i+1].alt = altAB[1];
+    }
+#endif
+
+    for(; i < numPts; i++)
+    {   convECEFToLLA(listPointECEF[i],listPointLLA[i]);   }
+}
+
 double MapRenderer::convStrToDbl(const std::string &strNum)
 {
     std::istringstream iss(strNum);
@@ -1750,7 +4553,7 @@ bool MapRenderer::calcAreaIsValid(std::vector<Vec2> &listOuterPts,
                                   std::vector<std::vector<Vec2> > &listListInnerPts)
 {
     if(listOuterPts.size() < 3)   {
-        OSRDEBUG << "WARN: Area has less than three points!";
+        OSRWARN << "Area has less than three points!";
         return false;
     }
 
@@ -1815,7 +4618,7 @@ bool MapRenderer::calcAreaIsValid(std::vector<Vec2> &listOuterPts,
         }
     }
     else   {
-        OSRDEBUG << "WARN: Area poly is complex!";
+        OSRWARN << "Area poly is complex!";
         return false;
     }
 
@@ -1850,24 +4653,82 @@ void MapRenderer::calcSimplePolyCentroid(std::vector<Vec2> const &listVx,
 
 
 
-double MapRenderer::calcPolylineLength(const std::vector<Vec3> &listVx)
+// calcSegmentLengths
+// * sets listLengths[k] to the length of the segment from
+//   point first+k to first+k+1, for numSegs segments
+// * the SSE2 path computes each length with the same
+//   operations as Vec3::DistanceTo so the results match
+static void calcSegmentLengths(GeomBuffer const &buff,
+                               size_t first, size_t numSegs,
+                               double *listLengths)
+{
+    double const * listX = buff.listX.data()+first;
+    double const * listY = buff.listY.data()+first;
+    double const * listZ = buff.listZ.data()+first;
+
+    size_t k=0;
+#if defined(__SSE2__)
+    // consecutive points are adjacent in each array
+    // so both ends of two segments are plain loads
+    for(; k+1 < numSegs; k+=2)
+    {
+        __m128d dx = _mm_sub_pd(_mm_loadu_pd(listX+k+1),_mm_loadu_pd(listX+k));
+        __m128d dy = _mm_sub_pd(_mm_loadu_pd(listY+k+1),_mm_loadu_pd(listY+k));
+        __m128d dz = _mm_sub_pd(_mm_loadu_pd(listZ+k+1),_mm_loadu_pd(listZ+k));
+        __m128d d2 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(dx,dx),_mm_mul_pd(dy,dy)),
+                                _mm_mul_pd(dz,dz));
+        _mm_storeu_pd(listLengths+k,_mm_sqrt_pd(d2));
+    }
+#endif
+
+    for(; k < numSegs; k++)
+    {
+        double dx = listX[k+1]-listX[k];
+        double dy = listY[k+1]-listY[k];
+        double dz = listZ[k+1]-listZ[k];
+        listLengths[k] = sqrt(dx*dx + dy*dy + dz*dz);
+    }
+}
+
+// the polyline kernels below work through segments
+// in chunks so their lengths can be computed together
+// without allocating a list for them
+#define SEG_CHUNK_SIZE 64
+
+double MapRenderer::calcPolylineLength(GeomBuffer const &buff, size_t ring)
 {
+    size_t first = buff.GetRingBegin(ring);
+    size_t numPts = buff.GetRingSize(ring);
+
+    double chunkLengths[SEG_CHUNK_SIZE];
     double totalDist = 0;
-    for(size_t i=0; i < listVx.size(); i++)
-    {   totalDist += (listVx[i].DistanceTo(listVx[i-1]));   }
+    for(size_t i=1; i < numPts; i+=SEG_CHUNK_SIZE)
+    {
+        size_t numSegs = std::min(size_t(SEG_CHUNK_SIZE),numPts-i);
+        calcSegmentLengths(buff,first+i-1,numSegs,chunkLengths);
+
+        for(size_t k=0; k < numSegs; k++)
+        {   totalDist += chunkLengths[k];   }
+    }
 
     return totalDist;
 }
 
-void MapRenderer::calcPolylineSegmentDist(const std::vector<Vec3> &listVx,
+void MapRenderer::calcPolylineSegmentDist(GeomBuffer const &buff, size_t ring,
                                           std::vector<double> &listSegDistances)
 {
-    double totalDist = 0;
-    listSegDistances.resize(listVx.size(),0);
-    for(size_t i=1; i < listVx.size(); i++)   {
-        totalDist += (listVx[i].DistanceTo(listVx[i-1]));
-        listSegDistances[i] = totalDist;
-    }
+    size_t numPts = buff.GetRingSize(ring);
+    listSegDistances.resize(numPts,0);
+    if(numPts < 2)
+    {   return;   }
+
+    // the lengths are written in place and then summed
+    calcSegmentLengths(buff,buff.GetRingBegin(ring),numPts-1,
+                       &(listSegDistances[1]));
+
+    listSegDistances[0] = 0;
+    for(size_t i=2; i < numPts; i++)
+    {   listSegDistances[i] += listSegDistances[i-1];   }
 }
 
 void MapRenderer::calcPolylineVxAtDist(std::vector<Vec3> const &listVx,
@@ -1895,7 +4756,7 @@ void MapRenderer::calcPolylineVxAtDist(std::vector<Vec3> const &listVx,
     vxAtDist = listVx[i-1]+(distVec.ScaledBy(fAlongSegment));
 }
 
-void MapRenderer::calcPolylineTrimmed(const std::vector<Vec3> &listVx,
+void MapRenderer::calcPolylineTrimmed(GeomBuffer const &buff, size_t ring,
                                       double distStart, double distEnd,
                                       std::vector<Vec3> &listVxTrim)
 {
@@ -1904,15 +4765,20 @@ void MapRenderer::calcPolylineTrimmed(const std::vector<Vec3> &listVx,
     if(!(distStart < distEnd))
     {   return;   }
 
+    size_t first = buff.GetRingBegin(ring);
+    size_t numPts = buff.GetRingSize(ring);
+
     listVxTrim.clear();
     double distPrev = 0;
     double distNext = 0;
     bool pastStart = false;
     bool pastEnd = false;
 
-    for(size_t i=1; i < listVx.size(); i++)
+    for(size_t i=1; i < numPts; i++)
     {
-        Vec3 vecDist = (listVx[i]-listVx[i-1]);
+        Vec3 vxPrev = buff.GetPoint(first+i-1);
+        Vec3 vxNext = buff.GetPoint(first+i);
+        Vec3 vecDist = (vxNext-vxPrev);
         distPrev = distNext;
         distNext += vecDist.Magnitude();
 
@@ -1920,7 +4786,7 @@ void MapRenderer::calcPolylineTrimmed(const std::vector<Vec3> &listVx,
             if(distNext >= distStart)   {
                 pastStart = true;
                 double fAlong = (distStart-distPrev)/(distNext-distPrev);
-                listVxTrim.push_back(listVx[i-1]+vecDist.ScaledBy(fAlong));
+                listVxTrim.push_back(vxPrev+vecDist.ScaledBy(fAlong));
             }
         }
 
@@ -1928,52 +4794,65 @@ void MapRenderer::calcPolylineTrimmed(const std::vector<Vec3> &listVx,
             if(distNext >= distEnd)   {
                 pastEnd = true;
                 double fAlong = (distEnd-distPrev)/(distNext-distPrev);
-                listVxTrim.push_back(listVx[i-1]+vecDist.ScaledBy(fAlong));
+                listVxTrim.push_back(vxPrev+vecDist.ScaledBy(fAlong));
             }
         }
 
         if(pastStart && !pastEnd)   {
-            listVxTrim.push_back(listVx[i]);
+            listVxTrim.push_back(vxNext);
         }
     }
 }
 
-void MapRenderer::calcPolylineResample(std::vector<Vec3> const &listVx,
+void MapRenderer::calcPolylineResample(GeomBuffer const &buff, size_t ring,
                                        double const distResample,
                                        std::vector<Vec3> &listVxRes)
 {
-    if(distResample == 0 || listVx.empty())
+    size_t first = buff.GetRingBegin(ring);
+    size_t numPts = buff.GetRingSize(ring);
+    if(distResample == 0 || numPts == 0)
     {   return;   }
 
-    double distOverlap=0;
     listVxRes.clear();
-    listVxRes.push_back(listVx[0]);
+    listVxRes.push_back(buff.GetPoint(first));
 
+    double chunkLengths[SEG_CHUNK_SIZE];
     double startBuffer=0;
-    for(size_t i=1; i < listVx.size(); i++)
+    for(size_t i=1; i < numPts; i+=SEG_CHUNK_SIZE)
     {
-        Vec3 vSegment = listVx[i]-listVx[i-1];
+        size_t numSegs = std::min(size_t(SEG_CHUNK_SIZE),numPts-i);
+        calcSegmentLengths(buff,first+i-1,numSegs,chunkLengths);
 
-        if(vSegment.Magnitude() == 0)    {
-            continue;
-        }
+        for(size_t k=0; k < numSegs; k++)
+        {
+            double segLength = chunkLengths[k];
+            if(segLength == 0)
+            {   continue;   }
 
-        if(startBuffer > vSegment.Magnitude())   {
-            startBuffer -= vSegment.Magnitude();
-            continue;
-        }
+            if(startBuffer > segLength)   {
+                startBuffer -= segLength;
+                continue;
+            }
 
-        Vec3 vAddPt = vSegment.Normalized().ScaledBy(distResample);
-        Vec3 vStartPt = vSegment.Normalized().ScaledBy(startBuffer);
-        vStartPt = vStartPt + listVx[i-1];
-        listVxRes.push_back(vStartPt);
+            Vec3 vPrev = buff.GetPoint(first+i-1+k);
+            Vec3 vSegment = buff.GetPoint(first+i+k)-vPrev;
 
-        double availDist = vSegment.Magnitude()-startBuffer;
-        size_t numDivs = availDist/distResample;
-        for(size_t j=0; j < numDivs; j++)   {
-            listVxRes.push_back(vStartPt+(vAddPt.ScaledBy(j+1)));
+            // same as vSegment.Normalized()
+            Vec3 vDirn(vSegment.x/segLength,
+                       vSegment.y/segLength,
+                       vSegment.z/segLength);
+
+            Vec3 vAddPt = vDirn.ScaledBy(distResample);
+            Vec3 vStartPt = vDirn.ScaledBy(startBuffer) + vPrev;
+            listVxRes.push_back(vStartPt);
+
+            double availDist = segLength-startBuffer;
+            size_t numDivs = availDist/distResample;
+            for(size_t j=0; j < numDivs; j++)   {
+                listVxRes.push_back(vStartPt+(vAddPt.ScaledBy(j+1)));
+            }
+            startBuffer = distResample-(availDist-(distResample*numDivs));
         }
-        startBuffer = distResample-(availDist-(distResample*numDivs));
     }
 }
 
@@ -2271,10 +5150,12 @@ bool MapRenderer::calcRayEarthIntersection(const Vec3 &linePoint,
     return false;
 }
 
-bool MapRenderer::calcBoundsIntersection(std::vector<Vec3> const &listVxB1,
+bool MapRenderer::calcBoundsIntersection(Vec3 const &camEye,
+                                         std::vector<Vec3> const &listVxB1,
                                          std::vector<Vec3> const &listVxB2,
                                          std::vector<Vec3> &listVxROI,
-                                         Vec3 &vxROICentroid)
+                                         Vec3 &vxROICentroid,
+                                         ScratchArena &scratch)
 {
     // to calculate the intersection of view/range bounds,
     // the input vertices are first converted into 2d by
@@ -2300,18 +5181,20 @@ bool MapRenderer::calcBoundsIntersection(std::vector<Vec3> const &listVxB1,
     // [project points]
     size_t szB1 = listVxB1.size();
     size_t szB2 = listVxB2.size();
-    std::vector<Vec3> listVxAll,listVxProj;
+    ScratchScope scope(scratch);
+    std::vector<Vec3> &listVxAll = scratch.Take<Vec3>();
+    std::vector<Vec3> &listVxProj = scratch.Take<Vec3>();
     listVxAll.insert(listVxAll.end(),listVxB1.begin(),listVxB1.end());
     listVxAll.insert(listVxAll.end(),listVxB2.begin(),listVxB2.end());
 
-    Vec3 pNormal = m_camera.eye;
+    Vec3 pNormal = camEye;
     Vec3 pPoint = pNormal.ScaledBy(1.25);   // ensure that the plane has some
                                             // distance from the earth's surface
     if(!calcPointPlaneProjection(pNormal,pPoint,listVxAll,listVxProj))
-    {   OSRDEBUG << "WARN: Could not project bounds";   return false;   }
+    {   OSRWARN << "Could not project bounds";   return false;   }
 
 //    OSRDEBUG << "### CameraEye:";
-//    printVector(m_camera.eye);
+//    printVector(camEye);
 
     // [align projected points to xy]
     Vec3 zVec(0,0,1);
@@ -2325,7 +5208,8 @@ bool MapRenderer::calcBoundsIntersection(std::vector<Vec3> const &listVxB1,
     }
 
     // [find the intersecting region]
-    std::vector<Vec2> listVxPoly1,listVxPoly2;
+    std::vector<Vec2> &listVxPoly1 = scratch.Take<Vec2>();
+    std::vector<Vec2> &listVxPoly2 = scratch.Take<Vec2>();
 
     for(size_t i=0; i < szB1; i++)
     {   listVxPoly1.push_back(Vec2(listVxProj[i].x,listVxProj[i].y));   }
@@ -2358,14 +5242,15 @@ bool MapRenderer::calcBoundsIntersection(std::vector<Vec3> const &listVxB1,
     clipperObj.AddPolygon(poly2,ClipperLib::ptClip);
 
     if(!clipperObj.Execute(ClipperLib::ctIntersection,listResults))
-    {   OSRDEBUG << "WARN: Could not calc xsec region";   return false;   }
+    {   OSRWARN << "Could not calc xsec region";   return false;   }
 
     if(listResults.empty())   {
         return true;    // bounding regions don't intersect
     }
 
     // note: we expect listResults to only have one poly
-    std::vector<Vec2> listVxRegionPoly(listResults[0].size());
+    std::vector<Vec2> &listVxRegionPoly = scratch.Take<Vec2>();
+    listVxRegionPoly.resize(listResults[0].size());
     for(size_t i=0; i < listResults[0].size(); i++)   {
         listVxRegionPoly[i] = Vec2(double(listResults[0][i].X)/100.0,
                                    double(listResults[0][i].Y)/100.0);
@@ -2392,7 +5277,7 @@ bool MapRenderer::calcBoundsIntersection(std::vector<Vec3> const &listVxB1,
         Vec3 xsecPt;
         if(!calcRayEarthIntersection(listVxROI[i],Vec3(0,0,0)-pNormal,xsecPt))
         {   // we should never get here
-            OSRDEBUG << "ERROR: Could not proj. xsec region";
+            OSRERROR << "Could not proj. xsec region";
             return false;
         }
         listVxROI[i] = xsecPt;
@@ -2489,14 +5374,18 @@ void MapRenderer::calcDistBoundingBox(const PointLLA &ptCenter,
     exBL = convLLAToECEF(listPointLLA[3]);
 }
 
-void MapRenderer::calcEnclosingGeoBounds(std::vector<Vec3> const &listVxPoly,
-                                         std::vector<GeoBounds> &listBounds)
+void MapRenderer::calcEnclosingGeoBounds(Vec3 const &camEye,
+                                         std::vector<Vec3> const &listVxPoly,
+                                         std::vector<GeoBounds> &listBounds,
+                                         ScratchArena &scratch)
 {
     listBounds.clear();
     if(listVxPoly.size() < 3)
     {   return;   }
 
-    std::vector<PointLLA> listPLLA(listVxPoly.size());
+    ScratchScope scope(scratch);
+    std::vector<PointLLA> &listPLLA = scratch.Take<PointLLA>();
+    listPLLA.resize(listVxPoly.size());
     for(size_t i=0; i < listPLLA.size(); i++)
     {   listPLLA[i] = convECEFToLLA(listVxPoly[i]);   }
 
@@ -2504,8 +5393,10 @@ void MapRenderer::calcEnclosingGeoBounds(std::vector<Vec3> const &listVxPoly,
     // TODO: desc using 'walking along the polygon' method
 
     // convert longitudes to cartesian
-    std::vector<double> listLonRads(listPLLA.size());
-    std::vector<Vec2> listVxLon(listPLLA.size());
+    std::vector<double> &listLonRads = scratch.Take<double>();
+    std::vector<Vec2> &listVxLon = scratch.Take<Vec2>();
+    listLonRads.resize(listPLLA.size());
+    listVxLon.resize(listPLLA.size());
     for(size_t i=0; i < listPLLA.size(); i++)   {
         double angleRads = listPLLA[i].lon*K_PI/180.0;
         listLonRads[i] = angleRads;
@@ -2620,7 +5511,7 @@ void MapRenderer::calcEnclosingGeoBounds(std::vector<Vec3> const &listVxPoly,
     if(is360)
     {
         // check if the camera is above or below the 'equator'
-        double critLat = (m_camera.eye.Dot(Vec3(0,0,1)) >= 0) ? 90 : -90;
+        double critLat = (camEye.Dot(Vec3(0,0,1)) >= 0) ? 90 : -90;
         listPLLA.push_back(PointLLA(critLat,0,0));
         OSRDEBUG << "### is360 and critLat @ " << critLat;
     }
@@ -2645,6 +5536,105 @@ void MapRenderer::calcEnclosingGeoBounds(std::vector<Vec3> const &listVxPoly,
     }
 }
 
+void MapRenderer::calcGeoBoundsDifference(std::vector<GeoBounds> const &listBoundsA,
+                                          std::vector<GeoBounds> const &listBoundsB,
+                                          std::vector<GeoBounds> &listBoundsDiff)
+{
+    listBoundsDiff = listBoundsA;
+
+    // subtract each bounds in B from every remaining
+    // piece of A; each subtraction leaves at most four
+    // pieces (strips above and below the overlap, and
+    // to its left and right)
+    for(size_t b=0; b < listBoundsB.size(); b++)
+    {
+        GeoBounds const &cut = listBoundsB[b];
+
+        std::vector<GeoBounds> listPieces;
+        for(size_t a=0; a < listBoundsDiff.size(); a++)
+        {
+            GeoBounds const &piece = listBoundsDiff[a];
+
+            if(cut.maxLat <= piece.minLat || cut.minLat >= piece.maxLat ||
+               cut.maxLon <= piece.minLon || cut.minLon >= piece.maxLon)
+            {   listPieces.push_back(piece);   continue;   }
+
+            double midMinLat = std::max(piece.minLat,cut.minLat);
+            double midMaxLat = std::min(piece.maxLat,cut.maxLat);
+
+            if(piece.minLat < cut.minLat)   {
+                GeoBounds strip = piece;
+                strip.maxLat = cut.minLat;
+                listPieces.push_back(strip);
+            }
+            if(piece.maxLat > cut.maxLat)   {
+                GeoBounds strip = piece;
+                strip.minLat = cut.maxLat;
+                listPieces.push_back(strip);
+            }
+            if(piece.minLon < cut.minLon)   {
+                GeoBounds strip = piece;
+                strip.minLat = midMinLat;
+                strip.maxLat = midMaxLat;
+                strip.maxLon = cut.minLon;
+                listPieces.push_back(strip);
+            }
+            if(piece.maxLon > cut.maxLon)   {
+                GeoBounds strip = piece;
+                strip.minLat = midMinLat;
+                strip.maxLat = midMaxLat;
+                strip.minLon = cut.maxLon;
+                listPieces.push_back(strip);
+            }
+        }
+        listBoundsDiff.swap(listPieces);
+    }
+}
+
+double MapRenderer::calcGeoBoundsArea(std::vector<GeoBounds> const &listBounds)
+{
+    double area = 0;
+    for(size_t i=0; i < listBounds.size(); i++)   {
+        area += (listBounds[i].maxLat-listBounds[i].minLat)*
+                (listBounds[i].maxLon-listBounds[i].minLon);
+    }
+    return area;
+}
+
+bool MapRenderer::calcPointInGeoBounds(double lat,double lon,
+                                       std::vector<GeoBounds> const &listBounds)
+{
+    for(size_t b=0; b < listBounds.size(); b++)   {
+        if(lat > listBounds[b].minLat && lat < listBounds[b].maxLat &&
+           lon > listBounds[b].minLon && lon < listBounds[b].maxLon)
+        {   return true;   }
+    }
+    return false;
+}
+
+bool MapRenderer::calcPointsInGeoBounds(std::vector<osmscout::Point> const &listPoints,
+                                        std::vector<GeoBounds> const &listBounds)
+{
+    if(listPoints.empty())
+    {   return false;   }
+
+    double minLat = listPoints[0].GetLat(); double maxLat = minLat;
+    double minLon = listPoints[0].GetLon(); double maxLon = minLon;
+    for(size_t i=1; i < listPoints.size(); i++)   {
+        minLat = std::min(minLat,listPoints[i].GetLat());
+        maxLat = std::max(maxLat,listPoints[i].GetLat());
+        minLon = std::min(minLon,listPoints[i].GetLon());
+        maxLon = std::max(maxLon,listPoints[i].GetLon());
+    }
+
+    for(size_t b=0; b < listBounds.size(); b++)   {
+        if(maxLat >= listBounds[b].minLat && minLat <= listBounds[b].maxLat &&
+           maxLon >= listBounds[b].minLon && minLon <= listBounds[b].maxLon)
+        {   return true;   }
+    }
+    return false;
+}
+
 /*
 void MapRenderer::calcEnclosingGeoBounds(std::vector<Vec3> const &listVxPoly,
                                          std::vector<GeoBounds> &listBounds,
@@ -2739,24 +5729,25 @@ bool MapRenderer::calcCamViewExtents(Camera &cam)
     return true;
 }
 
-void MapRenderer::calcCamViewDistances(double &minViewDist,
+void MapRenderer::calcCamViewDistances(Camera const &cam,
+                                       double &minViewDist,
                                        double &maxViewDist)
 {
     std::vector<Vec3> listVx(5);
-    listVx[0] = m_camera.exTL;
-    listVx[1] = m_camera.exTR;
-    listVx[2] = m_camera.exBR;
-    listVx[3] = m_camera.exBL;
-    calcRayEarthIntersection(m_camera.eye,
-        m_camera.viewPt-m_camera.eye,listVx[4]);
+    listVx[0] = cam.exTL;
+    listVx[1] = cam.exTR;
+    listVx[2] = cam.exBR;
+    listVx[3] = cam.exBL;
+    calcRayEarthIntersection(cam.eye,
+        cam.viewPt-cam.eye,listVx[4]);
 
 
     // get the min/max distances
     double minViewDist2,maxViewDist2;
     maxViewDist2 = -1;
-    minViewDist2 = m_camera.eye.Distance2To(listVx[0]);
+    minViewDist2 = cam.eye.Distance2To(listVx[0]);
     for(size_t i=0; i < listVx.size(); i++)   {
-        double cDist = m_camera.eye.Distance2To(listVx[i]);
+        double cDist = cam.eye.Distance2To(listVx[i]);
         minViewDist2 = std::min(cDist,minViewDist2);
         maxViewDist2 = std::max(cDist,maxViewDist2);
     }
@@ -2831,12 +5822,13 @@ void MapRenderer::calcCamViewDistances(double &minViewDist,
 */
 double MapRenderer::calcEstBuildingHeight(double baseArea)
 {
-    // use the baseArea as a random seed
-    srand(int(baseArea));
+    // use the baseArea as a random seed (a local generator
+    // is used since render data is generated concurrently)
+    std::minstd_rand randGen(int(baseArea)+1);
 
     // we estimate buildings to have a height of 3-5m per level
     // and randomly select a value within this height range
-    int levelHeight = rand()%3 + 3;
+    int levelHeight = randGen()%3 + 3;
 
     // if the baseArea of the building is below 3500 sqft
     // (~350m^2), it's likely a residential building
@@ -2847,7 +5839,7 @@ double MapRenderer::calcEstBuildingHeight(double baseArea)
     else
     {   // randomly generate number of levels building has,
         // 3-8 levels are currently used as the range
-        int numLevels = rand()%6 + 3;
+        int numLevels = randGen()%6 + 3;
         return double(numLevels*levelHeight);
     }
 }
@@ -2932,19 +5924,26 @@ ColorRGBA MapRenderer::calcRainbowGradient(double cVal)
     return myColor;
 }
 
-void MapRenderer::buildPolylineAsTriStrip(std::vector<Vec3> const &listPolylineVx,
+void MapRenderer::buildPolylineAsTriStrip(GeomBuffer const &buff, size_t ring,
                                           double const polylineWidth,
                                           std::vector<Vec3> &listVx,
                                           std::vector<Vec2> &listTx,
                                           double &polylineLength,
                                           bool cleanOverlaps)
 {
-    size_t numPts = listPolylineVx.size();
+    size_t first = buff.GetRingBegin(ring);
+    size_t numPts = buff.GetRingSize(ring);
     size_t numOffsets = (numPts-1)*2;   // 2 for each edge
-    std::vector<Vec3> listOffsetPtsL(numOffsets);
-    std::vector<Vec3> listOffsetPtsR(numOffsets);
-    std::vector<Vec2> listOffsetTxL(numOffsets);
-    std::vector<Vec2> listOffsetTxR(numOffsets);
+
+    ScratchScope scope(m_commitScratch);
+    std::vector<Vec3> &listOffsetPtsL = m_commitScratch.Take<Vec3>();
+    std::vector<Vec3> &listOffsetPtsR = m_commitScratch.Take<Vec3>();
+    std::vector<Vec2> &listOffsetTxL = m_commitScratch.Take<Vec2>();
+    std::vector<Vec2> &listOffsetTxR = m_commitScratch.Take<Vec2>();
+    listOffsetPtsL.resize(numOffsets);
+    listOffsetPtsR.resize(numOffsets);
+    listOffsetTxL.resize(numOffsets);
+    listOffsetTxR.resize(numOffsets);
 
     Vec3 vecNormal;                     // vector originating at the center of the earth
                                         // (0,0,0) to a vertex on the way
@@ -2956,9 +5955,10 @@ void MapRenderer::buildPolylineAsTriStrip(std::vector<Vec3> const &listPolylineV
 
     Vec3 vecOffsetL,vecOffsetR;         // offsets from way center
 
-    // keep track of edge distances and total length
-    double totalLength = 0;
-    std::vector<double> listEdgeDists(numPts,0);
+    // edge distances and total length
+    std::vector<double> &listEdgeDists = m_commitScratch.Take<double>();
+    calcPolylineSegmentDist(buff,ring,listEdgeDists);
+    double totalLength = listEdgeDists[numPts-1];
 
     // we offset the polyline on both sides of the
     // centerline and stitch the resulting shape together
@@ -2978,25 +5978,24 @@ void MapRenderer::buildPolylineAsTriStrip(std::vector<Vec3> const &listPolylineV
     // for each segment, create dirn and offset vecs
     size_t k=0;
     double offsetLength = polylineWidth/2;
+    Vec3 vxPrev = buff.GetPoint(first);
     for(size_t i=1; i < numPts; i++)   {
         // offset vertex coordinates
-        vecNormal = listPolylineVx[i];
-        vecDirn   = listPolylineVx[i]-listPolylineVx[i-1];
+        Vec3 vxNext = buff.GetPoint(first+i);
+        vecNormal = vxNext;
+        vecDirn   = vxNext-vxPrev;
         vecOffset = vecDirn.Cross(vecNormal).Normalized();
 
         vecOffsetL = vecOffset.ScaledBy(offsetLength);
         vecOffsetR = vecOffsetL.ScaledBy(-1.0);
 
-        listOffsetPtsL[k] = listPolylineVx[i-1]+vecOffsetL;
-        listOffsetPtsR[k] = listPolylineVx[i-1]+vecOffsetR; k++;
+        listOffsetPtsL[k] = vxPrev+vecOffsetL;
+        listOffsetPtsR[k] = vxPrev+vecOffsetR; k++;
 
-        listOffsetPtsL[k] = listPolylineVx[i]+vecOffsetL;
-        listOffsetPtsR[k] = listPolylineVx[i]+vecOffsetR;   k++;
+        listOffsetPtsL[k] = vxNext+vecOffsetL;
+        listOffsetPtsR[k] = vxNext+vecOffsetR;   k++;
 
-        // edge length and total polyline length
-        double edgeLength = vecDirn.Magnitude();
-        listEdgeDists[i] = listEdgeDists[i-1]+edgeLength;
-        totalLength += edgeLength;
+        vxPrev = vxNext;
     }
 
     k=0;
@@ -3023,8 +6022,9 @@ void MapRenderer::buildPolylineAsTriStrip(std::vector<Vec3> const &listPolylineV
                 size_t idx = (i*2)-2;   // first idx for prev edge offset
 
                 // determine the angle between two adjacent edges
-                Vec3 edgePrev = (listPolylineVx[i-1]-listPolylineVx[i]).Normalized();
-                Vec3 edgeNext = (listPolylineVx[i+1]-listPolylineVx[i]).Normalized();
+                Vec3 vxJoint = buff.GetPoint(first+i);
+                Vec3 edgePrev = (buff.GetPoint(first+i-1)-vxJoint).Normalized();
+                Vec3 edgeNext = (buff.GetPoint(first+i+1)-vxJoint).Normalized();
                 Vec3 edgeBisect = edgePrev+edgeNext;
                 double edgeBisectLength = edgeBisect.Magnitude();
 
@@ -3049,7 +6049,7 @@ void MapRenderer::buildPolylineAsTriStrip(std::vector<Vec3> const &listPolylineV
 
                 // get the vertex coincident with the xsec of adjacent inside edges
                 Vec3 vecBisect = edgeBisect.Normalized().ScaledBy(offsetLength/sinTheta);
-                vecBisect = listPolylineVx[i]+vecBisect;
+                vecBisect = vxJoint+vecBisect;
 
                 // determine which side (left or right) corresponds
                 // to the inner and outer offsets and move vertices
@@ -3083,24 +6083,33 @@ void MapRenderer::buildPolylineAsTriStrip(std::vector<Vec3> const &listPolylineV
     polylineLength = totalLength;
 }
 
-void MapRenderer::buildContourSideWalls(const std::vector<Vec3> &listContourVx,
+void MapRenderer::buildContourSideWalls(GeomBuffer const &buff, size_t ring,
                                         const Vec3 &offsetHeight,
                                         std::vector<Vec3> &listSideTriVx,
                                         std::vector<Vec3> &listSideTriNx)
 {
-    if(listContourVx.size() < 3)   {
+    size_t first = buff.GetRingBegin(ring);
+    size_t numPts = buff.GetRingSize(ring);
+    if(numPts < 3)   {
         return;
     }
 
-    std::vector<Vec3> const &listBtmVx = listContourVx;
-    std::vector<Vec3> listTopVx(listBtmVx.size());
+    ScratchScope scope(m_commitScratch);
+    std::vector<Vec3> &listBtmVx = m_commitScratch.Take<Vec3>();
+    std::vector<Vec3> &listTopVx = m_commitScratch.Take<Vec3>();
+    listBtmVx.resize(numPts);
+    listTopVx.resize(numPts);
 
-    for(size_t i=0; i < listTopVx.size(); i++)
-    {   listTopVx[i] = listBtmVx[i] + offsetHeight;   }
+    for(size_t i=0; i < numPts; i++)   {
+        listBtmVx[i] = buff.GetPoint(first+i);
+        listTopVx[i] = listBtmVx[i] + offsetHeight;
+    }
 
     // we append onto listSideTriVx and listSideTriNx
     // without clearing/modifying it so that multiple
     // geometries can be built up
+    listSideTriVx.reserve(listSideTriVx.size()+listBtmVx.size()*6);
+    listSideTriNx.reserve(listSideTriNx.size()+listBtmVx.size()*6);
 
     size_t v=0;
     Vec3 alongLeft,alongUp,triNx;
@@ -3144,22 +6153,25 @@ void MapRenderer::buildContourSideWalls(const std::vector<Vec3> &listContourVx,
     listSideTriNx.insert(listSideTriNx.end(),6,triNx);
 }
 
-void MapRenderer::buildContourWireframe(const std::vector<Vec3> &listContourVx,
+void MapRenderer::buildContourWireframe(GeomBuffer const &buff, size_t ring,
                                         const Vec3 &offsetHeight,
                                         std::vector<Vec3> &listVx,
                                         std::vector<size_t> &listIx)
 {
+    size_t first = buff.GetRingBegin(ring);
+    size_t numPts = buff.GetRingSize(ring);
+
     listVx.clear(); listIx.clear();
-    listVx.resize(listContourVx.size()*2);
-    listIx.resize(listContourVx.size()*6);
+    listVx.resize(numPts*2);
+    listIx.resize(numPts*6);
 
     // base verts
-    for(size_t v=0; v < listContourVx.size(); v++)
-    { listVx[v] = listContourVx[v]; }
+    for(size_t v=0; v < numPts; v++)
+    { listVx[v] = buff.GetPoint(first+v); }
 
     // roof verts
     for(size_t v=listVx.size()/2; v < listVx.size(); v++)
-    { listVx[v] = listVx[v-listContourVx.size()] + offsetHeight; }
+    { listVx[v] = listVx[v-numPts] + offsetHeight; }
 
     // base indices
     size_t k=0;
@@ -3198,7 +6210,7 @@ bool MapRenderer::buildEarthSurfaceGeometry(unsigned int latSegments,
 
     if(latSegments < 4 || lonSegments < 4)
     {   // we want at least 4 lat segments and 4 lon segments
-        OSRDEBUG << "ERROR: Insufficient lat/lon segments for Earth geometry";
+        OSRERROR << "Insufficient lat/lon segments for Earth geometry";
         return false;
     }
 
@@ -3260,12 +6272,12 @@ bool MapRenderer::buildEarthSurfaceGeometry(double minLon, double minLat,
                                             std::vector<size_t> &triIdx)
 {
     if((!(minLon < maxLon)) || (!(minLat < maxLat)))   {
-        OSRDEBUG << "ERROR: EarthSurfaceGeometry: Invalid bounds";
+        OSRERROR << "EarthSurfaceGeometry: Invalid bounds";
         return false;
     }
 
     if(latSegments < 4 || lonSegments < 4)   {
-        OSRDEBUG << "ERROR: EarthSurfaceGeometry: Insufficient segments";
+        OSRERROR << "EarthSurfaceGeometry: Insufficient segments";
         return false;
     }
 
@@ -3344,10 +6356,10 @@ bool MapRenderer::buildCoastlinePointCloud(std::string const &filePath,
         }
     }
     else   {
-        OSRDEBUG << "ERROR: Could not read coastline0 CTM file";
+        OSRERROR << "Could not read coastline0 CTM file";
         return false;
     }
-    OSRDEBUG << "INFO: Read in coastline0 CTM file";
+    OSRINFO << "Read in coastline0 CTM file";
     ctmFreeContext(ctmContext);
 
     return true;
@@ -3386,10 +6398,10 @@ bool MapRenderer::buildCoastlineLines(std::string const &filePath,
         }
     }
     else   {
-        OSRDEBUG << "ERROR: Could not read coastline0 CTM file: " << filePath;
+        OSRERROR << "Could not read coastline0 CTM file: " << filePath;
         return false;
     }
-    OSRDEBUG << "INFO: Read in coastline0 CTM file";
+    OSRINFO << "Read in coastline0 CTM file";
     ctmFreeContext(ctmContext);
 
     // build a list of indices for the GL_LINES primitive;
@@ -3446,10 +6458,10 @@ bool MapRenderer::buildAdmin0Lines(const std::string &filePath,
         }
     }
     else   {
-        OSRDEBUG << "ERROR: Could not read admin0 CTM file: " << filePath;;
+        OSRERROR << "Could not read admin0 CTM file: " << filePath;;
         return false;
     }
-    OSRDEBUG << "INFO: Read in admin0 CTM file";
+    OSRINFO << "Read in admin0 CTM file";
     ctmFreeContext(ctmContext);
 
     // build a list of indices for the GL_LINES primitive;
@@ -24,10 +24,17 @@
 // std includes
 #include <math.h>
 #include <vector>
+#include <map>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <atomic>
 
 //#ifdef USE_BOOST
 //    #include <boost/unordered_map.hpp>
@@ -55,7 +62,12 @@
 // osmscout-render includes
 #include "Vec2.hpp"
 #include "Vec3.hpp"
-#include "SimpleLogger.hpp"
+#include "GeomBuffer.hpp"
+#include "Logger.hpp"
+#include "TaskPool.hpp"
+#include "ScratchArena.hpp"
+#include "TraceRecorder.hpp"
+#include "RenderDataCache.hpp"
 #include "RenderStyleReader.h"
 #include "RenderStyleConfig.hpp"
 #include "DataSet.hpp"
@@ -84,7 +96,14 @@
 #define CIR_AV 40041438   // average (meters)
 
 // option: keep track of shared nodes/intersections
-#define OPT_TRACK_SHARED_NODES 0
+// * each DataSet keeps an index of the nodes used by the
+//   ways in the scene, updated once per applied update,
+//   and ways get a list of the ways they intersect
+#define OPT_TRACK_SHARED_NODES 1
+
+// option: max number of objects passed to the
+// backend in one batched add or remove call
+#define OPT_SCENE_BATCH_SIZE 64
 
 namespace osmsrender
 {
@@ -92,6 +111,528 @@ namespace osmsrender
 // ========================================================================== //
 // ========================================================================== //
 
+// lists of render data that still needs to be added
+// to the scene, by lod
+typedef std::vector<std::vector<NodeRenderData> >       ListNodeAddsByLod;
+typedef std::vector<std::vector<WayRenderData> >        ListWayAddsByLod;
+typedef std::vector<std::vector<AreaRenderData> >       ListAreaAddsByLod;
+typedef std::vector<std::vector<RelAreaRenderData> >    ListRelAreaAddsByLod;
+
+// object types
+enum ObjectType
+{
+    OBJ_NODE,
+    OBJ_WAY,
+    OBJ_AREA,
+    OBJ_RELAREA
+};
+
+// QueuedAdd
+// * an entry in list[]Adds of a DataSetUpdate
+// * distSq is the squared distance between the camera
+//   and the center of the object's bounds
+struct QueuedAdd
+{
+    QueuedAdd(ObjectType myType,size_t myLod,size_t myIdx) :
+        objType(myType),lod(myLod),idx(myIdx),distSq(0) {}
+
+    ObjectType objType;
+    size_t lod;
+    size_t idx;
+    double distSq;
+};
+
+// SceneBatch
+// * render data for objects of one type that are
+//   passed to the backend in a single call
+// * listLods holds the lod each added object
+//   is stored at once it's in the scene
+template <typename T>
+struct SceneBatch
+{
+    std::vector<T>          listData;
+    std::vector<size_t>     listLods;
+};
+
+// ApplyStage
+// * how far an object type in a DataSetUpdate
+//   has been applied to the scene
+enum ApplyStage
+{
+    APPLY_REMOVES,
+    APPLY_ADDS,
+    APPLY_DONE
+};
+
+// ApplyCursor
+// * where to resume removing an object type in a
+//   DataSetUpdate if the commit budget ran out
+// * listOldLods holds objects that changed lod and
+//   haven't been added at their new lod yet
+struct ApplyCursor
+{
+    ApplyCursor() :
+        stage(APPLY_REMOVES),idx(0) {}
+
+    ApplyStage stage;
+    size_t idx;
+    IdMap<size_t> listOldLods;
+};
+
+// CommitBudget
+// * limits how much of a SceneUpdate is applied at once;
+//   at least one object is always applied so a commit
+//   can't stall
+// * modified[] is set for object types that were changed
+//   so the backend is only told about those
+struct CommitBudget
+{
+    CommitBudget() :
+        hasDeadline(false),maxObjects(0),numObjects(0),
+        modifiedWays(false),modifiedAreas(false),
+        modifiedRelAreas(false) {}
+
+    bool IsSpent() const
+    {
+        if(numObjects == 0)
+        {   return false;   }
+
+        if(maxObjects > 0 && numObjects >= maxObjects)
+        {   return true;   }
+
+        return (hasDeadline &&
+                std::chrono::steady_clock::now() >= deadline);
+    }
+
+    bool hasDeadline;
+    std::chrono::steady_clock::time_point deadline;
+    size_t maxObjects;
+    size_t numObjects;
+
+    bool modifiedWays;
+    bool modifiedAreas;
+    bool modifiedRelAreas;
+};
+
+// DataSetUpdate
+// * everything that should be in the scene for a DataSet
+//   after an update (list[]Refs and list[]Ids), how that
+//   differs from the scene when the update was built
+//   ([]Diff), and pre-generated render data for objects
+//   that weren't in the scene or changed lod (list[]Adds)
+// * listAddOrder has every entry in list[]Adds with the
+//   most detailed lods first and nearest objects first
+//   within each lod; render data is generated and added
+//   to the scene in that order so the objects closest to
+//   the camera show up first
+// * listQueryBounds and list[]Ids are saved to the
+//   DataSet when the update is applied
+struct DataSetUpdate
+{
+    DataSetUpdate() :
+        dataSet(NULL),addIdx(0) {}
+
+    DataSet * dataSet;
+    ListGeoBoundsByLod      listQueryBounds;
+
+    ListNodeRefsByLod       listNodeRefs;
+    ListWayRefsByLod        listWayRefs;
+    ListAreaRefsByLod       listAreaRefs;
+    ListRelAreaRefsByLod    listRelAreaRefs;
+
+    ListIdLods              listNodeIds;
+    ListIdLods              listWayIds;
+    ListIdLods              listAreaIds;
+    ListIdLods              listRelAreaIds;
+
+    IdDiff                  nodeDiff;
+    IdDiff                  wayDiff;
+    IdDiff                  areaDiff;
+    IdDiff                  relAreaDiff;
+
+    ListNodeAddsByLod       listNodeAdds;
+    ListWayAddsByLod        listWayAdds;
+    ListAreaAddsByLod       listAreaAdds;
+    ListRelAreaAddsByLod    listRelAreaAdds;
+    std::vector<QueuedAdd>  listAddOrder;
+
+    ApplyCursor             nodeCursor;
+    ApplyCursor             wayCursor;
+    ApplyCursor             areaCursor;
+    ApplyCursor             relAreaCursor;
+    size_t                  addIdx;
+};
+
+// ObjectQuery
+// * a DataSet query for a single LOD range and
+//   set of bounds, and the objects it returned
+struct ObjectQuery
+{
+    DataSet * dataSet;
+    size_t dsIdx;
+    size_t lod;
+    std::vector<GeoBounds> listBounds;
+    osmscout::TypeSet typeSet;
+    bool opOk;
+    double queryMs;
+
+    std::vector<osmscout::NodeRef>        listNodeRefs;
+    std::vector<osmscout::WayRef>         listWayRefs;
+    std::vector<osmscout::WayRef>         listAreaRefs;
+    std::vector<osmscout::RelationRef>    listRelWayRefs;
+    std::vector<osmscout::RelationRef>    listRelAreaRefs;
+};
+
+// GenTask
+// * generating render data for a single queued object
+//   in list[]Adds of a SceneUpdate
+// * isPrefetched and isCached are set if the render
+//   data didn't need to be generated; genMs is how
+//   long the task took
+struct GenTask
+{
+    GenTask(ObjectType myType,size_t myDsIdx,
+            size_t myLod,size_t myIdx) :
+        objType(myType),dsIdx(myDsIdx),
+        lod(myLod),idx(myIdx),opOk(false),
+        isPrefetched(false),isCached(false),genMs(0) {}
+
+    ObjectType objType;
+    size_t dsIdx;
+    size_t lod;
+    size_t idx;
+    bool opOk;
+    bool isPrefetched;
+    bool isCached;
+    double genMs;
+};
+
+// LODHysteresisStats
+// * numActivationsHeld and numDeactivationsHeld count lod
+//   ranges that would have been switched on or off by an
+//   update without hysteresis, but weren't
+struct LODHysteresisStats
+{
+    LODHysteresisStats() :
+        numActivationsHeld(0),numDeactivationsHeld(0),
+        numActivations(0),numDeactivations(0)
+    {}
+
+    size_t numActivationsHeld;
+    size_t numDeactivationsHeld;
+    size_t numActivations;
+    size_t numDeactivations;
+};
+
+// SceneLODStats
+// * time spent on a single lod range while building a
+//   scene update; queryMs adds up the time taken by each
+//   of the range's queries, which may run concurrently
+// * filterMs is the time spent merging query results,
+//   dropping objects the range doesn't show (or that
+//   are shown by a more detailed range) and keeping
+//   objects that are still in view
+// * num[] are the objects in view at this lod
+struct SceneLODStats
+{
+    SceneLODStats() :
+        isActive(false),numQueries(0),queryMs(0),filterMs(0),
+        numNodes(0),numWays(0),numAreas(0),numRelAreas(0)
+    {}
+
+    bool isActive;
+    size_t numQueries;
+    double queryMs;
+    double filterMs;
+
+    size_t numNodes;
+    size_t numWays;
+    size_t numAreas;
+    size_t numRelAreas;
+};
+
+// SceneTypeStats
+// * what a scene update did with a single object type
+// * numQueued objects needed render data: numPrefetched
+//   and numCached already had it, numGenerated had it
+//   generated and numFailed couldn't be generated; genMs
+//   adds up the generation time across all threads
+// * the rest are calls to the backend and the time spent
+//   in them: numAdded objects were added as new geometry
+//   with numVertices points between them, numShown came
+//   back from the cache, numRestyled changed lod in place,
+//   and numHidden and numRemoved left the scene
+// * doneMs is the time spent in doneUpdating[] (which
+//   isn't called for nodes)
+struct SceneTypeStats
+{
+    SceneTypeStats() :
+        numQueued(0),numPrefetched(0),numCached(0),
+        numGenerated(0),numFailed(0),genMs(0),
+        numAdded(0),numVertices(0),numShown(0),
+        numRestyled(0),numHidden(0),numRemoved(0),
+        addMs(0),showMs(0),restyleMs(0),hideMs(0),
+        removeMs(0),doneMs(0)
+    {}
+
+    size_t numQueued;
+    size_t numPrefetched;
+    size_t numCached;
+    size_t numGenerated;
+    size_t numFailed;
+    double genMs;
+
+    size_t numAdded;
+    size_t numVertices;
+    size_t numShown;
+    size_t numRestyled;
+    size_t numHidden;
+    size_t numRemoved;
+
+    double addMs;
+    double showMs;
+    double restyleMs;
+    double hideMs;
+    double removeMs;
+    double doneMs;
+};
+
+// SceneUpdateStats
+// * where the time went in a single scene update
+// * the update is built by the worker thread if async
+//   updates are enabled: viewExtentsMs is the time spent
+//   finding the view extents and query bounds for each lod
+//   range, and queryMs, filterMs, diffMs and genMs are the
+//   wall times for querying DataSets, filtering the results,
+//   diffing them against the scene and generating render
+//   data; buildMs is the time for the whole build
+// * commitMs adds up the time spent applying the update over
+//   numCommits calls (see SetSceneCommitBudget), including
+//   the backend time counted in the type stats
+// * updateIdx counts committed updates, so it changes
+//   whenever a new update's stats are available;
+//   generation is the scene generation the update was
+//   built for
+struct SceneUpdateStats
+{
+    SceneUpdateStats() :
+        updateIdx(0),generation(0),viewExtentsMs(0),queryMs(0),
+        filterMs(0),diffMs(0),genMs(0),buildMs(0),
+        numCommits(0),commitMs(0)
+    {}
+
+    SceneTypeStats & GetTypeStats(ObjectType objType)
+    {
+        if(objType == OBJ_NODE)        {   return nodeStats;   }
+        else if(objType == OBJ_WAY)    {   return wayStats;   }
+        else if(objType == OBJ_AREA)   {   return areaStats;   }
+        return relAreaStats;
+    }
+
+    size_t updateIdx;
+    size_t generation;
+
+    double viewExtentsMs;
+    double queryMs;
+    double filterMs;
+    double diffMs;
+    double genMs;
+    double buildMs;
+
+    size_t numCommits;
+    double commitMs;
+
+    std::vector<SceneLODStats> listLODStats;
+
+    SceneTypeStats nodeStats;
+    SceneTypeStats wayStats;
+    SceneTypeStats areaStats;
+    SceneTypeStats relAreaStats;
+};
+
+// MemoryUsage
+// * estimated bytes retained by numObjects objects
+struct MemoryUsage
+{
+    MemoryUsage() :
+        numObjects(0),numBytes(0)
+    {}
+
+    void Add(size_t myNumObjects, size_t myNumBytes)
+    {
+        numObjects += myNumObjects;
+        numBytes += myNumBytes;
+    }
+
+    void Add(MemoryUsage const &usage)
+    {   Add(usage.numObjects,usage.numBytes);   }
+
+    size_t numObjects;
+    size_t numBytes;
+};
+
+// ObjectMemoryUsage
+// * memory used for each type of object
+struct ObjectMemoryUsage
+{
+    MemoryUsage & GetUsage(ObjectType objType)
+    {
+        if(objType == OBJ_NODE)        {   return nodes;   }
+        else if(objType == OBJ_WAY)    {   return ways;   }
+        else if(objType == OBJ_AREA)   {   return areas;   }
+        return relAreas;
+    }
+
+    MemoryUsage GetTotal() const
+    {
+        MemoryUsage total;
+        total.Add(nodes);
+        total.Add(ways);
+        total.Add(areas);
+        total.Add(relAreas);
+        return total;
+    }
+
+    MemoryUsage nodes;
+    MemoryUsage ways;
+    MemoryUsage areas;
+    MemoryUsage relAreas;
+};
+
+// DataSetMemoryStats
+// * listLODUsage is the render data for objects in the
+//   scene by lod: each lod's id maps and everything their
+//   render data points to, but not the osmscout objects
+//   it refers to (which the DataSet may share)
+// * mapTypeUsage is the same render data by osmscout
+//   type across all lods (without the id maps' empty
+//   slots), so types whose styles generate a lot of
+//   geometry stand out
+// * sceneIds are the sorted id lists the scene is
+//   diffed with, and sharedNodes the shared node index
+//   for every lod (see OPT_TRACK_SHARED_NODES)
+// * styleConfigs are the DataSet's style configs, one
+//   for each lod range
+struct DataSetMemoryStats
+{
+    DataSetMemoryStats() :
+        dataSet(NULL)
+    {}
+
+    MemoryUsage GetTotal() const
+    {
+        MemoryUsage total;
+        for(size_t i=0; i < listLODUsage.size(); i++)
+        {   total.Add(listLODUsage[i].GetTotal());   }
+
+        total.Add(0,sceneIds.GetTotal().numBytes);
+        total.Add(0,sharedNodes.numBytes);
+        total.Add(0,styleConfigs.numBytes);
+        return total;
+    }
+
+    DataSet const * dataSet;
+    std::vector<ObjectMemoryUsage> listLODUsage;
+    std::map<osmscout::TypeId,MemoryUsage> mapTypeUsage;
+
+    ObjectMemoryUsage sceneIds;
+    MemoryUsage sharedNodes;
+    MemoryUsage styleConfigs;
+};
+
+// BackendMemoryUsage
+// * memory the backend holds in a single structure
+struct BackendMemoryUsage
+{
+    BackendMemoryUsage(std::string const &myName,
+                       MemoryUsage const &myUsage) :
+        name(myName),usage(myUsage)
+    {}
+
+    std::string name;
+    MemoryUsage usage;
+};
+
+// MemoryStats
+// * estimated memory retained by a renderer
+// * cache is the render data cache by type of object
+//   (see SetRenderDataCacheSize)
+// * backend is the memory the backend holds for objects
+//   in the scene by type of object; listBackendUsage
+//   breaks down everything the backend holds (including
+//   memory that isn't for any one object, like glyphs)
+//   by the structure it's held in
+struct MemoryStats
+{
+    size_t GetTotalBytes() const
+    {
+        size_t numBytes = cache.GetTotal().numBytes;
+        for(size_t i=0; i < listDataSetStats.size(); i++)
+        {   numBytes += listDataSetStats[i].GetTotal().numBytes;   }
+
+        for(size_t i=0; i < listBackendUsage.size(); i++)
+        {   numBytes += listBackendUsage[i].usage.numBytes;   }
+
+        return numBytes;
+    }
+
+    std::vector<DataSetMemoryStats> listDataSetStats;
+    ObjectMemoryUsage cache;
+
+    ObjectMemoryUsage backend;
+    std::vector<BackendMemoryUsage> listBackendUsage;
+};
+
+// SceneUpdate
+// * a scene update built for a specific camera; building
+//   an update doesn't touch the scene so it can be done
+//   on a worker thread and committed later on
+// * generation is the scene generation the update was
+//   built for; a newer camera supersedes the update
+// * listLODRangesActive and lodStats are the lod ranges
+//   active in the update and how hysteresis affected them
+// * scratchStats is the scratch list use while building
+//   the update (see ScratchArena)
+// * stats has the timing and counts for building the
+//   update; the rest is filled in as it's applied
+// * commitDsIdx is the DataSetUpdate being applied
+//   if the update is committed over several frames
+struct SceneUpdate
+{
+    SceneUpdate() :
+        generation(0),commitStarted(false),commitDsIdx(0) {}
+
+    Camera camera;
+    std::vector<DataSetUpdate> listDataSetUpdates;
+    size_t generation;
+
+    std::vector<bool> listLODRangesActive;
+    LODHysteresisStats lodStats;
+    ScratchArenaStats scratchStats;
+    SceneUpdateStats stats;
+
+    bool commitStarted;
+    size_t commitDsIdx;
+};
+
+// PrefetchData
+// * every object in a region the camera is expected to
+//   move into, with render data already generated, by lod
+// * listBounds is the region covered for each lod
+struct PrefetchData
+{
+    DataSet * dataSet;
+    ListGeoBoundsByLod      listBounds;
+
+    ListNodeDataByLod       listNodeData;
+    ListWayDataByLod        listWayData;
+    ListAreaDataByLod       listAreaData;
+    ListRelAreaDataByLod    listRelAreaData;
+};
+
+// ========================================================================== //
+// ========================================================================== //
+
 class MapRenderer
 {
 public:
@@ -111,6 +652,8 @@ public:
     void SetRenderStyle(std::string const &stylePath);
 
     // GetDebugLog
+    // * the messages logged by this renderer that are
+    //   still kept in the log (see Logger), oldest first
     void GetDebugLog(std::vector<std::string> &listDebugMessages);
 
     // InitializeScene
@@ -152,6 +695,158 @@ public:
     // GetCamera
     Camera const * GetCamera();
 
+    // SetAsyncSceneUpdates
+    // * when enabled, camera updates don't modify the scene
+    //   directly; a worker thread queries the DataSets and
+    //   generates render data for a snapshot of the camera
+    //   and the result is applied with CommitSceneUpdate
+    // * a camera with a new view cancels the update being
+    //   built for the old one (and a finished update that
+    //   hasn't started committing) so stale results are
+    //   never applied to the scene
+    // * disabled by default
+    void SetAsyncSceneUpdates(bool enable);
+    bool GetAsyncSceneUpdates();
+
+    // CommitSceneUpdate
+    // * applies the last update finished by the worker
+    //   thread to the scene -- should be called from the
+    //   render thread (ie. once before each frame)
+    // * if a commit budget is set, only part of the update
+    //   may be applied; the rest is applied by later calls
+    //   before the worker starts on the next camera
+    // * returns true if the scene was updated
+    bool CommitSceneUpdate();
+
+    // IsSceneUpdatePending
+    // * returns true if an update finished by the worker
+    //   thread hasn't been fully committed yet -- the app
+    //   should keep drawing frames (and committing) while
+    //   this is true
+    bool IsSceneUpdatePending();
+
+    // SetSceneCommitBudget
+    // * limits how long each CommitSceneUpdate call spends
+    //   applying changes to the scene (maxMillis) and how
+    //   many objects it adds or removes (maxObjects), so a
+    //   large update streams in over several frames instead
+    //   of stalling a single frame
+    // * the backend's doneUpdating[] functions are called at
+    //   the end of every commit that modified the scene
+    // * 0 means no limit; both are 0 by default
+    void SetSceneCommitBudget(double maxMillis, size_t maxObjects);
+    void GetSceneCommitBudget(double &maxMillis, size_t &maxObjects);
+
+    // SetIncrementalSceneUpdates
+    // * when enabled, camera updates only query DataSets
+    //   for the regions newly exposed in each LOD range and
+    //   keep objects already in the scene that are still
+    //   within view, instead of querying the whole view
+    // * falls back to querying the whole view if most of
+    //   it is new, or if a DataSet's contents were updated
+    // * disabled by default
+    void SetIncrementalSceneUpdates(bool enable);
+    bool GetIncrementalSceneUpdates();
+
+    // SetScenePrefetch
+    // * when enabled, the camera's velocity is tracked between
+    //   UpdateCameraLookAt calls and the worker thread uses any
+    //   idle time to prefetch the region the camera is expected
+    //   to move into within lookAheadSecs
+    // * objects in the prefetched region are added to the
+    //   scene without querying the DataSets or generating
+    //   their render data again
+    // * requires async scene updates and works best with
+    //   incremental scene updates; 0 disables prefetching
+    //   (default)
+    void SetScenePrefetch(double lookAheadSecs);
+    double GetScenePrefetch();
+
+    // SetRenderDataCacheSize
+    // * render data for objects that leave the scene is kept
+    //   in an LRU cache of up to maxBytes, so objects that come
+    //   back into view don't need their render data generated
+    //   again (the backend may also keep their geometry)
+    // * while the cache is enabled, render data for objects in
+    //   the scene isn't cleared once they're added so it can be
+    //   cached later; enabling or disabling the cache rebuilds
+    //   the scene
+    // * 0 disables the cache (default)
+    void SetRenderDataCacheSize(size_t maxBytes);
+    size_t GetRenderDataCacheSize();
+
+    // GetRenderDataCacheStats
+    void GetRenderDataCacheStats(RenderDataCacheStats &stats);
+
+    // SetCompactRenderData
+    // * way and area points that are kept after an object
+    //   is added to the scene (render data for the cache,
+    //   and prefetched render data) are stored as float
+    //   offsets from an origin on the object instead of
+    //   as absolute doubles, which halves their size
+    // * points are restored before render data is added to
+    //   the scene again, to within a few millimeters; the
+    //   backend always gets absolute points
+    // * disabled by default
+    void SetCompactRenderData(bool enable);
+    bool GetCompactRenderData();
+
+    // SetLODHysteresis
+    // * a lod range that's active in the scene stays active
+    //   until the view is further than bandFraction of the
+    //   range's width outside of it, and an inactive range
+    //   only becomes active once the view is that far inside
+    //   of it, so lods don't flip on and off (regenerating
+    //   all of their objects) when the camera hovers near a
+    //   range boundary
+    // * 0 disables hysteresis (default)
+    void SetLODHysteresis(double bandFraction);
+    double GetLODHysteresis();
+
+    // GetLODHysteresisStats
+    // * counts lod range changes in committed updates, and
+    //   the changes hysteresis held back
+    void GetLODHysteresisStats(LODHysteresisStats &stats);
+
+    // GetScratchArenaStats
+    // * scratch list use for the last committed update,
+    //   from building it through to applying it; numAllocs
+    //   counts the heap allocations made for temporary lists
+    void GetScratchArenaStats(ScratchArenaStats &stats);
+
+    // GetSceneUpdateStats
+    // * per phase timing and counts for the last
+    //   committed update (see SceneUpdateStats)
+    void GetSceneUpdateStats(SceneUpdateStats &stats);
+
+    // GetMemoryStats
+    // * estimates the memory retained by each DataSet's
+    //   render data and style configs, the render data
+    //   cache and the backend (see MemoryStats)
+    // * walks all of the scene's render data, so it isn't
+    //   meant to be called every frame; should be called
+    //   from the thread that updates the scene (the one
+    //   that calls CommitSceneUpdate if async scene
+    //   updates are enabled)
+    void GetMemoryStats(MemoryStats &stats);
+
+    // SetTraceRecording
+    // * when enabled, the stages of each scene update (and
+    //   the backend's own stages) are recorded as events on
+    //   the thread that ran them, up to maxEventsPerThread
+    //   events per thread; enabling clears earlier events
+    // * the events can be viewed on a timeline with
+    //   WriteTraceFile
+    // * disabled by default
+    void SetTraceRecording(bool enable, size_t maxEventsPerThread=65536);
+    bool GetTraceRecording();
+
+    // WriteTraceFile
+    // * writes the recorded events to path as Chrome trace
+    //   event json (for chrome://tracing or Perfetto)
+    // * returns false if the file couldn't be written
+    bool WriteTraceFile(std::string const &path);
+
     //
     virtual void ShowPlanetSurface() = 0;
     virtual void HidePlanetSurface() = 0;
@@ -168,6 +863,13 @@ private:
     // rebuildAllData
     void rebuildAllData();
 
+    // removeDataSet
+    // * waits for the worker and drops any pending update
+    //   or prefetch data that refers to dataSet, so the
+    //   caller can delete it once this returns
+    // * the DataSet's objects are taken out of the scene
+    void removeDataSet(DataSet *dataSet);
+
     // if the render engine wants to do anything with the
     // new style data (cache certain stuff, etc), it
     // should be done here -- it isn't mandatory to do
@@ -189,6 +891,71 @@ private:
     virtual void removeAreaFromScene(AreaRenderData const &areaData) = 0;
     virtual void removeRelAreaFromScene(RelAreaRenderData const &relAreaData) = 0;
 
+    // add[]sToScene,remove[]sFromScene
+    // * batched versions of add[]ToScene and remove[]FromScene
+    //   that are passed up to OPT_SCENE_BATCH_SIZE objects of
+    //   one type at a time, so the implementation can build
+    //   and upload (or tear down) their geometry together
+    // * the default implementations call add[]ToScene or
+    //   remove[]FromScene for each object
+    virtual void addNodesToScene(std::vector<NodeRenderData> &listNodeData);
+    virtual void addWaysToScene(std::vector<WayRenderData> &listWayData);
+    virtual void addAreasToScene(std::vector<AreaRenderData> &listAreaData);
+    virtual void addRelAreasToScene(std::vector<RelAreaRenderData> &listRelAreaData);
+
+    virtual void removeNodesFromScene(std::vector<NodeRenderData> const &listNodeData);
+    virtual void removeWaysFromScene(std::vector<WayRenderData> const &listWayData);
+    virtual void removeAreasFromScene(std::vector<AreaRenderData> const &listAreaData);
+    virtual void removeRelAreasFromScene(std::vector<RelAreaRenderData> const &listRelAreaData);
+
+    // hide[]InScene
+    // * called instead of remove[]FromScene when an object's
+    //   render data goes into the cache; the implementation
+    //   can take the object's geometry out of the scene but
+    //   keep it so that show[]InScene can put it back without
+    //   rebuilding it
+    // * returns false if the geometry isn't kept (default),
+    //   otherwise remove[]FromScene is called for the hidden
+    //   object once it's evicted from the cache
+    virtual bool hideNodeInScene(NodeRenderData &nodeData);
+    virtual bool hideWayInScene(WayRenderData &wayData);
+    virtual bool hideAreaInScene(AreaRenderData &areaData);
+    virtual bool hideRelAreaInScene(RelAreaRenderData &relAreaData);
+
+    virtual void showNodeInScene(NodeRenderData &nodeData);
+    virtual void showWayInScene(WayRenderData &wayData);
+    virtual void showAreaInScene(AreaRenderData &areaData);
+    virtual void showRelAreaInScene(RelAreaRenderData &relAreaData);
+
+    // restyle[]InScene
+    // * called when an object only changed lod; oldData is
+    //   its render data at the old lod and newData its render
+    //   data for the new lod (styles may differ by lod)
+    // * oldData's geometry may only be in its compact
+    //   form (see SetCompactRenderData)
+    // * the implementation can update the object's existing
+    //   geometry instead of rebuilding it, in which case it
+    //   sets newData.geomPtr and returns true
+    // * returns false if the object should be removed and
+    //   added again (default)
+    virtual bool restyleNodeInScene(NodeRenderData const &oldData,
+                                    NodeRenderData &newData);
+    virtual bool restyleWayInScene(WayRenderData const &oldData,
+                                   WayRenderData &newData);
+    virtual bool restyleAreaInScene(AreaRenderData const &oldData,
+                                    AreaRenderData &newData);
+    virtual bool restyleRelAreaInScene(RelAreaRenderData const &oldData,
+                                       RelAreaRenderData &newData);
+
+    // calcBackendMemoryUsage
+    // * adds the memory the backend holds for objects in
+    //   the scene to objUsage by type of object, and adds
+    //   each structure the backend keeps (whether or not
+    //   it's for objects) to listUsage
+    // * the default implementation adds nothing
+    virtual void calcBackendMemoryUsage(ObjectMemoryUsage &objUsage,
+                                        std::vector<BackendMemoryUsage> &listUsage);
+
     virtual void toggleSceneVisibility(bool isVisibile) = 0;
     virtual void removeAllFromScene() = 0;
     virtual void showCameraViewArea(Camera &sceneCam) = 0;
@@ -207,14 +974,360 @@ private:
     //   (if the overlap of their view extent areas is < 75%)
     void updateSceneBasedOnCamera();
 
-    // update[]RenderData
-    // * removes drawable objects no longer in the scene
-    //   and adds drawable objects newly present in the scene
-    void updateNodeRenderData(DataSet *dataSet,ListNodeRefsByLod &listNodeRefs);
-    void updateWayRenderData(DataSet *dataSet,ListWayRefsByLod &listWayRefs);
-    void updateAreaRenderData(DataSet *dataSet,ListAreaRefsByLod &listAreaRefs);
-    void updateRelWayRenderData(DataSet *dataSet,ListRelWayRefsByLod &listRelWayRefs);
-    void updateRelAreaRenderData(DataSet *dataSet,ListRelAreaRefsByLod &listRelAreaRefs);
+    // buildSceneUpdate
+    // * queries the specified DataSets for the given camera
+    //   and generates render data for objects that aren't
+    //   in the scene yet without modifying the scene
+    // * queries for each DataSet, LOD range and bounds are
+    //   run in parallel and merged in a fixed order, so
+    //   closer LODs still take precedence over further ones
+    // * gives up once sceneUpdate.generation is superseded
+    // * listLODRangesWereActive are the lod ranges active
+    //   in the scene (see calcQueryBounds)
+    // * returns false if there's nothing to update
+    bool buildSceneUpdate(Camera const &cam,
+                          std::vector<DataSet*> const &listDataSets,
+                          std::vector<bool> const &listLODRangesWereActive,
+                          SceneUpdate &sceneUpdate);
+
+    // calcQueryBounds
+    // * finds the LOD ranges that are active for the
+    //   camera and the lat/lon bounds to query for each
+    // * listLODRangesWereActive are the ranges active in the
+    //   scene (may be empty); a range only changes state if
+    //   it's past the hysteresis band, and changes that were
+    //   held back are counted in lodStats
+    // * returns false if no LOD range is active or the
+    //   bounds couldn't be calculated
+    bool calcQueryBounds(Camera const &cam,
+                         std::vector<RenderStyleConfig*> const &listStyleConfigs,
+                         std::vector<bool> const &listLODRangesWereActive,
+                         std::vector<bool> &listLODRangesActive,
+                         ListGeoBoundsByLod &listBoundsByLod,
+                         LODHysteresisStats &lodStats,
+                         ScratchArena &scratch);
+
+    // runObjectQueries
+    // * runs DataSet queries in parallel; queries to DataSets
+    //   that aren't reentrant and share a query source are
+    //   run one after another
+    // * queries that haven't started are skipped once
+    //   generation is superseded
+    void runObjectQueries(std::vector<ObjectQuery> &listObjQueries,
+                          size_t generation);
+
+    // keepObjects
+    // * adds objects in objSource's render data (at any lod;
+    //   either a DataSet's scene data or PrefetchData) that
+    //   are valid for lod and within listBounds to the lod's
+    //   refs in dsUpdate, unless a closer lod has them
+    template <typename ObjectSource>
+    void keepObjects(ObjectSource const &objSource,
+                     DataSet *dataSet,size_t lod,
+                     std::vector<GeoBounds> const &listBounds,
+                     DataSetUpdate &dsUpdate,
+                     IdSet &setNodesAllLods,
+                     IdSet &setWaysAllLods,
+                     IdSet &setAreasAllLods,
+                     IdSet &setRelAreasAllLods);
+
+    // queue[]Adds
+    // * queues render data (with only its ref set) for
+    //   objects in list[]Refs that the diff against the
+    //   DataSet's scene data added or moved to another lod
+    void queueNodeAdds(ListNodeRefsByLod const &listNodeRefs,
+                       IdDiff const &nodeDiff,
+                       ListNodeAddsByLod &listNodeAdds);
+
+    void queueWayAdds(ListWayRefsByLod const &listWayRefs,
+                      IdDiff const &wayDiff,
+                      ListWayAddsByLod &listWayAdds);
+
+    void queueAreaAdds(ListAreaRefsByLod const &listAreaRefs,
+                       IdDiff const &areaDiff,
+                       ListAreaAddsByLod &listAreaAdds);
+
+    void queueRelAreaAdds(ListRelAreaRefsByLod const &listRelAreaRefs,
+                          IdDiff const &relAreaDiff,
+                          ListRelAreaAddsByLod &listRelAreaAdds);
+
+    // orderQueuedAdds
+    // * sorts the objects in list[]Adds by lod (most detailed
+    //   lod first) and then by distance to cam into listAddOrder
+    void orderQueuedAdds(Camera const &cam,DataSetUpdate &dsUpdate);
+
+    // genSceneUpdateRenderData
+    // * generates render data for all queued objects in
+    //   parallel (in listAddOrder) and drops any that fail
+    //   to generate
+    // * only the backend add[]ToScene calls need to be
+    //   serialized, which happens when the update is applied
+    // * listPrefetch has the PrefetchData (or NULL) for
+    //   each DataSet in the update
+    // * the render data cache is only used if useCache is
+    //   set, since it may be modified by the render thread
+    //   while prefetching
+    // * returns false if sceneUpdate.generation was
+    //   superseded, in which case the remaining objects
+    //   aren't generated
+    bool genSceneUpdateRenderData(SceneUpdate &sceneUpdate,
+                                  std::vector<PrefetchData const *> const &listPrefetch,
+                                  bool useCache);
+
+    // genTaskRenderData
+    // * generates render data for a single queued object,
+    //   or copies it from prefetch or the render data cache
+    //   if either has the object at the same lod
+    void genTaskRenderData(SceneUpdate &sceneUpdate,
+                           PrefetchData const *prefetch,
+                           bool useCache,
+                           GenTask &genTask);
+
+    // buildPrefetch
+    // * queries the DataSets for the region that predCam's
+    //   view adds to cam's, and generates render data for
+    //   everything in it
+    // * gives up if a scene update is queued before
+    //   render data is generated, or once generation
+    //   is superseded
+    bool buildPrefetch(Camera const &cam,Camera const &predCam,
+                       size_t generation,
+                       std::vector<DataSet*> const &listDataSets,
+                       std::vector<bool> const &listLODRangesWereActive,
+                       std::vector<PrefetchData> &listPrefetchData);
+
+    // isPrefetchCancelled
+    // * true if a scene update was queued for the worker
+    bool isPrefetchCancelled();
+
+    // isSceneUpdateCancelled
+    // * true if work for generation was superseded by a
+    //   newer camera (or dropped) and should be abandoned
+    // * doesn't lock, so it's cheap enough to be checked
+    //   between individual queries and objects
+    bool isSceneUpdateCancelled(size_t generation);
+
+    // findPrefetchData
+    // * returns the PrefetchData for dataSet, or NULL
+    PrefetchData const * findPrefetchData(DataSet const *dataSet);
+
+    // updateCameraVelocity
+    // * updates the camera's velocity using the time since
+    //   the last call; the velocity is smoothed over calls
+    void updateCameraVelocity();
+
+    // calcPredictedCamera
+    // * moves the current camera along its velocity for
+    //   lookAheadSecs, keeping its altitude
+    // * returns false if the camera isn't moving enough
+    //   to expose much of a new region
+    bool calcPredictedCamera(double lookAheadSecs,Camera &predCam);
+
+    // applySceneUpdate
+    // * calls the renderer driver's functions to remove
+    //   objects no longer in the scene and add objects
+    //   newly present in the scene
+    // * stops once budget is spent and picks up where it
+    //   left off when called again with the same update
+    // * returns true once the whole update is applied
+    bool applySceneUpdate(SceneUpdate &sceneUpdate,
+                          CommitBudget &budget);
+
+    // applyDataSetUpdate
+    // * removes drawable objects no longer in the scene,
+    //   then adds objects newly present in the scene (or
+    //   restyles/replaces objects that changed lod) in the
+    //   order given by listAddOrder
+    // * returns false if budget ran out first
+    bool applyDataSetUpdate(DataSetUpdate &dsUpdate, CommitBudget &budget);
+
+    // apply[]Removes
+    // * removes objects of one type that are no longer
+    //   in the scene and notes the ones that changed lod
+    // * returns false if budget ran out first
+    bool applyNodeRemoves(DataSetUpdate &dsUpdate, CommitBudget &budget);
+    bool applyWayRemoves(DataSetUpdate &dsUpdate, CommitBudget &budget);
+    bool applyAreaRemoves(DataSetUpdate &dsUpdate, CommitBudget &budget);
+    bool applyRelAreaRemoves(DataSetUpdate &dsUpdate, CommitBudget &budget);
+
+    // apply[]Add
+    // * adds a single queued object to the scene
+    void applyNodeAdd(DataSetUpdate &dsUpdate, QueuedAdd const &add);
+    void applyWayAdd(DataSetUpdate &dsUpdate, QueuedAdd const &add);
+    void applyAreaAdd(DataSetUpdate &dsUpdate, QueuedAdd const &add);
+    void applyRelAreaAdd(DataSetUpdate &dsUpdate, QueuedAdd const &add);
+
+    // removeOldLods
+    // * removes objects that changed lod but couldn't
+    //   be generated at their new lod from the scene
+    // * returns true if anything was removed
+    template <typename T>
+    bool removeOldLods(RenderDataCache<T> &cache,
+                       DataSet *dataSet,
+                       std::vector<IdMap<T> > &listData,
+                       ApplyCursor &cursor);
+
+    // commitPendingUpdate
+    // * applies m_pendingUpdate within budget and
+    //   deletes it once it's fully applied
+    // * m_workerMutex must be held by the caller
+    void commitPendingUpdate(CommitBudget &budget);
+
+    // cacheRenderData
+    // * moves render data for an object leaving the scene
+    //   into the cache, hiding or removing its geometry
+    template <typename T>
+    void cacheRenderData(RenderDataCache<T> &cache,
+                         DataSet const *dataSet,size_t lod,
+                         osmscout::Id objId,T &renderData);
+
+    // takeCachedGeometry
+    // * if the cache has an entry for the object, removes
+    //   it, and if the backend kept its geometry, shows
+    //   it and copies the entry's render data
+    // * returns true if the object's geometry was shown
+    template <typename T>
+    bool takeCachedGeometry(RenderDataCache<T> &cache,
+                            DataSet const *dataSet,size_t lod,
+                            osmscout::Id objId,T &renderData);
+
+    // removeSceneObject
+    // * removes an object's render data from the DataSet's
+    //   scene data, moving it into the cache if enabled
+    //   or removing its geometry from the scene
+    // * if batch isn't NULL, geometry that isn't cached is
+    //   moved into it instead, to be removed when the batch
+    //   is flushed (see flushRemoveBatch)
+    template <typename T>
+    void removeSceneObject(RenderDataCache<T> &cache,
+                           DataSet *dataSet,size_t lod,
+                           IdMap<T> &listData,
+                           osmscout::Id objId,
+                           SceneBatch<T> *batch=NULL);
+
+    // flushAddBatch
+    // * adds the objects in batch to the scene and
+    //   stores their render data at their lods
+    template <typename T>
+    void flushAddBatch(std::vector<IdMap<T> > &listData,
+                       SceneBatch<T> &batch);
+
+    // flushAddBatches
+    // * flushes the add batches for every object type
+    void flushAddBatches(DataSet *dataSet);
+
+    // flushRemoveBatch
+    // * removes the objects in batch from the scene
+    template <typename T>
+    void flushRemoveBatch(SceneBatch<T> &batch);
+
+    // calcNumBatched
+    // * number of objects waiting in all batches
+    size_t calcNumBatched() const;
+
+    // changeObjectLod
+    // * restyles an object that moved from oldLod to a new
+    //   lod, or removes it from oldLod if it can't be
+    // * returns true if the object was restyled, in which
+    //   case renderData shouldn't be added to the scene
+    template <typename T>
+    bool changeObjectLod(RenderDataCache<T> &cache,
+                         DataSet *dataSet,size_t oldLod,
+                         IdMap<T> &listOldData,
+                         osmscout::Id objId,T &renderData);
+
+    // releaseCacheEntries
+    // * removes geometry kept for cache entries
+    //   that have been taken out of the cache
+    template <typename T>
+    void releaseCacheEntries(std::vector<typename RenderDataCache<T>::Entry> &listEntries);
+
+    // retainRenderData
+    // * called for render data that's just been added
+    //   to the scene; clears it if it isn't needed for
+    //   the cache, otherwise compacts its geometry if
+    //   compact render data is enabled
+    template <typename T>
+    void retainRenderData(T &renderData);
+
+    // removeCachedRenderData
+    // * removes all cache entries for dataSet
+    //   (or every entry if dataSet is NULL)
+    void removeCachedRenderData(DataSet const *dataSet);
+
+    // trimRenderDataCache
+    // * evicts the least recently used entries
+    //   until the cache is within its budget
+    void trimRenderDataCache();
+
+    // hideInScene,showInScene,addToScene,
+    // removeFromScene,clearRenderData
+    // * forward to the implementation for each object
+    //   type so the cache functions can be shared
+    bool hideInScene(NodeRenderData &nodeData)          {   return hideNodeInScene(nodeData);   }
+    bool hideInScene(WayRenderData &wayData)            {   return hideWayInScene(wayData);   }
+    bool hideInScene(AreaRenderData &areaData)          {   return hideAreaInScene(areaData);   }
+    bool hideInScene(RelAreaRenderData &relAreaData)    {   return hideRelAreaInScene(relAreaData);   }
+
+    void showInScene(NodeRenderData &nodeData)          {   showNodeInScene(nodeData);   }
+    void showInScene(WayRenderData &wayData)            {   showWayInScene(wayData);   }
+    void showInScene(AreaRenderData &areaData)          {   showAreaInScene(areaData);   }
+    void showInScene(RelAreaRenderData &relAreaData)    {   showRelAreaInScene(relAreaData);   }
+
+    void removeFromScene(NodeRenderData const &nodeData)        {   removeNodeFromScene(nodeData);   }
+    void removeFromScene(WayRenderData const &wayData)          {   removeWayFromScene(wayData);   }
+    void removeFromScene(AreaRenderData const &areaData)        {   removeAreaFromScene(areaData);   }
+    void removeFromScene(RelAreaRenderData const &relAreaData)  {   removeRelAreaFromScene(relAreaData);   }
+
+    void addToScene(std::vector<NodeRenderData> &listNodeData)          {   addNodesToScene(listNodeData);   }
+    void addToScene(std::vector<WayRenderData> &listWayData)            {   addWaysToScene(listWayData);   }
+    void addToScene(std::vector<AreaRenderData> &listAreaData)          {   addAreasToScene(listAreaData);   }
+    void addToScene(std::vector<RelAreaRenderData> &listRelAreaData)    {   addRelAreasToScene(listRelAreaData);   }
+
+    void removeFromScene(std::vector<NodeRenderData> const &listNodeData)       {   removeNodesFromScene(listNodeData);   }
+    void removeFromScene(std::vector<WayRenderData> const &listWayData)         {   removeWaysFromScene(listWayData);   }
+    void removeFromScene(std::vector<AreaRenderData> const &listAreaData)       {   removeAreasFromScene(listAreaData);   }
+    void removeFromScene(std::vector<RelAreaRenderData> const &listRelAreaData) {   removeRelAreasFromScene(listRelAreaData);   }
+
+    void clearRenderData(NodeRenderData &nodeData)          {   clearNodeRenderData(nodeData);   }
+    void clearRenderData(WayRenderData &wayData)            {   clearWayRenderData(wayData);   }
+    void clearRenderData(AreaRenderData &areaData)          {   clearAreaRenderData(areaData);   }
+    void clearRenderData(RelAreaRenderData &relAreaData)    {   clearRelAreaRenderData(relAreaData);   }
+
+    bool restyleInScene(NodeRenderData const &oldData, NodeRenderData &newData)
+    {   return restyleNodeInScene(oldData,newData);   }
+
+    bool restyleInScene(WayRenderData const &oldData, WayRenderData &newData)
+    {   return restyleWayInScene(oldData,newData);   }
+
+    bool restyleInScene(AreaRenderData const &oldData, AreaRenderData &newData)
+    {   return restyleAreaInScene(oldData,newData);   }
+
+    bool restyleInScene(RelAreaRenderData const &oldData, RelAreaRenderData &newData)
+    {   return restyleRelAreaInScene(oldData,newData);   }
+
+    // runSceneUpdateWorker
+    // * worker thread loop; waits for a camera snapshot
+    //   and builds a SceneUpdate for it once the previous
+    //   update has been committed
+    void runSceneUpdateWorker();
+
+    // stopSceneUpdateWorker
+    // * joins the worker thread without committing
+    //   the last update it built
+    void stopSceneUpdateWorker();
+
+    // queueSceneUpdate
+    // * hands the current camera to the worker thread
+    // * m_workerMutex must be held by the caller
+    void queueSceneUpdate();
+
+    // waitForWorkerIdle
+    // * blocks until the worker isn't building an update
+    //   and drops any queued or uncommitted update; an
+    //   update that's partly committed is finished instead
+    // * returns true if an update was dropped
+    bool waitForWorkerIdle(std::unique_lock<std::mutex> &lock);
 
     // gen[]RenderData
     // * generates render data given a []Ref
@@ -227,13 +1340,14 @@ private:
     bool genWayRenderData(DataSet *dataSet,
                           osmscout::WayRef const &wayRef,
                           RenderStyleConfig const *renderStyle,
-                          ListSharedNodes &listSharedNodes,
-                          WayRenderData &wayRenderData);
+                          WayRenderData &wayRenderData,
+                          ScratchArena &scratch);
 
     bool genAreaRenderData(DataSet *dataSet,
                            osmscout::WayRef const &areaRef,
                            RenderStyleConfig const *renderStyle,
-                           AreaRenderData &areaRenderData);
+                           AreaRenderData &areaRenderData,
+                           ScratchArena &scratch);
 
     bool genRelWayRenderData(DataSet *dataSet,
                              osmscout::RelationRef const &relRef,
@@ -243,7 +1357,8 @@ private:
     bool genRelAreaRenderData(DataSet *dataSet,
                               osmscout::RelationRef const &relRef,
                               RenderStyleConfig const *renderStyle,
-                              RelAreaRenderData &relRenderData);
+                              RelAreaRenderData &relRenderData,
+                              ScratchArena &scratch);
 
     // clear[]RenderData
     // * clears render data for map geometry, but keeps
@@ -256,15 +1371,12 @@ private:
     void clearRelWayRenderData(RelWayRenderData &relRenderData);
     void clearRelAreaRenderData(RelAreaRenderData &relRenderData);
 
-    // getListIntersections
-    void getListSharedWayNodes(ListSharedNodes &listSharedNodes,
-                               osmscout::WayRef const &wayRef,
-                               std::vector<std::vector<WayXSec*> > &listWayXSec);
-
-    // removeWayFromSharedNodes
-    // * remove all nodes belonging to way from shared nodes list
-    void removeWayFromSharedNodes(ListSharedNodes &listSharedNodes,
-                                  osmscout::WayRef const &wayRef);
+    // addWaysToSharedNodes
+    // * adds the ways in dsUpdate to their DataSet's shared
+    //   node indices and updates the indices, so that the
+    //   ways' intersections can be found as they're added
+    //   (removed ways must already have been queued)
+    void addWaysToSharedNodes(DataSetUpdate &dsUpdate);
 
     std::string                                m_stylePath;
     std::vector<DataSet*>                      m_listDataSets;
@@ -279,6 +1391,99 @@ private:
     Vec3 m_data_exBR;
     Vec3 m_data_exBL;
 
+    // async scene update vars
+    // * the worker only reads DataSet render data while
+    //   m_pendingUpdate is NULL, and the render thread only
+    //   modifies it while holding m_workerMutex
+    // * m_pendingUpdate stays set until it has been fully
+    //   committed, which may take several frames
+    // * m_sceneGeneration is incremented whenever the
+    //   worker's camera changes or its work is dropped;
+    //   anything built for an older generation is stale
+    bool                        m_asyncUpdates;
+    std::thread                 m_workerThread;
+    std::mutex                  m_workerMutex;
+    std::condition_variable     m_workerCondVar;
+    bool                        m_workerExit;
+    bool                        m_workerBusy;
+    bool                        m_workerHasJob;
+    Camera                      m_workerCamera;
+    std::vector<DataSet*>       m_workerDataSets;
+    SceneUpdate *               m_pendingUpdate;
+    std::atomic<size_t>         m_sceneGeneration;
+
+    // commit budget (0 is unlimited)
+    double                      m_commitMaxMillis;
+    size_t                      m_commitMaxObjects;
+
+    // only query newly exposed regions
+    bool                        m_incrementalUpdates;
+
+    // lod hysteresis vars
+    // * m_listLODRangesActive are the lod ranges active
+    //   in the scene, updated when an update is applied
+    double                      m_lodHysteresis;
+    std::vector<bool>           m_listLODRangesActive;
+    LODHysteresisStats          m_lodStats;
+
+    // prefetch vars
+    // * m_listPrefetchData is only used while building
+    //   updates, and replaced by the worker thread
+    double                      m_prefetchTime;
+    bool                        m_camHasLastEye;
+    bool                        m_camHasVelocity;
+    Vec3                        m_camLastEye;
+    Vec3                        m_camVelocity;
+    std::chrono::steady_clock::time_point m_camLastTime;
+    bool                        m_workerHasPrefetchJob;
+    Camera                      m_workerPrefetchCamera;
+    std::vector<PrefetchData>   m_listPrefetchData;
+
+    // render data cache vars
+    // * the caches are only modified by the render
+    //   thread while the worker isn't building an
+    //   update (the same as DataSet render data)
+    size_t                                  m_cacheMaxBytes;
+    size_t                                  m_cacheTick;
+    std::atomic<size_t>                     m_cacheHits;
+    std::atomic<size_t>                     m_cacheMisses;
+    size_t                                  m_cacheEvictions;
+    RenderDataCache<NodeRenderData>         m_nodeCache;
+    RenderDataCache<WayRenderData>          m_wayCache;
+    RenderDataCache<AreaRenderData>         m_areaCache;
+    RenderDataCache<RelAreaRenderData>      m_relAreaCache;
+
+    // store kept geometry as float offsets
+    bool                                    m_compactRenderData;
+
+    // objects waiting to be passed to the backend
+    // in a batched add or remove call; only used
+    // while an update is being applied
+    SceneBatch<NodeRenderData>              m_nodeBatch;
+    SceneBatch<WayRenderData>               m_wayBatch;
+    SceneBatch<AreaRenderData>              m_areaBatch;
+    SceneBatch<RelAreaRenderData>           m_relAreaBatch;
+
+    // threads used to run DataSet queries
+    // and generate render data
+    TaskPool                    m_taskPool;
+
+    // scratch lists for temporary buffers, reset once
+    // per update cycle; there's an arena for each task
+    // pool thread (see TaskPool::GetThreadIdx, arena 0
+    // belongs to the thread building the update) and one
+    // for the render thread while applying updates
+    std::vector<ScratchArena*>  m_listScratchArenas;
+    ScratchArena                m_commitScratch;
+    ScratchArenaStats           m_scratchStats;
+
+    // scene update stats
+    // * m_commitStats collects the stats for the update
+    //   being applied, and is copied to m_updateStats
+    //   once the update has been fully applied
+    SceneUpdateStats            m_commitStats;
+    SceneUpdateStats            m_updateStats;
+
 protected:
     // METHODS
 
@@ -288,12 +1493,24 @@ protected:
     void convLLAToECEF(PointLLA const &pointLLA, Vec3 &pointECEF);
     Vec3 convLLAToECEF(PointLLA const &pointLLA);
 
+    // * batched version that adds a list of points to
+    //   buffECEF as a new ring, two at a time with SSE2
+    //   when it's available (falls back to the single
+    //   point version)
+    void convLLAToECEF(std::vector<PointLLA> const &listPointLLA,
+                       GeomBuffer &buffECEF);
+
     // convECEFToLLA
     // * converts point data in ECEF X/Y/Z to its corresponding
     //   Longitude/Latitude/Altitude coordinates
     void convECEFToLLA(Vec3 const &pointECEF, PointLLA &pointLLA);
     PointLLA convECEFToLLA(Vec3 const &pointECEF);
 
+    // * batched version; only the sin/cos and sqrt
+    //   terms are vectorized (atan2 is still scalar)
+    void convECEFToLLA(std::vector<Vec3> const &listPointECEF,
+                       std::vector<PointLLA> &listPointLLA);
+
     // convStrToDbl
     double convStrToDbl(std::string const &strNum);
 
@@ -376,13 +1593,15 @@ protected:
     // [3d]
 
     // calcPolylineLength
-    // * computes the length of a series of ordered points
-    double calcPolylineLength(std::vector<Vec3> const &listVx);
+    // * computes the length of a ring in buff
+    // * segment lengths are computed two at a time
+    //   with SSE2 when it's available
+    double calcPolylineLength(GeomBuffer const &buff, size_t ring);
 
     // calcPolylineSegmentDist
     // * computes the distance from the staring vertex
-    //   to the end of each segment in a polyline
-    void calcPolylineSegmentDist(std::vector<Vec3> const &listVx,
+    //   to the end of each segment in a ring in buff
+    void calcPolylineSegmentDist(GeomBuffer const &buff, size_t ring,
                                  std::vector<double> &listSegLengths);
 
     // calcPolylineVxAtDist
@@ -395,16 +1614,16 @@ protected:
     // calcPolylineTrimmed
     // * trims the start and end of a polyine according
     //   to the provided start and end distances
-    void calcPolylineTrimmed(std::vector<Vec3> const &listVx,
+    void calcPolylineTrimmed(GeomBuffer const &buff, size_t ring,
                              double distStart,double distEnd,
                              std::vector<Vec3> &listVxTrim);
 
     // calcPolylineResample
-    // * resamples a polyline by adding vertices according
-    //   to the specified spacing distance
+    // * resamples a ring in buff by adding vertices
+    //   according to the specified spacing distance
     // * the resampling preserves existing vertices so the
     //   distance between vertices won't always be equal
-    void calcPolylineResample(std::vector<Vec3> const &listVx,
+    void calcPolylineResample(GeomBuffer const &buff, size_t ring,
                               double const distResample,
                               std::vector<Vec3> &listVxRes);
 
@@ -479,10 +1698,14 @@ protected:
                                   Vec3 &nearXsecPoint);
 
     // calcBoundsIntersection
-    bool calcBoundsIntersection(std::vector<Vec3> const &listVxB1,
+    // * bounds are projected onto a plane normal
+    //   to camEye before being intersected
+    bool calcBoundsIntersection(Vec3 const &camEye,
+                                std::vector<Vec3> const &listVxB1,
                                 std::vector<Vec3> const &listVxB2,
                                 std::vector<Vec3> &listVxROI,
-                                Vec3 &vxROICentroid);
+                                Vec3 &vxROICentroid,
+                                ScratchArena &scratch);
 
     // [geo]
 
@@ -512,8 +1735,34 @@ protected:
                              Vec3 &exBR,Vec3 &exBL);
 
     // calcEnclosingGeoBounds
-    void calcEnclosingGeoBounds(std::vector<Vec3> const &listPolyVx,
-                                std::vector<GeoBounds> &listBounds);
+    void calcEnclosingGeoBounds(Vec3 const &camEye,
+                                std::vector<Vec3> const &listPolyVx,
+                                std::vector<GeoBounds> &listBounds,
+                                ScratchArena &scratch);
+
+    // calcGeoBoundsDifference
+    // * splits the parts of listBoundsA that aren't
+    //   covered by listBoundsB into a list of bounds
+    void calcGeoBoundsDifference(std::vector<GeoBounds> const &listBoundsA,
+                                 std::vector<GeoBounds> const &listBoundsB,
+                                 std::vector<GeoBounds> &listBoundsDiff);
+
+    // calcGeoBoundsArea
+    // * sum of the areas of the given bounds, in
+    //   degrees squared (only useful for comparisons)
+    double calcGeoBoundsArea(std::vector<GeoBounds> const &listBounds);
+
+    // calcPointInGeoBounds
+    // * checks if a lat/lon point lies strictly
+    //   within any of the given bounds
+    bool calcPointInGeoBounds(double lat,double lon,
+                              std::vector<GeoBounds> const &listBounds);
+
+    // calcPointsInGeoBounds
+    // * checks if the lat/lon bounding box of listPoints
+    //   overlaps with any of the given bounds
+    bool calcPointsInGeoBounds(std::vector<osmscout::Point> const &listPoints,
+                               std::vector<GeoBounds> const &listBounds);
 
     /*
     void calcEnclosingGeoBounds(std::vector<Vec3> const &listPolyVx,
@@ -531,7 +1780,8 @@ protected:
     bool calcCamViewExtents(Camera &cam);
 
     // getCameraMinViewDist
-    void calcCamViewDistances(double &minViewDist,
+    void calcCamViewDistances(Camera const &cam,
+                              double &minViewDist,
                               double &maxViewDist);
 
 
@@ -555,10 +1805,12 @@ protected:
     // [builders]
 
     // buildPolylineAsTriStrip
-    // * converts a set of points and a given width to
+    // * converts a ring in buff and a given width to
     //   '3d' as a triangle strip
     // * calculates vertices, texcoords and total length
-    void buildPolylineAsTriStrip(std::vector<Vec3> const &listPolylineVx,
+    // * only called while applying an update (temporary
+    //   lists come from the render thread's scratch arena)
+    void buildPolylineAsTriStrip(GeomBuffer const &buff, size_t ring,
                                  double const polylineWidth,
                                  std::vector<Vec3> &listVx,
                                  std::vector<Vec2> &listTx,
@@ -566,17 +1818,17 @@ protected:
                                  bool cleanOverlaps=false);
 
     // buildContourSideWalls
-    // * extrude a contour along the offsetHeight
-    //   vector and build its side walls as tris
-    void buildContourSideWalls(std::vector<Vec3> const &listContourVx,
+    // * extrude a contour (a ring in buff) along the
+    //   offsetHeight vector and build its side walls as tris
+    void buildContourSideWalls(GeomBuffer const &buff, size_t ring,
                                Vec3 const &offsetHeight,
                                std::vector<Vec3> &listSideTriVx,
                                std::vector<Vec3> &listSideTriNx);
 
     // buildContourWireframe
-    // * extrude a contour along the offsetHeight
-    //   vector and build a wireframe along its edges
-    void buildContourWireframe(std::vector<Vec3> const &listContourVx,
+    // * extrude a contour (a ring in buff) along the
+    //   offsetHeight vector and build a wireframe along its edges
+    void buildContourWireframe(GeomBuffer const &buff, size_t ring,
                                Vec3 const &offsetHeight,
                                std::vector<Vec3> &listVx,
                                std::vector<size_t> &listIx);
@@ -651,7 +1903,9 @@ protected:
     void printCamera(Camera const &cam);
 
     // MEMBERS
-    std::vector<std::string> m_listMessages;
+
+    // trace events (see OSRTRACE)
+    TraceRecorder m_trace;
 };
 
 }
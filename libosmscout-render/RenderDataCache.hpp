@@ -0,0 +1,235 @@
+/*
+    libosmscout-render
+
+    Copyright (C) 2012, Preet Desai
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef OSMSCOUTRENDER_RENDERDATACACHE_HPP
+#define OSMSCOUTRENDER_RENDERDATACACHE_HPP
+
+#include <list>
+#include <vector>
+#include <functional>
+
+#include "DataSet.hpp"
+
+namespace osmsrender
+{
+    // RenderDataCacheStats
+    // * hits and misses count queued objects that were
+    //   or weren't found in the cache when render data
+    //   was about to be generated for them
+    struct RenderDataCacheStats
+    {
+        RenderDataCacheStats() :
+            numHits(0),numMisses(0),numEvictions(0),
+            numEntries(0),numBytes(0),maxBytes(0)
+        {}
+
+        size_t numHits;
+        size_t numMisses;
+        size_t numEvictions;
+        size_t numEntries;
+        size_t numBytes;
+        size_t maxBytes;
+    };
+
+    // render data for objects that recently left
+    // the scene, keyed by (DataSet,lod,osmscout::Id)
+
+    // entries are kept in the order they were inserted
+    // so the least recently used entry is always at the
+    // back; an object that's used again is taken out of
+    // the cache, so inserts are the only 'uses'
+
+    // the cache doesn't enforce a memory budget by itself
+    // since MapRenderer keeps one for each type of object
+    // with a shared budget; PeekOldest and PopOldest are
+    // used to evict the oldest entry amongst all of them
+
+    template <typename T>
+    class RenderDataCache
+    {
+    public:
+        struct Entry
+        {
+            Entry() :
+                dataSet(NULL),lod(0),objId(0),
+                numBytes(0),insertTick(0),hasGeometry(false)
+            {}
+
+            DataSet const * dataSet;
+            size_t lod;
+            osmscout::Id objId;
+            size_t numBytes;
+            size_t insertTick;
+
+            // the backend kept the object's
+            // geometry (see geomPtr)
+            bool hasGeometry;
+
+            T renderData;
+        };
+
+        RenderDataCache() :
+            m_numBytes(0)
+        {}
+
+        size_t GetNumEntries() const
+        {   return m_mapEntries.size();   }
+
+        size_t GetNumBytes() const
+        {   return m_numBytes;   }
+
+        // Find
+        // * returns the render data for an object or NULL
+        // * doesn't modify the cache, so it can be called
+        //   from multiple threads as long as nothing is
+        //   being inserted or taken at the same time
+        T const * Find(DataSet const *dataSet, size_t lod,
+                       osmscout::Id objId) const
+        {
+            typename MapEntries::const_iterator it =
+                    m_mapEntries.find(Key(dataSet,lod,objId));
+
+            if(it == m_mapEntries.end())
+            {   return NULL;   }
+
+            return &(it->second->renderData);
+        }
+
+        // Insert
+        // * adds an entry, replacing any existing entry
+        //   for the same object (which is returned in
+        //   listReplaced so it can be released)
+        void Insert(Entry const &entry,
+                    std::vector<Entry> &listReplaced)
+        {
+            Entry oldEntry;
+            if(Take(entry.dataSet,entry.lod,entry.objId,oldEntry))
+            {   listReplaced.push_back(oldEntry);   }
+
+            m_listEntries.push_front(entry);
+            m_mapEntries.insert(std::make_pair(
+                Key(entry.dataSet,entry.lod,entry.objId),
+                m_listEntries.begin()));
+
+            m_numBytes += entry.numBytes;
+        }
+
+        // Take
+        // * removes an object's entry and returns it
+        bool Take(DataSet const *dataSet, size_t lod,
+                  osmscout::Id objId, Entry &entry)
+        {
+            typename MapEntries::iterator it =
+                    m_mapEntries.find(Key(dataSet,lod,objId));
+
+            if(it == m_mapEntries.end())
+            {   return false;   }
+
+            entry = *(it->second);
+            m_numBytes -= entry.numBytes;
+            m_listEntries.erase(it->second);
+            m_mapEntries.erase(it);
+            return true;
+        }
+
+        // PeekOldest
+        // * gets the insert tick of the least recently
+        //   used entry; returns false if the cache is empty
+        bool PeekOldest(size_t &insertTick) const
+        {
+            if(m_listEntries.empty())
+            {   return false;   }
+
+            insertTick = m_listEntries.back().insertTick;
+            return true;
+        }
+
+        // PopOldest
+        // * removes the least recently used entry
+        void PopOldest(Entry &entry)
+        {
+            Entry const &oldest = m_listEntries.back();
+            Take(oldest.dataSet,oldest.lod,oldest.objId,entry);
+        }
+
+        // Remove
+        // * removes all entries belonging to dataSet (or all
+        //   entries if dataSet is NULL) into listRemoved
+        void Remove(DataSet const *dataSet,
+                    std::vector<Entry> &listRemoved)
+        {
+            typename std::list<Entry>::iterator it;
+            for(it = m_listEntries.begin();
+                it != m_listEntries.end();)
+            {
+                if(dataSet == NULL || it->dataSet == dataSet)   {
+                    listRemoved.push_back(*it);
+                    m_numBytes -= it->numBytes;
+                    m_mapEntries.erase(Key(it->dataSet,it->lod,it->objId));
+                    it = m_listEntries.erase(it);
+                }
+                else
+                {   ++it;   }
+            }
+        }
+
+    private:
+        struct Key
+        {
+            Key(DataSet const *myDataSet, size_t myLod,
+                osmscout::Id myObjId) :
+                dataSet(myDataSet),lod(myLod),objId(myObjId)
+            {}
+
+            bool operator == (Key const &other) const
+            {
+                return (dataSet == other.dataSet &&
+                        lod == other.lod &&
+                        objId == other.objId);
+            }
+
+            DataSet const * dataSet;
+            size_t lod;
+            osmscout::Id objId;
+        };
+
+        struct KeyHash
+        {
+            size_t operator() (Key const &key) const
+            {
+                size_t hash = std::hash<osmscout::Id>()(key.objId);
+                hash ^= std::hash<size_t>()(key.lod) +
+                        0x9e3779b9 + (hash << 6) + (hash >> 2);
+                hash ^= std::hash<DataSet const *>()(key.dataSet) +
+                        0x9e3779b9 + (hash << 6) + (hash >> 2);
+                return hash;
+            }
+        };
+
+        typedef TYPE_UNORDERED_MAP<Key,typename std::list<Entry>::iterator,
+                                   KeyHash> MapEntries;
+
+        std::list<Entry>    m_listEntries;
+        MapEntries          m_mapEntries;
+        size_t              m_numBytes;
+    };
+}
+
+#endif
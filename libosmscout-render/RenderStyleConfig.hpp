@@ -452,6 +452,36 @@ namespace osmsrender
     // ========================================================================== //
     // ========================================================================== //
 
+    // TypeStyle
+    // * the styles and layers a type has as a node, way
+    //   and area; styles are indices into the style lists
+    //   of the RenderStyleConfig (STYLE_NONE if unset)
+    struct TypeStyle
+    {
+        TypeStyle() :
+            nodeFill(STYLE_NONE),nodeSymbol(STYLE_NONE),nodeLabel(STYLE_NONE),
+            wayLine(STYLE_NONE),wayLabel(STYLE_NONE),wayLayer(0),
+            areaFill(STYLE_NONE),areaLabel(STYLE_NONE),areaLayer(0)
+        {}
+
+        static unsigned int const STYLE_NONE = 0xFFFFFFFF;
+
+        unsigned int nodeFill;
+        unsigned int nodeSymbol;
+        unsigned int nodeLabel;
+
+        unsigned int wayLine;
+        unsigned int wayLabel;
+        unsigned int wayLayer;
+
+        unsigned int areaFill;
+        unsigned int areaLabel;
+        unsigned int areaLayer;
+    };
+
+    // ========================================================================== //
+    // ========================================================================== //
+
     class RenderStyleConfig
     {
     public:
@@ -462,75 +492,21 @@ namespace osmsrender
             m_planetShowSurface(false),
             m_planetShowCoastline(false),
             m_planetShowAdmin0(false),
-            m_planetShowBuildingEdges(false)
+            m_planetShowBuildingEdges(false),
+            m_maxWayLayer(0),
+            m_maxAreaLayer(0)
         {
             m_numTypes = typeConfig->GetTypes().size();
-
-            m_activeNodeTypes.resize(m_numTypes,false);
-            m_nodeFillStyles.resize(m_numTypes,NULL);
-            m_nodeSymbolStyles.resize(m_numTypes,NULL);
-            m_nodeNameLabelStyles.resize(m_numTypes,NULL);
-
-            m_activeWayTypes.resize(m_numTypes,false);
-            m_wayLayers.resize(m_numTypes,0);
-            m_wayLineStyles.resize(m_numTypes,NULL);
-            m_wayNameLabelStyles.resize(m_numTypes,NULL);
-
-            m_activeAreaTypes.resize(m_numTypes,false);
-            m_areaLayers.resize(m_numTypes,0);
-            m_areaFillStyles.resize(m_numTypes,NULL);
-            m_areaNameLabelStyles.resize(m_numTypes,NULL);
-        }
-
-        ~RenderStyleConfig()
-        {
-            // clear NODE style data
-            for(size_t i=0; i < m_nodeFillStyles.size(); i++)
-            {
-                if(!(m_nodeFillStyles[i] == NULL))
-                {   delete m_nodeFillStyles[i];   }
-            }
-
-            for(size_t i=0; i < m_nodeSymbolStyles.size(); i++)
-            {
-                if(!(m_nodeSymbolStyles[i] == NULL))
-                {   delete m_nodeSymbolStyles[i];   }
-            }
-
-            for(size_t i=0; i < m_nodeNameLabelStyles.size(); i++)
-            {
-                if(!(m_nodeNameLabelStyles[i] == NULL))
-                {   delete m_nodeNameLabelStyles[i];   }
-            }
-
-            // clear WAY style data
-            for(size_t i=0; i < m_wayLineStyles.size(); i++)
-            {
-                if(!(m_wayLineStyles.at(i) == NULL))
-                {   delete m_wayLineStyles[i];    }
-            }
-
-            for(size_t i=0; i < m_wayNameLabelStyles.size(); i++)
-            {
-                if(!(m_wayNameLabelStyles.at(i) == NULL))
-                {   delete m_wayNameLabelStyles[i];   }
-            }
-
-
-            // clear AREA style data
-            for(size_t i=0; i < m_areaFillStyles.size(); i++)
-            {
-                if(!(m_areaFillStyles.at(i) == NULL))
-                {   delete m_areaFillStyles[i];   }
-            }
-
-            for(size_t i=0; i < m_areaNameLabelStyles.size(); i++)
-            {
-                if(!(m_areaNameLabelStyles.at(i) == NULL))
-                {   delete m_areaNameLabelStyles[i];   }
-            }
+            m_listTypeFlags.resize(m_numTypes,0);
+            m_listTypeStyles.resize(m_numTypes);
         }
 
+        // PostProcess
+        // * compiles the styles that were set into their
+        //   final tables; must be called once all styles
+        //   have been set
+        // * style pointers handed out after this are stable
+        //   for the lifetime of the RenderStyleConfig
         void PostProcess()
         {
             // use sparsely populated property lists
@@ -538,38 +514,38 @@ namespace osmsrender
             for(osmscout::TypeId i=0; i < m_numTypes; i++)
             {
                 // nodes
-                if(m_activeNodeTypes[i])   {
+                if(m_listTypeFlags[i] & TYPE_NODE)   {
                     m_nodeTypes.push_back(i);
                     m_typeSet.SetType(i);
                 }
 
                 // ways
-                if(m_activeWayTypes[i])   {
+                if(m_listTypeFlags[i] & TYPE_WAY)   {
                     m_wayTypes.push_back(i);
                     m_typeSet.SetType(i);
                 }
 
                 // areas
-                if(m_activeAreaTypes[i])   {
+                if(m_listTypeFlags[i] & TYPE_AREA)   {
                     m_areaTypes.push_back(i);
                     m_typeSet.SetType(i);
                 }
             }
 
             // generate font list
-            LabelStyle *labelStyle;
+            LabelStyle const *labelStyle;
 
-            // m_wayNameLabelRenderStyles
+            // way name labels
             for(size_t i=0; i < m_wayTypes.size(); i++)  {
-                labelStyle = m_wayNameLabelStyles[m_wayTypes[i]];
+                labelStyle = GetWayNameLabelStyle(m_wayTypes[i]);
 
                 if(!(labelStyle == NULL))
                 {   m_listFonts.push_back(labelStyle->GetFontFamily());   }
             }
 
-            // m_areaNameLabelRenderStyles
+            // area name labels
             for(size_t i=0; i < m_areaTypes.size(); i++)  {
-                labelStyle = m_areaNameLabelStyles[m_areaTypes[i]];
+                labelStyle = GetAreaNameLabelStyle(m_areaTypes[i]);
 
                 if(!(labelStyle == NULL))
                 {   m_listFonts.push_back(labelStyle->GetFontFamily());   }
@@ -581,18 +557,31 @@ namespace osmsrender
             m_listFonts.resize(it-m_listFonts.begin());
 
             // flip layer orders
-            int maxWayLayer = this->GetMaxWayLayer()+1;
-            for(size_t i=0; i < m_activeWayTypes.size(); i++)   {
-                if(m_activeWayTypes[i])   {
-                    m_wayLayers[i] = abs(m_wayLayers[i]-maxWayLayer);
-                }
+            unsigned int maxWayLayer = 0;
+            unsigned int maxAreaLayer = 0;
+            for(size_t i=0; i < m_listTypeStyles.size(); i++)   {
+                maxWayLayer = std::max(maxWayLayer,m_listTypeStyles[i].wayLayer);
+                maxAreaLayer = std::max(maxAreaLayer,m_listTypeStyles[i].areaLayer);
             }
-            int maxAreaLayer = this->GetMaxAreaLayer()+1;
-            for(size_t i=0; i < m_activeAreaTypes.size(); i++)   {
-                if(m_activeAreaTypes[i])   {
-                    m_areaLayers[i] = abs(m_areaLayers[i]-maxAreaLayer);
-                }
+
+            for(size_t i=0; i < m_listTypeStyles.size(); i++)   {
+                TypeStyle &typeStyle = m_listTypeStyles[i];
+                if(m_listTypeFlags[i] & TYPE_WAY)
+                {   typeStyle.wayLayer = maxWayLayer+1-typeStyle.wayLayer;   }
+
+                if(m_listTypeFlags[i] & TYPE_AREA)
+                {   typeStyle.areaLayer = maxAreaLayer+1-typeStyle.areaLayer;   }
+
+                m_maxWayLayer = std::max(m_maxWayLayer,size_t(typeStyle.wayLayer));
+                m_maxAreaLayer = std::max(m_maxAreaLayer,size_t(typeStyle.areaLayer));
             }
+
+            // the style lists don't change after
+            // this, so they're trimmed to size
+            m_listFillStyles.shrink_to_fit();
+            m_listSymbolStyles.shrink_to_fit();
+            m_listLineStyles.shrink_to_fit();
+            m_listLabelStyles.shrink_to_fit();
         }
 
 
@@ -632,44 +621,44 @@ namespace osmsrender
 
         // Set NODE info
         void SetNodeTypeActive(osmscout::TypeId nodeType)
-        {   m_activeNodeTypes[nodeType] = true;   }
+        {   m_listTypeFlags[nodeType] |= TYPE_NODE;   }
 
         void SetNodeFillStyle(osmscout::TypeId nodeType, FillStyle const &fillStyle)
-        {   m_nodeFillStyles[nodeType] = new FillStyle(fillStyle);   }
+        {   m_listTypeStyles[nodeType].nodeFill = addStyle(m_listFillStyles,fillStyle);   }
 
         void SetNodeSymbolStyle(osmscout::TypeId nodeType,SymbolStyle const &symbolStyle)
-        {   m_nodeSymbolStyles[nodeType] = new SymbolStyle(symbolStyle);   }
+        {   m_listTypeStyles[nodeType].nodeSymbol = addStyle(m_listSymbolStyles,symbolStyle);   }
 
         void SetNodeNameLabelStyle(osmscout::TypeId nodeType,LabelStyle const &labelStyle)
-        {   m_nodeNameLabelStyles[nodeType] = new LabelStyle(labelStyle);   }
+        {   m_listTypeStyles[nodeType].nodeLabel = addStyle(m_listLabelStyles,labelStyle);   }
 
 
         // Set WAY info
         void SetWayTypeActive(osmscout::TypeId wayType)
-        {   m_activeWayTypes[wayType] = true;   }
+        {   m_listTypeFlags[wayType] |= TYPE_WAY;   }
 
         void SetWayLayer(osmscout::TypeId wayType, size_t wayLayer)
-        {   m_wayLayers[wayType] = wayLayer;   }
+        {   m_listTypeStyles[wayType].wayLayer = wayLayer;   }
 
         void SetWayLineStyle(osmscout::TypeId wayType,LineStyle const &lineStyle)
-        {   m_wayLineStyles[wayType] = new LineStyle(lineStyle);   }
+        {   m_listTypeStyles[wayType].wayLine = addStyle(m_listLineStyles,lineStyle);   }
 
         void SetWayNameLabelStyle(osmscout::TypeId wayType,LabelStyle const &labelStyle)
-        {   m_wayNameLabelStyles[wayType] = new LabelStyle(labelStyle);   }
+        {   m_listTypeStyles[wayType].wayLabel = addStyle(m_listLabelStyles,labelStyle);   }
 
 
         // Set AREA info
         void SetAreaTypeActive(osmscout::TypeId areaType)
-        {   m_activeAreaTypes[areaType] = true;   }
+        {   m_listTypeFlags[areaType] |= TYPE_AREA;   }
 
         void SetAreaLayer(osmscout::TypeId areaType, size_t areaLayer)
-        {   m_areaLayers[areaType] = areaLayer;   }
+        {   m_listTypeStyles[areaType].areaLayer = areaLayer;   }
 
         void SetAreaFillStyle(osmscout::TypeId areaType, FillStyle const &fillStyle)
-        {   m_areaFillStyles[areaType] = new FillStyle(fillStyle);   }
+        {   m_listTypeStyles[areaType].areaFill = addStyle(m_listFillStyles,fillStyle);   }
 
         void SetAreaNameLabelStyle(osmscout::TypeId areaType, LabelStyle const &labelStyle)
-        {   m_areaNameLabelStyles[areaType] = new LabelStyle(labelStyle);   }
+        {   m_listTypeStyles[areaType].areaLabel = addStyle(m_listLabelStyles,labelStyle);   }
 
 
         // Get RendererStyleConfig parameters
@@ -703,9 +692,44 @@ namespace osmsrender
         void GetActiveTypes(osmscout::TypeSet &typeSet) const
         {   typeSet = m_typeSet;   }
 
+        // GetActiveTypeSet
+        // * the types that have style data, built
+        //   once by PostProcess
+        osmscout::TypeSet const & GetActiveTypeSet() const
+        {   return m_typeSet;   }
+
         void GetFontList(std::vector<std::string> &listFonts) const
         {   listFonts = m_listFonts;   }
 
+        // GetNumBytes
+        // * estimates the memory used by the style config
+        //   and all of its styles
+        size_t GetNumBytes() const
+        {
+            size_t numBytes = sizeof(RenderStyleConfig);
+            numBytes += (m_nodeTypes.capacity() +
+                         m_wayTypes.capacity() +
+                         m_areaTypes.capacity())*sizeof(osmscout::TypeId);
+
+            numBytes += m_listTypeFlags.capacity();
+            numBytes += m_listTypeStyles.capacity()*sizeof(TypeStyle);
+
+            numBytes += m_listFillStyles.capacity()*sizeof(FillStyle);
+            numBytes += m_listSymbolStyles.capacity()*sizeof(SymbolStyle);
+            numBytes += m_listLineStyles.capacity()*sizeof(LineStyle);
+            numBytes += m_listLabelStyles.capacity()*sizeof(LabelStyle);
+            for(size_t i=0; i < m_listLabelStyles.size(); i++)   {
+                numBytes += m_listLabelStyles[i].GetFontFamily().size() +
+                            m_listLabelStyles[i].GetLabelText().size();
+            }
+
+            numBytes += m_listFonts.capacity()*sizeof(std::string);
+            for(size_t i=0; i < m_listFonts.size(); i++)
+            {   numBytes += m_listFonts[i].capacity();   }
+
+            return numBytes;
+        }
+
 
         // Get PLANET info
         bool GetPlanetShowSurface() const
@@ -733,24 +757,45 @@ namespace osmsrender
         {   return m_planetBuildingEdgeColor;   }
 
 
+        // Get TYPE info
+        // GetTypeStyle
+        // * all of a type's style indices in one lookup;
+        //   types without style data get STYLE_NONE
+        TypeStyle const & GetTypeStyle(osmscout::TypeId type) const
+        {   return (type < m_numTypes) ? m_listTypeStyles[type] : m_noTypeStyle;   }
+
+        // style lookups by index (NULL for STYLE_NONE)
+        FillStyle const * GetFillStyle(unsigned int styleIdx) const
+        {   return getStyle(m_listFillStyles,styleIdx);   }
+
+        SymbolStyle const * GetSymbolStyle(unsigned int styleIdx) const
+        {   return getStyle(m_listSymbolStyles,styleIdx);   }
+
+        LineStyle const * GetLineStyle(unsigned int styleIdx) const
+        {   return getStyle(m_listLineStyles,styleIdx);   }
+
+        LabelStyle const * GetLabelStyle(unsigned int styleIdx) const
+        {   return getStyle(m_listLabelStyles,styleIdx);   }
+
+
         // Get NODE info
         void GetNodeTypes(std::vector<osmscout::TypeId> & nodeTypes) const
         {   nodeTypes = m_nodeTypes;   }
 
         bool GetNodeTypeIsValid(osmscout::TypeId nodeType) const
-        {   return (m_activeNodeTypes[nodeType] == true);   }
+        {   return (nodeType < m_numTypes) && (m_listTypeFlags[nodeType] & TYPE_NODE);   }
 
         unsigned int GetNodeTypesCount() const
         {   return m_nodeTypes.size();   }
 
-        FillStyle* GetNodeFillStyle(osmscout::TypeId nodeType) const
-        {   return (nodeType < m_numTypes) ? m_nodeFillStyles[nodeType] : NULL;   }
+        FillStyle const * GetNodeFillStyle(osmscout::TypeId nodeType) const
+        {   return GetFillStyle(GetTypeStyle(nodeType).nodeFill);   }
 
-        SymbolStyle* GetNodeSymbolStyle(osmscout::TypeId nodeType) const
-        {   return (nodeType < m_numTypes) ? m_nodeSymbolStyles[nodeType] : NULL;   }
+        SymbolStyle const * GetNodeSymbolStyle(osmscout::TypeId nodeType) const
+        {   return GetSymbolStyle(GetTypeStyle(nodeType).nodeSymbol);   }
 
-        LabelStyle*  GetNodeNameLabelStyle(osmscout::TypeId nodeType) const
-        {   return (nodeType < m_numTypes) ? m_nodeNameLabelStyles[nodeType] : NULL;   }
+        LabelStyle const * GetNodeNameLabelStyle(osmscout::TypeId nodeType) const
+        {   return GetLabelStyle(GetTypeStyle(nodeType).nodeLabel);   }
 
 
         // Get WAY info
@@ -758,28 +803,22 @@ namespace osmsrender
         {   wayTypes = m_wayTypes;   }
 
         bool GetWayTypeIsValid(osmscout::TypeId wayType) const
-        {   return (m_activeWayTypes[wayType] == true);   }
+        {   return (wayType < m_numTypes) && (m_listTypeFlags[wayType] & TYPE_WAY);   }
 
         unsigned int GetWayTypesCount() const
         {   return m_wayTypes.size();   }
 
         size_t GetWayLayer(osmscout::TypeId wayType) const
-        {   return m_wayLayers[wayType];   }
+        {   return GetTypeStyle(wayType).wayLayer;   }
 
         size_t GetMaxWayLayer() const
-        {
-            size_t maxWayLayer = 0;
-            for(int i=0; i < m_wayLayers.size(); i++)
-            {   maxWayLayer = std::max(maxWayLayer,m_wayLayers[i]);   }
+        {   return m_maxWayLayer;   }
 
-            return maxWayLayer;
-        }
+        LineStyle const * GetWayLineStyle(osmscout::TypeId wayType) const
+        {   return GetLineStyle(GetTypeStyle(wayType).wayLine);   }
 
-        LineStyle* GetWayLineStyle(osmscout::TypeId wayType) const
-        {   return (wayType < m_numTypes) ? m_wayLineStyles[wayType] : NULL;   }
-
-        LabelStyle* GetWayNameLabelStyle(osmscout::TypeId wayType) const
-        {   return (wayType < m_numTypes) ? m_wayNameLabelStyles[wayType] : NULL;   }
+        LabelStyle const * GetWayNameLabelStyle(osmscout::TypeId wayType) const
+        {   return GetLabelStyle(GetTypeStyle(wayType).wayLabel);   }
 
 
         // Get AREA info
@@ -787,30 +826,50 @@ namespace osmsrender
         {   areaTypes = m_areaTypes;   }
 
         bool GetAreaTypeIsValid(osmscout::TypeId areaType) const
-        {   return (m_activeAreaTypes[areaType] == true);   }
+        {   return (areaType < m_numTypes) && (m_listTypeFlags[areaType] & TYPE_AREA);   }
 
         unsigned int GetAreaTypesCount() const
         {   return m_areaTypes.size();   }
 
         size_t GetAreaLayer(osmscout::TypeId areaType) const
-        {   return m_areaLayers[areaType];   }
+        {   return GetTypeStyle(areaType).areaLayer;   }
 
         size_t GetMaxAreaLayer() const
-        {
-            size_t maxAreaLayer = 0;
-            for(int i=0; i < m_areaLayers.size(); i++)
-            {   maxAreaLayer = std::max(maxAreaLayer,m_areaLayers[i]);   }
+        {   return m_maxAreaLayer;   }
 
-            return maxAreaLayer;
-        }
-
-        FillStyle* GetAreaFillStyle(osmscout::TypeId areaType) const
-        {   return (areaType < m_numTypes) ? m_areaFillStyles[areaType] : NULL;   }
+        FillStyle const * GetAreaFillStyle(osmscout::TypeId areaType) const
+        {   return GetFillStyle(GetTypeStyle(areaType).areaFill);   }
 
-        LabelStyle* GetAreaNameLabelStyle(osmscout::TypeId areaType) const
-        {   return (areaType < m_numTypes) ? m_areaNameLabelStyles[areaType] : NULL;   }
+        LabelStyle const * GetAreaNameLabelStyle(osmscout::TypeId areaType) const
+        {   return GetLabelStyle(GetTypeStyle(areaType).areaLabel);   }
 
     private:
+        // type flags
+        enum
+        {
+            TYPE_NODE = 0x01,
+            TYPE_WAY  = 0x02,
+            TYPE_AREA = 0x04
+        };
+
+        // addStyle
+        // * adds a copy of style to listStyles and
+        //   returns its index
+        template <typename T>
+        static unsigned int addStyle(std::vector<T> &listStyles, T const &style)
+        {
+            listStyles.push_back(style);
+            return listStyles.size()-1;
+        }
+
+        template <typename T>
+        static T const * getStyle(std::vector<T> const &listStyles,
+                                  unsigned int styleIdx)
+        {
+            return (styleIdx == TypeStyle::STYLE_NONE) ?
+                        NULL : &(listStyles[styleIdx]);
+        }
+
         // PLANET
         bool                            m_planetShowSurface;
         bool                            m_planetShowCoastline;
@@ -830,32 +889,26 @@ namespace osmsrender
         // ALL
         osmscout::TypeSet               m_typeSet;
 
-        // NODES
+        // lists of active types
         std::vector<osmscout::TypeId>   m_nodeTypes;
-
-        // sparsely populated lists
-        std::vector<bool>               m_activeNodeTypes;
-        std::vector<FillStyle*>         m_nodeFillStyles;
-        std::vector<SymbolStyle*>       m_nodeSymbolStyles;
-        std::vector<LabelStyle*>        m_nodeNameLabelStyles;
-
-        // WAYS
         std::vector<osmscout::TypeId>   m_wayTypes;
-
-        // sparsely populated lists
-        std::vector<bool>               m_activeWayTypes;
-        std::vector<size_t>             m_wayLayers;
-        std::vector<LineStyle*>         m_wayLineStyles;
-        std::vector<LabelStyle*>        m_wayNameLabelStyles;
-
-        // AREAS
         std::vector<osmscout::TypeId>   m_areaTypes;
 
-        // sparsely populated lists
-        std::vector<bool>               m_activeAreaTypes;
-        std::vector<size_t>             m_areaLayers;
-        std::vector<FillStyle*>         m_areaFillStyles;
-        std::vector<LabelStyle*>        m_areaNameLabelStyles;
+        // per type tables (indexed by TypeId); the
+        // flags are kept apart from the styles so
+        // filtering by type stays in a few cache lines
+        std::vector<unsigned char>      m_listTypeFlags;
+        std::vector<TypeStyle>          m_listTypeStyles;
+        TypeStyle                       m_noTypeStyle;
+
+        // styles (TypeStyle indices point in here)
+        std::vector<FillStyle>          m_listFillStyles;
+        std::vector<SymbolStyle>        m_listSymbolStyles;
+        std::vector<LineStyle>          m_listLineStyles;
+        std::vector<LabelStyle>         m_listLabelStyles;
+
+        size_t                          m_maxWayLayer;
+        size_t                          m_maxAreaLayer;
 
         // FONTS
         std::vector<std::string>        m_listFonts;
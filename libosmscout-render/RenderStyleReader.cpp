@@ -45,7 +45,7 @@ RenderStyleReader::RenderStyleReader(std::string const &filePath,
     // [STYLECONFIGS]
     json_t * jStyleConfigs = json_object_get(jRoot,"STYLECONFIGS");
     if(json_array_size(jStyleConfigs) < 1)
-    {   OSRDEBUG << "ERROR: No STYLECONFIG objects found";   return;   }
+    {   OSRERROR << "No STYLECONFIG objects found";   return;   }
 
     for(size_t i=0; i < json_array_size(jStyleConfigs); i++)
     {
@@ -66,8 +66,8 @@ RenderStyleReader::RenderStyleReader(std::string const &filePath,
         // [NODES]
         json_t * jListNodes = json_object_get(jStyleConfig,"NODES");
         if(json_array_size(jListNodes) < 1)   {
-            OSRDEBUG << "WARN: No Node styles found in range: "
-                     << minDist << "-" << maxDist;
+            OSRWARN << "No Node styles found in range: "
+                   << minDist << "-" << maxDist;
         }
         for(size_t j=0; j < json_array_size(jListNodes); j++)
         {
@@ -76,14 +76,14 @@ RenderStyleReader::RenderStyleReader(std::string const &filePath,
             // [type]
             json_t * jNodeType = json_object_get(jNode,"type");
             if(json_string_value(jNodeType) == NULL)   {
-                OSRDEBUG << "ERROR: Missing Node Type " << j;
+                OSRERROR << "Missing Node Type " << j;
                 return;
             }
             std::string strTypeId(json_string_value(jNodeType));
             osmscout::TypeId nodeType = typeConfig->GetNodeTypeId(strTypeId);
             if(nodeType == osmscout::typeIgnore)   {
-                OSRDEBUG << "WARN: Unknown Node Type "
-                         << strTypeId << " (Ignoring)";
+                OSRWARN << "Unknown Node Type "
+                       << strTypeId << " (Ignoring)";
                 continue;
             }
 
@@ -114,8 +114,8 @@ RenderStyleReader::RenderStyleReader(std::string const &filePath,
         // [WAYS]
         json_t * jListWays = json_object_get(jStyleConfig,"WAYS");
         if(json_array_size(jListWays) < 1)   {
-            OSRDEBUG << "WARN: No Way styles found in range: "
-                     << minDist << "-" << maxDist;
+            OSRWARN << "No Way styles found in range: "
+                   << minDist << "-" << maxDist;
         }
         for(size_t j=0; j < json_array_size(jListWays); j++)
         {
@@ -124,14 +124,14 @@ RenderStyleReader::RenderStyleReader(std::string const &filePath,
             // [type]
             json_t * jWayType = json_object_get(jWay,"type");
             if(json_string_value(jWayType) == NULL)   {
-                OSRDEBUG << "ERROR: Missing Way type " << j;
+                OSRERROR << "Missing Way type " << j;
                 return;
             }
             std::string strTypeId(json_string_value(jWayType));
             osmscout::TypeId wayType = typeConfig->GetWayTypeId(strTypeId);
             if(wayType == osmscout::typeIgnore)   {
-                OSRDEBUG << "WARN: Unknown Way Type "
-                         << strTypeId << " (Ignoring)";
+                OSRWARN << "Unknown Way Type "
+                       << strTypeId << " (Ignoring)";
                 continue;
             }
 
@@ -139,9 +139,9 @@ RenderStyleReader::RenderStyleReader(std::string const &filePath,
             size_t wayLayer =0;
             json_t * jWayLayer = json_object_get(jWay,"layer");
             if(jWayLayer == NULL)
-            {   OSRDEBUG << "WARN: No layer specified (" << j << ")";   }
+            {   OSRWARN << "No layer specified (" << j << ")";   }
             else if(json_number_value(jWayLayer) < 0)
-            {   OSRDEBUG << "WARN: Invalid layer specified (" << j << ")";   }
+            {   OSRWARN << "Invalid layer specified (" << j << ")";   }
             else
             {   wayLayer = json_number_value(jWayLayer);   }
             myStyleConfig->SetWayLayer(wayType,wayLayer);
@@ -167,8 +167,8 @@ RenderStyleReader::RenderStyleReader(std::string const &filePath,
         // [AREAS]
         json_t * jListAreas = json_object_get(jStyleConfig,"AREAS");
         if(json_array_size(jListAreas) < 1)   {
-            OSRDEBUG << "WARN: No Area Styles found in range: "
-                     << minDist << "-" << maxDist;
+            OSRWARN << "No Area Styles found in range: "
+                   << minDist << "-" << maxDist;
         }
         for(size_t j=0; j < json_array_size(jListAreas); j++)
         {
@@ -177,14 +177,14 @@ RenderStyleReader::RenderStyleReader(std::string const &filePath,
             // [type]
             json_t * jAreaType = json_object_get(jArea,"type");
             if(json_string_value(jAreaType) == NULL)   {
-                OSRDEBUG << "ERROR: Missing Area type " << j;
+                OSRERROR << "Missing Area type " << j;
                 return;
             }
             std::string strTypeId(json_string_value(jAreaType));
             osmscout::TypeId areaType = typeConfig->GetAreaTypeId(strTypeId);
             if(areaType == osmscout::typeIgnore)   {
-                OSRDEBUG << "WARN: Unknown Area Type "
-                         << strTypeId << " (Ignoring)";
+                OSRWARN << "Unknown Area Type "
+                       << strTypeId << " (Ignoring)";
                 continue;
             }
 
@@ -192,9 +192,9 @@ RenderStyleReader::RenderStyleReader(std::string const &filePath,
             size_t areaLayer = 0;
             json_t * jAreaLayer = json_object_get(jArea,"layer");
             if(jAreaLayer == NULL)
-            {   OSRDEBUG << "WARN: No area layer specified (" << j << ")";   }
+            {   OSRWARN << "No area layer specified (" << j << ")";   }
             else if(json_number_value(jAreaLayer) < 0)
-            {   OSRDEBUG << "WARN: Invalid area layer specified(" << j << ")";   }
+            {   OSRWARN << "Invalid area layer specified(" << j << ")";   }
             else
             {   areaLayer = json_number_value(jAreaLayer);   }
             myStyleConfig->SetAreaLayer(areaType,areaLayer);
@@ -232,7 +232,7 @@ RenderStyleReader::RenderStyleReader(std::string const &filePath,
 
     json_t * jPlanetStyle = json_object_get(jRoot,"PLANET");
     if(jPlanetStyle == NULL)   {
-        OSRDEBUG << "WARN: No Planet Style specified";
+        OSRWARN << "No Planet Style specified";
     }
     else   {
         // [surfaceColor]
@@ -264,16 +264,16 @@ RenderStyleReader::RenderStyleReader(std::string const &filePath,
         }
 
         if(!showPlanetSurf)
-        {   OSRDEBUG << "WARN: -> (Planet Surface won't be rendered)";   }
+        {   OSRWARN << "-> (Planet Surface won't be rendered)";   }
 
         if(!showPlanetCoast)
-        {   OSRDEBUG << "WARN: -> (Planet Coastline won't be rendered)";   }
+        {   OSRWARN << "-> (Planet Coastline won't be rendered)";   }
 
         if(!showPlanetAdmin0)
-        {   OSRDEBUG << "WARN: -> (Planet Admin0 won't be rendered)";   }
+        {   OSRWARN << "-> (Planet Admin0 won't be rendered)";   }
 
         if(!showPlanetBuildingEdges)
-        {   OSRDEBUG << "WARN: -> (Building edges won't be rendered)";   }
+        {   OSRWARN << "-> (Building edges won't be rendered)";   }
     }
     // save planet style
     for(size_t j=0; j < listStyleConfigs.size(); j++)   {
@@ -291,10 +291,7 @@ RenderStyleReader::RenderStyleReader(std::string const &filePath,
 }
 
 void RenderStyleReader::GetDebugLog(std::vector<std::string> &listDebugMessages)
-{
-    for(int i=0; i < m_listMessages.size(); i++)
-    {   listDebugMessages.push_back(m_listMessages.at(i));   }
-}
+{   Logger::Get().GetMessages(this,listDebugMessages);   }
 
 bool RenderStyleReader::getMagRange(json_t *jsonMinMag,
                                     json_t *jsonMaxMag,
@@ -305,9 +302,9 @@ bool RenderStyleReader::getMagRange(json_t *jsonMinMag,
     double maxMagValue = json_number_value(jsonMaxMag);
 
     if(maxMagValue <= minMagValue)
-    {   OSRDEBUG << "ERROR: Max Distance <= Min Distance";   return false;   }
+    {   OSRERROR << "Max Distance <= Min Distance";   return false;   }
     else if((maxMagValue-minMagValue) < 50)
-    {   OSRDEBUG << "ERROR: Distance range < 50m";   return false;   }
+    {   OSRERROR << "Distance range < 50m";   return false;   }
     else   {
         minMag = minMagValue;
         maxMag = maxMagValue;
@@ -319,13 +316,13 @@ bool RenderStyleReader::getSymbolStyle(json_t *jsonSymbolStyle,
                                        SymbolStyle &symbolStyle)
 {
     if(jsonSymbolStyle == NULL)
-    {   OSRDEBUG << "ERROR: -> (SymbolStyle doesn't exist)";   return false;   }
+    {   OSRERROR << "-> (SymbolStyle doesn't exist)";   return false;   }
 
     // SymbolStyle.type
     SymbolStyleType symbolType;
     json_t * jsonSymbolType = json_object_get(jsonSymbolStyle,"type");
     if(json_string_value(jsonSymbolType) == NULL)
-    {   OSRDEBUG << "WARN: -> (Missing SymbolType type)";   }
+    {   OSRWARN << "-> (Missing SymbolType type)";   }
     else
     {
         std::string symbolTypeStr(json_string_value(jsonSymbolType));
@@ -341,7 +338,7 @@ bool RenderStyleReader::getSymbolStyle(json_t *jsonSymbolStyle,
         else if(symbolTypeStr.compare("circle") == 0)
         {   symbolType = SYMBOL_CIRCLE;   }
         else
-        {   OSRDEBUG << "WARN: -> (Invalid SymbolStyle type)";   }
+        {   OSRWARN << "-> (Invalid SymbolStyle type)";   }
 
         symbolStyle.SetSymbolType(symbolType);
     }
@@ -350,7 +347,7 @@ bool RenderStyleReader::getSymbolStyle(json_t *jsonSymbolStyle,
     json_t * jsonSymbolSize = json_object_get(jsonSymbolStyle,"size");
     double symbolSize = json_number_value(jsonSymbolSize);
     if(symbolSize <= 0)
-    {   OSRDEBUG << "WARN: -> (Invalid SymbolStyle size)";   }
+    {   OSRWARN << "-> (Invalid SymbolStyle size)";   }
     else
     {   symbolStyle.SetSymbolSize(symbolSize);   }
 
@@ -358,7 +355,7 @@ bool RenderStyleReader::getSymbolStyle(json_t *jsonSymbolStyle,
     json_t * jsonSymbolHeight = json_object_get(jsonSymbolStyle,"offsetHeight");
     double offsetHeight = json_number_value(jsonSymbolHeight);
     if(offsetHeight < 0)
-    {   OSRDEBUG << "WARN: -> (Invalid SymbolStyle offsetHeight)";   }
+    {   OSRWARN << "-> (Invalid SymbolStyle offsetHeight)";   }
     else
     {   symbolStyle.SetOffsetHeight(offsetHeight);   }
 
@@ -389,8 +386,8 @@ bool RenderStyleReader::getSymbolStyle(json_t *jsonSymbolStyle,
         {   labelPos = SYMBOL_TOPLEFT;   }
         else
         {
-            OSRDEBUG << "WARN: -> (Invalid SymbolStyle labelPos)";
-            OSRDEBUG << "WARN: -> (labelPos must be one of top,top_right,"
+            OSRWARN << "-> (Invalid SymbolStyle labelPos)";
+            OSRWARN << "-> (labelPos must be one of top,top_right,"
                         "right,btm_right,btm,btm_left,left,top_left)";
             labelPos = SYMBOL_TOP;
         }
@@ -406,18 +403,18 @@ bool RenderStyleReader::getFillStyle(json_t *jsonFillStyle,
                                      FillStyle &fillStyle)
 {
     if(jsonFillStyle == NULL)
-    {   OSRDEBUG << "ERROR: -> (FillStyle doesn't exist)";   return false;   }
+    {   OSRERROR << "-> (FillStyle doesn't exist)";   return false;   }
 
     // FillStyle.fillColors
     json_t * jsonFillColor = json_object_get(jsonFillStyle,"fillColor");
     if(json_string_value(jsonFillColor) == NULL)
-    {   OSRDEBUG << "WARN: -> (Missing fillColor value)";   }
+    {   OSRWARN << "-> (Missing fillColor value)";   }
     else
     {
         ColorRGBA fillColor;
         std::string strFillColor(json_string_value(jsonFillColor));
         if(!parseColorRGBA(strFillColor,fillColor))
-        {   OSRDEBUG << "WARN: -> (Could not parse fillColor string)";   }
+        {   OSRWARN << "-> (Could not parse fillColor string)";   }
         else
         {   fillStyle.SetFillColor(fillColor);   }
     }
@@ -426,7 +423,7 @@ bool RenderStyleReader::getFillStyle(json_t *jsonFillStyle,
     json_t * jsonOutlineWidth = json_object_get(jsonFillStyle,"outlineWidth");
     double outlineWidth = json_number_value(jsonOutlineWidth);
     if(outlineWidth < 0)
-    {   OSRDEBUG << "WARN: -> (Invalid outlineWidth value)";   }
+    {   OSRWARN << "-> (Invalid outlineWidth value)";   }
     else
     {
         fillStyle.SetOutlineWidth(outlineWidth);
@@ -436,13 +433,13 @@ bool RenderStyleReader::getFillStyle(json_t *jsonFillStyle,
         {
             json_t * jsonOutlineColor = json_object_get(jsonFillStyle,"outlineColor");
             if(json_string_value(jsonOutlineColor) == NULL)
-            {   OSRDEBUG << "WARN: -> (Missing outlineColor value)";   }
+            {   OSRWARN << "-> (Missing outlineColor value)";   }
             else
             {
                 ColorRGBA outlineColor;
                 std::string strOutlineColor(json_string_value(jsonOutlineColor));
                 if(!parseColorRGBA(strOutlineColor,outlineColor))
-                {   OSRDEBUG << "WARN: -> (Could not parse outlineColor string(";   }
+                {   OSRWARN << "-> (Could not parse outlineColor string(";   }
                 else
                 {   fillStyle.SetOutlineColor(outlineColor);   }
             }
@@ -459,26 +456,26 @@ bool RenderStyleReader::getLineStyle(json_t *jsonLineStyle,
                                      LineStyle &lineStyle)
 {
     if(jsonLineStyle == NULL)
-    {   OSRDEBUG << "ERROR: -> (LineStyle doesn't exist)";   return false;   }
+    {   OSRERROR << "-> (LineStyle doesn't exist)";   return false;   }
 
     // LineStyle.lineWidth
     json_t * jsonLineWidth = json_object_get(jsonLineStyle,"lineWidth");
     double lineWidth = json_number_value(jsonLineWidth);
     if(lineWidth <= 0)
-    {   OSRDEBUG << "WARN: -> (Invalid lineWidth value)";   }
+    {   OSRWARN << "-> (Invalid lineWidth value)";   }
     else
     {   lineStyle.SetLineWidth(lineWidth);   }
 
     // LineStyle.lineColor
     json_t * jsonLineColor = json_object_get(jsonLineStyle,"lineColor");
     if(json_string_value(jsonLineColor) == NULL)
-    {   OSRDEBUG << "WARN: -> (Missing lineColor value)";   }
+    {   OSRWARN << "-> (Missing lineColor value)";   }
     else
     {
         ColorRGBA lineColor;
         std::string strLineColor(json_string_value(jsonLineColor));
         if(!parseColorRGBA(strLineColor,lineColor))
-        {   OSRDEBUG << "WARN: -> (Could not parse lineColor string)";   }
+        {   OSRWARN << "-> (Could not parse lineColor string)";   }
         else
         {   lineStyle.SetLineColor(lineColor);   }
     }
@@ -487,7 +484,7 @@ bool RenderStyleReader::getLineStyle(json_t *jsonLineStyle,
     json_t * jsonOutlineWidth = json_object_get(jsonLineStyle,"outlineWidth");
     double outlineWidth = json_number_value(jsonOutlineWidth);
     if(outlineWidth < 0)
-    {   OSRDEBUG << "WARN: -> (Invalid outlineWidth value)";   }
+    {   OSRWARN << "-> (Invalid outlineWidth value)";   }
     else
     {
         lineStyle.SetOutlineWidth(outlineWidth);
@@ -497,13 +494,13 @@ bool RenderStyleReader::getLineStyle(json_t *jsonLineStyle,
         {
             json_t * jsonOutlineColor = json_object_get(jsonLineStyle,"outlineColor");
             if(json_string_value(jsonOutlineColor) == NULL)
-            {   OSRDEBUG << "WARN: -> (Missing outlineColor value)";   }
+            {   OSRWARN << "-> (Missing outlineColor value)";   }
             else
             {
                 ColorRGBA outlineColor;
                 std::string strOutlineColor(json_string_value(jsonOutlineColor));
                 if(!parseColorRGBA(strOutlineColor,outlineColor))
-                {   OSRDEBUG << "WARN: -> (Could not parse outlineColor)";   }
+                {   OSRWARN << "-> (Could not parse outlineColor)";   }
                 else
                 {   lineStyle.SetOutlineColor(outlineColor);   }
             }
@@ -514,7 +511,7 @@ bool RenderStyleReader::getLineStyle(json_t *jsonLineStyle,
     json_t * jsonSymbolWidth = json_object_get(jsonLineStyle,"symbolWidth");
     double symbolWidth = json_number_value(jsonSymbolWidth);
     if(symbolWidth < 0)
-    {   OSRDEBUG << "WARN: -> (Invalid symbolWidth value)";   }
+    {   OSRWARN << "-> (Invalid symbolWidth value)";   }
     else
     {
         lineStyle.SetSymbolWidth(symbolWidth);
@@ -524,13 +521,13 @@ bool RenderStyleReader::getLineStyle(json_t *jsonLineStyle,
         {
             json_t * jsonSymbolColor = json_object_get(jsonLineStyle,"symbolColor");
             if(json_string_value(jsonSymbolColor) == NULL)
-            {   OSRDEBUG << "WARN: -> (Missing symbolColor value)";   }
+            {   OSRWARN << "-> (Missing symbolColor value)";   }
             else
             {
                 ColorRGBA symbolColor;
                 std::string strSymbolColor(json_string_value(jsonSymbolColor));
                 if(!parseColorRGBA(strSymbolColor,symbolColor))
-                {   OSRDEBUG << "WARN: -> (Could not parse symbolColor";   }
+                {   OSRWARN << "-> (Could not parse symbolColor";   }
                 else
                 {   lineStyle.SetSymbolColor(symbolColor);   }
             }
@@ -541,7 +538,7 @@ bool RenderStyleReader::getLineStyle(json_t *jsonLineStyle,
     json_t * jsonSymbolSpacing = json_object_get(jsonLineStyle,"symbolSpacing");
     double symbolSpacing = json_number_value(jsonSymbolSpacing);
     if(symbolSpacing < 0)
-    {   OSRDEBUG << "WARN: -> (Invalid symbolSpacing value)";   }
+    {   OSRWARN << "-> (Invalid symbolSpacing value)";   }
     else
     {   lineStyle.SetSymbolSpacing(symbolSpacing);   }
 
@@ -550,7 +547,7 @@ bool RenderStyleReader::getLineStyle(json_t *jsonLineStyle,
     json_t * jsonDashSpacing = json_object_get(jsonLineStyle,"dashSpacing");
     double dashSpacing = json_number_value(jsonDashSpacing);
     if(dashSpacing < 0)
-    {   OSRDEBUG << "WARN: -> (Invalid dashSpacing value)";   }
+    {   OSRWARN << "-> (Invalid dashSpacing value)";   }
     else
     {
         lineStyle.SetDashSpacing(dashSpacing);
@@ -559,13 +556,13 @@ bool RenderStyleReader::getLineStyle(json_t *jsonLineStyle,
         {
             json_t * jsonDashColor = json_object_get(jsonLineStyle,"dashColor");
             if(json_string_value(jsonDashColor) == NULL)
-            {   OSRDEBUG << "WARN: -> (Missing dashColor value)";   }
+            {   OSRWARN << "-> (Missing dashColor value)";   }
             else
             {
                 ColorRGBA dashColor;
                 std::string strDashColor(json_string_value(jsonDashColor));
                 if(!parseColorRGBA(strDashColor,dashColor))
-                {   OSRDEBUG << "WARN: -> (Could not parse dashColor";   }
+                {   OSRWARN << "-> (Could not parse dashColor";   }
                 else
                 {   lineStyle.SetDashColor(dashColor);   }
             }
@@ -585,25 +582,25 @@ bool RenderStyleReader::getLabelStyle(json_t *jsonLabelStyle,
                                       LabelStyle &labelStyle)
 {
     if(jsonLabelStyle == NULL)
-    {   OSRDEBUG << "ERROR: -> (LabelStyle doesn't exist)";   return false;   }
+    {   OSRERROR << "-> (LabelStyle doesn't exist)";   return false;   }
 
     // LabelStyle.fontFamily (must be explicitly specified)
     json_t * jsonFontFamily = json_object_get(jsonLabelStyle,"fontFamily");
     if(json_string_value(jsonFontFamily) == NULL)
-    {   OSRDEBUG << "ERROR: -> (Missing fontFamily)";   return false;   }
+    {   OSRERROR << "-> (Missing fontFamily)";   return false;   }
     std::string fontFamily(json_string_value(jsonFontFamily));
     labelStyle.SetFontFamily(fontFamily);
 
     // LabelStyle.fontColor
     json_t * jsonFontColor = json_object_get(jsonLabelStyle,"fontColor");
     if(json_string_value(jsonFontColor) == NULL)
-    {   OSRDEBUG << "WARN: -> (Missing fontColor)";   }
+    {   OSRWARN << "-> (Missing fontColor)";   }
     else
     {
         ColorRGBA fontColor;
         std::string strFontColor(json_string_value(jsonFontColor));
         if(!parseColorRGBA(strFontColor,fontColor))
-        {   OSRDEBUG << "WARN: -> (Could not parse fontColor)";   }
+        {   OSRWARN << "-> (Could not parse fontColor)";   }
         else
         {   labelStyle.SetFontColor(fontColor);   }
     }
@@ -612,7 +609,7 @@ bool RenderStyleReader::getLabelStyle(json_t *jsonLabelStyle,
     json_t * jsonFontSize = json_object_get(jsonLabelStyle,"fontSize");
     double fontSize = json_number_value(jsonFontSize);
     if(fontSize <= 0)
-    {   OSRDEBUG << "WARN: -> (Invalid fontSize)";   }
+    {   OSRWARN << "-> (Invalid fontSize)";   }
     else
     {   labelStyle.SetFontSize(fontSize);   }
 
@@ -648,7 +645,7 @@ bool RenderStyleReader::getLabelStyle(json_t *jsonLabelStyle,
         json_t * jsonContourPadding = json_object_get(jsonLabelStyle,"contourPadding");
         double contourPadding = json_number_value(jsonContourPadding);
         if(contourPadding <= 0)
-        {   OSRDEBUG << "WARN: -> (Invalid contourPadding)";   }
+        {   OSRWARN << "-> (Invalid contourPadding)";   }
         else
         {   labelStyle.SetContourPadding(contourPadding);   }
     }
@@ -659,7 +656,7 @@ bool RenderStyleReader::getLabelStyle(json_t *jsonLabelStyle,
         json_t * jsonOffsetDist = json_object_get(jsonLabelStyle,"offsetDist");
         double offsetDist = json_number_value(jsonOffsetDist);
         if(offsetDist < 0)
-        {   OSRDEBUG << "WARN: -> (Invalid offsetDist)";   }
+        {   OSRWARN << "-> (Invalid offsetDist)";   }
         else
         {   labelStyle.SetOffsetDist(offsetDist);   }
     }
@@ -670,7 +667,7 @@ bool RenderStyleReader::getLabelStyle(json_t *jsonLabelStyle,
         json_t * jsonMaxWidth = json_object_get(jsonLabelStyle,"maxWidth");
         double maxWidth = json_number_value(jsonMaxWidth);
         if(maxWidth < 0)
-        {   OSRDEBUG << "WARN: -> (Invalid maxWidth)";   }
+        {   OSRWARN << "-> (Invalid maxWidth)";   }
         else
         {   labelStyle.SetMaxWidth(maxWidth);   }
     }
@@ -681,7 +678,7 @@ bool RenderStyleReader::getLabelStyle(json_t *jsonLabelStyle,
         json_t * jsonWayPointDist = json_object_get(jsonLabelStyle,"wayPointDist");
         double wayPointDist = json_number_value(jsonWayPointDist);
         if(wayPointDist < 0)
-        {   OSRDEBUG << "WARN: -> (Invalid wayPointDist)";   }
+        {   OSRWARN << "-> (Invalid wayPointDist)";   }
         else
         {   labelStyle.SetWayPointDist(wayPointDist);   }
     }
@@ -692,19 +689,19 @@ bool RenderStyleReader::getLabelStyle(json_t *jsonLabelStyle,
         json_t *jsonPlatePadding = json_object_get(jsonLabelStyle,"platePadding");
         double platePadding = json_number_value(jsonPlatePadding);
         if(platePadding < 0)
-        {   OSRDEBUG << "WARN: -> (Invalid platePadding)";   }
+        {   OSRWARN << "-> (Invalid platePadding)";   }
         else
         {   labelStyle.SetPlatePadding(platePadding);   }
 
         // LabelStyle.plateColor
         json_t * jsonPlateColor = json_object_get(jsonLabelStyle,"plateColor");
         if(json_string_value(jsonPlateColor) == NULL)
-        {   OSRDEBUG << "WARN: -> (Invalid plateColor)";   }
+        {   OSRWARN << "-> (Invalid plateColor)";   }
         else
         {   ColorRGBA plateColor;
             std::string strPlateColor(json_string_value(jsonPlateColor));
             if(!parseColorRGBA(strPlateColor,plateColor))
-            {   OSRDEBUG << "WARN: -> (Could not parse plateColor)";   }
+            {   OSRWARN << "-> (Could not parse plateColor)";   }
             else
             {   labelStyle.SetPlateColor(plateColor);   }
         }
@@ -713,7 +710,7 @@ bool RenderStyleReader::getLabelStyle(json_t *jsonLabelStyle,
         json_t *jsonPlateOutlineWidth = json_object_get(jsonLabelStyle,"plateOutlineWidth");
         double plateOutlineWidth = json_number_value(jsonPlateOutlineWidth);
         if(plateOutlineWidth < 0)
-        {   OSRDEBUG << "WARN: -> (Invalid plateOutlineWidth)";   }
+        {   OSRWARN << "-> (Invalid plateOutlineWidth)";   }
         else
         {
             labelStyle.SetPlateOutlineWidth(plateOutlineWidth);
@@ -723,13 +720,13 @@ bool RenderStyleReader::getLabelStyle(json_t *jsonLabelStyle,
             {
                 json_t * jsonPlateOutlineColor = json_object_get(jsonLabelStyle,"plateOutlineColor");
                 if(json_string_value(jsonPlateOutlineColor) == NULL)
-                {   OSRDEBUG << "WARN: -> (Invalid plateOutlineColor)";   }
+                {   OSRWARN << "-> (Invalid plateOutlineColor)";   }
                 else
                 {
                     ColorRGBA plateOutlineColor;
                     std::string strPlateOutlineColor(json_string_value(jsonPlateOutlineColor));
                     if(!parseColorRGBA(strPlateOutlineColor,plateOutlineColor))
-                    {   OSRDEBUG << "WARN: -> (Could not parse plateOutlineColor)";   }
+                    {   OSRWARN << "-> (Could not parse plateOutlineColor)";   }
                     else
                     {   labelStyle.SetPlateOutlineColor(plateOutlineColor);   }
                 }
@@ -787,9 +784,9 @@ void RenderStyleReader::logJsonError()
     std::string errorText(m_jsonError.text);
     std::string errorLine(convIntToString(m_jsonError.line));
     std::string errorPos(convIntToString(m_jsonError.position));
-    OSRDEBUG << "ERROR: Parsing JSON: Text: " << errorText;
-    OSRDEBUG << "ERROR: Parsing JSON: Line: " << errorLine;
-    OSRDEBUG << "ERROR: Parsing JSON: Pos: "  <<errorPos;
+    OSRERROR << "Parsing JSON: Text: " << errorText;
+    OSRERROR << "Parsing JSON: Line: " << errorLine;
+    OSRERROR << "Parsing JSON: Pos: "  <<errorPos;
 }
 
 std::string RenderStyleReader::convIntToString(int myInt)
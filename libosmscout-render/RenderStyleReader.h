@@ -14,7 +14,7 @@
 #include <osmscout/TypeConfig.h>
 
 // osmscout-render includes
-#include "SimpleLogger.hpp"
+#include "Logger.hpp"
 #include "RenderStyleConfig.hpp"
 
 namespace osmsrender
@@ -55,7 +55,6 @@ private:
 
     bool m_hasErrors;
     json_error_t m_jsonError;
-    std::vector<std::string> m_listMessages;
 
     unsigned int m_cLineStyleId;
     unsigned int m_cFillStyleId;
@@ -0,0 +1,251 @@
+/*
+    libosmscout-render
+
+    Copyright (C) 2012, Preet Desai
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef OSMSCOUTRENDER_SCRATCHARENA_HPP
+#define OSMSCOUTRENDER_SCRATCHARENA_HPP
+
+#include <vector>
+#include <atomic>
+#include <cstddef>
+
+namespace osmsrender
+{
+    // ScratchArenaStats
+    // * numTakes counts temporary lists taken from the
+    //   arena, each of which would otherwise have been a
+    //   new std::vector with at least one allocation
+    // * numAllocs counts lists that had to allocate (a new
+    //   list or one that grew past its old capacity)
+    // * numBytes is the capacity held by the arena's lists
+    struct ScratchArenaStats
+    {
+        ScratchArenaStats() :
+            numTakes(0),numAllocs(0),numBytes(0)
+        {}
+
+        void Add(ScratchArenaStats const &other)
+        {
+            numTakes += other.numTakes;
+            numAllocs += other.numAllocs;
+            numBytes += other.numBytes;
+        }
+
+        size_t numTakes;
+        size_t numAllocs;
+        size_t numBytes;
+    };
+
+    // a set of reusable std::vectors for temporary
+    // lists used while building and applying updates
+
+    // lists are taken within a ScratchScope and given back
+    // (cleared, but keeping their capacity) when the scope
+    // ends, in the reverse order they were taken; once the
+    // arena has warmed up, taking a list doesn't allocate
+
+    // Reset is called once per update cycle; it clears the
+    // stats and frees lists that grew beyond maxListBytes so
+    // a single large object doesn't pin memory indefinitely
+
+    // an arena must only be used by one thread at a time
+
+    class ScratchArena
+    {
+    public:
+        ScratchArena(size_t maxListBytes=256*1024) :
+            m_maxListBytes(maxListBytes)
+        {}
+
+        ~ScratchArena()
+        {
+            for(size_t i=0; i < m_listPools.size(); i++)
+            {   delete m_listPools[i];   }
+        }
+
+        // Take
+        // * returns an empty list that stays valid
+        //   until the enclosing ScratchScope ends
+        template <typename T>
+        std::vector<T> & Take()
+        {
+            size_t poolIdx = getPoolIdx<T>();
+            if(poolIdx >= m_listPools.size())   {
+                m_listPools.resize(poolIdx+1,NULL);
+            }
+            if(m_listPools[poolIdx] == NULL)   {
+                m_listPools[poolIdx] = new Pool<T>;
+            }
+
+            Pool<T> * pool = static_cast<Pool<T>*>(m_listPools[poolIdx]);
+            if(pool->numUsed == pool->listLists.size())   {
+                pool->listLists.push_back(new std::vector<T>);
+                pool->listCapacities.push_back(0);
+                m_stats.numAllocs++;
+            }
+
+            std::vector<T> * list = pool->listLists[pool->numUsed];
+            pool->listCapacities[pool->numUsed] = list->capacity();
+            pool->numUsed++;
+
+            m_listTaken.push_back(poolIdx);
+            m_stats.numTakes++;
+            return *list;
+        }
+
+        // Reset
+        // * clears the stats and trims lists that grew
+        //   too large; no lists may be taken
+        void Reset()
+        {
+            for(size_t i=0; i < m_listPools.size(); i++)   {
+                if(m_listPools[i])
+                {   m_listPools[i]->Trim(m_maxListBytes);   }
+            }
+            m_stats = ScratchArenaStats();
+        }
+
+        ScratchArenaStats GetStats() const
+        {
+            ScratchArenaStats stats = m_stats;
+            for(size_t i=0; i < m_listPools.size(); i++)   {
+                if(m_listPools[i])
+                {   stats.numBytes += m_listPools[i]->CalcNumBytes();   }
+            }
+            return stats;
+        }
+
+    private:
+        friend class ScratchScope;
+
+        ScratchArena(ScratchArena const &);
+        ScratchArena & operator = (ScratchArena const &);
+
+        struct PoolBase
+        {
+            PoolBase() : numUsed(0) {}
+            virtual ~PoolBase() {}
+
+            // GiveBack
+            // * returns the most recently taken list
+            virtual bool GiveBack() = 0;
+
+            virtual void Trim(size_t maxListBytes) = 0;
+            virtual size_t CalcNumBytes() const = 0;
+
+            size_t numUsed;
+        };
+
+        template <typename T>
+        struct Pool : public PoolBase
+        {
+            ~Pool()
+            {
+                for(size_t i=0; i < listLists.size(); i++)
+                {   delete listLists[i];   }
+            }
+
+            bool GiveBack()
+            {
+                numUsed--;
+                std::vector<T> * list = listLists[numUsed];
+                list->clear();
+                return (list->capacity() > listCapacities[numUsed]);
+            }
+
+            void Trim(size_t maxListBytes)
+            {
+                for(size_t i=0; i < listLists.size(); i++)   {
+                    if(listLists[i]->capacity()*sizeof(T) > maxListBytes)
+                    {   std::vector<T>().swap(*(listLists[i]));   }
+                }
+            }
+
+            size_t CalcNumBytes() const
+            {
+                size_t numBytes=0;
+                for(size_t i=0; i < listLists.size(); i++)
+                {   numBytes += listLists[i]->capacity()*sizeof(T);   }
+                return numBytes;
+            }
+
+            // lists are allocated separately so references
+            // to them stay valid as the pool grows
+            std::vector<std::vector<T>*>    listLists;
+            std::vector<size_t>             listCapacities;
+        };
+
+        // getPoolIdx
+        // * each list type gets its own pool index,
+        //   shared by every arena
+        template <typename T>
+        static size_t getPoolIdx()
+        {
+            static size_t const poolIdx = newPoolIdx();
+            return poolIdx;
+        }
+
+        static size_t newPoolIdx()
+        {
+            static std::atomic<size_t> nextPoolIdx(0);
+            return nextPoolIdx++;
+        }
+
+        // rewind
+        // * gives back lists until numTaken are left
+        void rewind(size_t numTaken)
+        {
+            while(m_listTaken.size() > numTaken)   {
+                if(m_listPools[m_listTaken.back()]->GiveBack())
+                {   m_stats.numAllocs++;   }
+
+                m_listTaken.pop_back();
+            }
+        }
+
+        size_t                      m_maxListBytes;
+        std::vector<PoolBase*>      m_listPools;
+        std::vector<size_t>         m_listTaken;
+        ScratchArenaStats           m_stats;
+    };
+
+    // ScratchScope
+    // * gives back every list taken from the
+    //   arena since the scope was created
+    class ScratchScope
+    {
+    public:
+        ScratchScope(ScratchArena &arena) :
+            m_arena(arena),
+            m_numTaken(arena.m_listTaken.size())
+        {}
+
+        ~ScratchScope()
+        {   m_arena.rewind(m_numTaken);   }
+
+    private:
+        ScratchScope(ScratchScope const &);
+        ScratchScope & operator = (ScratchScope const &);
+
+        ScratchArena &  m_arena;
+        size_t          m_numTaken;
+    };
+}
+
+#endif
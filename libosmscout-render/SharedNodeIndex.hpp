@@ -0,0 +1,366 @@
+/*
+    libosmscout-render
+
+    Copyright (C) 2012, Preet Desai
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef OSMSCOUTRENDER_SHAREDNODEINDEX_HPP
+#define OSMSCOUTRENDER_SHAREDNODEINDEX_HPP
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+#include <osmscout/Way.h>
+
+#include "IdMap.hpp"
+
+namespace osmsrender
+{
+    // WayXSec
+    // * another way that shares the node at
+    //   nodeIdx in a way (an intersection)
+    struct WayXSec
+    {
+        WayXSec() :
+            nodeIdx(0),wayId(0)
+        {}
+
+        WayXSec(size_t myNodeIdx, osmscout::Id myWayId) :
+            nodeIdx(myNodeIdx),wayId(myWayId)
+        {}
+
+        size_t nodeIdx;
+        osmscout::Id wayId;
+    };
+
+    // SharedNodeIndex
+    // * maps node ids to the ids of the ways that use them
+    //   in compressed sparse row form: a sorted list of node
+    //   ids, and for each node an offset into a single list
+    //   of way ids (sorted by id within each node)
+    // * lookups are a binary search and a contiguous range,
+    //   and the index takes 12 bytes per node plus 8 bytes
+    //   per way that uses it, without any per-entry heap
+    //   allocations
+
+    // ways are added and removed in batches; AddWay and
+    // RemoveWay only record changes and Update merges them
+    // into the index in a single pass, so the cost of an
+    // update is one sort of the added nodes plus one copy
+    // of the index
+
+    // removes are applied before adds, so a way that's
+    // removed and added again before Update stays in the
+    // index; adding a way that's already in the index
+    // doesn't duplicate it
+
+    class SharedNodeIndex
+    {
+    public:
+        SharedNodeIndex()
+        {   Clear();   }
+
+        void Clear()
+        {
+            m_listNodeIds.clear();
+            m_listOffsets.assign(1,0);
+            m_listWayIds.clear();
+            m_listPendingAdds.clear();
+            m_setPendingRemoves.clear();
+        }
+
+        size_t GetNumNodes() const
+        {   return m_listNodeIds.size();   }
+
+        size_t GetNumEntries() const
+        {   return m_listWayIds.size();   }
+
+        size_t GetNumBytes() const
+        {
+            return m_listNodeIds.capacity()*sizeof(osmscout::Id) +
+                   m_listOffsets.capacity()*sizeof(uint32_t) +
+                   m_listWayIds.capacity()*sizeof(osmscout::Id) +
+                   m_listPendingAdds.capacity()*sizeof(NodeWay);
+        }
+
+        // AddWay
+        // * queues every node in listNodes as used by wayId
+        void AddWay(osmscout::Id wayId,
+                    std::vector<osmscout::Point> const &listNodes)
+        {
+            for(size_t i=0; i < listNodes.size(); i++)   {
+                m_listPendingAdds.push_back(
+                    NodeWay(listNodes[i].GetId(),wayId));
+            }
+        }
+
+        // RemoveWay
+        // * queues wayId's removal from every node
+        void RemoveWay(osmscout::Id wayId)
+        {   m_setPendingRemoves.insert(wayId);   }
+
+        // Update
+        // * applies queued adds and removes
+        void Update()
+        {
+            if(m_listPendingAdds.empty() && m_setPendingRemoves.empty())
+            {   return;   }
+
+            sortPendingAdds();
+
+            std::vector<osmscout::Id> listNodeIds;
+            std::vector<uint32_t> listOffsets;
+            std::vector<osmscout::Id> listWayIds;
+            listNodeIds.reserve(m_listNodeIds.size()+m_listPendingAdds.size());
+            listOffsets.reserve(m_listOffsets.size()+m_listPendingAdds.size());
+            listWayIds.reserve(m_listWayIds.size()+m_listPendingAdds.size());
+            listOffsets.push_back(0);
+
+            // merge the existing nodes with the (sorted)
+            // queued adds, node by node
+            size_t n=0;
+            size_t a=0;
+            while(n < m_listNodeIds.size() || a < m_listPendingAdds.size())
+            {
+                osmscout::Id nodeId;
+                if(a == m_listPendingAdds.size() ||
+                   (n < m_listNodeIds.size() &&
+                    m_listNodeIds[n] <= m_listPendingAdds[a].nodeId))
+                {   nodeId = m_listNodeIds[n];   }
+                else
+                {   nodeId = m_listPendingAdds[a].nodeId;   }
+
+                // existing ways for the node, less removes
+                size_t w=0; size_t wEnd=0;
+                if(n < m_listNodeIds.size() && m_listNodeIds[n] == nodeId)   {
+                    w = m_listOffsets[n];
+                    wEnd = m_listOffsets[n+1];
+                    n++;
+                }
+
+                size_t numWays = listWayIds.size();
+                while(w < wEnd || (a < m_listPendingAdds.size() &&
+                                   m_listPendingAdds[a].nodeId == nodeId))
+                {
+                    osmscout::Id wayId;
+                    if(w < wEnd &&
+                       (a == m_listPendingAdds.size() ||
+                        m_listPendingAdds[a].nodeId != nodeId ||
+                        m_listWayIds[w] <= m_listPendingAdds[a].wayId))
+                    {
+                        wayId = m_listWayIds[w];
+                        w++;
+                        if(m_setPendingRemoves.count(wayId) != 0)
+                        {   continue;   }
+                    }
+                    else
+                    {
+                        wayId = m_listPendingAdds[a].wayId;
+                        a++;
+                    }
+
+                    if(listWayIds.size() == numWays ||
+                       listWayIds.back() != wayId)
+                    {   listWayIds.push_back(wayId);   }
+                }
+
+                if(listWayIds.size() > numWays)   {
+                    listNodeIds.push_back(nodeId);
+                    listOffsets.push_back(uint32_t(listWayIds.size()));
+                }
+            }
+
+            m_listNodeIds.swap(listNodeIds);
+            m_listOffsets.swap(listOffsets);
+            m_listWayIds.swap(listWayIds);
+            m_listPendingAdds.clear();
+            m_setPendingRemoves.clear();
+        }
+
+        // FindNode
+        // * gets the range [begin,end) of the ways that use
+        //   nodeId (see GetWayId); returns false if there
+        //   aren't any
+        bool FindNode(osmscout::Id nodeId,
+                      size_t &begin, size_t &end) const
+        {
+            size_t idx = findNodeIdx(nodeId,m_listNodeIds.size()/2);
+            if(idx == m_listNodeIds.size())
+            {   return false;   }
+
+            begin = m_listOffsets[idx];
+            end = m_listOffsets[idx+1];
+            return true;
+        }
+
+        osmscout::Id GetWayId(size_t idx) const
+        {   return m_listWayIds[idx];   }
+
+        // GetIntersections
+        // * sets listXSecs to every other way that shares
+        //   a node in listNodes with wayId, in node order
+        void GetIntersections(osmscout::Id wayId,
+                              std::vector<osmscout::Point> const &listNodes,
+                              std::vector<WayXSec> &listXSecs) const
+        {
+            listXSecs.clear();
+
+            // consecutive nodes in a way usually have
+            // nearby ids, so each search starts from
+            // where the last one ended
+            size_t hint = m_listNodeIds.size()/2;
+            for(size_t i=0; i < listNodes.size(); i++)
+            {
+                size_t idx = findNodeIdx(listNodes[i].GetId(),hint);
+                if(idx == m_listNodeIds.size())
+                {   continue;   }
+
+                hint = idx;
+                size_t begin = m_listOffsets[idx];
+                size_t end = m_listOffsets[idx+1];
+                for(size_t k=begin; k < end; k++)   {
+                    if(m_listWayIds[k] != wayId)
+                    {   listXSecs.push_back(WayXSec(i,m_listWayIds[k]));   }
+                }
+            }
+        }
+
+    private:
+        struct NodeWay
+        {
+            NodeWay(osmscout::Id myNodeId, osmscout::Id myWayId) :
+                nodeId(myNodeId),wayId(myWayId)
+            {}
+
+            bool operator < (NodeWay const &other) const
+            {
+                return (nodeId < other.nodeId) ||
+                       (nodeId == other.nodeId && wayId < other.wayId);
+            }
+
+            osmscout::Id nodeId;
+            osmscout::Id wayId;
+        };
+
+        // findNodeIdx
+        // * returns the index of nodeId in m_listNodeIds
+        //   or m_listNodeIds.size() if it isn't there
+        // * gallops out from hint to bound the binary
+        //   search, so nearby ids are found quickly
+        size_t findNodeIdx(osmscout::Id nodeId, size_t hint) const
+        {
+            size_t numNodes = m_listNodeIds.size();
+            if(numNodes == 0)
+            {   return numNodes;   }
+
+            if(hint >= numNodes)
+            {   hint = numNodes-1;   }
+
+            // nodeId is in [lo,hi) if it's in the list
+            size_t lo,hi;
+            if(m_listNodeIds[hint] < nodeId)   {
+                lo = hint+1;
+                hi = numNodes;
+                for(size_t step=1; hint+step < numNodes; step*=2)   {
+                    if(m_listNodeIds[hint+step] >= nodeId)
+                    {   hi = hint+step+1;   break;   }
+
+                    lo = hint+step+1;
+                }
+            }
+            else   {
+                lo = 0;
+                hi = hint+1;
+                for(size_t step=1; step <= hint; step*=2)   {
+                    if(m_listNodeIds[hint-step] < nodeId)
+                    {   lo = hint-step+1;   break;   }
+
+                    hi = hint-step+1;
+                }
+            }
+
+            std::vector<osmscout::Id>::const_iterator it =
+                    std::lower_bound(m_listNodeIds.begin()+lo,
+                                     m_listNodeIds.begin()+hi,nodeId);
+
+            if(it == m_listNodeIds.begin()+hi || *it != nodeId)
+            {   return numNodes;   }
+
+            return (it-m_listNodeIds.begin());
+        }
+
+        // sortPendingAdds
+        // * sorts queued adds by node id and then way id
+        // * a full scene adds every node of every way at
+        //   once, so this is a (stable) LSD radix sort on
+        //   the node id bytes that are in use, followed by
+        //   sorting the short run of ways for each node
+        void sortPendingAdds()
+        {
+            size_t numAdds = m_listPendingAdds.size();
+            if(numAdds < 256)   {
+                std::sort(m_listPendingAdds.begin(),m_listPendingAdds.end());
+                return;
+            }
+
+            osmscout::Id maxNodeId = 0;
+            for(size_t i=0; i < numAdds; i++)
+            {   maxNodeId = std::max(maxNodeId,m_listPendingAdds[i].nodeId);   }
+
+            std::vector<NodeWay> listSorted(numAdds,NodeWay(0,0));
+            for(size_t shift=0; shift < 64 && (maxNodeId >> shift) != 0; shift+=8)
+            {
+                size_t listCounts[257] = {0};
+                for(size_t i=0; i < numAdds; i++)
+                {   listCounts[((m_listPendingAdds[i].nodeId >> shift) & 0xFF)+1]++;   }
+
+                for(size_t b=1; b < 257; b++)
+                {   listCounts[b] += listCounts[b-1];   }
+
+                for(size_t i=0; i < numAdds; i++)   {
+                    size_t b = (m_listPendingAdds[i].nodeId >> shift) & 0xFF;
+                    listSorted[listCounts[b]++] = m_listPendingAdds[i];
+                }
+                m_listPendingAdds.swap(listSorted);
+            }
+
+            for(size_t i=0; i < numAdds;)   {
+                size_t j=i+1;
+                while(j < numAdds &&
+                      m_listPendingAdds[j].nodeId == m_listPendingAdds[i].nodeId)
+                {   j++;   }
+
+                if(j-i > 1)   {
+                    std::sort(m_listPendingAdds.begin()+i,
+                              m_listPendingAdds.begin()+j);
+                }
+                i = j;
+            }
+        }
+
+        std::vector<osmscout::Id>   m_listNodeIds;
+        std::vector<uint32_t>       m_listOffsets;
+        std::vector<osmscout::Id>   m_listWayIds;
+
+        std::vector<NodeWay>        m_listPendingAdds;
+        IdSet                       m_setPendingRemoves;
+    };
+}
+
+#endif
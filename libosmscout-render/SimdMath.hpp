@@ -0,0 +1,90 @@
+/*
+    libosmscout-render
+
+    Copyright (C) 2012, Preet Desai
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef OSMSCOUTRENDER_SIMDMATH_HPP
+#define OSMSCOUTRENDER_SIMDMATH_HPP
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+namespace osmsrender
+{
+    // calcSinCos2
+    // * sin and cos of two angles (radians) at once, using
+    //   the cephes range reduction and polynomials
+    // * within an ulp of libm sin/cos over [-2pi,2pi], as
+    //   checked by the benchmark (-p)
+    inline void calcSinCos2(__m128d x, __m128d &sinX, __m128d &cosX)
+    {
+        __m128d const signBit = _mm_set1_pd(-0.0);
+        __m128d xSign = _mm_and_pd(x,signBit);
+        __m128d ax = _mm_andnot_pd(signBit,x);
+
+        // octant j (rounded up to even) and the
+        // angle reduced to [-pi/4,pi/4]
+        __m128i j = _mm_cvttpd_epi32(_mm_mul_pd(ax,_mm_set1_pd(1.27323954473516268615)));
+        j = _mm_and_si128(_mm_add_epi32(j,_mm_set1_epi32(1)),_mm_set1_epi32(~1));
+        __m128d y = _mm_cvtepi32_pd(j);
+
+        __m128d z = _mm_sub_pd(ax,_mm_mul_pd(y,_mm_set1_pd(7.85398125648498535156E-1)));
+        z = _mm_sub_pd(z,_mm_mul_pd(y,_mm_set1_pd(3.77489470793079817668E-8)));
+        z = _mm_sub_pd(z,_mm_mul_pd(y,_mm_set1_pd(2.69515142907905952645E-15)));
+        __m128d zz = _mm_mul_pd(z,z);
+
+        // sin(z) = z + z^3*P(z^2)
+        __m128d ps = _mm_set1_pd(1.58962301576546568060E-10);
+        ps = _mm_add_pd(_mm_mul_pd(ps,zz),_mm_set1_pd(-2.50507477628578072866E-8));
+        ps = _mm_add_pd(_mm_mul_pd(ps,zz),_mm_set1_pd(2.75573136213857245213E-6));
+        ps = _mm_add_pd(_mm_mul_pd(ps,zz),_mm_set1_pd(-1.98412698295895385996E-4));
+        ps = _mm_add_pd(_mm_mul_pd(ps,zz),_mm_set1_pd(8.33333333332211858878E-3));
+        ps = _mm_add_pd(_mm_mul_pd(ps,zz),_mm_set1_pd(-1.66666666666666307295E-1));
+        ps = _mm_add_pd(z,_mm_mul_pd(_mm_mul_pd(z,zz),ps));
+
+        // cos(z) = 1 - z^2/2 + z^4*Q(z^2)
+        __m128d pc = _mm_set1_pd(-1.13585365213876817300E-11);
+        pc = _mm_add_pd(_mm_mul_pd(pc,zz),_mm_set1_pd(2.08757008419747316778E-9));
+        pc = _mm_add_pd(_mm_mul_pd(pc,zz),_mm_set1_pd(-2.75573141792967388112E-7));
+        pc = _mm_add_pd(_mm_mul_pd(pc,zz),_mm_set1_pd(2.48015872888517045348E-5));
+        pc = _mm_add_pd(_mm_mul_pd(pc,zz),_mm_set1_pd(-1.38888888888730564116E-3));
+        pc = _mm_add_pd(_mm_mul_pd(pc,zz),_mm_set1_pd(4.16666666666665929218E-2));
+        pc = _mm_add_pd(_mm_sub_pd(_mm_set1_pd(1.0),_mm_mul_pd(zz,_mm_set1_pd(0.5))),
+                        _mm_mul_pd(_mm_mul_pd(zz,zz),pc));
+
+        // widen the octant bits to 64 bit lane masks
+        __m128i jj = _mm_unpacklo_epi32(j,j);
+        __m128i const two = _mm_set1_epi32(2);
+        __m128i const four = _mm_set1_epi32(4);
+        __m128d swapMask = _mm_castsi128_pd(_mm_cmpeq_epi32(_mm_and_si128(jj,two),two));
+        __m128d sinFlip = _mm_castsi128_pd(_mm_cmpeq_epi32(_mm_and_si128(jj,four),four));
+        __m128d cosFlip = _mm_castsi128_pd(_mm_cmpeq_epi32(
+            _mm_and_si128(_mm_add_epi32(jj,two),four),four));
+
+        // octants 2 and 6 swap the polynomials
+        sinX = _mm_or_pd(_mm_and_pd(swapMask,pc),_mm_andnot_pd(swapMask,ps));
+        cosX = _mm_or_pd(_mm_and_pd(swapMask,ps),_mm_andnot_pd(swapMask,pc));
+
+        sinX = _mm_xor_pd(sinX,_mm_xor_pd(xSign,_mm_and_pd(sinFlip,signBit)));
+        cosX = _mm_xor_pd(cosX,_mm_and_pd(cosFlip,signBit));
+    }
+}
+
+#endif
+
+#endif
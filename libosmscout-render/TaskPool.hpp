@@ -0,0 +1,289 @@
+/*
+    libosmscout-render
+
+    Copyright (C) 2012, Preet Desai
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef OSMSCOUTRENDER_TASKPOOL_HPP
+#define OSMSCOUTRENDER_TASKPOOL_HPP
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace osmsrender
+{
+    // a fixed set of threads used to run batches
+    // of independent tasks in parallel
+
+    // each thread starts a batch with an equal share of the
+    // tasks and works through them in order; threads that run
+    // out of tasks steal the back half of another thread's
+    // remaining tasks, so uneven task costs are balanced out
+
+    class TaskPool
+    {
+    public:
+        // numThreads includes the calling thread; if
+        // zero, the hardware concurrency is used
+        TaskPool(size_t numThreads=0) :
+            m_taskFn(NULL),
+            m_batchId(0),
+            m_numBusy(0),
+            m_exit(false)
+        {
+            if(numThreads == 0)   {
+                numThreads = std::thread::hardware_concurrency();
+            }
+            numThreads = (numThreads > 0) ? numThreads : 1;
+
+            for(size_t i=0; i < numThreads; i++)   {
+                m_listRanges.push_back(new TaskRange);
+            }
+
+            // the calling thread uses the first range
+            for(size_t i=1; i < numThreads; i++)   {
+                m_listThreads.push_back(
+                    std::thread(&TaskPool::runWorker,this,i));
+            }
+        }
+
+        ~TaskPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_exit = true;
+            }
+            m_cvStart.notify_all();
+
+            for(size_t i=0; i < m_listThreads.size(); i++)
+            {   m_listThreads[i].join();   }
+
+            for(size_t i=0; i < m_listRanges.size(); i++)
+            {   delete m_listRanges[i];   }
+        }
+
+        size_t GetNumThreads() const
+        {   return m_listThreads.size()+1;   }
+
+        // GetThreadIdx
+        // * the index in [0,GetNumThreads()) of the thread
+        //   running the current task; the thread that calls
+        //   RunTasks is always 0, so this can be used to give
+        //   each thread its own scratch data
+        static size_t GetThreadIdx()
+        {   return threadIdx();   }
+
+        // RunTasks
+        // * calls taskFn(i) for each i in [0,numTasks) using
+        //   the pool's threads and the calling thread, and
+        //   returns once all of the tasks have finished
+        // * tasks may run in any order on any thread, so
+        //   they shouldn't depend on each other
+        void RunTasks(size_t numTasks,
+                      std::function<void(size_t)> const &taskFn)
+        {
+            if(numTasks == 0)
+            {   return;   }
+
+            // only one batch runs at a time
+            std::lock_guard<std::mutex> batchLock(m_batchMutex);
+
+            if(numTasks == 1 || m_listThreads.empty())   {
+                threadIdx() = 0;
+                for(size_t i=0; i < numTasks; i++)
+                {   taskFn(i);   }
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                // split tasks evenly between threads
+                size_t numRanges = m_listRanges.size();
+                for(size_t i=0; i < numRanges; i++)   {
+                    std::lock_guard<std::mutex> rangeLock(m_listRanges[i]->mutex);
+                    m_listRanges[i]->begin = calcRangeBegin(numTasks,i);
+                    m_listRanges[i]->end = calcRangeBegin(numTasks,i+1);
+                }
+
+                m_taskFn = &taskFn;
+                m_numBusy = m_listThreads.size();
+                m_batchId++;
+            }
+            m_cvStart.notify_all();
+
+            // the calling thread helps out
+            runTasks(taskFn,0);
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while(m_numBusy > 0)
+            {   m_cvDone.wait(lock);   }
+
+            m_taskFn = NULL;
+        }
+
+        // RunTasksByPriority
+        // * like RunTasks, but tasks with a lower index are
+        //   started first -- tasks are dealt out to threads
+        //   in turn instead of in contiguous blocks, so every
+        //   thread works from the front of the list
+        void RunTasksByPriority(size_t numTasks,
+                                std::function<void(size_t)> const &taskFn)
+        {
+            // listTaskIdxs maps the position of a task within
+            // the thread ranges RunTasks uses to its index
+            std::vector<size_t> listTaskIdxs(numTasks);
+            size_t taskIdx=0;
+            for(size_t j=0; taskIdx < numTasks; j++)   {
+                for(size_t i=0; i < m_listRanges.size(); i++)   {
+                    size_t pos = calcRangeBegin(numTasks,i)+j;
+                    if(pos < calcRangeBegin(numTasks,i+1))   {
+                        listTaskIdxs[pos] = taskIdx;
+                        taskIdx++;
+                    }
+                }
+            }
+
+            RunTasks(numTasks,[&](size_t i)
+            {   taskFn(listTaskIdxs[i]);   });
+        }
+
+    private:
+        // calcRangeBegin
+        // * the first task of a thread's range when
+        //   tasks are split evenly between threads
+        size_t calcRangeBegin(size_t numTasks, size_t rangeIdx) const
+        {   return (numTasks*rangeIdx)/m_listRanges.size();   }
+
+        static size_t & threadIdx()
+        {
+            static thread_local size_t idx = 0;
+            return idx;
+        }
+
+        struct TaskRange
+        {
+            TaskRange() : begin(0),end(0) {}
+
+            std::mutex mutex;
+            size_t begin;
+            size_t end;
+        };
+
+        void runWorker(size_t rangeIdx)
+        {
+            size_t lastBatchId = 0;
+            while(true)
+            {
+                std::function<void(size_t)> const * taskFn;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    while(!m_exit && m_batchId == lastBatchId)
+                    {   m_cvStart.wait(lock);   }
+
+                    if(m_exit)
+                    {   return;   }
+
+                    lastBatchId = m_batchId;
+                    taskFn = m_taskFn;
+                }
+
+                runTasks(*taskFn,rangeIdx);
+
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_numBusy--;
+                }
+                m_cvDone.notify_all();
+            }
+        }
+
+        void runTasks(std::function<void(size_t)> const &taskFn,
+                      size_t rangeIdx)
+        {
+            TaskRange * ownRange = m_listRanges[rangeIdx];
+            size_t taskIdx;
+            threadIdx() = rangeIdx;
+
+            while(true)
+            {
+                while(popTask(ownRange,taskIdx))
+                {   taskFn(taskIdx);   }
+
+                if(!stealTasks(rangeIdx))
+                {   break;   }
+            }
+        }
+
+        bool popTask(TaskRange * range, size_t &taskIdx)
+        {
+            std::lock_guard<std::mutex> lock(range->mutex);
+            if(range->begin == range->end)
+            {   return false;   }
+
+            taskIdx = range->begin;
+            range->begin++;
+            return true;
+        }
+
+        bool stealTasks(size_t rangeIdx)
+        {
+            // look for the first thread after this one
+            // with tasks left and take the back half
+            size_t numRanges = m_listRanges.size();
+            for(size_t i=1; i < numRanges; i++)
+            {
+                TaskRange * victim = m_listRanges[(rangeIdx+i)%numRanges];
+                size_t stolenBegin,stolenEnd;
+                {
+                    std::lock_guard<std::mutex> lock(victim->mutex);
+                    size_t numLeft = victim->end - victim->begin;
+                    if(numLeft == 0)
+                    {   continue;   }
+
+                    stolenEnd = victim->end;
+                    stolenBegin = victim->begin + numLeft/2;
+                    victim->end = stolenBegin;
+                }
+
+                TaskRange * ownRange = m_listRanges[rangeIdx];
+                std::lock_guard<std::mutex> lock(ownRange->mutex);
+                ownRange->begin = stolenBegin;
+                ownRange->end = stolenEnd;
+                return true;
+            }
+            return false;
+        }
+
+        std::vector<std::thread>            m_listThreads;
+        std::vector<TaskRange*>             m_listRanges;
+        std::mutex                          m_batchMutex;
+        std::mutex                          m_mutex;
+        std::condition_variable             m_cvStart;
+        std::condition_variable             m_cvDone;
+
+        std::function<void(size_t)> const * m_taskFn;
+        size_t                              m_batchId;
+        size_t                              m_numBusy;
+        bool                                m_exit;
+    };
+}
+
+#endif
@@ -0,0 +1,269 @@
+/*
+    libosmscout-render
+
+    Copyright (C) 2012, Preet Desai
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef OSMSCOUTRENDER_TRACERECORDER_HPP
+#define OSMSCOUTRENDER_TRACERECORDER_HPP
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+namespace osmsrender
+{
+    // TraceEvent
+    // * a single traced scope; name and category
+    //   aren't copied so they should be literals
+    // * startUs and durationUs are in microseconds,
+    //   relative to when recording was started
+    struct TraceEvent
+    {
+        TraceEvent() :
+            name(NULL),category(NULL),startUs(0),durationUs(0)
+        {}
+
+        char const *    name;
+        char const *    category;
+        double          startUs;
+        double          durationUs;
+    };
+
+    // TraceThread
+    // * the events recorded by a single thread; only that
+    //   thread adds events, and numEvents is only increased
+    //   once an event has been written, so events can be
+    //   read without locking while the thread is recording
+    // * events past the end of listEvents are dropped
+    struct TraceThread
+    {
+        TraceThread(std::thread::id myThreadId,size_t myTid) :
+            threadId(myThreadId),tid(myTid),
+            numEvents(0),numDropped(0)
+        {}
+
+        std::thread::id             threadId;
+        size_t                      tid;
+        std::vector<TraceEvent>     listEvents;
+        std::atomic<size_t>         numEvents;
+        std::atomic<size_t>         numDropped;
+    };
+
+    // records scoped events from any number of threads
+    // (see TraceScope) so they can be viewed on a timeline
+
+    // each thread writes to its own buffer, so recording an
+    // event doesn't take a lock; a thread only locks the
+    // recorder the first time it records an event (to find
+    // or create its buffer) -- when recording is stopped,
+    // a trace scope only checks an atomic flag
+
+    // buffers are a fixed size so they never move while
+    // being written; Start should only be called while no
+    // other thread is recording events
+
+    class TraceRecorder
+    {
+    public:
+        TraceRecorder() :
+            m_id(nextRecorderId()),
+            m_recording(false),
+            m_maxEventsPerThread(0)
+        {}
+
+        ~TraceRecorder()
+        {
+            for(size_t i=0; i < m_listThreads.size(); i++)
+            {   delete m_listThreads[i];   }
+        }
+
+        // Start
+        // * clears any recorded events and starts recording
+        //   up to maxEventsPerThread events for each thread
+        void Start(size_t maxEventsPerThread)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_maxEventsPerThread = maxEventsPerThread;
+            for(size_t i=0; i < m_listThreads.size(); i++)   {
+                TraceThread * thread = m_listThreads[i];
+                thread->listEvents.resize(m_maxEventsPerThread);
+                thread->numEvents.store(0,std::memory_order_relaxed);
+                thread->numDropped.store(0,std::memory_order_relaxed);
+            }
+
+            m_tStart = std::chrono::steady_clock::now();
+            m_recording.store(true,std::memory_order_release);
+        }
+
+        // Stop
+        // * events already recorded are kept
+        void Stop()
+        {   m_recording.store(false,std::memory_order_release);   }
+
+        bool IsRecording() const
+        {   return m_recording.load(std::memory_order_relaxed);   }
+
+        // GetTimeUs
+        // * microseconds since recording was started
+        double GetTimeUs() const
+        {
+            return std::chrono::duration<double,std::micro>(
+                        std::chrono::steady_clock::now()-m_tStart).count();
+        }
+
+        // AddEvent
+        // * adds an event for the calling thread
+        void AddEvent(char const *name, char const *category,
+                      double startUs, double endUs)
+        {
+            TraceThread * thread = getThread();
+            size_t idx = thread->numEvents.load(std::memory_order_relaxed);
+            if(idx >= thread->listEvents.size())   {
+                thread->numDropped.fetch_add(1,std::memory_order_relaxed);
+                return;
+            }
+
+            TraceEvent &event = thread->listEvents[idx];
+            event.name = name;
+            event.category = category;
+            event.startUs = startUs;
+            event.durationUs = endUs-startUs;
+            thread->numEvents.store(idx+1,std::memory_order_release);
+        }
+
+        // GetEvents
+        // * copies the events recorded by each thread,
+        //   with listEventsByThread indexed by tid
+        // * returns the number of events that were dropped
+        //   because a thread's buffer was full
+        size_t GetEvents(std::vector<std::vector<TraceEvent> > &listEventsByThread)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            size_t numDropped=0;
+            listEventsByThread.clear();
+            listEventsByThread.resize(m_listThreads.size());
+            for(size_t i=0; i < m_listThreads.size(); i++)   {
+                TraceThread const * thread = m_listThreads[i];
+                size_t numEvents = thread->numEvents.load(std::memory_order_acquire);
+                listEventsByThread[i].assign(thread->listEvents.begin(),
+                                             thread->listEvents.begin()+numEvents);
+
+                numDropped += thread->numDropped.load(std::memory_order_relaxed);
+            }
+            return numDropped;
+        }
+
+    private:
+        // getThread
+        // * each thread remembers its buffer for the
+        //   last recorder it added an event to, so the
+        //   recorder is only locked on the first event
+        // * recorders get unique ids so a remembered
+        //   buffer is never used for a new recorder at
+        //   the same address
+        TraceThread * getThread()
+        {
+            static thread_local size_t t_recorderId = 0;
+            static thread_local TraceThread * t_thread = NULL;
+            if(t_recorderId == m_id)
+            {   return t_thread;   }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::thread::id threadId = std::this_thread::get_id();
+
+            TraceThread * thread = NULL;
+            for(size_t i=0; i < m_listThreads.size(); i++)   {
+                if(m_listThreads[i]->threadId == threadId)
+                {   thread = m_listThreads[i];   break;   }
+            }
+
+            if(thread == NULL)   {
+                thread = new TraceThread(threadId,m_listThreads.size());
+                thread->listEvents.resize(m_maxEventsPerThread);
+                m_listThreads.push_back(thread);
+            }
+
+            t_recorderId = m_id;
+            t_thread = thread;
+            return thread;
+        }
+
+        static size_t nextRecorderId()
+        {
+            static std::atomic<size_t> nextId(1);
+            return nextId.fetch_add(1);
+        }
+
+        size_t                      m_id;
+        std::atomic<bool>           m_recording;
+        size_t                      m_maxEventsPerThread;
+        std::chrono::steady_clock::time_point m_tStart;
+
+        // guards the list of threads (but
+        // not the events in each thread)
+        std::mutex                  m_mutex;
+        std::vector<TraceThread*>   m_listThreads;
+    };
+
+    // TraceScope
+    // * records an event from when the scope is created
+    //   until it ends if the recorder was recording when
+    //   the scope was created
+    class TraceScope
+    {
+    public:
+        TraceScope(TraceRecorder &recorder,
+                   char const *name,
+                   char const *category) :
+            m_recorder(recorder.IsRecording() ? &recorder : NULL),
+            m_name(name),
+            m_category(category),
+            m_startUs(0)
+        {
+            if(m_recorder)
+            {   m_startUs = m_recorder->GetTimeUs();   }
+        }
+
+        ~TraceScope()
+        {
+            if(m_recorder)   {
+                m_recorder->AddEvent(m_name,m_category,m_startUs,
+                                     m_recorder->GetTimeUs());
+            }
+        }
+
+    private:
+        TraceRecorder *     m_recorder;
+        char const *        m_name;
+        char const *        m_category;
+        double              m_startUs;
+    };
+}
+
+// OSRTRACE
+// * traces the rest of the enclosing scope with the
+//   renderer's recorder (see MapRenderer::SetTraceRecording)
+#define OSRTRACE_JOIN2(a,b) a##b
+#define OSRTRACE_JOIN(a,b) OSRTRACE_JOIN2(a,b)
+#define OSRTRACE(name,category) \
+    osmsrender::TraceScope OSRTRACE_JOIN(osrTraceScope,__LINE__)(m_trace,name,category)
+
+#endif
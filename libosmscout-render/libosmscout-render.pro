@@ -1,6 +1,7 @@
 TEMPLATE = lib
 TARGET = osmscoutrender
-CONFIG += debug staticlib
+CONFIG += debug staticlib thread
+QMAKE_CXXFLAGS += -std=c++11
 
 #boost
 USE_BOOST   {
@@ -69,6 +70,16 @@ HEADERS += \
         RenderStyleConfig.hpp \
         Vec2.hpp \
         Vec3.hpp \
-        SimpleLogger.hpp \
+        CompactGeometry.hpp \
+        GeomBuffer.hpp \
+        Logger.hpp \
+        IdMap.hpp \
+        IdDiff.hpp \
+        SharedNodeIndex.hpp \
+        TaskPool.hpp \
+        RenderDataCache.hpp \
+        ScratchArena.hpp \
+        SimdMath.hpp \
+        TraceRecorder.hpp \
         DataSet.hpp \
         MapRenderer.h
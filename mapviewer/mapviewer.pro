@@ -4,7 +4,7 @@ LIBOSMSCOUTRENDER_PATH = /home/preet/Dev/projects/libosmscout-render
 
 
 QT       += core gui opengl
-CONFIG   += debug link_pkgconfig
+CONFIG   += debug link_pkgconfig thread
 PKGCONFIG += openthreads openscenegraph
 TARGET = mapviewer
 TEMPLATE = app
@@ -86,9 +86,19 @@ LIBS += -L$${LIBOSMSCOUT_PATH}/lib -losmscout
 HEADERS += \
     $${LIBOSMSCOUTRENDER_PATH}/libosmscout-render/RenderStyleReader.h \
     $${LIBOSMSCOUTRENDER_PATH}/libosmscout-render/RenderStyleConfig.hpp \
-    $${LIBOSMSCOUTRENDER_PATH}/libosmscout-render/SimpleLogger.hpp \
+    $${LIBOSMSCOUTRENDER_PATH}/libosmscout-render/Logger.hpp \
+    $${LIBOSMSCOUTRENDER_PATH}/libosmscout-render/IdMap.hpp \
+    $${LIBOSMSCOUTRENDER_PATH}/libosmscout-render/IdDiff.hpp \
+    $${LIBOSMSCOUTRENDER_PATH}/libosmscout-render/SharedNodeIndex.hpp \
+    $${LIBOSMSCOUTRENDER_PATH}/libosmscout-render/TaskPool.hpp \
+    $${LIBOSMSCOUTRENDER_PATH}/libosmscout-render/RenderDataCache.hpp \
+    $${LIBOSMSCOUTRENDER_PATH}/libosmscout-render/ScratchArena.hpp \
+    $${LIBOSMSCOUTRENDER_PATH}/libosmscout-render/SimdMath.hpp \
+    $${LIBOSMSCOUTRENDER_PATH}/libosmscout-render/TraceRecorder.hpp \
     $${LIBOSMSCOUTRENDER_PATH}/libosmscout-render/Vec2.hpp \
     $${LIBOSMSCOUTRENDER_PATH}/libosmscout-render/Vec3.hpp \
+    $${LIBOSMSCOUTRENDER_PATH}/libosmscout-render/CompactGeometry.hpp \
+    $${LIBOSMSCOUTRENDER_PATH}/libosmscout-render/GeomBuffer.hpp \
     $${LIBOSMSCOUTRENDER_PATH}/libosmscout-render/DataSet.hpp \
     $${LIBOSMSCOUTRENDER_PATH}/libosmscout-render/MapRenderer.h
 
@@ -63,6 +63,25 @@ void Viewport::onLoadMap(const QString &mapPath, const QString &stylePath)
     m_mapRenderer->SetRenderStyle(stylePath.toStdString());
     m_mapRenderer->AddDataSet(m_dataset_osm);
 
+    // build scene updates off the ui thread and
+    // commit them before each frame is drawn
+    m_mapRenderer->SetAsyncSceneUpdates(true);
+
+    // only query regions newly exposed by camera moves
+    m_mapRenderer->SetIncrementalSceneUpdates(true);
+
+    // prefetch where the camera is headed
+    m_mapRenderer->SetScenePrefetch(1.5);
+
+    // keep render data for objects that leave the view
+    m_mapRenderer->SetRenderDataCacheSize(64*1024*1024);
+
+    // don't flip lods on and off near range boundaries
+    m_mapRenderer->SetLODHysteresis(0.1);
+
+    // stream large updates in over several frames
+    m_mapRenderer->SetSceneCommitBudget(8.0,0);
+
     // init scene
     osmsrender::PointLLA camLLA(51.5039,-0.1214,750);   // dt london
     m_mapRenderer->InitializeScene(camLLA,30.0,1.67);
@@ -164,9 +183,17 @@ void Viewport::initializeGL()
 
 void Viewport::paintGL()
 {
+    if(m_loadedMap)
+    {   m_mapRenderer->CommitSceneUpdate();   }
+
 //    this->startTiming("Rendering Frame");
     m_osg_viewer->frame();
 //    this->endTiming();
+
+    // we only render on demand, so keep drawing
+    // frames until the update is fully committed
+    if(m_loadedMap && m_mapRenderer->IsSceneUpdatePending())
+    {   QTimer::singleShot(0,this,SLOT(updateGL()));   }
 }
 
 void Viewport::mousePressEvent(QMouseEvent *event)